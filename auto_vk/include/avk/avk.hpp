@@ -2,10 +2,13 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <bitset>
 #include <cassert>
+#include <chrono>
 #include <cmath>
 #include <cstdint>
+#include <deque>
 #include <exception>
 #include <filesystem>
 #include <fstream>
@@ -13,6 +16,7 @@
 #include <iostream>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <queue>
 #include <set>
@@ -71,6 +75,20 @@
 #define AVK_STAGING_BUFFER_READBACK_MEMORY_USAGE avk::memory_usage::host_visible
 #endif
 
+/** CONFIG SETTING: AVK_STAGING_RING_SIZE
+ *
+ *	The following setting CAN be set BEFORE including avk.hpp in order to change
+ *	the size (in bytes) of the staging rings which are used by buffer_t::fill and
+ *	buffer_t::read_into instead of creating a new staging buffer for every transfer.
+ *	One ring is used for uploads and one for readbacks. Transfers which are larger
+ *	than a quarter of the ring's size always get a dedicated staging buffer.
+ *
+ *	Define it to 0 to disable the staging rings altogether.
+ */
+#if !defined(AVK_STAGING_RING_SIZE)
+#define AVK_STAGING_RING_SIZE (32 * 1024 * 1024)
+#endif
+
 /** CONFIG SETTING: AVK_USE_CORE_INSTEAD_OF_SYNCHRONIZATION2
  *	If this is defined BEFORE including avk.hpp, the Vulkan API core functions are used 
  *	instead of the Synchronization2 extension functions (which were promoted to core with
@@ -221,6 +239,7 @@ namespace avk
 }
 
 #include "avk/buffer.hpp"
+#include "avk/staging_ring.hpp"
 #include "avk/shader_info.hpp"
 
 #include "avk/shader_binding_table.hpp"
@@ -544,6 +563,41 @@ namespace avk
 		//}
 #pragma endregion
 
+#pragma region staging rings
+		/** Gets the staging ring which is used by buffer_t::fill for uploads to device-local memory.
+		 *	It is created lazily upon first use.
+		 *	@return	The ring, or nullptr if staging rings are disabled (see AVK_STAGING_RING_SIZE).
+		 */
+		staging_ring* upload_staging_ring() const;
+
+		/** Gets the staging ring which is used by buffer_t::read_into for readbacks from device-local memory.
+		 *	It is created lazily upon first use.
+		 *	@return	The ring, or nullptr if staging rings are disabled (see AVK_STAGING_RING_SIZE).
+		 */
+		staging_ring* readback_staging_ring() const;
+
+		/** Returns the usage counters of the upload staging ring (bytes uploaded, ring wraps, fallback allocations). */
+		staging_ring_statistics upload_staging_statistics() const;
+
+		/** Returns the usage counters of the readback staging ring. */
+		staging_ring_statistics readback_staging_statistics() const;
+
+		/** Destroys the staging rings. Must be invoked before the memory allocator and the device are destroyed.
+		 *	Regions which are still referenced by command buffers are simply dropped then.
+		 */
+		void destroy_staging_rings();
+#pragma endregion
+
+#pragma region pipeline cache
+		/** Gets the pipeline cache which is passed to every creation of a graphics, compute, or ray tracing pipeline.
+		 *	Override it in order to provide a cache. By default, pipelines are created without a cache.
+		 */
+		virtual vk::PipelineCache pipeline_cache() const { return nullptr; }
+
+		/** Returns the total time which has been spent in the driver's pipeline creation calls so far, summed over all threads. */
+		std::chrono::nanoseconds pipeline_creation_time() const { return std::chrono::nanoseconds{ mPipelineCreationTimeNs.load(std::memory_order_relaxed) }; }
+#pragma endregion
+
 #pragma region buffer view
 		/**	Create a buffer view over the given buffer in the specified format.
 		 *
@@ -1010,6 +1064,14 @@ namespace avk
 #pragma region semaphore
 		static semaphore create_semaphore(vk::Device aDevice, const DISPATCH_LOADER_CORE_TYPE& aDispatchLoader, std::function<void(semaphore_t&)> aAlterConfigBeforeCreation = {});
 		semaphore create_semaphore(std::function<void(semaphore_t&)> aAlterConfigBeforeCreation = {});
+
+		/** Creates a timeline semaphore, which requires the timelineSemaphore feature (core in Vulkan 1.2).
+		 *	Its value can be waited on and signalled via the mValue members of semaphore_wait_info and
+		 *	semaphore_signal_info, e.g.: .waiting_for((aTimeline >> avk::stage::all_commands).at_value(1))
+		 *	@param	aInitialValue					The semaphore's counter value after creation
+		 *	@param	aAlterConfigBeforeCreation		Optional function to alter the config before the semaphore is created
+		 */
+		semaphore create_timeline_semaphore(uint64_t aInitialValue = 0, std::function<void(semaphore_t&)> aAlterConfigBeforeCreation = {});
 #pragma endregion
 
 #pragma region shader
@@ -1058,5 +1120,20 @@ namespace avk
 		 *	@param	aRecordedCommands	Stuff to be put into a new instance of avk::recoded_commands
 		 */
 		avk::recorded_commands record(std::vector<recorded_commands_t> aRecordedCommands) const;
+
+	private:
+		/** Invokes aCreate and adds its duration to the pipeline creation time. */
+		template <typename F>
+		auto timed_pipeline_creation(F aCreate)
+		{
+			const auto begin = std::chrono::steady_clock::now();
+			auto result = aCreate();
+			mPipelineCreationTimeNs.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count(), std::memory_order_relaxed);
+			return result;
+		}
+
+		mutable std::shared_ptr<staging_ring> mUploadStagingRing;
+		mutable std::shared_ptr<staging_ring> mReadbackStagingRing;
+		std::atomic<int64_t> mPipelineCreationTimeNs{ 0 };
 	};
 }
@@ -227,6 +227,14 @@ namespace avk
 
 		void bind_descriptors(vk::PipelineBindPoint aBindingPoint, vk::PipelineLayout aLayoutHandle, std::vector<descriptor_set> aDescriptorSets);
 
+		/** Binds descriptor sets given by their handles.
+		 *	@param	aBindingPoint		The pipeline bind point
+		 *	@param	aLayoutHandle		The layout of the pipeline to bind descriptors to
+		 *	@param	aSetIds				The set id of each descriptor set, in ascending order
+		 *	@param	aHandles			The handle of each descriptor set
+		 */
+		void bind_descriptors(vk::PipelineBindPoint aBindingPoint, vk::PipelineLayout aLayoutHandle, const std::vector<uint32_t>& aSetIds, const std::vector<vk::DescriptorSet>& aHandles);
+
 		void save_subpass_contents_state(vk::SubpassContents x) { mSubpassContentsState = x; }
 		
 		[[nodiscard]] const auto* root_ptr() const { return mRoot; }
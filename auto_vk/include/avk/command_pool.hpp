@@ -35,6 +35,13 @@ namespace avk
 			
 		command_buffer alloc_command_buffer(vk::CommandBufferUsageFlags aUsageFlags = {}, vk::CommandBufferLevel aLevel = vk::CommandBufferLevel::ePrimary);
 
+		/** Resets the whole pool, i.e., moves all command buffers which have been allocated from it back into the initial state.
+		 *	None of them may be pending execution. This does NOT invoke the command buffers' post-execution handlers or
+		 *	custom deleters => call command_buffer_t::prepare_for_reuse on each of them before resetting the pool.
+		 *	@param	aFlags		Pass vk::CommandPoolResetFlagBits::eReleaseResources to also return the pool's memory to the system.
+		 */
+		void reset(vk::CommandPoolResetFlags aFlags = {});
+
 		[[nodiscard]] const auto* root_ptr() const { return mRoot; }
 
 	private:
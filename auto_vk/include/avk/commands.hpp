@@ -614,24 +614,24 @@ namespace avk
 		extern state_type_command bind_pipeline(const ray_tracing_pipeline_t& aPipeline);
 #endif 
 
-		/** Binds a graphics pipeline.
+		/** Binds descriptor sets.
 		 *	@param	aPipelineLayout		The layout of the pipeline to bind descriptors to
-		 *	@param	aDescriptorSets		The descriptor sets to be bound
+		 *	@param	aDescriptorSets		The descriptor sets to be bound. Only their handles and set ids are stored in the command.
 		 */
-		extern state_type_command bind_descriptors(std::tuple<const graphics_pipeline_t*, const vk::PipelineLayout, const std::vector<vk::PushConstantRange>*> aPipelineLayout, std::vector<descriptor_set> aDescriptorSets);
+		extern state_type_command bind_descriptors(std::tuple<const graphics_pipeline_t*, const vk::PipelineLayout, const std::vector<vk::PushConstantRange>*> aPipelineLayout, const std::vector<descriptor_set>& aDescriptorSets);
 
-		/** Binds a graphics pipeline.
+		/** Binds descriptor sets.
 		 *	@param	aPipelineLayout		The layout of the pipeline to bind descriptors to
-		 *	@param	aDescriptorSets		The descriptor sets to be bound
+		 *	@param	aDescriptorSets		The descriptor sets to be bound. Only their handles and set ids are stored in the command.
 		 */
-		extern state_type_command bind_descriptors(std::tuple<const compute_pipeline_t*, const vk::PipelineLayout, const std::vector<vk::PushConstantRange>*> aPipelineLayout, std::vector<descriptor_set> aDescriptorSets);
+		extern state_type_command bind_descriptors(std::tuple<const compute_pipeline_t*, const vk::PipelineLayout, const std::vector<vk::PushConstantRange>*> aPipelineLayout, const std::vector<descriptor_set>& aDescriptorSets);
 
 #if VK_HEADER_VERSION >= 135
-		/** Binds a graphics pipeline.
+		/** Binds descriptor sets.
 		 *	@param	aPipelineLayout		The layout of the pipeline to bind descriptors to
-		 *	@param	aDescriptorSets		The descriptor sets to be bound
+		 *	@param	aDescriptorSets		The descriptor sets to be bound. Only their handles and set ids are stored in the command.
 		 */
-		extern state_type_command bind_descriptors(std::tuple<const ray_tracing_pipeline_t*, const vk::PipelineLayout, const std::vector<vk::PushConstantRange>*> aPipelineLayout, std::vector<descriptor_set> aDescriptorSets);
+		extern state_type_command bind_descriptors(std::tuple<const ray_tracing_pipeline_t*, const vk::PipelineLayout, const std::vector<vk::PushConstantRange>*> aPipelineLayout, const std::vector<descriptor_set>& aDescriptorSets);
 #endif
 
 		extern action_type_command draw(uint32_t aVertexCount, uint32_t aInstanceCount, uint32_t aFirstVertex, uint32_t aFirstInstance);
@@ -1434,6 +1434,15 @@ namespace avk
 	{
 		avk::resource_argument<avk::semaphore_t> mWaitSemaphore;
 		avk::stage::pipeline_stage_flags mDstStage;
+		// The value to wait for. Only used for timeline semaphores:
+		uint64_t mValue = 0;
+
+		/** Sets the value which a timeline semaphore must have reached before the wait is satisfied. */
+		semaphore_wait_info&& at_value(uint64_t aValue) &&
+		{
+			mValue = aValue;
+			return std::move(*this);
+		}
 	};
 
 	inline semaphore_wait_info operator>> (avk::resource_argument<avk::semaphore_t> a, avk::stage::pipeline_stage_flags b)
@@ -1446,6 +1455,15 @@ namespace avk
 	{
 		avk::stage::pipeline_stage_flags mSrcStage;
 		avk::resource_argument<avk::semaphore_t> mSignalSemaphore;
+		// The value to signal. Only used for timeline semaphores:
+		uint64_t mValue = 0;
+
+		/** Sets the value which a timeline semaphore is set to when it is signalled. */
+		semaphore_signal_info&& at_value(uint64_t aValue) &&
+		{
+			mValue = aValue;
+			return std::move(*this);
+		}
 	};
 
 	inline semaphore_signal_info operator>> (avk::stage::pipeline_stage_flags a, avk::resource_argument<avk::semaphore_t> b)
@@ -41,20 +41,55 @@ namespace avk
 		
 		std::shared_ptr<descriptor_pool> get_descriptor_pool_for_layouts(const descriptor_alloc_request& aAllocRequest, bool aRequestNewPool = false);
 
-		std::vector<descriptor_set> get_or_create_descriptor_sets(std::initializer_list<binding_data> aBindings);
+		/**	Gets the descriptor sets for the given bindings from the cache, or allocates and writes them if they are not in there.
+		 *	Bindings which have been requested before are found in a lookup table, which is keyed on a hash of their set ids,
+		 *	binding ids, descriptor types, and resource handles. Such a lookup neither prepares descriptor_set instances nor
+		 *	allocates memory. Bindings of acceleration structures, and calls with more than cMaxLookupBindings bindings,
+		 *	always take the path of find_or_alloc_descriptor_sets.
+		 *	@return	The descriptor sets, ordered by their set ids. The reference is only valid until the next call of a
+		 *			non-const member of this cache, i.e., copy the sets to keep them.
+		 */
+		const std::vector<descriptor_set>& get_or_create_descriptor_sets(std::initializer_list<binding_data> aBindings);
+
+		/**	Prepares descriptor sets for the given bindings, and looks them up among all cached descriptor sets; the ones which
+		 *	are not in there are allocated and written. This is what get_or_create_descriptor_sets does if its lookup table
+		 *	does not contain the bindings yet.
+		 */
+		std::vector<descriptor_set> find_or_alloc_descriptor_sets(std::initializer_list<binding_data> aBindings);
 
 		int remove_sets_with_handle(vk::ImageView aHandle);
 		int remove_sets_with_handle(vk::Buffer aHandle);
 		int remove_sets_with_handle(vk::Sampler aHandle);
 		int remove_sets_with_handle(vk::BufferView aHandle);
 		
+		/** Maximum number of bindings per call of get_or_create_descriptor_sets which are looked up in its lookup table */
+		static constexpr size_t cMaxLookupBindings = 64;
+
 	private:
+		struct lookup_entry
+		{
+			std::size_t mHash;
+			uint32_t mResultIndex;
+		};
+		static constexpr uint32_t cEmptyLookupEntry = std::numeric_limits<uint32_t>::max();
+
+		const std::vector<descriptor_set>* find_in_lookup_table(std::size_t aHash, const binding_data* const* aBegin, const binding_data* const* aEnd) const;
+		const std::vector<descriptor_set>& insert_into_lookup_table(std::size_t aHash, std::vector<descriptor_set> aSets);
+		void clear_lookup_table();
+
 		std::string mName = "descriptor cache";
 		int mPreallocFactor = 5;
 		const root* mRoot;
 		
 		std::unordered_set<descriptor_set_layout> mLayouts;
 		std::unordered_set<descriptor_set> mSets;
+
+		// Open addressing with linear probing into mLookupResults, with a power-of-two size, and at most half full.
+		// The results are stored in a deque, so that references to them stay valid while further results are inserted:
+		std::vector<lookup_entry> mLookupTable;
+		std::deque<std::vector<descriptor_set>> mLookupResults;
+		// The result of the last call which could not use the lookup table:
+		std::vector<descriptor_set> mSetsWithoutLookup;
 		
 		// Descriptor pools are created/stored per thread and can have a name (an integer-id). 
 		// If possible, it is tried to re-use a pool. Even when re-using a pool, it might happen that
@@ -48,9 +48,26 @@ namespace avk
 		const auto& handle() const { return mSemaphore.get(); }
 		const auto* handle_addr() const { return &mSemaphore.get(); }
 
+		/** Returns true if this is a timeline semaphore (see root::create_timeline_semaphore), false if it is a binary semaphore. */
+		bool is_timeline() const { return vk::SemaphoreType::eTimeline == mSemaphoreType; }
+
+		/** Returns the current counter value of a timeline semaphore.
+		 *	Must not be called for binary semaphores.
+		 */
+		uint64_t query_current_value() const;
+
+		/** Waits on the host until a timeline semaphore has reached at least the given value.
+		 *	Must not be called for binary semaphores.
+		 *	@param	aValue		The value to wait for
+		 *	@param	aTimeout	Timeout in nanoseconds. Waits indefinitely if not set.
+		 */
+		void wait_until_value(uint64_t aValue, std::optional<uint64_t> aTimeout = {}) const;
+
 	private:
 		// The semaphore config struct:
 		vk::SemaphoreCreateInfo mCreateInfo;
+		// Binary or timeline:
+		vk::SemaphoreType mSemaphoreType;
 		// The semaphore handle:
 		vk::UniqueHandle<vk::Semaphore, DISPATCH_LOADER_CORE_TYPE> mSemaphore;
 
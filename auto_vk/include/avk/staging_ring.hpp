@@ -0,0 +1,162 @@
+#pragma once
+#include "avk/avk.hpp"
+
+namespace avk
+{
+	class staging_ring;
+
+	/** Counters which describe how a staging_ring has been used so far. */
+	struct staging_ring_statistics
+	{
+		/** Number of bytes which have been transferred through the ring */
+		uint64_t mBytesTransferred = 0;
+		/** Number of suballocations which have been served by the ring */
+		uint64_t mNumAllocations = 0;
+		/** How often the ring's head has wrapped around to the beginning of the ring */
+		uint64_t mNumWraps = 0;
+		/** Number of transfers which could not be served by the ring and required a dedicated staging buffer */
+		uint64_t mNumFallbackAllocations = 0;
+		/** Number of bytes which have been transferred through dedicated staging buffers */
+		uint64_t mBytesTransferredViaFallback = 0;
+	};
+
+	/** The bookkeeping of a staging_ring, which does not need a device: Hands out regions of a ring of the given capacity
+	 *	in order, and recycles them in the same order once they have been released.
+	 *	Not thread-safe; staging_ring guards it with its mutex.
+	 */
+	class ring_suballocator
+	{
+	public:
+		explicit ring_suballocator(vk::DeviceSize aCapacity) : mCapacity{ aCapacity } {}
+
+		/** Suballocates aSize bytes.
+		 *	@param	aSize			Number of bytes requested
+		 *	@param	aAlignment		Alignment of the region's offset; must be a power of two.
+		 *	@return	The region's id and offset, or an empty value if the ring has no room for it until older regions are released.
+		 */
+		std::optional<std::tuple<uint64_t, vk::DeviceSize>> allocate(vk::DeviceSize aSize, vk::DeviceSize aAlignment);
+
+		/** Releases the region with the given id. Its space is recycled as soon as all regions which have been allocated before it are released, too. */
+		void release(uint64_t aId);
+
+		/** The ring's capacity in bytes */
+		vk::DeviceSize capacity() const { return mCapacity; }
+
+		/** Number of regions which still occupy space, including released ones which wait for older regions to be released */
+		size_t num_in_flight() const { return mInFlight.size(); }
+
+		/** How often the head has wrapped around to the beginning of the ring */
+		uint64_t num_wraps() const { return mNumWraps; }
+
+	private:
+		struct in_flight_region
+		{
+			uint64_t mId;
+			vk::DeviceSize mOffset;
+			bool mReleased;
+		};
+
+		vk::DeviceSize mCapacity;
+		vk::DeviceSize mHead = 0;
+		uint64_t mNextId = 0;
+		uint64_t mNumWraps = 0;
+		std::deque<in_flight_region> mInFlight;
+	};
+
+	/** A region of a staging_ring's buffer.
+	 *	The region is handed back to the ring when this object is destroyed. Typically, its lifetime
+	 *	is tied to a command buffer (see command_buffer_t::set_custom_deleter), s.t. the region is
+	 *	recycled as soon as the command buffer is reset or destroyed, i.e., after its fence has signalled.
+	 */
+	class staging_ring_allocation
+	{
+		friend class staging_ring;
+
+	public:
+		staging_ring_allocation() = default;
+		staging_ring_allocation(staging_ring_allocation&&) noexcept = delete;
+		staging_ring_allocation(const staging_ring_allocation&) = delete;
+		staging_ring_allocation& operator=(staging_ring_allocation&&) noexcept = delete;
+		staging_ring_allocation& operator=(const staging_ring_allocation&) = delete;
+		~staging_ring_allocation();
+
+		/** The handle of the ring's buffer this region has been suballocated from */
+		vk::Buffer buffer_handle() const { return mBufferHandle; }
+
+		/** Offset in bytes of this region within the ring's buffer */
+		vk::DeviceSize offset() const { return mOffset; }
+
+		/** Size of this region in bytes */
+		vk::DeviceSize size() const { return mSize; }
+
+		/** Host-address of this region. The ring's buffer is persistently mapped. */
+		void* mapped_data() const { return mMappedData; }
+
+	private:
+		std::weak_ptr<staging_ring> mRing;
+		uint64_t mId = 0;
+		vk::Buffer mBufferHandle;
+		vk::DeviceSize mOffset = 0;
+		vk::DeviceSize mSize = 0;
+		void* mMappedData = nullptr;
+	};
+
+	/** A persistently mapped linear allocator for staging memory, used as a ring.
+	 *
+	 *	It is used internally by buffer_t::fill and buffer_t::read_into instead of creating
+	 *	a new staging buffer for each transfer. Regions are handed out in order and are
+	 *	recycled in order once they have been released (which happens when the command
+	 *	buffer they have been used with has finished executing and is reset or destroyed).
+	 *	The ring never blocks: If there is not enough free space, or if a transfer is too
+	 *	large for the ring, allocate() returns an empty pointer and the caller is expected
+	 *	to fall back to a dedicated staging buffer (see count_fallback).
+	 *
+	 *	All member functions are thread-safe.
+	 */
+	class staging_ring : public std::enable_shared_from_this<staging_ring>
+	{
+		friend class staging_ring_allocation;
+
+	public:
+		/** Creates a ring of the given capacity.
+		 *	@param	aRoot				The root which is used to create the ring's buffer
+		 *	@param	aMemoryUsage		Memory usage of the ring's buffer. Must be host-visible.
+		 *	@param	aBufferUsage		Usage flags of the ring's buffer, i.e., eTransferSrc for uploads or eTransferDst for readbacks.
+		 *	@param	aCapacity			Size of the ring's buffer in bytes
+		 */
+		staging_ring(const root& aRoot, avk::memory_usage aMemoryUsage, vk::BufferUsageFlags aBufferUsage, vk::DeviceSize aCapacity);
+		staging_ring(staging_ring&&) noexcept = delete;
+		staging_ring(const staging_ring&) = delete;
+		staging_ring& operator=(staging_ring&&) noexcept = delete;
+		staging_ring& operator=(const staging_ring&) = delete;
+		~staging_ring() = default;
+
+		/** Suballocates aSize bytes from the ring.
+		 *	@param	aSize			Number of bytes requested
+		 *	@param	aAlignment		Alignment of the region's offset; must be a power of two.
+		 *	@return	The allocation, or an empty pointer if it can not be served by the ring.
+		 *			The allocation is shared, s.t. it can be tied to multiple command buffers.
+		 */
+		std::shared_ptr<staging_ring_allocation> allocate(vk::DeviceSize aSize, vk::DeviceSize aAlignment = 16);
+
+		/** Records that a transfer of aSize bytes had to use a dedicated staging buffer instead of the ring. */
+		void count_fallback(vk::DeviceSize aSize);
+
+		/** The ring's capacity in bytes */
+		vk::DeviceSize capacity() const { return mRegions.capacity(); }
+
+		/** Returns a snapshot of the ring's usage counters */
+		staging_ring_statistics statistics() const;
+
+	private:
+		void release(uint64_t aId);
+
+		mutable std::mutex mMutex;
+		avk::buffer mBuffer;
+		std::optional<scoped_mapping<AVK_MEM_BUFFER_HANDLE>> mMapping;
+		// Only coherent memory can be used without explicit flushes/invalidations of the persistent mapping:
+		bool mUsable = false;
+		ring_suballocator mRegions;
+		staging_ring_statistics mStatistics;
+	};
+}
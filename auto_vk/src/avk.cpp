@@ -2641,6 +2641,35 @@ namespace avk
 		else {
 			assert(avk::has_flag(memProps, vk::MemoryPropertyFlagBits::eDeviceLocal));
 
+			// Whatever comes before/after must synchronize with the device-local copy:
+			std::get<avk::sync::sync_hint>(actionTypeCommand.mResourceSpecificSyncHints.front()).mDstForPreviousCmds = stage::copy + (access::transfer_read | access::transfer_write);
+			std::get<avk::sync::sync_hint>(actionTypeCommand.mResourceSpecificSyncHints.front()).mSrcForSubsequentCmds = stage::copy + access::transfer_write;
+			actionTypeCommand.infer_sync_hint_from_resource_sync_hints();
+
+			// Prefer a region of the persistently mapped upload ring over creating a new staging buffer:
+			if (auto* ring = mRoot->upload_staging_ring(); nullptr != ring) {
+				if (auto region = ring->allocate(dataSize); region) {
+					memcpy(region->mapped_data(), aDataPtr, dataSize);
+
+					actionTypeCommand.mBeginFun = [
+						lRoot = mRoot,
+						lRegion = std::move(region),
+						lDstBufferHandle = handle(),
+						dstOffset, dataSize
+					](avk::command_buffer_t& cb) {
+						const auto copyRegion = vk::BufferCopy{ lRegion->offset(), dstOffset, dataSize };
+						cb.handle().copyBuffer(lRegion->buffer_handle(), lDstBufferHandle, 1u, &copyRegion, lRoot->dispatch_loader_core());
+
+						// The region is recycled by the ring once the command buffer has been reset or destroyed, i.e., after it has been executed:
+						cb.set_custom_deleter([lRegion]() {});
+					};
+
+					return actionTypeCommand;
+				}
+				// Too large for the ring, or the ring is full of regions which are still in flight:
+				ring->count_fallback(dataSize);
+			}
+
 			// We have to create a (somewhat temporary) staging buffer and transfer it to the GPU
 			// "somewhat temporary" means that it can not be deleted in this function, but only
 			//						after the transfer operation has completed => handle via sync
@@ -2657,11 +2686,6 @@ namespace avk
 			stagingBuffer.enable_shared_ownership(); // TODO: Why does it not work WITHOUT shared_ownership? (Fails when assigning it to mBeginFun)
 			stagingBuffer->fill(aDataPtr, 0); // Recurse into the other if-branch
 
-			// Whatever comes before/after must synchronize with the device-local copy:
-			std::get<avk::sync::sync_hint>(actionTypeCommand.mResourceSpecificSyncHints.front()).mDstForPreviousCmds = stage::copy + (access::transfer_read | access::transfer_write);
-			std::get<avk::sync::sync_hint>(actionTypeCommand.mResourceSpecificSyncHints.front()).mSrcForSubsequentCmds = stage::copy + access::transfer_write;
-			actionTypeCommand.infer_sync_hint_from_resource_sync_hints();
-						
 			actionTypeCommand.mBeginFun = [
 				lRoot = mRoot,
 				lOwnedStagingBuffer = std::move(stagingBuffer),
@@ -2717,6 +2741,47 @@ namespace avk
 		else {
 			assert(avk::has_flag(memProps, vk::MemoryPropertyFlagBits::eDeviceLocal));
 
+			// Prefer a region of the persistently mapped readback ring over creating a new staging buffer:
+			if (auto* ring = mRoot->readback_staging_ring(); nullptr != ring) {
+				if (auto region = ring->allocate(bufferSize); region) {
+					auto actionTypeCommand = avk::command::action_type_command{
+						{}, // Define a resource-specific sync hint here and let the general sync hint be inferred afterwards (because it is supposed to be exactly the same)
+						{
+							std::make_tuple(handle(), avk::sync::sync_hint{
+								stage::copy + access::transfer_read,
+								stage::copy + access::none
+							})
+						},
+						[
+							lBufferSize = bufferSize,
+							lBufferHandle = handle(),
+							lRegion = std::move(region),
+							aDataPtr
+						] (avk::command_buffer_t& cb) {
+							auto copyRegion = vk::BufferCopy{}
+								.setSrcOffset(0u)
+								.setDstOffset(lRegion->offset())
+								.setSize(lBufferSize);
+							cb.handle().copyBuffer(lBufferHandle, lRegion->buffer_handle(), { copyRegion });
+
+							// The handler keeps the region alive until the data has been read back:
+							cb.set_post_execution_handler([
+								lRegion,
+								lBufferSize,
+								aDataPtr
+							]() {
+								memcpy(aDataPtr, lRegion->mapped_data(), lBufferSize);
+							});
+						}
+					};
+
+					actionTypeCommand.infer_sync_hint_from_resource_sync_hints();
+
+					return actionTypeCommand;
+				}
+				ring->count_fallback(bufferSize);
+			}
+
 			// We have to create a (somewhat temporary) staging buffer and transfer it to the GPU
 			// "somewhat temporary" means that it can not be deleted in this function, but only
 			//						after the transfer operation has completed => handle via avk::old_sync!
@@ -2727,8 +2792,6 @@ namespace avk
 				generic_buffer_meta::create_from_size(bufferSize)
 			);
 
-			// TODO: Creating a staging buffer in every read()-call is probably not optimal. => Think about alternative ways!
-
 			auto actionTypeCommand = avk::command::action_type_command{
 				{}, // Define a resource-specific sync hint here and let the general sync hint be inferred afterwards (because it is supposed to be exactly the same)
 				{
@@ -2769,6 +2832,171 @@ namespace avk
 	}
 #pragma endregion
 
+#pragma region staging ring definitions
+	std::optional<std::tuple<uint64_t, vk::DeviceSize>> ring_suballocator::allocate(vk::DeviceSize aSize, vk::DeviceSize aAlignment)
+	{
+		if (0 == aSize || aSize > mCapacity) {
+			return {};
+		}
+
+		if (mInFlight.empty()) {
+			mHead = 0;
+		}
+
+		auto offset = (mHead + aAlignment - 1) & ~(aAlignment - 1);
+		// The head is behind the oldest in-flight region after it has wrapped around:
+		const bool headHasWrapped = !mInFlight.empty() && mHead <= mInFlight.front().mOffset;
+		if (headHasWrapped) {
+			if (offset + aSize > mInFlight.front().mOffset) {
+				return {};
+			}
+		}
+		else if (offset + aSize > mCapacity) {
+			// Not enough space at the end => wrap around to the beginning if the oldest in-flight region allows it:
+			if (aSize > mInFlight.front().mOffset) {
+				return {};
+			}
+			offset = 0;
+			++mNumWraps;
+		}
+
+		const auto id = mNextId++;
+		mInFlight.push_back(in_flight_region{ id, offset, false });
+		mHead = offset + aSize;
+		return std::make_tuple(id, offset);
+	}
+
+	void ring_suballocator::release(uint64_t aId)
+	{
+		if (mInFlight.empty() || aId < mInFlight.front().mId || aId >= mInFlight.front().mId + mInFlight.size()) {
+			return;
+		}
+		mInFlight[static_cast<size_t>(aId - mInFlight.front().mId)].mReleased = true;
+
+		// Regions are recycled in allocation order:
+		while (!mInFlight.empty() && mInFlight.front().mReleased) {
+			mInFlight.pop_front();
+		}
+	}
+
+	staging_ring_allocation::~staging_ring_allocation()
+	{
+		if (auto ring = mRing.lock(); ring) {
+			ring->release(mId);
+		}
+	}
+
+	staging_ring::staging_ring(const root& aRoot, avk::memory_usage aMemoryUsage, vk::BufferUsageFlags aBufferUsage, vk::DeviceSize aCapacity)
+		: mRegions{ aCapacity }
+	{
+		mBuffer = root::create_buffer(aRoot, aMemoryUsage, aBufferUsage, generic_buffer_meta::create_from_size(aCapacity));
+
+		// The mapping is kept for the whole lifetime of the ring. Without coherent memory, every single
+		// transfer would require an explicit flush or invalidation => rather use dedicated staging buffers then.
+		mUsable = avk::has_flag(mBuffer->memory_properties(), vk::MemoryPropertyFlagBits::eHostCoherent);
+		if (mUsable) {
+			mMapping.emplace(mBuffer->memory_handle(), mapping_access::read | mapping_access::write);
+		}
+		else {
+			AVK_LOG_WARNING("The staging ring's memory is not host-coherent. All transfers will use dedicated staging buffers.");
+		}
+	}
+
+	std::shared_ptr<staging_ring_allocation> staging_ring::allocate(vk::DeviceSize aSize, vk::DeviceSize aAlignment)
+	{
+		std::scoped_lock lock(mMutex);
+
+		// Large transfers would evict too much from the ring => they get dedicated staging buffers:
+		if (!mUsable || aSize > mRegions.capacity() / 4) {
+			return {};
+		}
+		const auto region = mRegions.allocate(aSize, aAlignment);
+		if (!region.has_value()) {
+			return {};
+		}
+
+		auto result = std::make_shared<staging_ring_allocation>();
+		result->mRing = weak_from_this();
+		std::tie(result->mId, result->mOffset) = region.value();
+		result->mBufferHandle = mBuffer->handle();
+		result->mSize = aSize;
+		result->mMappedData = static_cast<uint8_t*>(mMapping->get()) + result->mOffset;
+
+		mStatistics.mBytesTransferred += aSize;
+		++mStatistics.mNumAllocations;
+		return result;
+	}
+
+	void staging_ring::count_fallback(vk::DeviceSize aSize)
+	{
+		std::scoped_lock lock(mMutex);
+		++mStatistics.mNumFallbackAllocations;
+		mStatistics.mBytesTransferredViaFallback += aSize;
+	}
+
+	staging_ring_statistics staging_ring::statistics() const
+	{
+		std::scoped_lock lock(mMutex);
+		auto result = mStatistics;
+		result.mNumWraps = mRegions.num_wraps();
+		return result;
+	}
+
+	void staging_ring::release(uint64_t aId)
+	{
+		std::scoped_lock lock(mMutex);
+		mRegions.release(aId);
+	}
+
+	// Guards the lazy creation of the rings of all roots:
+	static std::mutex sStagingRingsMutex;
+
+	staging_ring* root::upload_staging_ring() const
+	{
+#if AVK_STAGING_RING_SIZE > 0
+		std::scoped_lock lock(sStagingRingsMutex);
+		if (!mUploadStagingRing) {
+			mUploadStagingRing = std::make_shared<staging_ring>(*this, AVK_STAGING_BUFFER_MEMORY_USAGE, vk::BufferUsageFlagBits::eTransferSrc, AVK_STAGING_RING_SIZE);
+		}
+		return mUploadStagingRing.get();
+#else
+		return nullptr;
+#endif
+	}
+
+	staging_ring* root::readback_staging_ring() const
+	{
+#if AVK_STAGING_RING_SIZE > 0
+		std::scoped_lock lock(sStagingRingsMutex);
+		if (!mReadbackStagingRing) {
+			mReadbackStagingRing = std::make_shared<staging_ring>(*this, AVK_STAGING_BUFFER_READBACK_MEMORY_USAGE, vk::BufferUsageFlagBits::eTransferDst, AVK_STAGING_RING_SIZE);
+		}
+		return mReadbackStagingRing.get();
+#else
+		return nullptr;
+#endif
+	}
+
+	staging_ring_statistics root::upload_staging_statistics() const
+	{
+		std::scoped_lock lock(sStagingRingsMutex);
+		return mUploadStagingRing ? mUploadStagingRing->statistics() : staging_ring_statistics{};
+	}
+
+	staging_ring_statistics root::readback_staging_statistics() const
+	{
+		std::scoped_lock lock(sStagingRingsMutex);
+		return mReadbackStagingRing ? mReadbackStagingRing->statistics() : staging_ring_statistics{};
+	}
+
+	void root::destroy_staging_rings()
+	{
+		std::scoped_lock lock(sStagingRingsMutex);
+		mUploadStagingRing.reset();
+		mReadbackStagingRing.reset();
+	}
+#pragma endregion
+
 #pragma region buffer view definitions
 	vk::Buffer buffer_view_t::buffer_handle() const
 	{
@@ -2861,6 +3089,11 @@ namespace avk
 		return result;
 	}
 
+	void command_pool_t::reset(vk::CommandPoolResetFlags aFlags)
+	{
+		mCommandPool->getOwner().resetCommandPool(handle(), aFlags, mRoot->dispatch_loader_core());
+	}
+
 	// prepare command buffer for re-recording
 	void command_buffer_t::prepare_for_reuse()
 	{
@@ -2929,23 +3162,32 @@ namespace avk
 			return;
 		}
 
+		std::vector<uint32_t> setIds;
 		std::vector<vk::DescriptorSet> handles;
+		setIds.reserve(aDescriptorSets.size());
 		handles.reserve(aDescriptorSets.size());
 		for (const auto& dset : aDescriptorSets)
 		{
+			setIds.push_back(dset.set_id());
 			handles.push_back(dset.handle());
 		}
+		bind_descriptors(aBindingPoint, aLayoutHandle, setIds, handles);
+	}
 
-		if (aDescriptorSets.empty()) {
+	void command_buffer_t::bind_descriptors(vk::PipelineBindPoint aBindingPoint, vk::PipelineLayout aLayoutHandle, const std::vector<uint32_t>& aSetIds, const std::vector<vk::DescriptorSet>& aHandles)
+	{
+		assert(aSetIds.size() == aHandles.size());
+		if (aHandles.empty()) {
+			AVK_LOG_WARNING("command_buffer_t::bind_descriptors has been called, but there are no descriptor sets to be bound.");
 			return;
 		}
 
 		// Issue one or multiple bindDescriptorSets commands. We can only bind CONSECUTIVELY NUMBERED sets.
 		size_t descIdx = 0;
-		while (descIdx < aDescriptorSets.size()) {
-			const uint32_t setId = aDescriptorSets[descIdx].set_id();
+		while (descIdx < aHandles.size()) {
+			const uint32_t setId = aSetIds[descIdx];
 			uint32_t count = 1u;
-			while ((descIdx + count) < aDescriptorSets.size() && aDescriptorSets[descIdx + count].set_id() == (setId + count)) {
+			while ((descIdx + count) < aHandles.size() && aSetIds[descIdx + count] == (setId + count)) {
 				++count;
 			}
 
@@ -2953,7 +3195,7 @@ namespace avk
 				aBindingPoint,
 				aLayoutHandle,
 				setId, count,
-				&handles[descIdx],
+				&aHandles[descIdx],
 				0, // TODO: Dynamic offset count
 				nullptr); // TODO: Dynamic offset
 
@@ -2990,10 +3232,10 @@ namespace avk
 			.setBasePipelineHandle(nullptr) // Optional
 			.setBasePipelineIndex(-1); // Optional
 #if VK_HEADER_VERSION >= 141
-		auto result = device().createComputePipelineUnique(nullptr, pipelineInfo, nullptr, dispatch_loader_core());
+		auto result = timed_pipeline_creation([&]() { return device().createComputePipelineUnique(pipeline_cache(), pipelineInfo, nullptr, dispatch_loader_core()); });
 		aPreparedPipeline.mPipeline = std::move(result.value);
 #else
-		aPreparedPipeline.mPipeline = device().createComputePipelineUnique(nullptr, pipelineInfo);
+		aPreparedPipeline.mPipeline = timed_pipeline_creation([&]() { return device().createComputePipelineUnique(pipeline_cache(), pipelineInfo); });
 #endif
 	}
 
@@ -3562,6 +3804,7 @@ namespace avk
 
 	void descriptor_cache_t::cleanup()
 	{
+		clear_lookup_table();
 		mSets.clear();
 		mLayouts.clear();
 	}
@@ -3738,7 +3981,193 @@ namespace avk
 		mPool.get()->mDescriptorPool.getOwner().updateDescriptorSets(static_cast<uint32_t>(mOrderedDescriptorDataWrites.size()), mOrderedDescriptorDataWrites.data(), 0u, nullptr);
 	}
 
-	std::vector<descriptor_set> descriptor_cache_t::get_or_create_descriptor_sets(std::initializer_list<binding_data> aBindings)
+	// What the descriptor of a bound resource stores: the texel buffer view of buffer views, the descriptor info of everything else
+	static vk::BufferView descriptor_info_of(const buffer_view_t& aResource) { return aResource.view_handle(); }
+	static vk::BufferView descriptor_info_of(const buffer_view_descriptor_info& aResource) { return aResource.view_handle(); }
+	template <typename T>
+	static const auto& descriptor_info_of(const T& aResource) { return aResource.descriptor_info(); }
+
+	// Calls aVisitor with the descriptor info of every resource of the given binding, which is either a vk::DescriptorImageInfo,
+	// a vk::DescriptorBufferInfo, or a vk::BufferView. Returns false, without calling aVisitor, for acceleration structures,
+	// whose descriptors are stored in a pNext chain, and for bindings without resources.
+	template <typename F>
+	static bool visit_descriptor_infos(const binding_data& aBinding, F&& aVisitor)
+	{
+		return std::visit([&aVisitor](const auto& aResource) -> bool {
+			using T = std::decay_t<decltype(aResource)>;
+			if constexpr (std::is_same_v<T, std::monostate>
+				|| std::is_same_v<T, const top_level_acceleration_structure_t*>
+				|| std::is_same_v<T, std::vector<const top_level_acceleration_structure_t*>>) {
+				return false;
+			}
+			else if constexpr (std::is_pointer_v<T>) {
+				aVisitor(descriptor_info_of(*aResource));
+				return true;
+			}
+			else {
+				for (const auto* resource : aResource) {
+					aVisitor(descriptor_info_of(*resource));
+				}
+				return true;
+			}
+		}, aBinding.mResourcePtr);
+	}
+
+	static void hash_descriptor_info(std::size_t& aHash, const vk::DescriptorImageInfo& aInfo)
+	{
+		hash_combine(aHash, static_cast<VkSampler>(aInfo.sampler), static_cast<VkImageView>(aInfo.imageView), static_cast<VkImageLayout>(aInfo.imageLayout));
+	}
+
+	static void hash_descriptor_info(std::size_t& aHash, const vk::DescriptorBufferInfo& aInfo)
+	{
+		hash_combine(aHash, static_cast<VkBuffer>(aInfo.buffer), aInfo.offset, aInfo.range);
+	}
+
+	static void hash_descriptor_info(std::size_t& aHash, vk::BufferView aInfo)
+	{
+		hash_combine(aHash, static_cast<VkBufferView>(aInfo));
+	}
+
+	static bool write_contains(const vk::WriteDescriptorSet& aWrite, uint32_t aIndex, const vk::DescriptorImageInfo& aInfo)
+	{
+		return nullptr != aWrite.pImageInfo && aWrite.pImageInfo[aIndex] == aInfo;
+	}
+
+	static bool write_contains(const vk::WriteDescriptorSet& aWrite, uint32_t aIndex, const vk::DescriptorBufferInfo& aInfo)
+	{
+		return nullptr != aWrite.pBufferInfo && aWrite.pBufferInfo[aIndex] == aInfo;
+	}
+
+	static bool write_contains(const vk::WriteDescriptorSet& aWrite, uint32_t aIndex, vk::BufferView aInfo)
+	{
+		return nullptr != aWrite.pTexelBufferView && aWrite.pTexelBufferView[aIndex] == aInfo;
+	}
+
+	// Combines the ids, the type, and the resources of the given binding into aHash. Returns false for bindings which can not be hashed.
+	static bool hash_binding(std::size_t& aHash, const binding_data& aBinding)
+	{
+		hash_combine(aHash, aBinding.mSetId, aBinding.mLayoutBinding.binding, aBinding.mLayoutBinding.descriptorType);
+		return visit_descriptor_infos(aBinding, [&aHash](const auto& aInfo) {
+			hash_descriptor_info(aHash, aInfo);
+		});
+	}
+
+	// Returns true if the write of a cached descriptor set has been prepared from a binding which equals the given one
+	static bool write_matches_binding(const vk::WriteDescriptorSet& aWrite, const binding_data& aBinding)
+	{
+		if (aWrite.dstBinding != aBinding.mLayoutBinding.binding
+			|| aWrite.descriptorType != aBinding.mLayoutBinding.descriptorType
+			|| aWrite.descriptorCount != aBinding.descriptor_count()) {
+			return false;
+		}
+		uint32_t index = 0;
+		bool matches = true;
+		visit_descriptor_infos(aBinding, [&aWrite, &index, &matches](const auto& aInfo) {
+			matches = matches && write_contains(aWrite, index++, aInfo);
+		});
+		return matches;
+	}
+
+	// Returns true if the given descriptor sets have been prepared from bindings which equal the given ones, which are ordered like for preparing them
+	static bool sets_match_bindings(const std::vector<descriptor_set>& aSets, const binding_data* const* aBegin, const binding_data* const* aEnd)
+	{
+		size_t setIndex = 0;
+		auto it = aBegin;
+		while (it != aEnd) {
+			const auto setEnd = std::find_if(it, aEnd, [setId = (*it)->mSetId](const binding_data* b) { return b->mSetId != setId; });
+			if (setIndex == aSets.size() || aSets[setIndex].number_of_writes() != static_cast<size_t>(setEnd - it)) {
+				return false;
+			}
+			const auto& set = aSets[setIndex++];
+			for (size_t i = 0; it != setEnd; ++it, ++i) {
+				if (!write_matches_binding(set.write_at(i), **it)) {
+					return false;
+				}
+			}
+		}
+		return setIndex == aSets.size();
+	}
+
+	const std::vector<descriptor_set>* descriptor_cache_t::find_in_lookup_table(std::size_t aHash, const binding_data* const* aBegin, const binding_data* const* aEnd) const
+	{
+		if (mLookupTable.empty()) {
+			return nullptr;
+		}
+		const auto mask = mLookupTable.size() - 1;
+		for (auto i = aHash & mask; cEmptyLookupEntry != mLookupTable[i].mResultIndex; i = (i + 1) & mask) {
+			const auto& entry = mLookupTable[i];
+			// Equal hashes are verified against the cached sets, which makes collisions harmless:
+			if (entry.mHash == aHash && sets_match_bindings(mLookupResults[entry.mResultIndex], aBegin, aEnd)) {
+				return &mLookupResults[entry.mResultIndex];
+			}
+		}
+		return nullptr;
+	}
+
+	const std::vector<descriptor_set>& descriptor_cache_t::insert_into_lookup_table(std::size_t aHash, std::vector<descriptor_set> aSets)
+	{
+		const auto insert = [](std::vector<lookup_entry>& aTable, const lookup_entry& aEntry) {
+			const auto mask = aTable.size() - 1;
+			auto i = aEntry.mHash & mask;
+			while (cEmptyLookupEntry != aTable[i].mResultIndex) {
+				i = (i + 1) & mask;
+			}
+			aTable[i] = aEntry;
+		};
+
+		if (2 * (mLookupResults.size() + 1) > mLookupTable.size()) {
+			std::vector<lookup_entry> table(std::max(size_t{ 64 }, 2 * mLookupTable.size()), lookup_entry{ 0, cEmptyLookupEntry });
+			for (const auto& entry : mLookupTable) {
+				if (cEmptyLookupEntry != entry.mResultIndex) {
+					insert(table, entry);
+				}
+			}
+			mLookupTable = std::move(table);
+		}
+		mLookupResults.push_back(std::move(aSets));
+		insert(mLookupTable, lookup_entry{ aHash, static_cast<uint32_t>(mLookupResults.size() - 1) });
+		return mLookupResults.back();
+	}
+
+	void descriptor_cache_t::clear_lookup_table()
+	{
+		mLookupTable.clear();
+		mLookupResults.clear();
+	}
+
+	const std::vector<descriptor_set>& descriptor_cache_t::get_or_create_descriptor_sets(std::initializer_list<binding_data> aBindings)
+	{
+		if (aBindings.size() > cMaxLookupBindings) {
+			mSetsWithoutLookup = find_or_alloc_descriptor_sets(aBindings);
+			return mSetsWithoutLookup;
+		}
+
+		// Order the bindings like find_or_alloc_descriptor_sets does, but on the stack:
+		std::array<const binding_data*, cMaxLookupBindings> orderedBindings;
+		size_t numBindings = 0;
+		for (const auto& b : aBindings) {
+			auto i = numBindings++;
+			while (i > 0 && b < *orderedBindings[i - 1]) {
+				orderedBindings[i] = orderedBindings[i - 1];
+				--i;
+			}
+			orderedBindings[i] = &b;
+		}
+		const auto* begin = orderedBindings.data();
+		const auto* end = begin + numBindings;
+
+		std::size_t hash = 0;
+		if (!std::all_of(begin, end, [&hash](const binding_data* b) { return hash_binding(hash, *b); })) {
+			mSetsWithoutLookup = find_or_alloc_descriptor_sets(aBindings);
+			return mSetsWithoutLookup;
+		}
+		if (const auto* sets = find_in_lookup_table(hash, begin, end)) {
+			return *sets;
+		}
+		return insert_into_lookup_table(hash, find_or_alloc_descriptor_sets(aBindings));
+	}
+
+	std::vector<descriptor_set> descriptor_cache_t::find_or_alloc_descriptor_sets(std::initializer_list<binding_data> aBindings)
 	{
 		std::vector<binding_data> orderedBindings;
 		uint32_t minSetId = std::numeric_limits<uint32_t>::max();
@@ -3840,6 +4269,10 @@ namespace avk
 				it = std::begin(mSets);
 			}
 		} while (std::end(mSets) != it);
+		if (numDeleted > 0) {
+			// The lookup table might contain copies of the deleted sets:
+			clear_lookup_table();
+		}
 		return numDeleted;
 	}
 
@@ -3872,6 +4305,10 @@ namespace avk
 				it = std::begin(mSets);
 			}
 		} while (std::end(mSets) != it);
+		if (numDeleted > 0) {
+			// The lookup table might contain copies of the deleted sets:
+			clear_lookup_table();
+		}
 		return numDeleted;
 	}
 
@@ -3904,6 +4341,10 @@ namespace avk
 				it = std::begin(mSets);
 			}
 		} while (std::end(mSets) != it);
+		if (numDeleted > 0) {
+			// The lookup table might contain copies of the deleted sets:
+			clear_lookup_table();
+		}
 		return numDeleted;
 	}
 
@@ -3936,6 +4377,10 @@ namespace avk
 				it = std::begin(mSets);
 			}
 		} while (std::end(mSets) != it);
+		if (numDeleted > 0) {
+			// The lookup table might contain copies of the deleted sets:
+			clear_lookup_table();
+		}
 		return numDeleted;
 	}
 
@@ -4415,10 +4860,10 @@ namespace avk
 		// TODO: Shouldn't the config be altered HERE, after the pipelineInfo has been compiled?!
 
 #if VK_HEADER_VERSION >= 141
-		auto result = device().createGraphicsPipelineUnique(nullptr, pipelineInfo, nullptr, dispatch_loader_core());
+		auto result = timed_pipeline_creation([&]() { return device().createGraphicsPipelineUnique(pipeline_cache(), pipelineInfo, nullptr, dispatch_loader_core()); });
 		aPreparedPipeline.mPipeline = std::move(result.value);
 #else
-		aPreparedPipeline.mPipeline = device().createGraphicsPipelineUnique(nullptr, pipelineInfo);
+		aPreparedPipeline.mPipeline = timed_pipeline_creation([&]() { return device().createGraphicsPipelineUnique(pipeline_cache(), pipelineInfo); });
 #endif
 	}
 
@@ -5978,17 +6423,17 @@ namespace avk
 			.setLayout(aPreparedPipeline.layout_handle());
 		
 #if VK_HEADER_VERSION >= 162
-		auto pipeCreationResult = device().createRayTracingPipelineKHRUnique(
-			{}, {},
+		auto pipeCreationResult = timed_pipeline_creation([&]() { return device().createRayTracingPipelineKHRUnique(
+			{}, pipeline_cache(),
 			pipelineCreateInfo,
 			nullptr,
-			dispatch_loader_ext());
+			dispatch_loader_ext()); });
 #else
-		auto pipeCreationResult = device().createRayTracingPipelineKHRUnique(
-			nullptr,
+		auto pipeCreationResult = timed_pipeline_creation([&]() { return device().createRayTracingPipelineKHRUnique(
+			pipeline_cache(),
 			pipelineCreateInfo,
 			nullptr,
-			dispatch_loader_ext());
+			dispatch_loader_ext()); });
 #endif
 
 		aPreparedPipeline.mPipeline = std::move(pipeCreationResult.value);
@@ -7200,6 +7645,7 @@ namespace avk
 #pragma region semaphore definitions
 	semaphore_t::semaphore_t()
 		: mCreateInfo{}
+		, mSemaphoreType{ vk::SemaphoreType::eBinary }
 		, mSemaphore{}
 		, mCustomDeleter{}
 	{
@@ -7236,6 +7682,45 @@ namespace avk
 		return create_semaphore(device(), dispatch_loader_core(), std::move(aAlterConfigBeforeCreation));
 	}
 
+	semaphore root::create_timeline_semaphore(uint64_t aInitialValue, std::function<void(semaphore_t&)> aAlterConfigBeforeCreation)
+	{
+		auto typeCreateInfo = vk::SemaphoreTypeCreateInfo{}
+			.setSemaphoreType(vk::SemaphoreType::eTimeline)
+			.setInitialValue(aInitialValue);
+
+		semaphore_t result;
+		result.mCreateInfo = vk::SemaphoreCreateInfo{}.setPNext(&typeCreateInfo);
+		result.mSemaphoreType = vk::SemaphoreType::eTimeline;
+
+		// Maybe alter the config?
+		if (aAlterConfigBeforeCreation) {
+			aAlterConfigBeforeCreation(result);
+		}
+
+		result.mSemaphore = device().createSemaphoreUnique(result.mCreateInfo, nullptr, dispatch_loader_core());
+		// Do not keep a pointer to the local type info around:
+		result.mCreateInfo.setPNext(nullptr);
+		return result;
+	}
+
+	uint64_t semaphore_t::query_current_value() const
+	{
+		assert(is_timeline());
+		return mSemaphore.getOwner().getSemaphoreCounterValue(handle());
+	}
+
+	void semaphore_t::wait_until_value(uint64_t aValue, std::optional<uint64_t> aTimeout) const
+	{
+		assert(is_timeline());
+		auto waitInfo = vk::SemaphoreWaitInfo{}
+			.setSemaphoreCount(1u)
+			.setPSemaphores(handle_addr())
+			.setPValues(&aValue);
+		// ReSharper disable once CppExpressionWithoutSideEffects
+		auto result = mSemaphore.getOwner().waitSemaphores(waitInfo, aTimeout.value_or(UINT64_MAX));
+		assert(static_cast<VkResult>(result) >= 0);
+	}
+
 	semaphore_t& semaphore_t::handle_lifetime_of(any_owning_resource_t aResource)
 	{
 		mLifetimeHandledResources.push_back(std::move(aResource));
@@ -8726,50 +9211,73 @@ namespace avk
 		}
 #endif
 
-		state_type_command bind_descriptors(std::tuple<const graphics_pipeline_t*, const vk::PipelineLayout, const std::vector<vk::PushConstantRange>*> aPipelineLayout, std::vector<descriptor_set> aDescriptorSets)
+		/** Gathers the set ids and handles of the given descriptor sets, which is all that binding them requires */
+		static std::tuple<std::vector<uint32_t>, std::vector<vk::DescriptorSet>> set_ids_and_handles_of(const std::vector<descriptor_set>& aDescriptorSets)
+		{
+			std::vector<uint32_t> setIds;
+			std::vector<vk::DescriptorSet> handles;
+			setIds.reserve(aDescriptorSets.size());
+			handles.reserve(aDescriptorSets.size());
+			for (const auto& dset : aDescriptorSets) {
+				setIds.push_back(dset.set_id());
+				handles.push_back(dset.handle());
+			}
+			return std::make_tuple(std::move(setIds), std::move(handles));
+		}
+
+		state_type_command bind_descriptors(std::tuple<const graphics_pipeline_t*, const vk::PipelineLayout, const std::vector<vk::PushConstantRange>*> aPipelineLayout, const std::vector<descriptor_set>& aDescriptorSets)
 		{
+			auto [setIds, handles] = set_ids_and_handles_of(aDescriptorSets);
 			return state_type_command{
 				[
 					lLayoutHandle = std::get<const graphics_pipeline_t*>(aPipelineLayout)->layout_handle(),
-					lDescriptorSets = std::move(aDescriptorSets)
+					lSetIds = std::move(setIds),
+					lHandles = std::move(handles)
 				] (avk::command_buffer_t& cb) {
 					cb.bind_descriptors(
 						vk::PipelineBindPoint::eGraphics,
 						lLayoutHandle,
-						lDescriptorSets // Attention: Copy! => Potentially expensive?! TODO: What was the reason for bind_descriptors requiring std::vector<descriptor_set> being passed by value?
+						lSetIds,
+						lHandles
 					);
 				}
 			};
 		}
 
-		state_type_command bind_descriptors(std::tuple<const compute_pipeline_t*, const vk::PipelineLayout, const std::vector<vk::PushConstantRange>*> aPipelineLayout, std::vector<descriptor_set> aDescriptorSets)
+		state_type_command bind_descriptors(std::tuple<const compute_pipeline_t*, const vk::PipelineLayout, const std::vector<vk::PushConstantRange>*> aPipelineLayout, const std::vector<descriptor_set>& aDescriptorSets)
 		{
+			auto [setIds, handles] = set_ids_and_handles_of(aDescriptorSets);
 			return state_type_command{
 				[
 					lLayoutHandle = std::get<const compute_pipeline_t*>(aPipelineLayout)->layout_handle(),
-					lDescriptorSets = std::move(aDescriptorSets)
+					lSetIds = std::move(setIds),
+					lHandles = std::move(handles)
 				] (avk::command_buffer_t& cb) {
 					cb.bind_descriptors(
 						vk::PipelineBindPoint::eCompute,
 						lLayoutHandle,
-						lDescriptorSets // Attention: Copy! => Potentially expensive?! TODO: What was the reason for bind_descriptors requiring std::vector<descriptor_set> being passed by value?
+						lSetIds,
+						lHandles
 					);
 				}
 			};
 		}
 
 #if VK_HEADER_VERSION >= 135
-		state_type_command bind_descriptors(std::tuple<const ray_tracing_pipeline_t*, const vk::PipelineLayout, const std::vector<vk::PushConstantRange>*> aPipelineLayout, std::vector<descriptor_set> aDescriptorSets)
+		state_type_command bind_descriptors(std::tuple<const ray_tracing_pipeline_t*, const vk::PipelineLayout, const std::vector<vk::PushConstantRange>*> aPipelineLayout, const std::vector<descriptor_set>& aDescriptorSets)
 		{
+			auto [setIds, handles] = set_ids_and_handles_of(aDescriptorSets);
 			return state_type_command{
 				[
 					lLayoutHandle = std::get<const ray_tracing_pipeline_t*>(aPipelineLayout)->layout_handle(),
-					lDescriptorSets = std::move(aDescriptorSets)
+					lSetIds = std::move(setIds),
+					lHandles = std::move(handles)
 				] (avk::command_buffer_t& cb) {
 					cb.bind_descriptors(
 						vk::PipelineBindPoint::eRayTracingKHR,
 						lLayoutHandle,
-						lDescriptorSets // Attention: Copy! => Potentially expensive?! TODO: What was the reason for bind_descriptors requiring std::vector<descriptor_set> being passed by value?
+						lSetIds,
+						lHandles
 					);
 				}
 			};
@@ -9066,7 +9574,7 @@ namespace avk
 		// Gather config for wait semaphores:
 		std::vector<vk::SemaphoreSubmitInfoKHR> waitSem;
 		for (auto& semWait : mSemaphoreWaits) {
-			auto& subInfo = waitSem.emplace_back(semWait.mWaitSemaphore->handle()); // TODO: What about timeline semaphores? (see 'value' param!)
+			auto& subInfo = waitSem.emplace_back(semWait.mWaitSemaphore->handle(), semWait.mValue); // The value is ignored for binary semaphores
 			std::visit(lambda_overload{
 				[&subInfo](const std::monostate&) {
 					subInfo.setStageMask(vk::PipelineStageFlagBits2KHR::eNone);
@@ -9099,7 +9607,7 @@ namespace avk
 		// Gather config for signal semaphores:
 		std::vector<vk::SemaphoreSubmitInfoKHR> signalSem;
 		for (auto& semSig : mSemaphoreSignals) {
-			auto& subInfo = signalSem.emplace_back(semSig.mSignalSemaphore->handle()); // TODO: What about timeline semaphores? (see 'value' param!)
+			auto& subInfo = signalSem.emplace_back(semSig.mSignalSemaphore->handle(), semSig.mValue); // The value is ignored for binary semaphores
 			std::visit(lambda_overload{
 				[&subInfo](const std::monostate&) {
 					subInfo.setStageMask(vk::PipelineStageFlagBits2KHR::eNone);
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "model_types.hpp"
+#include "work_stealing_pool.hpp"
 
 namespace avk
 {
@@ -56,6 +57,165 @@ namespace avk
 		glm::vec3 mValue;
 	};
 
+	/**	The keys of one animation channel, repacked into separate arrays of times and values.
+	 *	Searching for the keys around a given time only touches the (contiguous) time values.
+	 */
+	template <typename T>
+	struct key_channel
+	{
+		/** Key times in ticks, in ascending order */
+		std::vector<double> mTimes;
+
+		/** Key values, one per element in mTimes */
+		std::vector<T> mValues;
+
+		size_t size() const { return mTimes.size(); }
+		bool empty() const { return mTimes.empty(); }
+	};
+
+	/**	Remembers the positions of the keys which have been sampled last for each channel of a node.
+	 *	During monotonic playback, the next keys are found by stepping forward from there, instead
+	 *	of searching the whole channel.
+	 */
+	struct keyframe_cursor
+	{
+		size_t mPosition = 0;
+		size_t mRotation = 0;
+		size_t mScaling = 0;
+	};
+
+	/**	A unit quaternion in "smallest three" form, packed into 48 bits:
+	 *	The component with the largest magnitude is dropped (and restored from the unit length), and
+	 *	the other three are quantized to 15 bits each. The two bits of the dropped component's index
+	 *	are stored in the most significant bits of the first two elements.
+	 */
+	struct packed_quat
+	{
+		std::array<uint16_t, 3> mComponents;
+	};
+
+	/**	Packs the given unit quaternion into 48 bits */
+	extern packed_quat pack_quat(const glm::quat& aQuat);
+
+	/**	Restores a unit quaternion from 48 bits */
+	extern glm::quat unpack_quat(const packed_quat& aPacked);
+
+	/**	The keys of one compressed animation channel. Key times are stored as 16-bit frame indices
+	 *	relative to the start of the clip.
+	 */
+	template <typename T>
+	struct compressed_key_channel
+	{
+		std::vector<uint16_t> mFrames;
+		std::vector<T> mValues;
+
+		size_t size() const { return mFrames.size(); }
+		bool empty() const { return mFrames.empty(); }
+	};
+
+	/**	The compressed channels of one animated node */
+	struct compressed_node_channels
+	{
+		compressed_key_channel<glm::vec3> mPositions;
+		compressed_key_channel<packed_quat> mRotations;
+		compressed_key_channel<glm::vec3> mScalings;
+	};
+
+	/**	Parameters of animation::compress_clip */
+	struct animation_compression_settings
+	{
+		/** Resolution of the key times. The clip must not be longer than 65535 frames. */
+		double mFramesPerSecond = 60.0;
+
+		/** Keys are dropped as long as positions can be interpolated with at most this error (in model units) */
+		float mMaxPositionError = 1e-4f;
+
+		/** Keys are dropped as long as rotations can be interpolated with at most this error (in radians) */
+		float mMaxRotationError = 1e-3f;
+
+		/** Keys are dropped as long as scalings can be interpolated with at most this error */
+		float mMaxScaleError = 1e-4f;
+	};
+
+	/**	Memory usage and accuracy of a compressed clip, measured against the uncompressed keys */
+	struct animation_compression_statistics
+	{
+		size_t mNumRawKeys = 0;
+		size_t mNumCompressedKeys = 0;
+		size_t mRawBytes = 0;
+		size_t mCompressedBytes = 0;
+		float mMaxPositionError = 0.0f;
+		float mMaxRotationError = 0.0f;
+		float mMaxScaleError = 0.0f;
+
+		/** Uncompressed size divided by compressed size */
+		double compression_ratio() const
+		{
+			return mCompressedBytes > 0 ? static_cast<double>(mRawBytes) / static_cast<double>(mCompressedBytes) : 0.0;
+		}
+	};
+
+	/**	One animation clip in compressed form, created by animation::compress_clip. It contains the keys of
+	 *	the clip's time range only, and is sampled by the animation::animate overload which takes it.
+	 */
+	class compressed_animation_clip
+	{
+		friend class animation;
+
+	public:
+		/** The clip which has been compressed */
+		const animation_clip_data& clip_data() const { return mClip; }
+
+		/** Memory usage and accuracy, measured during compression */
+		const animation_compression_statistics& statistics() const { return mStatistics; }
+
+		/** Number of animated nodes. Equals the number of animated nodes of the animation which it has been created from. */
+		size_t number_of_animated_nodes() const { return mNodes.size(); }
+
+		/** True if the node at the given index has keys at all. Otherwise, its local transform is not animated. */
+		bool has_keys(size_t aNodeIndex) const;
+
+		/**	Computes the node-local translation at the given animation time (in ticks).
+		 *	@param	aNodeIndex			Index of the animated node
+		 *	@param	aTimeInTicks		Animation time that determines the state of the node-local animation matrix
+		 *	@param	aCursor				Position of the key which has been used for this node the last time, or nullptr for a binary search.
+		 */
+		glm::vec3 compute_node_local_translation(size_t aNodeIndex, double aTimeInTicks, size_t* aCursor = nullptr) const;
+
+		/**	Computes the node-local rotation at the given animation time (in ticks).
+		 *	@param	aNodeIndex			Index of the animated node
+		 *	@param	aTimeInTicks		Animation time that determines the state of the node-local animation matrix
+		 *	@param	aCursor				Position of the key which has been used for this node the last time, or nullptr for a binary search.
+		 */
+		glm::quat compute_node_local_rotation(size_t aNodeIndex, double aTimeInTicks, size_t* aCursor = nullptr) const;
+
+		/**	Computes the node-local scale at the given animation time (in ticks).
+		 *	@param	aNodeIndex			Index of the animated node
+		 *	@param	aTimeInTicks		Animation time that determines the state of the node-local animation matrix
+		 *	@param	aCursor				Position of the key which has been used for this node the last time, or nullptr for a binary search.
+		 */
+		glm::vec3 compute_node_local_scale(size_t aNodeIndex, double aTimeInTicks, size_t* aCursor = nullptr) const;
+
+		/**	Computes the node-local transformation matrix at the given animation time (in ticks).
+		 *	@param	aNodeIndex			Index of the animated node
+		 *	@param	aTimeInTicks		Animation time that determines the state of the node-local animation matrix
+		 *	@param	aCursor				Positions of the keys which have been used for this node the last time, or nullptr for a binary search.
+		 */
+		glm::mat4 compute_node_local_transform(size_t aNodeIndex, double aTimeInTicks, keyframe_cursor* aCursor = nullptr) const;
+
+	private:
+		/** Converts an animation time in ticks into a (fractional) frame index */
+		double frame_at(double aTimeInTicks) const;
+
+		animation_clip_data mClip;
+		double mFramesPerSecond = 60.0;
+		std::vector<compressed_node_channels> mNodes;
+		animation_compression_statistics mStatistics;
+
+		template<typename Archive>
+		friend void serialize(Archive& aArchive, avk::compressed_animation_clip& aValue);
+	};
+
 	/**	Struct which contains information about a particular bone w.r.t. a particular mesh
 	 *	during animation. I.e. when a certain mesh-specific(!) bone matrix shall be written
 	 *	to its target location, this struct contains the following information:
@@ -174,6 +334,14 @@ namespace avk
 		/**	Animation keys for the scalings of this node. */
 		std::vector<scaling_key> mScalingKeys;
 
+		/**	The same keys as in mPositionKeys, mRotationKeys, and mScalingKeys, repacked into
+		 *	separate time and value arrays. These are the ones which are used for sampling.
+		 *	They are (re-)built from the keys by animation::pack_keys.
+		 */
+		key_channel<glm::vec3> mPositionChannel;
+		key_channel<glm::quat> mRotationChannel;
+		key_channel<glm::vec3> mScalingChannel;
+
 		/** True if the mPositionKeys and mRotationKeys contain the same
 		 *	number of elements and each element with the same index has
 		 *	the same mTime in both.
@@ -229,6 +397,34 @@ namespace avk
 		model_space,
 	};
 	
+	/**	One instance of an animated model, as evaluated by animation::animate_batch_into_strided_targets.
+	 *	All instances of a batch share the same animation (i.e., hierarchy and keys), but can play
+	 *	different clips at different times, and write their bone matrices into different memory.
+	 */
+	struct animation_instance
+	{
+		/** Animation clip to use for this instance */
+		animation_clip_data mClip;
+
+		/** Time in seconds to calculate the bone matrices at */
+		double mTime;
+
+		/** Pointer to the memory location where the first bone matrix of this instance shall be written to */
+		glm::mat4* mTargetMemory;
+
+		/** Offset in BYTES between the first memory target location for mesh i, and the first memory target location for mesh i+1 */
+		size_t mMeshStride;
+
+		/** Offset in BYTES between two consecutive bone matrices that are assigned to the same mesh */
+		size_t mMatricesStride = sizeof(glm::mat4);
+
+		/** Optional cursors of this instance, which are kept by the caller across invocations, s.t. keys are found in
+		 *	constant time during playback. They are resized to the number of animated nodes if required.
+		 *	If nullptr, the keys are found via binary search.
+		 */
+		std::vector<keyframe_cursor>* mCursors = nullptr;
+	};
+
 	class model_t;
 
 	/**	Class that represents one specific animation for one or multiple meshes
@@ -236,6 +432,7 @@ namespace avk
 	class animation
 	{
 		friend class model_t;
+		friend class compressed_animation_clip;
 		
 	public:
 		/**	Calculates the bone animation, calculates and writes all the bone matrices into their target storage.
@@ -280,56 +477,33 @@ namespace avk
 
 			double timeInTicks = aTime * aClip.mTicksPerSecond;
 
-			const auto an = mAnimationData.size();
-			for (size_t ai = 0; ai < an; ++ai) {
-				auto& anode = mAnimationData[ai];
+			animate_nodes(timeInTicks, [this, timeInTicks](const animated_node& aNode, size_t aNodeIndex) {
+				// Start the key search at the previously sampled keys:
+				return compute_node_local_transform(aNode, timeInTicks, &mCursors[aNodeIndex]);
+			}, std::forward<F>(aBoneMatrixCalc));
+		}
 
-				// Get the node-local TRS transformation matrix:
-				auto localTransform = compute_node_local_transform(anode, timeInTicks);
+		/**	Calculates the bone animation from a compressed clip, calculates and writes all the bone matrices into their target storage.
+		 *	Apart from the keys, which are taken from the compressed clip, this behaves exactly like the overload above.
+		 *
+		 *	@param	aClip				Compressed animation clip, created from this animation via compress_clip
+		 *	@param	aTime				Time in seconds to calculate the bone matrices at.
+		 *	@param	aBoneMatrixCalc		Callback-function which receives the matrices, see the overload above
+		 */
+		template <typename F>
+		void animate(const compressed_animation_clip& aClip, double aTime, F&& aBoneMatrixCalc)
+		{
+			if (aClip.clip_data().mAnimationIndex != mAnimationIndex || aClip.number_of_animated_nodes() != mAnimationData.size()) {
+				throw avk::runtime_error("The compressed clip has not been created from this animation.");
+			}
 
-				// Calculate the node's global transform, using its local transform and the transforms of its parents:
-				if (anode.mAnimatedParentIndex.has_value()) {
-					anode.mGlobalTransform = mAnimationData[anode.mAnimatedParentIndex.value()].mGlobalTransform * anode.mParentTransform * localTransform;
-				}
-				else {
-					anode.mGlobalTransform = anode.mParentTransform * localTransform;
-				}
+			double timeInTicks = aTime * aClip.clip_data().mTicksPerSecond;
 
-				// Calculate the final bone matrices for this node, for each mesh that is affected; and write out the matrix into the target storage:
-				const auto n = anode.mBoneMeshTargets.size();
-				for (size_t i = 0; i < n; ++i) {
-					// The final (mesh-specific!) bone matrix will be created in and stored via the lambda:
-					if constexpr (std::is_assignable<std::function<void(mesh_bone_info, const glm::mat4&, const glm::mat4&, const glm::mat4&)>, decltype(aBoneMatrixCalc)>::value) {
-						// Option 1: lambda that takes: mesh_bone_info, inverse mesh root matrix, global node/bone transform w.r.t. the animation, inverse bind-pose matrix
-						aBoneMatrixCalc(anode.mBoneMeshTargets[i].mMeshBoneInfo, anode.mBoneMeshTargets[i].mInverseMeshRootMatrix, anode.mGlobalTransform, anode.mBoneMeshTargets[i].mInverseBindPoseMatrix);
-					}
-				    else if constexpr (std::is_assignable<std::function<void(mesh_bone_info, const glm::mat4&, const glm::mat4&, const glm::mat4&, const glm::mat4&)>, decltype(aBoneMatrixCalc)>::value) {
-						// Option 2: lambda that takes: mesh_bone_info, inverse mesh root matrix, global node/bone transform w.r.t. the animation, inverse bind-pose matrix, local node/bone transformation
-				    	//           (The first four parameters are the same as with Option 1. Parameter five is passed in addition.)
-						aBoneMatrixCalc(anode.mBoneMeshTargets[i].mMeshBoneInfo, anode.mBoneMeshTargets[i].mInverseMeshRootMatrix, anode.mGlobalTransform, anode.mBoneMeshTargets[i].mInverseBindPoseMatrix, localTransform);
-				    }
-				    else if constexpr (std::is_assignable<std::function<void(mesh_bone_info, const glm::mat4&, const glm::mat4&, const glm::mat4&, const glm::mat4&, size_t)>, decltype(aBoneMatrixCalc)>::value) {
-						// Option 3: lambda that takes: mesh_bone_info, inverse mesh root matrix, global node/bone transform w.r.t. the animation, inverse bind-pose matrix, local node/bone transformation, animated_node
-				    	//           (The first five parameters are the same as with Option 2. Parameter six is passed in addition.)
-						aBoneMatrixCalc(anode.mBoneMeshTargets[i].mMeshBoneInfo, anode.mBoneMeshTargets[i].mInverseMeshRootMatrix, anode.mGlobalTransform, anode.mBoneMeshTargets[i].mInverseBindPoseMatrix, localTransform, ai);
-				    }
-				    else if constexpr (std::is_assignable<std::function<void(mesh_bone_info, const glm::mat4&, const glm::mat4&, const glm::mat4&, const glm::mat4&, size_t, size_t)>, decltype(aBoneMatrixCalc)>::value) {
-						// Option 4: lambda that takes: mesh_bone_info, inverse mesh root matrix, global node/bone transform w.r.t. the animation, inverse bind-pose matrix, local node/bone transformation, animated_node, bone mesh targets index
-				    	//           (The first six parameters are the same as with Option 3. Parameter seven is passed in addition.)
-						aBoneMatrixCalc(anode.mBoneMeshTargets[i].mMeshBoneInfo, anode.mBoneMeshTargets[i].mInverseMeshRootMatrix, anode.mGlobalTransform, anode.mBoneMeshTargets[i].mInverseBindPoseMatrix, localTransform, ai, i);
-				    }
-				    else if constexpr (std::is_assignable<std::function<void(mesh_bone_info, const glm::mat4&, const glm::mat4&, const glm::mat4&, const glm::mat4&, size_t, size_t, double)>, decltype(aBoneMatrixCalc)>::value) {
-						// Option 4: lambda that takes: mesh_bone_info, inverse mesh root matrix, global node/bone transform w.r.t. the animation, inverse bind-pose matrix, local node/bone transformation, animated_node, bone mesh targets index, animation time in ticks
-				    	//           (The first seven parameters are the same as with Option 4. Parameter eight is passed in addition.)
-						aBoneMatrixCalc(anode.mBoneMeshTargets[i].mMeshBoneInfo, anode.mBoneMeshTargets[i].mInverseMeshRootMatrix, anode.mGlobalTransform, anode.mBoneMeshTargets[i].mInverseBindPoseMatrix, localTransform, ai, i, timeInTicks);
-				    }
-					else {
-						assert(false);
-						throw avk::logic_error("No compatible lambda has been passed to animation::animate.");
-					}
-					
-				}
-			}
+			animate_nodes(timeInTicks, [this, &aClip, timeInTicks](const animated_node& aNode, size_t aNodeIndex) {
+				return aClip.has_keys(aNodeIndex)
+					? aClip.compute_node_local_transform(aNodeIndex, timeInTicks, &mCursors[aNodeIndex])
+					: aNode.mLocalTransform;
+			}, std::forward<F>(aBoneMatrixCalc));
 		}
 
 		/**	Computes the node-local translation at the given animation time (in ticks).
@@ -366,6 +540,16 @@ namespace avk
 		 */
 		glm::mat4 compute_node_local_transform(const animated_node& aNode, double aTimeInTicks) const;
 
+		/**	Computes the node-local transformation matrix at the given animation time (in ticks), like the overload above,
+		 *	but starts searching for the keys at the positions stored in the given cursor, and updates the cursor afterwards.
+		 *	If the animation time only increases by small amounts between invocations, finding the keys takes constant time.
+		 *	@param	aNode				Node to compute the local transformation matrix for
+		 *	@param	aTimeInTicks		Animation time that determines the state of the node-local animation matrix
+		 *	@param	aCursor				Positions of the keys which have been used for aNode the last time. Pass nullptr for a binary search.
+		 *	@return	Transformation matrix according to the parameters.
+		 */
+		glm::mat4 compute_node_local_transform(const animated_node& aNode, double aTimeInTicks, keyframe_cursor* aCursor) const;
+
 		/**	Computes the node-local translation at the given animation time (in ticks).
 		 *	@param	aNode				Node to compute the local translation for
 		 *	@param	aTimeInTicks		Animation time that determines the state of the node-local animation matrix
@@ -456,6 +640,19 @@ namespace avk
 		 */
 		void animate_into_single_target_buffer(const animation_clip_data& aClip, double aTime, bone_matrices_space aTargetSpace, glm::mat4* aTargetMemory);
 
+		/**	Calculates the bone animations of many instances in parallel, and writes their bone matrices into contiguous strided memory
+		 *	(like animate_into_strided_target_per_mesh does for one instance). This animation is not modified, i.e., neither
+		 *	animated_node::mGlobalTransform nor the cursors used by animate() are updated. The bone matrices of each instance are
+		 *	bit-identical to the ones which animate_into_strided_target_per_mesh calculates for the same clip and time.
+		 *
+		 *	@param	aInstances			The instances to evaluate; their target memory locations must not overlap
+		 *	@param	aPool				Thread pool which evaluates the instances
+		 *	@param	aTargetSpace		The target space into which the vertices shall be transformed by multiplying them with the bone matrices
+		 *	@param	aMaxMeshes			The maximum number of meshes to write out bone matrices for, per instance.
+		 *	@param	aMaxBonesPerMesh	The maximum number of bones to write out bone matrices for per mesh.
+		 */
+		void animate_batch_into_strided_targets(std::span<const animation_instance> aInstances, work_stealing_pool& aPool, bone_matrices_space aTargetSpace = bone_matrices_space::mesh_space, std::optional<size_t> aMaxMeshes = {}, std::optional<size_t> aMaxBonesPerMesh = {}) const;
+
 		/**	Returns all the unique keyframe time-values of the given animation.
 		 *	@param	aClip				Animation clip which to extract the unique keyframe time-values from
 		 *	@return	A collection of unique keyframe times in ticks
@@ -523,42 +720,142 @@ namespace avk
 		 */
 		auto get_animated_nodes() const { return mAnimationData; }
 
+		/**	Creates an animation from animated nodes which have not been loaded by model_t, e.g. for procedural animations.
+		 *	@param	aAnimatedNodes			All animated nodes, parents before their children
+		 *	@param	aAnimationIndex			The animation index which clips must refer to when they are passed to animate
+		 *	@param	aMaxNumBoneMatrices		Maximum number of bone matrices which are written per mesh
+		 */
+		static animation from_animated_nodes(std::vector<animated_node> aAnimatedNodes, uint32_t aAnimationIndex, size_t aMaxNumBoneMatrices);
+
+		/**	Repacks the keys of all animated nodes into their key channels, and resets the cursors.
+		 *	This must be invoked after the keys of an animated node have been modified.
+		 */
+		void pack_keys();
+
+		/**	Compresses the keys of the given clip: Key times are quantized to 16-bit frame indices, rotations are
+		 *	packed into 48 bits, and keys which can be interpolated from their neighbours within the given tolerances
+		 *	are dropped. The compressed clip can be passed to animate instead of the clip.
+		 *	@param	aClip		The clip to compress
+		 *	@param	aSettings	Frame rate and error tolerances
+		 *	@return	The compressed clip, including statistics about its memory usage and its maximum errors
+		 */
+		compressed_animation_clip compress_clip(const animation_clip_data& aClip, const animation_compression_settings& aSettings = {}) const;
+
 	private:
-		/** Helper function used during animate() to find two positions of key-elements
-		 *	between which the given aTime lies.
+		/**	Walks the node hierarchy, computes every node's global transform from the local transform which aLocalTransformOf
+		 *	returns for it, and invokes aBoneMatrixCalc for every bone mesh target (see animate for its signature).
+		 */
+		template <typename L, typename F>
+		void animate_nodes(double aTimeInTicks, L&& aLocalTransformOf, F&& aBoneMatrixCalc)
+		{
+			const auto an = mAnimationData.size();
+			if (mCursors.size() != an) {
+				mCursors.resize(an);
+			}
+			for (size_t ai = 0; ai < an; ++ai) {
+				auto& anode = mAnimationData[ai];
+
+				// Get the node-local TRS transformation matrix:
+				auto localTransform = aLocalTransformOf(anode, ai);
+
+				// Calculate the node's global transform, using its local transform and the transforms of its parents:
+				if (anode.mAnimatedParentIndex.has_value()) {
+					anode.mGlobalTransform = mAnimationData[anode.mAnimatedParentIndex.value()].mGlobalTransform * anode.mParentTransform * localTransform;
+				}
+				else {
+					anode.mGlobalTransform = anode.mParentTransform * localTransform;
+				}
+
+				// Calculate the final bone matrices for this node, for each mesh that is affected; and write out the matrix into the target storage:
+				const auto n = anode.mBoneMeshTargets.size();
+				for (size_t i = 0; i < n; ++i) {
+					// The final (mesh-specific!) bone matrix will be created in and stored via the lambda:
+					if constexpr (std::is_assignable<std::function<void(mesh_bone_info, const glm::mat4&, const glm::mat4&, const glm::mat4&)>, decltype(aBoneMatrixCalc)>::value) {
+						// Option 1: lambda that takes: mesh_bone_info, inverse mesh root matrix, global node/bone transform w.r.t. the animation, inverse bind-pose matrix
+						aBoneMatrixCalc(anode.mBoneMeshTargets[i].mMeshBoneInfo, anode.mBoneMeshTargets[i].mInverseMeshRootMatrix, anode.mGlobalTransform, anode.mBoneMeshTargets[i].mInverseBindPoseMatrix);
+					}
+				    else if constexpr (std::is_assignable<std::function<void(mesh_bone_info, const glm::mat4&, const glm::mat4&, const glm::mat4&, const glm::mat4&)>, decltype(aBoneMatrixCalc)>::value) {
+						// Option 2: lambda that takes: mesh_bone_info, inverse mesh root matrix, global node/bone transform w.r.t. the animation, inverse bind-pose matrix, local node/bone transformation
+				    	//           (The first four parameters are the same as with Option 1. Parameter five is passed in addition.)
+						aBoneMatrixCalc(anode.mBoneMeshTargets[i].mMeshBoneInfo, anode.mBoneMeshTargets[i].mInverseMeshRootMatrix, anode.mGlobalTransform, anode.mBoneMeshTargets[i].mInverseBindPoseMatrix, localTransform);
+				    }
+				    else if constexpr (std::is_assignable<std::function<void(mesh_bone_info, const glm::mat4&, const glm::mat4&, const glm::mat4&, const glm::mat4&, size_t)>, decltype(aBoneMatrixCalc)>::value) {
+						// Option 3: lambda that takes: mesh_bone_info, inverse mesh root matrix, global node/bone transform w.r.t. the animation, inverse bind-pose matrix, local node/bone transformation, animated_node
+				    	//           (The first five parameters are the same as with Option 2. Parameter six is passed in addition.)
+						aBoneMatrixCalc(anode.mBoneMeshTargets[i].mMeshBoneInfo, anode.mBoneMeshTargets[i].mInverseMeshRootMatrix, anode.mGlobalTransform, anode.mBoneMeshTargets[i].mInverseBindPoseMatrix, localTransform, ai);
+				    }
+				    else if constexpr (std::is_assignable<std::function<void(mesh_bone_info, const glm::mat4&, const glm::mat4&, const glm::mat4&, const glm::mat4&, size_t, size_t)>, decltype(aBoneMatrixCalc)>::value) {
+						// Option 4: lambda that takes: mesh_bone_info, inverse mesh root matrix, global node/bone transform w.r.t. the animation, inverse bind-pose matrix, local node/bone transformation, animated_node, bone mesh targets index
+				    	//           (The first six parameters are the same as with Option 3. Parameter seven is passed in addition.)
+						aBoneMatrixCalc(anode.mBoneMeshTargets[i].mMeshBoneInfo, anode.mBoneMeshTargets[i].mInverseMeshRootMatrix, anode.mGlobalTransform, anode.mBoneMeshTargets[i].mInverseBindPoseMatrix, localTransform, ai, i);
+				    }
+				    else if constexpr (std::is_assignable<std::function<void(mesh_bone_info, const glm::mat4&, const glm::mat4&, const glm::mat4&, const glm::mat4&, size_t, size_t, double)>, decltype(aBoneMatrixCalc)>::value) {
+						// Option 4: lambda that takes: mesh_bone_info, inverse mesh root matrix, global node/bone transform w.r.t. the animation, inverse bind-pose matrix, local node/bone transformation, animated_node, bone mesh targets index, animation time in ticks
+				    	//           (The first seven parameters are the same as with Option 4. Parameter eight is passed in addition.)
+						aBoneMatrixCalc(anode.mBoneMeshTargets[i].mMeshBoneInfo, anode.mBoneMeshTargets[i].mInverseMeshRootMatrix, anode.mGlobalTransform, anode.mBoneMeshTargets[i].mInverseBindPoseMatrix, localTransform, ai, i, aTimeInTicks);
+				    }
+					else {
+						assert(false);
+						throw avk::logic_error("No compatible lambda has been passed to animation::animate.");
+					}
+					
+				}
+			}
+		}
+
+
+		/** Evaluates one instance of animate_batch_into_strided_targets on the calling thread */
+		void animate_instance_into_strided_target(const animation_instance& aInstance, bone_matrices_space aTargetSpace, size_t aMaxMeshes, size_t aMaxBonesPerMesh) const;
+
+		/** Helper function used during animate() to find two positions of keys between which the given aTime lies.
+		 *	Without a cursor, the keys are found via binary search. With a cursor, the search steps forward
+		 *	from the keys which have been found the last time, and only falls back to binary search if
+		 *	aTime lies further away (e.g., when the animation time jumps or runs backwards).
+		 *	@param	aTimes		Key times (or frame indices) of one channel in ascending order; must not be empty
+		 *	@param	aTime		The time to find the keys for
+		 *	@param	aCursor		Optional position of the first key which has been found the last time; is updated
 		 */
 		template <typename T>
-		std::tuple<size_t, size_t> find_positions_in_keys(const T& aCollection, double aTime) const
+		static std::tuple<size_t, size_t> find_positions_in_keys(const std::vector<T>& aTimes, double aTime, size_t* aCursor = nullptr)
 		{
-			const auto maxIndex = aCollection.size() - 1;
-			
+			// Number of keys to step over before giving up on the cursor:
+			constexpr size_t cMaxCursorSteps = 4;
+			const auto maxIndex = aTimes.size() - 1;
+
 			size_t pos1 = 0;
-			while (pos1 + 1 <= maxIndex && aCollection[pos1 + 1].mTime <= aTime) {
-				++pos1;
+			bool found = false;
+			if (nullptr != aCursor) {
+				pos1 = std::min(*aCursor, maxIndex);
+				if (0 == pos1 || aTimes[pos1] <= aTime) {
+					for (size_t step = 0; step < cMaxCursorSteps && pos1 < maxIndex && aTimes[pos1 + 1] <= aTime; ++step) {
+						++pos1;
+					}
+					found = pos1 == maxIndex || aTimes[pos1 + 1] > aTime;
+				}
+			}
+			if (!found) {
+				// Last key with a time <= aTime, or the first key if there is none:
+				pos1 = static_cast<size_t>(std::upper_bound(std::begin(aTimes) + 1, std::end(aTimes), aTime) - std::begin(aTimes)) - 1;
 			}
-			
-			size_t pos2 = pos1 + (pos1 < maxIndex ? 1 : 0);
-			while (pos2 + 1 < maxIndex && aCollection[pos2 + 1].mTime < aTime) {
-				LOG_WARNING(std::format("Now that's strange: keys[{}].mTime {} < {}, despite keys[{}].mTime {} <= {}", pos2 + 1, aCollection[pos2 + 1].mTime, aTime, pos1, aCollection[pos1].mTime, aTime));
-				++pos2;
+			if (nullptr != aCursor) {
+				*aCursor = pos1;
 			}
-			
+
+			const size_t pos2 = pos1 + (pos1 < maxIndex ? 1 : 0);
 			return std::make_tuple(pos1, pos2);
 		}
 
-		/**	For two given keys (each of which must contain a .mTime member of type
-		 *	double), and a given aTime value, return the corresponding interpolation
-		 *	factor in the range [0..1].
+		/**	For the times of two given keys, and a given aTime value, return the
+		 *	corresponding interpolation factor in the range [0..1].
 		 */
-		template <typename K>
-		float get_interpolation_factor(const K& key1, const K& key2, double aTime) const
+		static float get_interpolation_factor(double aKeyTime1, double aKeyTime2, double aTime)
 		{
-			double timeDifferenceTicks = key2.mTime - key1.mTime;
+			double timeDifferenceTicks = aKeyTime2 - aKeyTime1;
 			if (std::abs(timeDifferenceTicks) < 2.3e-16 /* ~machine epsilon */) {
 				return 1.0f; // Same time, doesn't really matter which one to use => take key2
 			}
-			assert (key2.mTime > key1.mTime);
-			return static_cast<float>((aTime - key1.mTime) / timeDifferenceTicks);
+			assert (aKeyTime2 > aKeyTime1);
+			return static_cast<float>((aTime - aKeyTime1) / timeDifferenceTicks);
 		}
 		
 		/**	All animated nodes, along with their animation data and target storage pointers
@@ -574,6 +871,10 @@ namespace avk
 		 */
 		size_t mMaxNumBoneMatrices;
 
+		/** Positions of the keys which have been sampled last by animate(), one per animated node
+		 */
+		std::vector<keyframe_cursor> mCursors;
+
 		/** Make serialize a friend, so the serializer can access private data members.
 		 *  (see custom serialization functions in serializer.hpp)
 		 */
@@ -23,10 +23,13 @@
 #include <variant>
 #include <iomanip>
 #include <optional>
+#include <span>
 #include <typeinfo>
 #include <atomic>
 #include <mutex>
 #include <condition_variable>
+#include <future>
+#include <thread>
 #include <cstdlib>
 #include <typeindex>
 #include <type_traits>
@@ -97,6 +100,7 @@
 #define AVK_LOG_DEBUG			LOG_DEBUG
 #define AVK_LOG_DEBUG_VERBOSE	LOG_DEBUG_VERBOSE
 #include "log.hpp"
+#include "log_queue.hpp"
 
 // Before including the Auto-Vk header, we define some settings
 // that influence Auto-Vk's behavior/workings:
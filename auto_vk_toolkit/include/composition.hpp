@@ -435,6 +435,59 @@ namespace avk
 			composition_interface::set_current(nullptr);
 		}
 
+		/**	Start a render loop for a composition without any windows, e.g., for offscreen rendering or benchmarks.
+		 *	It runs on the calling thread, and it loops until composition_interface::stop has been called. There is no
+		 *	user input, i.e., input() stays empty, and no window is synced, i.e., the callbacks must throttle the frames themselves.
+		 *	@param	aUpdateCallback		A function which must invoke all the passed invokee's update() methods if they are enabled.
+		 *                              Required signature of the callback: void(const std::vector<invokee*>&)
+		 *	@param	aRenderCallback		A function which must invoke all the passed invokee's render() methods if they are enabled.
+		 *                              Required signature of the callback: void(const std::vector<invokee*>&)
+		 */
+		template <typename UC, typename RC>
+		void start_headless_render_loop(UC aUpdateCallback, RC aRenderCallback)
+		{
+			context().work_off_event_handlers();
+			composition_interface::set_current(this);
+
+			for (auto& o : mElements) {
+				o->initialize();
+			}
+			context().begin_composition();
+			context().work_off_event_handlers();
+
+			mIsRunning = true;
+			while (!mShouldStop)
+			{
+				add_pending_elements();
+				context().begin_frame();
+				const auto frameType = time().tick();
+				for (auto& e : mElements) {
+					e->handle_enabling();
+				}
+				if ((frameType & timer_frame_type::update) == timer_frame_type::update) {
+					aUpdateCallback(static_cast<const std::vector<invokee*>&>(mElements));
+					context().update_stage_done();
+				}
+				if ((frameType & timer_frame_type::render) == timer_frame_type::render) {
+					aRenderCallback(static_cast<const std::vector<invokee*>&>(mElements));
+				}
+				for (auto& e : mElements) {
+					e->handle_disabling();
+				}
+				context().end_frame();
+				remove_pending_elements();
+				context().work_off_all_pending_main_thread_actions();
+			}
+			mIsRunning = false;
+
+			context().end_composition(); // Performs a waitIdle
+			const auto elementsReverseView = std::ranges::reverse_view{ mElements };
+			for (const auto& o : elementsReverseView) {
+				o->finalize();
+			}
+			composition_interface::set_current(nullptr);
+		}
+
 		/** Stop a currently running game/rendering-loop for this composition_interface */
 		void stop() override
 		{
@@ -0,0 +1,39 @@
+#pragma once
+#include "serializer.hpp"
+
+namespace avk
+{
+	/**	Compresses the given clip of the given animation, or loads the compressed clip from a cache file.
+	 *	@param	aSerializer		If it is in serialize mode, the clip is compressed and written to the cache file.
+	 *							If it is in deserialize mode, the compressed clip is read from the cache file.
+	 *	@param	aAnimation		The animation which the clip belongs to. Also required in deserialize mode, in order to validate the clip.
+	 *	@param	aClip			The clip to compress
+	 *	@param	aSettings		Frame rate and error tolerances, see animation::compress_clip
+	 *	@return	The compressed clip, which can be passed to animation::animate
+	 */
+	static compressed_animation_clip compress_animation_clip_cached(avk::serializer& aSerializer, const animation& aAnimation, const animation_clip_data& aClip, const animation_compression_settings& aSettings = {})
+	{
+		compressed_animation_clip result;
+		if (aSerializer.mode() == avk::serializer::mode::serialize) {
+			result = aAnimation.compress_clip(aClip, aSettings);
+		}
+		aSerializer.archive(result);
+
+		if (result.clip_data().mAnimationIndex != aClip.mAnimationIndex || result.number_of_animated_nodes() != aAnimation.number_of_animated_nodes()) {
+			throw avk::runtime_error("The cached compressed clip does not belong to the given animation.");
+		}
+		return result;
+	}
+
+	/**	Logs the memory usage and the maximum errors of a compressed clip
+	 *	@param	aName			Name of the clip, which is included in the message
+	 *	@param	aClip			The compressed clip
+	 */
+	static void log_animation_compression_statistics(const std::string& aName, const compressed_animation_clip& aClip)
+	{
+		const auto& stats = aClip.statistics();
+		LOG_INFO(std::format("Compressed clip '{}': {} keys ({} bytes) => {} keys ({} bytes), ratio {:.1f}:1, max. errors: position {:.6f}, rotation {:.6f} rad, scale {:.6f}",
+			aName, stats.mNumRawKeys, stats.mRawBytes, stats.mNumCompressedKeys, stats.mCompressedBytes, stats.compression_ratio(),
+			stats.mMaxPositionError, stats.mMaxRotationError, stats.mMaxScaleError));
+	}
+}
@@ -111,6 +111,18 @@ namespace avk
 
 		const std::vector<uint32_t>& all_queue_family_indices() const { return mDistinctQueueFamilies; }
 
+		/** The pipeline cache which all pipelines are created with. It is persisted in the file set via avk::pipeline_cache_file. */
+		vk::PipelineCache pipeline_cache() const override                       { return mPipelineCache; }
+
+		/** True if the pipeline cache has been initialized with the data of a previous run, i.e., if pipelines are created warm. */
+		bool pipeline_cache_loaded_from_file() const                            { return mPipelineCacheLoadedFromFile; }
+
+		/** Writes the pipeline cache's data into the file set via avk::pipeline_cache_file.
+		 *	The data is written into a temporary file first, which then replaces the file, s.t. a crash can not leave a truncated cache behind.
+		 *	This is done automatically when the context is destroyed.
+		 */
+		void save_pipeline_cache() const;
+
 		/** Gets a command pool for the given queue family index.
 		 *	If the command pool does not exist already, it will be created.
 		 *	The pool must have exactly the flags specified, i.e. the flags specified and only the flags specified.
@@ -147,6 +159,15 @@ namespace avk
 		 */
 		avk::command_pool& get_command_pool_for_resettable_command_buffers(const avk::queue& aQueue);
 
+		/**	Requests a queue which is created together with the logical device.
+		 *	If the queue family which is selected for it does not provide another queue, the returned queue shares the
+		 *	handle of a queue which has been created for that family before, i.e., compare family_index() and
+		 *	queue_index() to find out whether it is a distinct queue. Submissions to shared queues must not overlap.
+		 *	@param	aRequiredFlags					Capabilities which the queue must have
+		 *	@param	aQueueSelectionPreference		Prefer a specialized or a versatile queue family
+		 *	@param	aPresentSupportForWindow		If set, the queue must be able to present to the given window
+		 *	@param	aQueuePriority					Priority of the queue
+		 */
 		avk::queue& create_queue(vk::QueueFlags aRequiredFlags = {}, avk::queue_selection_preference aQueueSelectionPreference = avk::queue_selection_preference::versatile_queue, window* aPresentSupportForWindow = nullptr, float aQueuePriority = 0.5f);
 		
 		/**	Creates a new window, but does not open it. Set the window's parameters
@@ -228,6 +249,7 @@ namespace avk
 		bool is_mesh_shader_nv_requested();
 		bool supports_dynamic_rendering(const vk::PhysicalDevice& device);
 		bool is_dynamic_rendering_requested();
+		bool memory_budget_extension_requested();
 
 #if VK_HEADER_VERSION >= 162
 		bool ray_tracing_pipeline_extension_requested();
@@ -256,6 +278,11 @@ namespace avk
         /** Pick the physical device which looks to be the most promising one */
 		void pick_physical_device();
 
+		/** Creates the pipeline cache, initialized with the data from the pipeline cache file if that has been written
+		 *	by the same driver for the same device. Otherwise, the cache starts empty.
+		 */
+		void create_pipeline_cache();
+
 		/** Gets the right resolution for the given window, considering the window's size and surface capabilities */
 		glm::uvec2 get_resolution_for_window(window* aWindow);
 
@@ -317,6 +344,9 @@ namespace avk
 
 		std::deque<avk::queue> mQueues;
 
+		vk::PipelineCache mPipelineCache;
+		bool mPipelineCacheLoadedFromFile = false;
+
 
 	};
 
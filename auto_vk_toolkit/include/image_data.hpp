@@ -377,4 +377,43 @@ namespace avk
 		// for user-defined destructor, there is no compiler-generated copy constructor and move-assignment operator; define out-of-line if needed
 		std::unique_ptr<image_data_implementor> pimpl;
 	};
+
+	/** Loads (i.e., decodes) multiple image_data objects on a pool of worker threads.
+	* Decoding starts upon construction. The images can be taken out in any order via take(), which only blocks until
+	* that particular image has been loaded. When taking them in construction order, the caller can create GPU resources
+	* for one image while the following ones are still being decoded.
+	*/
+	class parallel_image_loader
+	{
+	public:
+		/** Starts loading the given images
+		* @param aImages		image_data objects which have not been loaded yet
+		* @param aNumThreads	number of worker threads. If zero, std::thread::hardware_concurrency() is used.
+		*/
+		explicit parallel_image_loader(std::vector<image_data> aImages, uint32_t aNumThreads = 0);
+		parallel_image_loader(parallel_image_loader&&) noexcept = delete;
+		parallel_image_loader(const parallel_image_loader&) = delete;
+		parallel_image_loader& operator=(parallel_image_loader&&) noexcept = delete;
+		parallel_image_loader& operator=(const parallel_image_loader&) = delete;
+		/** Stops picking up images which have not been started yet, and waits for the worker threads to finish */
+		~parallel_image_loader();
+
+		/** Number of images */
+		size_t size() const { return mImages.size(); }
+
+		/** Waits until the image at the given index has been loaded, and hands it over to the caller.
+		* Rethrows the exception if the image could not be loaded. Must be called at most once per index.
+		*/
+		image_data take(size_t aIndex);
+
+	private:
+		void work();
+
+		std::vector<image_data> mImages;
+		std::vector<std::promise<void>> mLoaded;
+		std::vector<std::future<void>> mLoadedFutures;
+		std::atomic<size_t> mNextIndex;
+		std::atomic<bool> mCancelled;
+		std::vector<std::thread> mWorkers;
+	};
 }
@@ -0,0 +1,133 @@
+#pragma once
+
+namespace avk
+{
+	/** Configuration of a log_queue and of its sinks */
+	struct log_queue_config
+	{
+		/** Number of preallocated message slots; rounded up to the next power of two */
+		size_t mCapacity = 4096;
+		/** Number of characters which every slot reserves up front, s.t. typical messages can be enqueued without allocations */
+		size_t mReservedMessageLength = 256;
+		/** Maximum number of messages which the writer thread takes out of the queue before it writes them */
+		size_t mMaxBatchSize = 256;
+		/** Write all messages to the console */
+		bool mConsoleSink = true;
+		/** If not empty, all messages are written into this file, too */
+		std::string mFileSinkPath;
+		/** If greater than zero, this number of most recent messages is kept in memory, see log_queue::recent_messages */
+		size_t mRingBufferSinkSize = 0;
+	};
+
+	/**	A bounded, lock-free multi-producer single-consumer queue of log messages, which are written by a dedicated thread.
+	 *
+	 *	Producers claim one of the preallocated slots with a single compare-and-swap and copy their message into it;
+	 *	they never take a lock and never wait for the writer thread. If all slots are occupied, the message is dropped
+	 *	and counted instead, unless it is an error (see push).
+	 *	The writer thread drains the queue in batches of up to log_queue_config::mMaxBatchSize messages, formats a batch
+	 *	into a single buffer, and hands that buffer to each sink at once, instead of writing message by message.
+	 *
+	 *	Usage example:
+	 *
+	 *	avk::log_queue queue({ .mConsoleSink = false, .mFileSinkPath = "log.txt" });
+	 *	queue.push(avk::log_pack{ "INFO: Hello\n", avk::log_type::info, avk::log_importance::normal });
+	 *	queue.flush();
+	 */
+	class log_queue
+	{
+	public:
+		/** Allocates all slots, opens the file sink (if configured), and starts the writer thread */
+		explicit log_queue(log_queue_config aConfig = {});
+		log_queue(log_queue&&) noexcept = delete;
+		log_queue(const log_queue&) = delete;
+		log_queue& operator=(log_queue&&) noexcept = delete;
+		log_queue& operator=(const log_queue&) = delete;
+		/** Writes all remaining messages and joins the writer thread */
+		~log_queue();
+
+		/**	Enqueues a message if a slot is available. Never blocks.
+		 *	@return	false if the queue was full, i.e., if the message has been dropped
+		 */
+		bool try_push(const log_pack& aPack);
+
+		/**	Enqueues a message. Errors are never dropped: if the queue is full, the calling thread yields until
+		 *	the writer thread has made room. All other types of messages are dropped if the queue is full.
+		 */
+		void push(const log_pack& aPack);
+
+		/** Blocks until all messages which have been enqueued before this call have been written to all sinks */
+		void flush();
+
+		/** Number of messages which have been dropped because the queue was full */
+		uint64_t num_dropped() const { return mNumDropped.load(std::memory_order_relaxed); }
+
+		/** Number of messages which have been written to the sinks */
+		uint64_t num_written() const { return mNumWritten.load(std::memory_order_acquire); }
+
+		/** The most recent messages (oldest first), if log_queue_config::mRingBufferSinkSize is greater than zero */
+		std::vector<std::string> recent_messages() const;
+
+	private:
+		/** A preallocated message slot. Aligned to avoid false sharing between producers which write neighbouring slots. */
+		struct alignas(64) slot
+		{
+			// Equals the enqueue position for which the slot is free, and that position + 1 once its message is ready:
+			std::atomic<uint64_t> mSequence;
+			log_pack mPack;
+		};
+
+		/** A range of the batch buffer which is written with the same console colors */
+		struct text_run
+		{
+			log_type mLogType;
+			log_importance mLogImportance;
+			bool mIsStacktrace;
+			size_t mEnd;
+		};
+
+		bool enqueue(const log_pack& aPack);
+		void writer_loop();
+		size_t write_batch();
+		void append_to_batch(const std::string& aText, log_type aLogType, log_importance aLogImportance, bool aIsStacktrace);
+		void write_to_sinks();
+		void wake_writer();
+
+		log_queue_config mConfig;
+		std::vector<slot> mSlots;
+		uint64_t mMask;
+
+		// Written by producers only:
+		alignas(64) std::atomic<uint64_t> mEnqueuePosition;
+		alignas(64) std::atomic<uint64_t> mNumDropped;
+		// Set by producers to wake the writer thread, reset by the writer thread before it drains the queue:
+		alignas(64) std::atomic<bool> mPendingSignal;
+		// Written by the writer thread only; waited on by flush:
+		alignas(64) std::atomic<uint64_t> mNumWritten;
+		std::atomic<bool> mStop;
+
+		// State of the writer thread:
+		uint64_t mDequeuePosition;
+		uint64_t mNumReportedDrops;
+		std::string mBatch;
+		std::vector<text_run> mRuns;
+		std::ofstream mFile;
+
+		mutable std::mutex mRingBufferMutex;
+		std::vector<std::string> mRingBuffer;
+		size_t mRingBufferNext;
+		bool mRingBufferWrapped;
+
+		std::thread mWriter;
+	};
+
+	/**	Configures the queue which is used by dispatch_log if LOGGING_ON_SEPARATE_THREAD is defined.
+	 *	Only has an effect if it is invoked before the first message is logged.
+	 */
+	extern void configure_log_queue(log_queue_config aConfig);
+
+	/** Blocks until all messages which have been logged so far have been written */
+	extern void flush_log();
+
+	/** Number of messages which dispatch_log has dropped because the logger thread could not keep up */
+	extern uint64_t num_dropped_log_messages();
+}
@@ -1762,14 +1762,25 @@ namespace avk
 		// Load all the images from file, and assign them to all usages
 		if (!aSerializer ||
 			(aSerializer && (aSerializer->get().mode() == serializer::mode::serialize))) {
+			// Decoding the image files takes most of the time => decode them on worker threads. The GPU resources are
+			// still created (and written to the serializer) one after the other, in the same order as the map is iterated
+			// below, so that the image sampler indices do not depend on which decoding job finishes first:
+			std::vector<image_data> imagesToLoad;
+			imagesToLoad.reserve(numTexNamesToBorderHandlingToUsages);
 			for (auto& pair : texNamesToBorderHandlingToUsages) {
 				assert(!pair.first.empty());
-
 				bool potentiallySrgb = srgbTextures.contains(pair.first);
+				imagesToLoad.push_back(get_image_data(pair.first, true, potentiallySrgb, aFlipTextures, 4));
+			}
+			parallel_image_loader loader(std::move(imagesToLoad));
 
-				// create_image_from_file_cached takes the serializer as an optional,
+			size_t loaderIndex = 0;
+			for (auto& pair : texNamesToBorderHandlingToUsages) {
+				// Only waits until this image has been decoded, while the following ones are being decoded in the meantime.
+				// create_image_from_image_data_cached takes the serializer as an optional,
 				// therefore the call is safe with and without one
-				auto [tex, cmds] = create_image_from_file_cached(pair.first, true, potentiallySrgb, aFlipTextures, 4, avk::layout::shader_read_only_optimal, avk::memory_usage::device, aImageUsage, aSerializer);
+				auto imageData = loader.take(loaderIndex++);
+				auto [tex, cmds] = create_image_from_image_data_cached(imageData, avk::layout::shader_read_only_optimal, avk::memory_usage::device, aImageUsage, aSerializer);
 				commandsToReturn.mNestedCommandsAndSyncInstructions.push_back(std::move(cmds));
 				auto imgView = context().create_image_view(std::move(tex));
 				assert(!pair.second.empty());
@@ -0,0 +1,65 @@
+#pragma once
+
+namespace avk
+{
+	/** Result of simulating the post-transform vertex cache for an index buffer, see analyze_vertex_cache */
+	struct vertex_cache_statistics
+	{
+		/** Number of vertex shader invocations, i.e., cache misses */
+		uint32_t mVerticesTransformed;
+		/** Average cache miss ratio: vertex shader invocations per triangle. 3 is the worst case, ~0.5 is optimal for large regular meshes. */
+		float mAcmr;
+		/** Average transform to vertex ratio: vertex shader invocations per referenced vertex. 1 is optimal. */
+		float mAtvr;
+	};
+
+	/**	Simulates a FIFO post-transform vertex cache for the given triangle list.
+	 *	@param	aIndices		The triangle list
+	 *	@param	aNumVertices	The number of vertices which aIndices refers to
+	 *	@param	aCacheSize		The number of entries of the simulated cache
+	 */
+	extern vertex_cache_statistics analyze_vertex_cache(const std::vector<uint32_t>& aIndices, size_t aNumVertices, uint32_t aCacheSize = 16);
+
+	/**	Reorders the triangles of a triangle list for locality in the post-transform vertex cache.
+	 *	Implements Tom Forsyth's "Linear-Speed Vertex Cache Optimisation": the next triangle is always the one with the highest
+	 *	score, which is the sum of its vertices' scores. A vertex scores higher the more recently it has been used, and the fewer
+	 *	triangles that still have to be emitted reference it, s.t. no lonely triangles are left behind.
+	 *	@param	aIndices		The triangle list
+	 *	@param	aNumVertices	The number of vertices which aIndices refers to
+	 *	@return	The same triangles in a different order; the winding of every triangle is retained.
+	 */
+	extern std::vector<uint32_t> optimize_vertex_cache(const std::vector<uint32_t>& aIndices, size_t aNumVertices);
+
+	/**	Reorders clusters of triangles of a cache-optimized triangle list s.t. triangles which are likely to occlude others
+	 *	are drawn first, which reduces overdraw from all directions (Sander et al., "Fast Triangle Reordering for Vertex Locality
+	 *	and Reduced Overdraw"). The triangle list is split into clusters wherever the vertex cache is not hurt too much by the split,
+	 *	and the clusters are sorted by how much they face away from the center of the mesh.
+	 *	@param	aIndices		A triangle list which has been optimized with optimize_vertex_cache
+	 *	@param	aPositions		The vertex positions which aIndices refers to
+	 *	@param	aThreshold		How much the ACMR may increase due to the splits, e.g., 1.05 allows for 5% more vertex shader invocations
+	 */
+	extern std::vector<uint32_t> optimize_overdraw(const std::vector<uint32_t>& aIndices, const std::vector<glm::vec3>& aPositions, float aThreshold = 1.05f);
+
+	/**	Renumbers the vertices in the order in which aIndices references them first, for locality of the vertex fetches.
+	 *	Vertices which are not referenced at all are removed.
+	 *	@param	aIndices		The triangle list; its indices are replaced with the new vertex indices.
+	 *	@param	aNumVertices	The number of vertices which aIndices refers to
+	 *	@return	For every new vertex index, the old vertex index. Pass it to remap_vertices for every vertex attribute.
+	 */
+	extern std::vector<uint32_t> optimize_vertex_fetch(std::vector<uint32_t>& aIndices, size_t aNumVertices);
+
+	/**	Reorders a vertex attribute according to the result of optimize_vertex_fetch
+	 *	@param	aVertices		The vertex attribute in its original order
+	 *	@param	aNewToOld		For every new vertex index, the old vertex index, as returned by optimize_vertex_fetch
+	 */
+	template <typename T>
+	std::vector<T> remap_vertices(const std::vector<T>& aVertices, const std::vector<uint32_t>& aNewToOld)
+	{
+		std::vector<T> result;
+		result.reserve(aNewToOld.size());
+		for (const auto oldIndex : aNewToOld) {
+			result.push_back(aVertices[oldIndex]);
+		}
+		return result;
+	}
+}
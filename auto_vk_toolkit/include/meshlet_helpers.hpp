@@ -2,9 +2,35 @@
 
 #include "material_image_helpers.hpp"
 #include "serializer.hpp"
+#include "work_stealing_pool.hpp"
 
 namespace avk
 {
+	/** Bounds of a meshlet, which allow to cull whole meshlets against the view frustum, and if they face away from the camera.
+	 *  Consists of two vec4 members, s.t. an array of it can be uploaded into a GPU buffer as is (std430), see convert_bounds_for_gpu_usage.
+	 *  The bounds are not part of meshlet_gpu_data or meshlet_redirected_gpu_data, s.t. their layouts stay the same for existing shaders.
+	 */
+	struct meshlet_bounds
+	{
+		/** Center (xyz) and radius (w) of a sphere which contains all vertices of the meshlet. */
+		glm::vec4 mBoundingSphere;
+		/** Axis (xyz) and cutoff (w) of a cone which contains the normals of all triangles of the meshlet.
+		 *  All triangles face away from a camera at position c (and the meshlet can be culled) if
+		 *  dot(center - c, axis) >= cutoff * length(center - c) + radius.
+		 *  A cutoff of 1 means that the normals diverge too much for the meshlet to ever be culled this way.
+		 */
+		glm::vec4 mNormalCone;
+
+		/** Bounds which never allow to cull a meshlet: an infinitely large sphere, and a cone with a cutoff of 1. */
+		static meshlet_bounds unbounded()
+		{
+			return meshlet_bounds{
+				glm::vec4{ 0.0f, 0.0f, 0.0f, std::numeric_limits<float>::infinity() },
+				glm::vec4{ 0.0f, 0.0f, 1.0f, 1.0f }
+			};
+		}
+	};
+
 	/** Meshlet struct for the CPU side. */
 	struct meshlet
 	{
@@ -24,6 +50,8 @@ namespace avk
 		uint32_t mVertexCount;
 		/** The actual number of indices in mIndices; */
 		uint32_t mIndexCount;
+		/** The bounds of the meshlet. Only set if the vertex positions were available when the meshlet was created. */
+		std::optional<meshlet_bounds> mBounds;
 	};
 
 	/** Meshlet for GPU usage
@@ -68,7 +96,7 @@ namespace avk
 	void serialize(Archive& aArchive, meshlet_gpu_data<NV, NI>& aValue)
 	{
 		aArchive(avk::serializer::binary_data(aValue.mVertices, sizeof(meshlet_gpu_data<NV, NI>::mVertices)));
-		aArchive(avk::serializer::binary_data(aValue.mVertices, sizeof(meshlet_gpu_data<NV, NI>::mIndices)));
+		aArchive(avk::serializer::binary_data(aValue.mIndices, sizeof(meshlet_gpu_data<NV, NI>::mIndices)));
 		aArchive(aValue.mVertexCount, aValue.mPrimitiveCount);
 	}
 
@@ -83,6 +111,17 @@ namespace avk
 		aArchive(aValue.mDataOffset, aValue.mVertexCount, aValue.mPrimitiveCount);
 	}
 
+	/** Serialization/deserialization method for meshlet_bounds.
+	 *	@param	aArchive	The archive.
+	 *	@param	aValue		The value to serialize or to deserialize into.
+	 *	@tparam Archive		The archive type.
+	 */
+	template<typename Archive>
+	void serialize(Archive& aArchive, meshlet_bounds& aValue)
+	{
+		aArchive(aValue.mBoundingSphere, aValue.mNormalCone);
+	}
+
 
 	/** Divides the given index buffer into meshlets by simply aggregating every aMaxVertices indices into a meshlet.
 	 *  @param	aIndices			The index buffer.
@@ -97,6 +136,31 @@ namespace avk
 		std::optional<mesh_index_t> aMeshIndex,
 		uint32_t aMaxVertices, uint32_t aMaxIndices);
 
+	/** Divides the given vertex and index buffer into meshlets whose triangles share their vertices.
+	 *  Every meshlet is grown greedily from a seed triangle: Among the not yet assigned triangles which share a vertex with the meshlet,
+	 *  the one which adds the fewest new vertices is taken next, and among those, the one closest to the meshlet's center.
+	 *  If no adjacent triangle fits, the closest unassigned triangle (by centroid) is taken, which also determines the seed of the next meshlet.
+	 *  The bounds of every meshlet are computed, see meshlet_bounds.
+	 *  @param	aVertices			The vertex buffer.
+	 *  @param	aIndices			The index buffer.
+	 *  @param	aModel				The model these buffers belong to.
+	 *	@param	aMeshIndex			The optional mesh index of the mesh these buffers belong to.
+	 *	@param	aMaxVertices		The maximum number of vertices of a meshlet. At most 255, because of the uint8_t indices.
+	 *	@param	aMaxIndices			The maximum number of indices of a meshlet.
+	 */
+	std::vector<meshlet> cluster_meshlets_builder(
+		const std::vector<glm::vec3>& aVertices,
+		const std::vector<uint32_t>& aIndices,
+		const model_t& aModel,
+		std::optional<mesh_index_t> aMeshIndex,
+		uint32_t aMaxVertices, uint32_t aMaxIndices);
+
+	/** Computes the bounding sphere and the normal cone of a meshlet.
+	 *  @param	aMeshlet			The meshlet.
+	 *  @param	aVertices			The vertex positions which aMeshlet.mVertices index into.
+	 */
+	meshlet_bounds compute_meshlet_bounds(const meshlet& aMeshlet, const std::vector<glm::vec3>& aVertices);
+
 	/** Divides the given vertex and index buffer into meshlets using the given callback function.
 	 *  @param	aVertices			The vertex buffer.
 	 *  @param	aIndices			The index buffer.
@@ -154,12 +218,16 @@ namespace avk
 		for (auto& meshlet : generatedMeshlets)
 		{
 			meshlet.mModel = aModel;
+			if (!meshlet.mBounds.has_value() && !aVertices.empty()) {
+				meshlet.mBounds = compute_meshlet_bounds(meshlet, aVertices);
+			}
 		}
 
 		return generatedMeshlets;
 	}
 
-	/** Divides the given models into meshlets using the default implementation divide_into_meshlets_simple.
+	/** Divides the given models into meshlets using the default implementation basic_meshlets_divider.
+	 *  Pass cluster_meshlets_builder to the overload which takes a callback for meshlets whose triangles share more of their vertices.
 	 *  @param	aModelsAndMeshletIndices				All the models and associated meshes that should be divided into meshlets.
 	 *	@param	aCombineSubmeshes	If submeshes should be combined into a single vertex/index buffer.
 	 *	@param	aMaxVertices		The maximum number of vertices of a meshlet.
@@ -205,10 +273,12 @@ namespace avk
 		for (auto& pair : aModelsAndMeshletIndices) {
 			auto& model = std::get<avk::model>(pair);
 			auto& meshIndices = std::get<std::vector<mesh_index_t>>(pair);
+			// Every mesh's meshlets keep a reference to the model:
+			model.enable_shared_ownership();
 
 			if (aCombineSubmeshes) {
 				auto [vertices, indices] = get_vertices_and_indices(make_model_references_and_mesh_indices_selection(model, meshIndices));
-				std::vector<meshlet> tmpMeshlets = divide_indexed_geometry_into_meshlets(vertices, indices, std::move(model), std::nullopt, aMaxVertices, aMaxIndices, std::move(aMeshletDivision));
+				std::vector<meshlet> tmpMeshlets = divide_indexed_geometry_into_meshlets(vertices, indices, model, std::nullopt, aMaxVertices, aMaxIndices, aMeshletDivision);
 				// append to meshlets
 				meshlets.insert(std::end(meshlets), std::make_move_iterator(std::begin(tmpMeshlets)), std::make_move_iterator(std::end(tmpMeshlets)));
 			}
@@ -216,7 +286,7 @@ namespace avk
 				for (const auto meshIndex : meshIndices) {
 					auto vertices = model.get().positions_for_mesh(meshIndex);
 					auto indices = model.get().indices_for_mesh<uint32_t>(meshIndex);
-					std::vector<meshlet> tmpMeshlets = divide_indexed_geometry_into_meshlets(vertices, indices, std::move(model), meshIndex, aMaxVertices, aMaxIndices, std::move(aMeshletDivision));
+					std::vector<meshlet> tmpMeshlets = divide_indexed_geometry_into_meshlets(vertices, indices, model, meshIndex, aMaxVertices, aMaxIndices, aMeshletDivision);
 					// append to meshlets
 					meshlets.insert(std::end(meshlets), std::make_move_iterator(std::begin(tmpMeshlets)), std::make_move_iterator(std::end(tmpMeshlets)));
 				}
@@ -225,6 +295,64 @@ namespace avk
 
 		return meshlets;
 	}
+
+	/** Divides the given models into meshlets using the given callback function, which is invoked for multiple meshes in parallel.
+	 *  The resulting meshlets are in the same order as with the sequential overload of divide_into_meshlets.
+	 *  @param	aModelsAndMeshletIndices				All the models and associated meshes that should be divided into meshlets.
+	 *  @param	aMeshletDivision	Callback used to divide meshes into meshlets, see the sequential overload of divide_into_meshlets.
+	 *								It is invoked concurrently from multiple threads and must therefore be thread-safe.
+	 *	@param	aPool				The threads which divide the meshes: one task per model if aCombineSubmeshes is true, and one task per mesh otherwise.
+	 *	@param	aCombineSubmeshes	If submeshes should be combined into a single vertex/index buffer.
+	 *	@param	aMaxVertices		The maximum number of vertices of a meshlet. This value is just passed on to aMeshletDivision.
+	 *	@param	aMaxIndices			The maximum number of indices of a meshlet. This value is just passed on to aMeshletDivision.
+	 */
+	template <typename F>
+	std::vector<meshlet> divide_into_meshlets(std::vector<std::tuple<avk::model, std::vector<avk::mesh_index_t>>>& aModelsAndMeshletIndices, F aMeshletDivision, work_stealing_pool& aPool,
+		const bool aCombineSubmeshes = true, const uint32_t aMaxVertices = 64, const uint32_t aMaxIndices = 378)
+	{
+		struct task
+		{
+			avk::model mModel;
+			const std::vector<mesh_index_t>* mMeshIndices;
+			std::optional<mesh_index_t> mMeshIndex;
+		};
+
+		std::vector<task> tasks;
+		for (auto& pair : aModelsAndMeshletIndices) {
+			auto& model = std::get<avk::model>(pair);
+			auto& meshIndices = std::get<std::vector<mesh_index_t>>(pair);
+			// Every task holds a reference to its model:
+			model.enable_shared_ownership();
+			if (aCombineSubmeshes) {
+				tasks.push_back(task{ model, &meshIndices, std::nullopt });
+			}
+			else {
+				for (const auto meshIndex : meshIndices) {
+					tasks.push_back(task{ model, &meshIndices, meshIndex });
+				}
+			}
+		}
+
+		std::vector<std::vector<meshlet>> tmpMeshlets(tasks.size());
+		aPool.parallel_for(tasks.size(), [&](size_t i) {
+			auto& t = tasks[i];
+			if (t.mMeshIndex.has_value()) {
+				auto vertices = t.mModel.get().positions_for_mesh(t.mMeshIndex.value());
+				auto indices = t.mModel.get().template indices_for_mesh<uint32_t>(t.mMeshIndex.value());
+				tmpMeshlets[i] = divide_indexed_geometry_into_meshlets(vertices, indices, t.mModel, t.mMeshIndex, aMaxVertices, aMaxIndices, aMeshletDivision);
+			}
+			else {
+				auto [vertices, indices] = get_vertices_and_indices(make_model_references_and_mesh_indices_selection(t.mModel, *t.mMeshIndices));
+				tmpMeshlets[i] = divide_indexed_geometry_into_meshlets(vertices, indices, t.mModel, std::nullopt, aMaxVertices, aMaxIndices, aMeshletDivision);
+			}
+		});
+
+		std::vector<meshlet> meshlets;
+		for (auto& m : tmpMeshlets) {
+			meshlets.insert(std::end(meshlets), std::make_move_iterator(std::begin(m)), std::make_move_iterator(std::end(m)));
+		}
+		return meshlets;
+	}
 	
 	// A concept which requires a type to have ::sNumVertices and ::sNumIndices
 	template <typename T>
@@ -389,4 +517,18 @@ namespace avk
 		return convert_for_gpu_usage_cached<T, T::sNumVertices, T::sNumIndices>(aSerializer, aMeshlets);
 	}
 
+	/** Gathers the bounds of the given meshlets into an array which can be uploaded into a GPU buffer of its own.
+	 *  The i-th element belongs to the i-th meshlet, i.e., to the i-th element of the meshlets returned by convert_for_gpu_usage.
+	 *	@param	aMeshlets	The meshlets whose bounds to gather
+	 *  @returns			One meshlet_bounds element per meshlet, which is meshlet_bounds::unbounded() for meshlets without bounds.
+	 */
+	std::vector<meshlet_bounds> convert_bounds_for_gpu_usage(const std::vector<meshlet>& aMeshlets);
+
+	/** Gathers the bounds of the given meshlets like convert_bounds_for_gpu_usage, or reads them from the given serializer.
+	 *  @param  aSerializer The serializer for the meshlet bounds.
+	 *	@param	aMeshlets	The meshlets whose bounds to gather. Only used if aSerializer serializes.
+	 *  @returns			One meshlet_bounds element per meshlet, which is meshlet_bounds::unbounded() for meshlets without bounds.
+	 */
+	std::vector<meshlet_bounds> convert_bounds_for_gpu_usage_cached(serializer& aSerializer, const std::vector<meshlet>& aMeshlets);
+
 }
@@ -394,9 +394,18 @@ namespace avk
 		 *	@param	aConfigSourceUV		The set of UV coordinates to be used for tangent space calculation
 		 */
 		void calculate_tangent_space_for_all_meshes(uint32_t aConfigSourceUV = 0);
+
+		/** Calculates the tangent space with Auto-Vk-Toolkit's implementation for all meshes in parallel,
+		 *  possibly overwriting ASSIMPs tangents/bitangents. Yields the same results as the single-threaded overload.
+		 *	@param	aPool				Thread pool whose threads compute the meshes' tangent spaces, one mesh at a time
+		 *	@param	aConfigSourceUV		The set of UV coordinates to be used for tangent space calculation
+		 */
+		void calculate_tangent_space_for_all_meshes(work_stealing_pool& aPool, uint32_t aConfigSourceUV = 0);
 		
 	private:
 		void initialize_materials();
+		/** Calculates the tangent space of the given mesh into the given vectors, without touching mTangentsAndBitangents */
+		void calculate_tangent_space_into(mesh_index_t aMeshIndex, uint32_t aConfigSourceUV, std::vector<glm::vec3>& aTangents, std::vector<glm::vec3>& aBitangents) const;
 		aiNode* find_mesh_root_node(unsigned int aMeshIndexToFind) const;
 		aiNode* mesh_node_traverser(unsigned int aMeshIndexToFind, aiNode* aNode) const;
 		std::optional<glm::mat4> transformation_matrix_traverser(unsigned int aMeshIndexToFind, const aiNode* aNode, const aiMatrix4x4& aM) const;
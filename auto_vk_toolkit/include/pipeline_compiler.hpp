@@ -0,0 +1,90 @@
+#pragma once
+
+#include "context_vulkan.hpp"
+
+namespace avk
+{
+	/**	Creates graphics and compute pipelines on a set of worker threads, s.t. multiple pipelines are compiled concurrently.
+	 *
+	 *	The functions take the same arguments as context_vulkan::create_graphics_pipeline_for and
+	 *	context_vulkan::create_compute_pipeline_for, but return immediately with a future of the pipeline.
+	 *	The arguments are evaluated on the calling thread, i.e., renderpasses and the like are created there;
+	 *	only the shader loading and the pipeline creation itself happen on the workers.
+	 *	All pipelines are created with the context's pipeline cache, which the driver synchronizes internally.
+	 *	If a creation throws, the exception is rethrown by the future's get().
+	 *
+	 *	Usage example:
+	 *
+	 *	avk::pipeline_compiler compiler;
+	 *	auto skybox = compiler.create_graphics_pipeline_for(avk::vertex_shader("shaders/skybox.vert"), ...);
+	 *	auto blur = compiler.create_graphics_pipeline_for(avk::vertex_shader("shaders/blur.vert"), ...);
+	 *	...
+	 *	mPipelineSkybox = skybox.get(); // Blocks only if the skybox pipeline has not been created yet
+	 */
+	class pipeline_compiler
+	{
+	public:
+		/**	Starts the worker threads
+		 *	@param	aNumThreads		Number of worker threads. If zero, std::thread::hardware_concurrency() is used.
+		 */
+		explicit pipeline_compiler(uint32_t aNumThreads = 0);
+		pipeline_compiler(pipeline_compiler&&) noexcept = delete;
+		pipeline_compiler(const pipeline_compiler&) = delete;
+		pipeline_compiler& operator=(pipeline_compiler&&) noexcept = delete;
+		pipeline_compiler& operator=(const pipeline_compiler&) = delete;
+		/** Finishes all pending pipeline creations, then stops and joins the worker threads */
+		~pipeline_compiler();
+
+		/** Number of worker threads */
+		uint32_t num_threads() const { return static_cast<uint32_t>(mWorkers.size()); }
+
+		/**	Enqueues the creation of a graphics pipeline.
+		 *	@param	args	The same arguments as for context_vulkan::create_graphics_pipeline_for
+		 *	@return	A future which becomes ready when the pipeline has been created
+		 */
+		template <typename... Ts>
+		std::future<graphics_pipeline> create_graphics_pipeline_for(Ts... args)
+		{
+			return enqueue<graphics_pipeline>([...args = std::move(args)]() mutable {
+				return context().create_graphics_pipeline_for(std::move(args)...);
+			});
+		}
+
+		/**	Enqueues the creation of a compute pipeline.
+		 *	@param	args	The same arguments as for context_vulkan::create_compute_pipeline_for
+		 *	@return	A future which becomes ready when the pipeline has been created
+		 */
+		template <typename... Ts>
+		std::future<compute_pipeline> create_compute_pipeline_for(Ts... args)
+		{
+			return enqueue<compute_pipeline>([...args = std::move(args)]() mutable {
+				return context().create_compute_pipeline_for(std::move(args)...);
+			});
+		}
+
+	private:
+		template <typename R, typename F>
+		std::future<R> enqueue(F aCreate)
+		{
+			// std::function must be copyable, the task is not => share it:
+			auto task = std::make_shared<std::packaged_task<R()>>(std::move(aCreate));
+			auto result = task->get_future();
+			{
+				std::scoped_lock lock(mMutex);
+				mTasks.emplace_back([task]() { (*task)(); });
+			}
+			mTaskAvailable.notify_one();
+			return result;
+		}
+
+		void worker_loop();
+
+		std::vector<std::thread> mWorkers;
+
+		// Pending tasks, guarded by mMutex:
+		std::mutex mMutex;
+		std::condition_variable mTaskAvailable;
+		std::deque<std::function<void()>> mTasks;
+		bool mStop;
+	};
+}
@@ -66,6 +66,12 @@ namespace avk {
 	 *  
 	 *  This type serializes/deserializes objects to/from binary files using the cereal
 	 *  serialization library.
+	 *
+	 *  In serialization mode, the data is written to `<path>.tmp`, which replaces the cache file
+	 *  only when the serializer is destroyed without an exception in flight and all writes have
+	 *  succeeded. A footer with the size of the data is appended, s.t. a cache file which is not
+	 *  complete can be detected (see has_complete_cache_file). A process which is killed while
+	 *  writing leaves the previous cache file, or no cache file, behind.
 	 */
 	class serializer
 	{
@@ -229,31 +235,66 @@ namespace avk {
 		 *  This type represents an output archive to save data in binary form to a file.
 		 */
 		class serialize {
+			std::string mCacheFilePath;
 			std::ofstream mOfstream;
 			cereal::BinaryOutputArchive mArchive;
+			int mUncaughtExceptions;
 
 		public:
 			serialize() = delete;
 
 			/** @brief Construct, outputting a binary file to the provided path
 			 *
-			 *  @param[in] aCacheFilePath The filename including the full path where to save the cached file
+			 *  @param[in] aCacheFilePath The filename including the full path where to save the cached file.
+			 *							  The data is written to a temporary file next to it until the serializer is destroyed.
 			 */
 			serialize(const std::string_view aCacheFilePath) :
-				mOfstream(aCacheFilePath.data(), std::ios::binary),
-				mArchive(mOfstream)
+				mCacheFilePath(aCacheFilePath),
+				mOfstream(mCacheFilePath + ".tmp", std::ios::binary),
+				mArchive(mOfstream),
+				mUncaughtExceptions(std::uncaught_exceptions())
 			{}
 
 			/* Construct from other serialize */
 			serialize(serialize&& aOther) noexcept :
+				mCacheFilePath(std::move(aOther.mCacheFilePath)),
 				mOfstream(std::move(aOther.mOfstream)),
-				mArchive(mOfstream)
-			{}
+				mArchive(mOfstream),
+				mUncaughtExceptions(aOther.mUncaughtExceptions)
+			{
+				aOther.mCacheFilePath.clear();
+			}
 
 			serialize(const serialize&) = delete;
 			serialize& operator=(serialize&&) noexcept = default;
 			serialize& operator=(const serialize&) = delete;
-			~serialize() = default;
+
+			/** Appends the footer and replaces the cache file with the temporary file, unless an exception is in flight
+			 *  or a write has failed; the temporary file is removed in these cases.
+			 */
+			~serialize()
+			{
+				if (mCacheFilePath.empty()) {
+					return; // moved from
+				}
+				const auto tmpPath = mCacheFilePath + ".tmp";
+				if (std::uncaught_exceptions() == mUncaughtExceptions) {
+					const std::uint64_t footer[2] = { static_cast<std::uint64_t>(mOfstream.tellp()), cFooterMagic };
+					mOfstream.write(reinterpret_cast<const char*>(footer), sizeof(footer));
+					mOfstream.close();
+					std::error_code ec;
+					if (!mOfstream.fail()) {
+						std::filesystem::rename(tmpPath, mCacheFilePath, ec);
+						if (!ec) {
+							return;
+						}
+					}
+					LOG_ERROR(std::format("Could not write cache file '{}'", mCacheFilePath));
+				}
+				mOfstream.close();
+				std::error_code ec;
+				std::filesystem::remove(tmpPath, ec);
+			}
 
 			/** @brief Serializes an Object
 			 *
@@ -324,7 +365,109 @@ namespace avk {
 		};
 
 		std::variant<deserialize, serialize> mArchive;
+
+	public:
+		/** Marks the end of a completely written cache file, preceded by the size of the data in front of the footer */
+		static constexpr std::uint64_t cFooterMagic = 0x4b43414345564b41ull;
 	};
+
+	/** @brief Checks if a cache file exists and has been written completely
+	 *
+	 *  @param[in] aPath The path to a cached file
+	 *
+	 *  @param[out] True if the file ends with a serializer's footer whose size matches the file's size
+	 */
+	static inline bool has_complete_cache_file(const std::string_view aPath)
+	{
+		std::error_code ec;
+		const auto fileSize = std::filesystem::file_size(aPath, ec);
+		std::uint64_t footer[2];
+		if (ec || fileSize < sizeof(footer)) {
+			return false;
+		}
+		std::ifstream file(aPath.data(), std::ios::binary);
+		file.seekg(static_cast<std::streamoff>(fileSize - sizeof(footer)));
+		file.read(reinterpret_cast<char*>(footer), sizeof(footer));
+		return file.good() && footer[0] == fileSize - sizeof(footer) && footer[1] == serializer::cFooterMagic;
+	}
+
+	/** @brief Computes a hash over the full contents of a file
+	 *
+	 *  The hash is a 64-bit FNV-1a hash over all bytes of the file. It is intended to detect
+	 *  modifications of source assets, not to be cryptographically secure.
+	 *
+	 *  @param[in] aPath The path to the file to be hashed
+	 *
+	 *  @param[out] The hash of the file's contents
+	 */
+	static inline std::uint64_t hash_file_contents(const std::string_view aPath)
+	{
+		std::ifstream file(aPath.data(), std::ios::binary);
+		if (!file.is_open()) {
+			throw avk::runtime_error(std::format("Could not open file '{}' for hashing.", aPath));
+		}
+
+		std::uint64_t hash = 0xcbf29ce484222325ull;
+		std::array<char, 64 * 1024> chunk;
+		while (file) {
+			file.read(chunk.data(), chunk.size());
+			const auto numRead = file.gcount();
+			for (std::streamsize i = 0; i < numRead; ++i) {
+				hash ^= static_cast<std::uint8_t>(chunk[i]);
+				hash *= 0x100000001b3ull;
+			}
+		}
+		return hash;
+	}
+
+	/** @brief Create a serializer for a cache file which has been derived from a source file
+	 *
+	 *  Right after the serializer's version, the hash of the source file's contents and a
+	 *  user-defined format version are stored in the cache file. If an existing cache file
+	 *  has been created from a different state of the source file, or with a different format
+	 *  version, or with a different serializer version, or if it has not been written completely,
+	 *  it is deleted and the returned serializer is initialized in serialization mode, i.e. the
+	 *  cache file is recreated.
+	 *  Otherwise, the serializer is initialized in deserialization mode and reads from the
+	 *  cache file, positioned right after its header.
+	 *
+	 *  @param[in] aCacheFilePath	The path to the cache file
+	 *  @param[in] aSourceFilePath	The path to the source file the cache file's contents are derived from
+	 *  @param[in] aFormatVersion	The version of the data layout that the caller stores in the cache file.
+	 *								Increment it whenever the layout changes to invalidate old cache files.
+	 *
+	 *  @param[out] A serializer which either reads from an up-to-date cache file or writes a new one
+	 */
+	static inline serializer create_serializer_for_source_file(const std::string_view aCacheFilePath, const std::string_view aSourceFilePath, std::uint32_t aFormatVersion = 0)
+	{
+		auto sourceHash = hash_file_contents(aSourceFilePath);
+
+		if (does_cache_file_exist(aCacheFilePath)) {
+			try {
+				if (!has_complete_cache_file(aCacheFilePath)) {
+					throw avk::runtime_error("Truncated cache file");
+				}
+				auto existing = serializer(aCacheFilePath, serializer::mode::deserialize);
+				std::uint64_t storedHash = 0;
+				std::uint32_t storedFormatVersion = 0;
+				existing.archive(storedHash);
+				existing.archive(storedFormatVersion);
+				if (storedHash == sourceHash && storedFormatVersion == aFormatVersion) {
+					return existing;
+				}
+			}
+			catch (const std::exception&) {
+				// Incompatible or truncated cache file => recreate it
+			}
+			LOG_INFO(std::format("Cache file '{}' is outdated w.r.t. '{}' and will be recreated.", aCacheFilePath, aSourceFilePath));
+			std::filesystem::remove(aCacheFilePath);
+		}
+
+		auto result = serializer(aCacheFilePath, serializer::mode::serialize);
+		result.archive(sourceHash);
+		result.archive(aFormatVersion);
+		return result;
+	}
 }
 
 /** @brief Custom Serialization Functions
@@ -588,6 +731,198 @@ namespace avk {
 			aValue.mAnimationIndex,
 			aValue.mMaxNumBoneMatrices
 		);
+		// The key channels are not serialized, but rebuilt from the keys:
+		aValue.pack_keys();
+	}
+
+	template<typename Archive>
+	void serialize(Archive& aArchive, avk::packed_quat& aValue)
+	{
+		aArchive(
+			aValue.mComponents
+		);
+	}
+
+	template<typename Archive, typename T>
+	void serialize(Archive& aArchive, avk::compressed_key_channel<T>& aValue)
+	{
+		aArchive(
+			aValue.mFrames,
+			aValue.mValues
+		);
+	}
+
+	template<typename Archive>
+	void serialize(Archive& aArchive, avk::compressed_node_channels& aValue)
+	{
+		aArchive(
+			aValue.mPositions,
+			aValue.mRotations,
+			aValue.mScalings
+		);
+	}
+
+	template<typename Archive>
+	void serialize(Archive& aArchive, avk::animation_compression_statistics& aValue)
+	{
+		aArchive(
+			aValue.mNumRawKeys,
+			aValue.mNumCompressedKeys,
+			aValue.mRawBytes,
+			aValue.mCompressedBytes,
+			aValue.mMaxPositionError,
+			aValue.mMaxRotationError,
+			aValue.mMaxScaleError
+		);
+	}
+
+	template<typename Archive>
+	void serialize(Archive& aArchive, avk::compressed_animation_clip& aValue)
+	{
+		aArchive(
+			aValue.mClip,
+			aValue.mFramesPerSecond,
+			aValue.mNodes,
+			aValue.mStatistics
+		);
+	}
+}
+
+namespace avk::cfg {
+	template<typename Archive>
+	void serialize(Archive& aArchive, avk::cfg::color_blending_config& aValue)
+	{
+		aArchive(
+			aValue.mTargetAttachment,
+			aValue.mEnabled,
+			aValue.mAffectedColorChannels,
+			aValue.mIncomingColorFactor,
+			aValue.mExistingColorFactor,
+			aValue.mColorOperation,
+			aValue.mIncomingAlphaFactor,
+			aValue.mExistingAlphaFactor,
+			aValue.mAlphaOperation
+		);
+	}
+}
+
+namespace avk {
+	template<typename Archive>
+	void serialize(Archive& aArchive, avk::material_config& aValue)
+	{
+		aArchive(
+			aValue.mName,
+			aValue.mIgnoreCpuOnlyDataForEquality,
+			aValue.mShadingModel,
+			aValue.mWireframeMode,
+			aValue.mTwosided,
+			aValue.mBlendMode
+		);
+
+		aArchive(
+			aValue.mDiffuseReflectivity,
+			aValue.mAmbientReflectivity,
+			aValue.mSpecularReflectivity,
+			aValue.mEmissiveColor,
+			aValue.mTransparentColor,
+			aValue.mReflectiveColor,
+			aValue.mAlbedo
+		);
+
+		aArchive(
+			aValue.mOpacity,
+			aValue.mBumpScaling,
+			aValue.mShininess,
+			aValue.mShininessStrength,
+			aValue.mRefractionIndex,
+			aValue.mReflectivity,
+			aValue.mMetallic,
+			aValue.mSmoothness,
+			aValue.mSheen,
+			aValue.mThickness,
+			aValue.mRoughness,
+			aValue.mAnisotropy
+		);
+
+		aArchive(
+			aValue.mAnisotropyRotation,
+			aValue.mCustomData
+		);
+
+		aArchive(
+			aValue.mDiffuseTex,
+			aValue.mSpecularTex,
+			aValue.mAmbientTex,
+			aValue.mEmissiveTex,
+			aValue.mHeightTex,
+			aValue.mNormalsTex,
+			aValue.mShininessTex,
+			aValue.mOpacityTex,
+			aValue.mDisplacementTex,
+			aValue.mReflectionTex,
+			aValue.mLightmapTex,
+			aValue.mExtraTex
+		);
+
+		aArchive(
+			aValue.mDiffuseTexUvSet,
+			aValue.mSpecularTexUvSet,
+			aValue.mAmbientTexUvSet,
+			aValue.mEmissiveTexUvSet,
+			aValue.mHeightTexUvSet,
+			aValue.mNormalsTexUvSet,
+			aValue.mShininessTexUvSet,
+			aValue.mOpacityTexUvSet,
+			aValue.mDisplacementTexUvSet,
+			aValue.mReflectionTexUvSet,
+			aValue.mLightmapTexUvSet,
+			aValue.mExtraTexUvSet
+		);
+
+		aArchive(
+			aValue.mDiffuseTexOffsetTiling,
+			aValue.mSpecularTexOffsetTiling,
+			aValue.mAmbientTexOffsetTiling,
+			aValue.mEmissiveTexOffsetTiling,
+			aValue.mHeightTexOffsetTiling,
+			aValue.mNormalsTexOffsetTiling,
+			aValue.mShininessTexOffsetTiling,
+			aValue.mOpacityTexOffsetTiling,
+			aValue.mDisplacementTexOffsetTiling,
+			aValue.mReflectionTexOffsetTiling,
+			aValue.mLightmapTexOffsetTiling,
+			aValue.mExtraTexOffsetTiling
+		);
+
+		aArchive(
+			aValue.mDiffuseTexRotation,
+			aValue.mSpecularTexRotation,
+			aValue.mAmbientTexRotation,
+			aValue.mEmissiveTexRotation,
+			aValue.mHeightTexRotation,
+			aValue.mNormalsTexRotation,
+			aValue.mShininessTexRotation,
+			aValue.mOpacityTexRotation,
+			aValue.mDisplacementTexRotation,
+			aValue.mReflectionTexRotation,
+			aValue.mLightmapTexRotation,
+			aValue.mExtraTexRotation
+		);
+
+		aArchive(
+			aValue.mDiffuseTexBorderHandlingMode,
+			aValue.mSpecularTexBorderHandlingMode,
+			aValue.mAmbientTexBorderHandlingMode,
+			aValue.mEmissiveTexBorderHandlingMode,
+			aValue.mHeightTexBorderHandlingMode,
+			aValue.mNormalsTexBorderHandlingMode,
+			aValue.mShininessTexBorderHandlingMode,
+			aValue.mOpacityTexBorderHandlingMode,
+			aValue.mDisplacementTexBorderHandlingMode,
+			aValue.mReflectionTexBorderHandlingMode,
+			aValue.mLightmapTexBorderHandlingMode,
+			aValue.mExtraTexBorderHandlingMode
+		);
 	}
 }
 
@@ -27,6 +27,16 @@ namespace avk
 		uint32_t mValue;
 	};
 
+	/** Set the file in which the pipeline cache is persisted between runs.
+	 *	It is loaded when the device is created, and written back when the context is destroyed.
+	 *	Set an empty path in order to create pipelines without a persistent cache.
+	 */
+	struct pipeline_cache_file
+	{
+		pipeline_cache_file(std::string aValue = "pipeline_cache.bin") : mValue{ std::move(aValue) } {}
+		std::string mValue;
+	};
+
 	/** Fill this vector with further required instance extensions, if required */
 	struct required_instance_extensions
 	{
@@ -231,6 +241,7 @@ namespace avk
 		physical_device_selection_hint mPhysicalDeviceSelectionHint;
 		application_name mApplicationName;
 		application_version mApplicationVersion;
+		pipeline_cache_file mPipelineCacheFile;
 		required_instance_extensions mRequiredInstanceExtensions;
 		validation_layers mValidationLayers;
 		required_device_extensions mRequiredDeviceExtensions;
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "material_config.hpp"
+#include "work_stealing_pool.hpp"
+
+namespace avk
+{
+	/** What a texture contains, which determines the block-compressed format it is baked into */
+	enum struct texture_content
+	{
+		/** Colors: BC1 if the texture is fully opaque, BC3 otherwise */
+		color,
+		/** Tangent-space normals in RGB: BC5, which stores X and Y only. Shaders must reconstruct Z as sqrt(1 - x*x - y*y). */
+		normal_map,
+		/** Scalar data in R, like roughness, height, or opacity: BC4, which stores R only. Textures with alpha are baked like color. */
+		single_channel
+	};
+
+	/**	Bakes textures into a cache of KTX files, which contain a full, block-compressed mip chain.
+	 *
+	 *	The mip chain is filtered on the CPU (Mitchell filter, in linear space for sRGB textures, with renormalized normals
+	 *	for normal maps) instead of being blitted on the GPU after every upload. Afterwards, all levels are compressed to
+	 *	BC1/BC3/BC4/BC5 depending on the texture_content, with the 4x4 blocks distributed across the threads of a work_stealing_pool.
+	 *	The baked files are loaded via image_data like any other texture file, where they take the path through gli, which
+	 *	uploads all of their levels directly.
+	 *
+	 *	A cache file's name is derived from the source file's path, size, and modification time, and from the baking parameters;
+	 *	i.e., changed source files are baked again, and unchanged ones are only baked once.
+	 *	The orientation of baked textures is final, i.e., load them with aFlip = false: BC4 and BC5 can not be flipped after loading.
+	 *
+	 *	Usage example:
+	 *
+	 *	avk::texture_baker baker("texture_cache");
+	 *	baker.bake_material_textures(materialConfigs, false, true);
+	 *	auto [gpuMaterials, imageSamplers, commands] = avk::convert_for_gpu_usage<avk::material_gpu_data>(materialConfigs, false, false, ...);
+	 */
+	class texture_baker
+	{
+	public:
+		/** Accumulated over all textures which have been requested from a texture_baker */
+		struct statistics
+		{
+			/** Number of textures which have been baked, and which have been taken from the cache */
+			size_t mNumBaked = 0;
+			size_t mNumFromCache = 0;
+			/** Size of all textures as uncompressed RGBA8 images with a full mip chain, i.e., as they would be uploaded without baking */
+			size_t mUncompressedBytes = 0;
+			/** Size of all baked textures */
+			size_t mBakedBytes = 0;
+			/** Time spent in baking, excluding the cache hits */
+			double mBakeSeconds = 0.0;
+		};
+
+		/**	@param	aCacheDirectory		Directory of the baked files; created if it does not exist
+		 *	@param	aNumThreads			Number of threads which compress a texture's blocks. If zero, std::thread::hardware_concurrency() is used.
+		 */
+		explicit texture_baker(std::string aCacheDirectory = "texture_cache", uint32_t aNumThreads = 0);
+
+		/**	Bakes a texture, unless it is in the cache already.
+		 *	@param	aPath		Path of a texture file which stb_image or gli can load. Files which gli loads, like DDS or KTX files, are
+		 *						copied into the cache as they are, except for the flip; their levels and format are kept.
+		 *	@param	aContent	What the texture contains
+		 *	@param	aSrgb		Use an sRGB format for color textures
+		 *	@param	aFlip		Flip the texture vertically
+		 *	@return	The path of the baked KTX file
+		 */
+		std::string bake(const std::string& aPath, texture_content aContent, bool aSrgb, bool aFlip);
+
+		/**	Bakes all textures of the given materials, and replaces their paths with the paths of the baked files.
+		 *	A texture's content is derived from the slot it is used in; a texture which is used in differently typed slots is baked as color.
+		 *	@param	aMaterialConfigs		Materials whose texture paths are replaced
+		 *	@param	aLoadTexturesInSrgb		Same as for convert_for_gpu_usage: use sRGB formats for diffuse, ambient, and extra textures
+		 *	@param	aFlipTextures			Same as for convert_for_gpu_usage. The baked textures must then be loaded without flipping.
+		 */
+		void bake_material_textures(std::vector<material_config>& aMaterialConfigs, bool aLoadTexturesInSrgb, bool aFlipTextures);
+
+		/** Statistics of all textures which have been requested so far */
+		const statistics& stats() const { return mStatistics; }
+
+		/** Directory of the baked files */
+		const std::string& cache_directory() const { return mCacheDirectory; }
+
+	private:
+		// Increment whenever the baked data changes for the same parameters:
+		static constexpr uint32_t cFormatVersion = 1;
+
+		std::string cache_path(const std::string& aPath, texture_content aContent, bool aSrgb, bool aFlip) const;
+		void bake_image(const std::string& aPath, texture_content aContent, bool aSrgb, bool aFlip, const std::string& aCachePath);
+		void copy_gli_texture(const std::string& aPath, bool aFlip, const std::string& aCachePath);
+		void compress_level(const std::vector<uint8_t>& aPixels, uint32_t aWidth, uint32_t aHeight, gli::format aFormat, uint8_t* aBlocks);
+
+		std::string mCacheDirectory;
+		work_stealing_pool mPool;
+		statistics mStatistics;
+	};
+}
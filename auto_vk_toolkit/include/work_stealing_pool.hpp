@@ -0,0 +1,78 @@
+#pragma once
+
+namespace avk
+{
+	/**	A persistent pool of worker threads which executes parallel loops.
+	 *
+	 *	The index range of a loop is split evenly among all workers (including the calling thread).
+	 *	Every worker processes its own range front to back, in chunks of the given grain size.
+	 *	A worker which has run out of work steals the back half of another worker's remaining range,
+	 *	so that uneven workloads are balanced without a central queue.
+	 *
+	 *	Usage example:
+	 *
+	 *	avk::work_stealing_pool pool;
+	 *	pool.parallel_for(instances.size(), [&](size_t i) {
+	 *		evaluate(instances[i]);
+	 *	});
+	 */
+	class work_stealing_pool
+	{
+	public:
+		/**	Starts the worker threads
+		 *	@param	aNumThreads		Total number of threads which execute a loop, including the calling thread.
+		 *							If zero, std::thread::hardware_concurrency() is used.
+		 */
+		explicit work_stealing_pool(uint32_t aNumThreads = 0);
+		work_stealing_pool(work_stealing_pool&&) noexcept = delete;
+		work_stealing_pool(const work_stealing_pool&) = delete;
+		work_stealing_pool& operator=(work_stealing_pool&&) noexcept = delete;
+		work_stealing_pool& operator=(const work_stealing_pool&) = delete;
+		/** Stops and joins the worker threads */
+		~work_stealing_pool();
+
+		/** Total number of threads which execute a loop, including the calling thread */
+		uint32_t num_threads() const { return static_cast<uint32_t>(mRanges.size()); }
+
+		/**	Invokes aFunc for every index in [0, aCount) and blocks until all invocations have returned.
+		 *	The calling thread takes part in the work. Must not be invoked from within aFunc.
+		 *	If aFunc throws, the remaining indices are still processed, and the first exception is rethrown.
+		 *	@param	aCount		Number of indices
+		 *	@param	aFunc		Function which is invoked with every index
+		 *	@param	aGrainSize	Number of consecutive indices which a worker takes at once
+		 */
+		void parallel_for(size_t aCount, const std::function<void(size_t)>& aFunc, size_t aGrainSize = 1);
+
+	private:
+		/** The remaining index range of one worker. Aligned to avoid false sharing between the workers. */
+		struct alignas(64) index_range
+		{
+			std::mutex mMutex;
+			size_t mBegin = 0;
+			size_t mEnd = 0;
+		};
+
+		void worker_loop(size_t aSlot);
+		void work(size_t aSlot);
+		bool steal(size_t aSlot);
+
+		std::vector<std::unique_ptr<index_range>> mRanges;
+		std::vector<std::thread> mWorkers;
+
+		// Serializes concurrent invocations of parallel_for:
+		std::mutex mLoopMutex;
+
+		// State of the current loop, guarded by mMutex:
+		std::mutex mMutex;
+		std::condition_variable mStarted;
+		std::condition_variable mFinished;
+		const std::function<void(size_t)>* mFunc;
+		size_t mGrainSize;
+		uint64_t mGeneration;
+		uint32_t mNumActiveWorkers;
+		bool mStop;
+		std::exception_ptr mException;
+
+		std::atomic<size_t> mRemaining;
+	};
+}
@@ -10,10 +10,10 @@ namespace avk
 		glm::vec3 localTranslation;
 
 		// The localTransform can only be different than the identity if there are animation keys.
-		if (aNode.mPositionKeys.size() > 0) { 
-			auto [tpos1, tpos2] = find_positions_in_keys(aNode.mPositionKeys, aTimeInTicks);
-			auto tf = get_interpolation_factor(aNode.mPositionKeys[tpos1], aNode.mPositionKeys[tpos2], aTimeInTicks);
-			localTranslation = glm::lerp(aNode.mPositionKeys[tpos1].mValue, aNode.mPositionKeys[tpos2].mValue, tf);
+		if (!aNode.mPositionChannel.empty()) { 
+			auto [tpos1, tpos2] = find_positions_in_keys(aNode.mPositionChannel.mTimes, aTimeInTicks);
+			auto tf = get_interpolation_factor(aNode.mPositionChannel.mTimes[tpos1], aNode.mPositionChannel.mTimes[tpos2], aTimeInTicks);
+			localTranslation = glm::lerp(aNode.mPositionChannel.mValues[tpos1], aNode.mPositionChannel.mValues[tpos2], tf);
 		}
 		else {
 			glm::quat unusedRotation;
@@ -29,10 +29,10 @@ namespace avk
 		glm::quat localRotation;
 
 		// The localTransform can only be different than the identity if there are animation keys.
-		if (aNode.mRotationKeys.size() > 0) {
-			auto [rpos1, rpos2] = find_positions_in_keys(aNode.mRotationKeys, aTimeInTicks);
-			auto rf = get_interpolation_factor(aNode.mRotationKeys[rpos1], aNode.mRotationKeys[rpos2], aTimeInTicks);
-			localRotation = glm::slerp(aNode.mRotationKeys[rpos1].mValue, aNode.mRotationKeys[rpos2].mValue, rf);	// use slerp, not lerp or mix (those lead to jerks)
+		if (!aNode.mRotationChannel.empty()) {
+			auto [rpos1, rpos2] = find_positions_in_keys(aNode.mRotationChannel.mTimes, aTimeInTicks);
+			auto rf = get_interpolation_factor(aNode.mRotationChannel.mTimes[rpos1], aNode.mRotationChannel.mTimes[rpos2], aTimeInTicks);
+			localRotation = glm::slerp(aNode.mRotationChannel.mValues[rpos1], aNode.mRotationChannel.mValues[rpos2], rf);	// use slerp, not lerp or mix (those lead to jerks)
 			localRotation = glm::normalize(localRotation); // normalize the resulting quaternion, just to be on the safe side
 		}
 		else {
@@ -49,10 +49,10 @@ namespace avk
 		glm::vec3 localScale;
 
 		// The localTransform can only be different than the identity if there are animation keys.
-		if (aNode.mScalingKeys.size() > 0) {
-			auto [spos1, spos2] = find_positions_in_keys(aNode.mScalingKeys, aTimeInTicks);
-			auto sf = get_interpolation_factor(aNode.mScalingKeys[spos1], aNode.mScalingKeys[spos2], aTimeInTicks);
-			localScale = glm::lerp(aNode.mScalingKeys[spos1].mValue, aNode.mScalingKeys[spos2].mValue, sf);
+		if (!aNode.mScalingChannel.empty()) {
+			auto [spos1, spos2] = find_positions_in_keys(aNode.mScalingChannel.mTimes, aTimeInTicks);
+			auto sf = get_interpolation_factor(aNode.mScalingChannel.mTimes[spos1], aNode.mScalingChannel.mTimes[spos2], aTimeInTicks);
+			localScale = glm::lerp(aNode.mScalingChannel.mValues[spos1], aNode.mScalingChannel.mValues[spos2], sf);
 		}
 		else {
 			glm::vec3 unusedTranslation;
@@ -64,32 +64,37 @@ namespace avk
 	}
 	
 	glm::mat4 animation::compute_node_local_transform(const animated_node& aNode, double aTimeInTicks) const
+	{
+		return compute_node_local_transform(aNode, aTimeInTicks, nullptr);
+	}
+
+	glm::mat4 animation::compute_node_local_transform(const animated_node& aNode, double aTimeInTicks, keyframe_cursor* aCursor) const
 	{
 		glm::mat4 localTransform;
 
 		// The localTransform can only be different than the identity if there are animation keys.
-		if (aNode.mPositionKeys.size() + aNode.mRotationKeys.size() + aNode.mScalingKeys.size() > 0) {
+		if (aNode.mPositionChannel.size() + aNode.mRotationChannel.size() + aNode.mScalingChannel.size() > 0) {
 			// Translation/position:
-			auto [tpos1, tpos2] = find_positions_in_keys(aNode.mPositionKeys, aTimeInTicks);
-			auto tf = get_interpolation_factor(aNode.mPositionKeys[tpos1], aNode.mPositionKeys[tpos2], aTimeInTicks);
-			auto translation = glm::lerp(aNode.mPositionKeys[tpos1].mValue, aNode.mPositionKeys[tpos2].mValue, tf);
+			auto [tpos1, tpos2] = find_positions_in_keys(aNode.mPositionChannel.mTimes, aTimeInTicks, nullptr != aCursor ? &aCursor->mPosition : nullptr);
+			auto tf = get_interpolation_factor(aNode.mPositionChannel.mTimes[tpos1], aNode.mPositionChannel.mTimes[tpos2], aTimeInTicks);
+			auto translation = glm::lerp(aNode.mPositionChannel.mValues[tpos1], aNode.mPositionChannel.mValues[tpos2], tf);
 
 			// Rotation:
 			size_t rpos1 = tpos1, rpos2 = tpos2;
 			if (!aNode.mSameRotationAndPositionKeyTimes) {
-				std::tie(rpos1, rpos2) = find_positions_in_keys(aNode.mRotationKeys, aTimeInTicks);
+				std::tie(rpos1, rpos2) = find_positions_in_keys(aNode.mRotationChannel.mTimes, aTimeInTicks, nullptr != aCursor ? &aCursor->mRotation : nullptr);
 			}
-			auto rf = get_interpolation_factor(aNode.mRotationKeys[rpos1], aNode.mRotationKeys[rpos2], aTimeInTicks);
-			auto rotation = glm::slerp(aNode.mRotationKeys[rpos1].mValue, aNode.mRotationKeys[rpos2].mValue, rf);	// use slerp, not lerp or mix (those lead to jerks)
+			auto rf = get_interpolation_factor(aNode.mRotationChannel.mTimes[rpos1], aNode.mRotationChannel.mTimes[rpos2], aTimeInTicks);
+			auto rotation = glm::slerp(aNode.mRotationChannel.mValues[rpos1], aNode.mRotationChannel.mValues[rpos2], rf);	// use slerp, not lerp or mix (those lead to jerks)
 			rotation = glm::normalize(rotation); // normalize the resulting quaternion, just to be on the safe side
 
 			// Scaling:
 			size_t spos1 = tpos1, spos2 = tpos2;
 			if (!aNode.mSameScalingAndPositionKeyTimes) {
-				std::tie(spos1, spos2) = find_positions_in_keys(aNode.mScalingKeys, aTimeInTicks);
+				std::tie(spos1, spos2) = find_positions_in_keys(aNode.mScalingChannel.mTimes, aTimeInTicks, nullptr != aCursor ? &aCursor->mScaling : nullptr);
 			}
-			auto sf = get_interpolation_factor(aNode.mScalingKeys[spos1], aNode.mScalingKeys[spos2], aTimeInTicks);
-			auto scaling = glm::lerp(aNode.mScalingKeys[spos1].mValue, aNode.mScalingKeys[spos2].mValue, sf);
+			auto sf = get_interpolation_factor(aNode.mScalingChannel.mTimes[spos1], aNode.mScalingChannel.mTimes[spos2], aTimeInTicks);
+			auto scaling = glm::lerp(aNode.mScalingChannel.mValues[spos1], aNode.mScalingChannel.mValues[spos2], sf);
 
 			localTransform = matrix_from_transforms(translation, rotation, scaling);
 		}
@@ -105,10 +110,10 @@ namespace avk
 		glm::vec3 inverseLocalTranslation;
 
 		// The localTransform can only be different than the identity if there are animation keys.
-		if (aNode.mPositionKeys.size() > 0) {
-			auto [tpos1, tpos2] = find_positions_in_keys(aNode.mPositionKeys, aTimeInTicks);
-			auto tf = get_interpolation_factor(aNode.mPositionKeys[tpos1], aNode.mPositionKeys[tpos2], aTimeInTicks);
-			inverseLocalTranslation = glm::lerp(-aNode.mPositionKeys[tpos1].mValue, -aNode.mPositionKeys[tpos2].mValue, tf);
+		if (!aNode.mPositionChannel.empty()) {
+			auto [tpos1, tpos2] = find_positions_in_keys(aNode.mPositionChannel.mTimes, aTimeInTicks);
+			auto tf = get_interpolation_factor(aNode.mPositionChannel.mTimes[tpos1], aNode.mPositionChannel.mTimes[tpos2], aTimeInTicks);
+			inverseLocalTranslation = glm::lerp(-aNode.mPositionChannel.mValues[tpos1], -aNode.mPositionChannel.mValues[tpos2], tf);
 		}
 		else {
 			glm::quat unusedRotation;
@@ -124,10 +129,10 @@ namespace avk
 		glm::quat localRotation;
 
 		// The localTransform can only be different than the identity if there are animation keys.
-		if (aNode.mRotationKeys.size() > 0) {
-			auto [rpos1, rpos2] = find_positions_in_keys(aNode.mRotationKeys, aTimeInTicks);
-			auto rf = get_interpolation_factor(aNode.mRotationKeys[rpos1], aNode.mRotationKeys[rpos2], aTimeInTicks);
-			localRotation = glm::slerp(glm::inverse(aNode.mRotationKeys[rpos1].mValue), glm::inverse(aNode.mRotationKeys[rpos2].mValue), rf);	// use slerp, not lerp or mix (those lead to jerks)
+		if (!aNode.mRotationChannel.empty()) {
+			auto [rpos1, rpos2] = find_positions_in_keys(aNode.mRotationChannel.mTimes, aTimeInTicks);
+			auto rf = get_interpolation_factor(aNode.mRotationChannel.mTimes[rpos1], aNode.mRotationChannel.mTimes[rpos2], aTimeInTicks);
+			localRotation = glm::slerp(glm::inverse(aNode.mRotationChannel.mValues[rpos1]), glm::inverse(aNode.mRotationChannel.mValues[rpos2]), rf);	// use slerp, not lerp or mix (those lead to jerks)
 			localRotation = glm::normalize(localRotation); // normalize the resulting quaternion, just to be on the safe side
 		}
 		else {
@@ -144,10 +149,10 @@ namespace avk
 		glm::vec3 localScale;
 
 		// The localTransform can only be different than the identity if there are animation keys.
-		if (aNode.mScalingKeys.size() > 0) {
-			auto [spos1, spos2] = find_positions_in_keys(aNode.mScalingKeys, aTimeInTicks);
-			auto sf = get_interpolation_factor(aNode.mScalingKeys[spos1], aNode.mScalingKeys[spos2], aTimeInTicks);
-			localScale = glm::lerp(1.0f / aNode.mScalingKeys[spos1].mValue, 1.0f / aNode.mScalingKeys[spos2].mValue, sf);
+		if (!aNode.mScalingChannel.empty()) {
+			auto [spos1, spos2] = find_positions_in_keys(aNode.mScalingChannel.mTimes, aTimeInTicks);
+			auto sf = get_interpolation_factor(aNode.mScalingChannel.mTimes[spos1], aNode.mScalingChannel.mTimes[spos2], aTimeInTicks);
+			localScale = glm::lerp(1.0f / aNode.mScalingChannel.mValues[spos1], 1.0f / aNode.mScalingChannel.mValues[spos2], sf);
 		}
 		else {
 			glm::vec3 unusedTranslation;
@@ -163,28 +168,28 @@ namespace avk
 		glm::mat4 inverseLocalTransform;
 
 		// The localTransform can only be different than the identity if there are animation keys.
-		if (aNode.mPositionKeys.size() + aNode.mRotationKeys.size() + aNode.mScalingKeys.size() > 0) {
+		if (aNode.mPositionChannel.size() + aNode.mRotationChannel.size() + aNode.mScalingChannel.size() > 0) {
 			// Translation/position:
-			auto [tpos1, tpos2] = find_positions_in_keys(aNode.mPositionKeys, aTimeInTicks);
-			auto tf = get_interpolation_factor(aNode.mPositionKeys[tpos1], aNode.mPositionKeys[tpos2], aTimeInTicks);
-			auto translation = glm::lerp(-aNode.mPositionKeys[tpos1].mValue, -aNode.mPositionKeys[tpos2].mValue, tf);
+			auto [tpos1, tpos2] = find_positions_in_keys(aNode.mPositionChannel.mTimes, aTimeInTicks);
+			auto tf = get_interpolation_factor(aNode.mPositionChannel.mTimes[tpos1], aNode.mPositionChannel.mTimes[tpos2], aTimeInTicks);
+			auto translation = glm::lerp(-aNode.mPositionChannel.mValues[tpos1], -aNode.mPositionChannel.mValues[tpos2], tf);
 
 			// Rotation:
 			size_t rpos1 = tpos1, rpos2 = tpos2;
 			if (!aNode.mSameRotationAndPositionKeyTimes) {
-				std::tie(rpos1, rpos2) = find_positions_in_keys(aNode.mRotationKeys, aTimeInTicks);
+				std::tie(rpos1, rpos2) = find_positions_in_keys(aNode.mRotationChannel.mTimes, aTimeInTicks);
 			}
-			auto rf = get_interpolation_factor(aNode.mRotationKeys[rpos1], aNode.mRotationKeys[rpos2], aTimeInTicks);
-			auto rotation = glm::slerp(glm::inverse(aNode.mRotationKeys[rpos1].mValue), glm::inverse(aNode.mRotationKeys[rpos2].mValue), rf);	// use slerp, not lerp or mix (those lead to jerks)
+			auto rf = get_interpolation_factor(aNode.mRotationChannel.mTimes[rpos1], aNode.mRotationChannel.mTimes[rpos2], aTimeInTicks);
+			auto rotation = glm::slerp(glm::inverse(aNode.mRotationChannel.mValues[rpos1]), glm::inverse(aNode.mRotationChannel.mValues[rpos2]), rf);	// use slerp, not lerp or mix (those lead to jerks)
 			rotation = glm::normalize(rotation); // normalize the resulting quaternion, just to be on the safe side
 
 			// Scaling:
 			size_t spos1 = tpos1, spos2 = tpos2;
 			if (!aNode.mSameScalingAndPositionKeyTimes) {
-				std::tie(spos1, spos2) = find_positions_in_keys(aNode.mScalingKeys, aTimeInTicks);
+				std::tie(spos1, spos2) = find_positions_in_keys(aNode.mScalingChannel.mTimes, aTimeInTicks);
 			}
-			auto sf = get_interpolation_factor(aNode.mScalingKeys[spos1], aNode.mScalingKeys[spos2], aTimeInTicks);
-			auto scaling = glm::lerp(1.0f / aNode.mScalingKeys[spos1].mValue, 1.0f / aNode.mScalingKeys[spos2].mValue, sf);
+			auto sf = get_interpolation_factor(aNode.mScalingChannel.mTimes[spos1], aNode.mScalingChannel.mTimes[spos2], aTimeInTicks);
+			auto scaling = glm::lerp(1.0f / aNode.mScalingChannel.mValues[spos1], 1.0f / aNode.mScalingChannel.mValues[spos2], sf);
 
 			inverseLocalTransform = // compute S^-1 * R^-1 * T^-1
 				glm::mat4{ glm::vec4{scaling.x, 0.f, 0.f, 0.f}, glm::vec4{0.f, scaling.y, 0.f, 0.f}, glm::vec4{0.f, 0.f, scaling.z, 0.f}, glm::vec4{0.f, 0.f, 0.f, 1.f} } *
@@ -268,6 +273,73 @@ namespace avk
 		}
 	}
 
+	void animation::animate_batch_into_strided_targets(std::span<const animation_instance> aInstances, work_stealing_pool& aPool, bone_matrices_space aTargetSpace, std::optional<size_t> aMaxMeshes, std::optional<size_t> aMaxBonesPerMesh) const
+	{
+		// Validate on the calling thread, before any work is started:
+		for (const auto& instance : aInstances) {
+			if (instance.mClip.mTicksPerSecond == 0.0) {
+				throw avk::runtime_error("animation_clip_data::mTicksPerSecond may not be 0.0 => set a different value!");
+			}
+			if (instance.mClip.mAnimationIndex != mAnimationIndex) {
+				throw avk::runtime_error("The animation index of the passed animation_clip_data is not the same that was used to create this animation.");
+			}
+		}
+		if (bone_matrices_space::mesh_space != aTargetSpace && bone_matrices_space::model_space != aTargetSpace) {
+			throw avk::runtime_error("Unknown target space value.");
+		}
+
+		const auto maxMeshes = aMaxMeshes.value_or(std::numeric_limits<size_t>::max());
+		const auto maxBones = aMaxBonesPerMesh.value_or(std::numeric_limits<size_t>::max());
+		aPool.parallel_for(aInstances.size(), [&](size_t i) {
+			animate_instance_into_strided_target(aInstances[i], aTargetSpace, maxMeshes, maxBones);
+		});
+	}
+
+	void animation::animate_instance_into_strided_target(const animation_instance& aInstance, bone_matrices_space aTargetSpace, size_t aMaxMeshes, size_t aMaxBonesPerMesh) const
+	{
+		// The global transforms of the instance's nodes; every thread reuses its own storage:
+		thread_local std::vector<glm::mat4> globalTransforms;
+		const auto an = mAnimationData.size();
+		globalTransforms.resize(an);
+
+		keyframe_cursor* cursors = nullptr;
+		if (nullptr != aInstance.mCursors) {
+			if (aInstance.mCursors->size() != an) {
+				aInstance.mCursors->resize(an);
+			}
+			cursors = aInstance.mCursors->data();
+		}
+
+		// Same computations as in animate(), s.t. the results are bit-identical:
+		double timeInTicks = aInstance.mTime * aInstance.mClip.mTicksPerSecond;
+		auto* target = reinterpret_cast<uint8_t*>(aInstance.mTargetMemory);
+		for (size_t ai = 0; ai < an; ++ai) {
+			const auto& anode = mAnimationData[ai];
+			auto localTransform = compute_node_local_transform(anode, timeInTicks, nullptr != cursors ? &cursors[ai] : nullptr);
+
+			if (anode.mAnimatedParentIndex.has_value()) {
+				globalTransforms[ai] = globalTransforms[anode.mAnimatedParentIndex.value()] * anode.mParentTransform * localTransform;
+			}
+			else {
+				globalTransforms[ai] = anode.mParentTransform * localTransform;
+			}
+
+			for (const auto& boneMeshTarget : anode.mBoneMeshTargets) {
+				const auto& info = boneMeshTarget.mMeshBoneInfo;
+				if (info.mMeshAnimationIndex >= aMaxMeshes || info.mMeshLocalBoneIndex >= aMaxBonesPerMesh) {
+					continue;
+				}
+				auto* boneMatrix = reinterpret_cast<glm::mat4*>(target + info.mMeshAnimationIndex * aInstance.mMeshStride + info.mMeshLocalBoneIndex * aInstance.mMatricesStride);
+				if (bone_matrices_space::mesh_space == aTargetSpace) {
+					*boneMatrix = boneMeshTarget.mInverseMeshRootMatrix * globalTransforms[ai] * boneMeshTarget.mInverseBindPoseMatrix;
+				}
+				else {
+					*boneMatrix = globalTransforms[ai] * boneMeshTarget.mInverseBindPoseMatrix;
+				}
+			}
+		}
+	}
+
 	std::vector<double> animation::animation_key_times_for_clip_in_ticks(const animation_clip_data& aClip) const
 	{
 		const double cMachineEpsilon = 2.3e-16;
@@ -327,6 +399,37 @@ namespace avk
 		return result;
 	}
 
+	animation animation::from_animated_nodes(std::vector<animated_node> aAnimatedNodes, uint32_t aAnimationIndex, size_t aMaxNumBoneMatrices)
+	{
+		animation result;
+		result.mAnimationData = std::move(aAnimatedNodes);
+		result.mAnimationIndex = aAnimationIndex;
+		result.mMaxNumBoneMatrices = aMaxNumBoneMatrices;
+		result.pack_keys();
+		return result;
+	}
+
+	void animation::pack_keys()
+	{
+		auto packChannel = [](const auto& aKeys, auto& aChannel) {
+			aChannel.mTimes.clear();
+			aChannel.mValues.clear();
+			aChannel.mTimes.reserve(aKeys.size());
+			aChannel.mValues.reserve(aKeys.size());
+			for (const auto& key : aKeys) {
+				aChannel.mTimes.push_back(key.mTime);
+				aChannel.mValues.push_back(key.mValue);
+			}
+		};
+
+		for (auto& anode : mAnimationData) {
+			packChannel(anode.mPositionKeys, anode.mPositionChannel);
+			packChannel(anode.mRotationKeys, anode.mRotationChannel);
+			packChannel(anode.mScalingKeys, anode.mScalingChannel);
+		}
+		mCursors.assign(mAnimationData.size(), keyframe_cursor{});
+	}
+
 	size_t animation::number_of_animated_nodes() const
 	{
 		return mAnimationData.size();
@@ -432,4 +535,279 @@ namespace avk
 		}
 		return result;
 	}
+
+	packed_quat pack_quat(const glm::quat& aQuat)
+	{
+		constexpr float cRange = 0.70710678118f; // 1/sqrt(2), i.e. the maximum magnitude of the three smallest components
+		constexpr float cMaxQuantized = 32767.0f;  // 15 bits
+
+		const float c[4] = { aQuat.x, aQuat.y, aQuat.z, aQuat.w };
+		uint16_t largest = 0;
+		for (uint16_t i = 1; i < 4; ++i) {
+			if (std::abs(c[i]) > std::abs(c[largest])) {
+				largest = i;
+			}
+		}
+		// q and -q represent the same rotation => make the dropped component positive:
+		const float sign = c[largest] < 0.0f ? -1.0f : 1.0f;
+
+		packed_quat result{};
+		for (uint16_t i = 0, j = 0; i < 4; ++i) {
+			if (i == largest) {
+				continue;
+			}
+			const auto normalized = std::clamp((sign * c[i] / cRange) * 0.5f + 0.5f, 0.0f, 1.0f);
+			result.mComponents[j++] = static_cast<uint16_t>(std::lround(normalized * cMaxQuantized));
+		}
+		result.mComponents[0] |= static_cast<uint16_t>((largest & 1u) << 15);
+		result.mComponents[1] |= static_cast<uint16_t>((largest >> 1) << 15);
+		return result;
+	}
+
+	glm::quat unpack_quat(const packed_quat& aPacked)
+	{
+		constexpr float cRange = 0.70710678118f;
+		constexpr float cMaxQuantized = 32767.0f;
+
+		const uint16_t largest = static_cast<uint16_t>((aPacked.mComponents[0] >> 15) | ((aPacked.mComponents[1] >> 15) << 1));
+		float c[4];
+		float sumOfSquares = 0.0f;
+		for (uint16_t i = 0, j = 0; i < 4; ++i) {
+			if (i == largest) {
+				continue;
+			}
+			const auto quantized = static_cast<float>(aPacked.mComponents[j++] & 0x7FFFu);
+			c[i] = (quantized / cMaxQuantized * 2.0f - 1.0f) * cRange;
+			sumOfSquares += c[i] * c[i];
+		}
+		c[largest] = std::sqrt(std::max(0.0f, 1.0f - sumOfSquares));
+		return glm::normalize(glm::quat{ c[3], c[0], c[1], c[2] });
+	}
+
+	bool compressed_animation_clip::has_keys(size_t aNodeIndex) const
+	{
+		const auto& node = mNodes[aNodeIndex];
+		return node.mPositions.size() + node.mRotations.size() + node.mScalings.size() > 0;
+	}
+
+	double compressed_animation_clip::frame_at(double aTimeInTicks) const
+	{
+		return (aTimeInTicks - mClip.mStartTicks) / mClip.mTicksPerSecond * mFramesPerSecond;
+	}
+
+	glm::vec3 compressed_animation_clip::compute_node_local_translation(size_t aNodeIndex, double aTimeInTicks, size_t* aCursor) const
+	{
+		const auto& channel = mNodes[aNodeIndex].mPositions;
+		if (channel.empty()) {
+			return glm::vec3{ 0.0f };
+		}
+		const auto frame = frame_at(aTimeInTicks);
+		auto [pos1, pos2] = animation::find_positions_in_keys(channel.mFrames, frame, aCursor);
+		auto f = animation::get_interpolation_factor(channel.mFrames[pos1], channel.mFrames[pos2], frame);
+		return glm::lerp(channel.mValues[pos1], channel.mValues[pos2], f);
+	}
+
+	glm::quat compressed_animation_clip::compute_node_local_rotation(size_t aNodeIndex, double aTimeInTicks, size_t* aCursor) const
+	{
+		const auto& channel = mNodes[aNodeIndex].mRotations;
+		if (channel.empty()) {
+			return glm::quat{ 1.0f, 0.0f, 0.0f, 0.0f };
+		}
+		const auto frame = frame_at(aTimeInTicks);
+		auto [pos1, pos2] = animation::find_positions_in_keys(channel.mFrames, frame, aCursor);
+		auto f = animation::get_interpolation_factor(channel.mFrames[pos1], channel.mFrames[pos2], frame);
+		return glm::normalize(glm::slerp(unpack_quat(channel.mValues[pos1]), unpack_quat(channel.mValues[pos2]), f));
+	}
+
+	glm::vec3 compressed_animation_clip::compute_node_local_scale(size_t aNodeIndex, double aTimeInTicks, size_t* aCursor) const
+	{
+		const auto& channel = mNodes[aNodeIndex].mScalings;
+		if (channel.empty()) {
+			return glm::vec3{ 1.0f };
+		}
+		const auto frame = frame_at(aTimeInTicks);
+		auto [pos1, pos2] = animation::find_positions_in_keys(channel.mFrames, frame, aCursor);
+		auto f = animation::get_interpolation_factor(channel.mFrames[pos1], channel.mFrames[pos2], frame);
+		return glm::lerp(channel.mValues[pos1], channel.mValues[pos2], f);
+	}
+
+	glm::mat4 compressed_animation_clip::compute_node_local_transform(size_t aNodeIndex, double aTimeInTicks, keyframe_cursor* aCursor) const
+	{
+		return matrix_from_transforms(
+			compute_node_local_translation(aNodeIndex, aTimeInTicks, nullptr != aCursor ? &aCursor->mPosition : nullptr),
+			compute_node_local_rotation(aNodeIndex, aTimeInTicks, nullptr != aCursor ? &aCursor->mRotation : nullptr),
+			compute_node_local_scale(aNodeIndex, aTimeInTicks, nullptr != aCursor ? &aCursor->mScaling : nullptr)
+		);
+	}
+
+	namespace
+	{
+		/**	Maximum number of consecutive keys which are replaced by one interpolated segment. This bounds the
+		 *	(quadratic) cost of the key reduction for long, smooth channels.
+		 */
+		constexpr size_t cMaxKeysPerSegment = 256;
+
+		/**	Greedily drops keys of a channel: A key is dropped if all keys between the previously kept key and the
+		 *	key after it can be interpolated from those two within aTolerance.
+		 *	@param	aFrames			Frame indices of all keys, strictly ascending
+		 *	@param	aValues			Values of all keys
+		 *	@param	aInterpolate	Interpolates between two values: T(const T&, const T&, float)
+		 *	@param	aError			Measures the error between two values: float(const T&, const T&)
+		 *	@return	Indices of the keys which are kept
+		 */
+		template <typename T, typename I, typename E>
+		std::vector<size_t> reduce_keys(const std::vector<uint16_t>& aFrames, const std::vector<T>& aValues, float aTolerance, I aInterpolate, E aError)
+		{
+			const auto n = aFrames.size();
+			std::vector<size_t> kept{ 0 };
+			size_t start = 0;
+			for (size_t end = 2; end < n; ++end) {
+				bool representable = end - start <= cMaxKeysPerSegment;
+				for (size_t k = start + 1; k < end && representable; ++k) {
+					const auto f = static_cast<float>(aFrames[k] - aFrames[start]) / static_cast<float>(aFrames[end] - aFrames[start]);
+					representable = aError(aInterpolate(aValues[start], aValues[end], f), aValues[k]) <= aTolerance;
+				}
+				if (!representable) {
+					kept.push_back(end - 1);
+					start = end - 1;
+				}
+			}
+			if (n > 1) {
+				kept.push_back(n - 1);
+			}
+			return kept;
+		}
+
+		/** Angle between two rotations in radians. (atan2 stays accurate for small angles, unlike acos of the dot product.) */
+		float rotation_error(const glm::quat& a, const glm::quat& b)
+		{
+			const auto d = glm::conjugate(a) * b;
+			return 2.0f * std::atan2(glm::length(glm::vec3{ d.x, d.y, d.z }), std::abs(d.w));
+		}
+
+		float vector_error(const glm::vec3& a, const glm::vec3& b)
+		{
+			return glm::length(a - b);
+		}
+	}
+
+	compressed_animation_clip animation::compress_clip(const animation_clip_data& aClip, const animation_compression_settings& aSettings) const
+	{
+		if (aClip.mTicksPerSecond == 0.0) {
+			throw avk::runtime_error("animation_clip_data::mTicksPerSecond may not be 0.0 => set a different value!");
+		}
+		if (aClip.mAnimationIndex != mAnimationIndex) {
+			throw avk::runtime_error("The animation index of the passed animation_clip_data is not the same that was used to create this animation.");
+		}
+		if (aSettings.mFramesPerSecond <= 0.0 || aClip.mEndTicks < aClip.mStartTicks) {
+			throw avk::runtime_error("Invalid frame rate or clip range passed to animation::compress_clip.");
+		}
+
+		const double framesPerTick = aSettings.mFramesPerSecond / aClip.mTicksPerSecond;
+		const double lastFrame = std::ceil((aClip.mEndTicks - aClip.mStartTicks) * framesPerTick);
+		if (lastFrame > static_cast<double>(std::numeric_limits<uint16_t>::max())) {
+			throw avk::runtime_error(std::format("The clip is {} frames long, which exceeds the 16-bit frame indices of compressed clips => use a lower frame rate.", lastFrame));
+		}
+		auto toFrame = [&](double aTicks) {
+			return static_cast<uint16_t>(std::clamp(std::round((aTicks - aClip.mStartTicks) * framesPerTick), 0.0, lastFrame));
+		};
+
+		compressed_animation_clip result;
+		result.mClip = aClip;
+		result.mFramesPerSecond = aSettings.mFramesPerSecond;
+		result.mNodes.resize(mAnimationData.size());
+		auto& stats = result.mStatistics;
+
+		// Compresses one channel: Samples it at the clip's boundaries and at all keys in between, snaps the times
+		// to frames, quantizes the values, and drops redundant keys:
+		auto compressChannel = [&](const std::vector<double>& aTimes, auto aSample, auto aQuantize, auto aDequantize, float aTolerance, auto aInterpolate, auto aError, auto& aTarget, size_t aRawKeySize) {
+			std::vector<uint16_t> frames;
+			std::vector<decltype(aQuantize(aSample(0.0)))> quantized;
+			// The errors are measured against the values which the sampler will actually see:
+			std::vector<decltype(aDequantize(quantized.front()))> values;
+			auto addKey = [&](double aTicks) {
+				const auto frame = toFrame(aTicks);
+				const auto value = aQuantize(aSample(aTicks));
+				if (frames.empty() || frames.back() != frame) {
+					frames.push_back(frame);
+					quantized.push_back(value);
+					values.push_back(aDequantize(value));
+				}
+				else {
+					// Several keys snap to the same frame => keep the last one
+					quantized.back() = value;
+					values.back() = aDequantize(value);
+				}
+			};
+
+			addKey(aClip.mStartTicks);
+			for (const auto t : aTimes) {
+				if (t >= aClip.mStartTicks && t <= aClip.mEndTicks) {
+					++stats.mNumRawKeys;
+					stats.mRawBytes += aRawKeySize;
+				}
+				if (t > aClip.mStartTicks && t < aClip.mEndTicks) {
+					addKey(t);
+				}
+			}
+			addKey(aClip.mEndTicks);
+
+			for (const auto k : reduce_keys(frames, values, aTolerance, aInterpolate, aError)) {
+				aTarget.mFrames.push_back(frames[k]);
+				aTarget.mValues.push_back(quantized[k]);
+			}
+			stats.mNumCompressedKeys += aTarget.size();
+			stats.mCompressedBytes += aTarget.size() * (sizeof(uint16_t) + sizeof(aTarget.mValues.front()));
+		};
+
+		auto identity = [](const auto& aValue) { return aValue; };
+		auto lerpVectors = [](const glm::vec3& a, const glm::vec3& b, float f) { return glm::lerp(a, b, f); };
+		auto slerpRotations = [](const glm::quat& a, const glm::quat& b, float f) { return glm::normalize(glm::slerp(a, b, f)); };
+
+		const auto an = mAnimationData.size();
+		for (size_t ai = 0; ai < an; ++ai) {
+			const auto& anode = mAnimationData[ai];
+			auto& target = result.mNodes[ai];
+			if (!anode.mPositionChannel.empty()) {
+				compressChannel(anode.mPositionChannel.mTimes, [&](double t) { return compute_node_local_translation(anode, t); },
+					identity, identity, aSettings.mMaxPositionError, lerpVectors, vector_error, target.mPositions, sizeof(position_key));
+			}
+			if (!anode.mRotationChannel.empty()) {
+				compressChannel(anode.mRotationChannel.mTimes, [&](double t) { return compute_node_local_rotation(anode, t); },
+					[](const glm::quat& q) { return pack_quat(q); }, [](const packed_quat& p) { return unpack_quat(p); },
+					aSettings.mMaxRotationError, slerpRotations, rotation_error, target.mRotations, sizeof(rotation_key));
+			}
+			if (!anode.mScalingChannel.empty()) {
+				compressChannel(anode.mScalingChannel.mTimes, [&](double t) { return compute_node_local_scale(anode, t); },
+					identity, identity, aSettings.mMaxScaleError, lerpVectors, vector_error, target.mScalings, sizeof(scaling_key));
+			}
+
+			// Measure the actual errors at all keys within the clip, and half-way between them:
+			std::set<double> times{ aClip.mStartTicks, aClip.mEndTicks };
+			for (const auto* channelTimes : { &anode.mPositionChannel.mTimes, &anode.mRotationChannel.mTimes, &anode.mScalingChannel.mTimes }) {
+				for (size_t i = 0; i < channelTimes->size(); ++i) {
+					const auto t = (*channelTimes)[i];
+					if (t > aClip.mStartTicks && t < aClip.mEndTicks) {
+						times.insert(t);
+					}
+				}
+			}
+			for (auto it = times.begin(); it != times.end(); ++it) {
+				const auto next = std::next(it);
+				for (const auto t : { *it, next != times.end() ? (*it + *next) * 0.5 : *it }) {
+					if (!target.mPositions.empty()) {
+						stats.mMaxPositionError = std::max(stats.mMaxPositionError, vector_error(compute_node_local_translation(anode, t), result.compute_node_local_translation(ai, t)));
+					}
+					if (!target.mRotations.empty()) {
+						stats.mMaxRotationError = std::max(stats.mMaxRotationError, rotation_error(compute_node_local_rotation(anode, t), result.compute_node_local_rotation(ai, t)));
+					}
+					if (!target.mScalings.empty()) {
+						stats.mMaxScaleError = std::max(stats.mMaxScaleError, vector_error(compute_node_local_scale(anode, t), result.compute_node_local_scale(ai, t)));
+					}
+				}
+			}
+		}
+
+		return result;
+	}
 }
@@ -1,3 +1,4 @@
+#include <cstring>
 #include <set>
 #include "context_vulkan.hpp"
 #include "context_generic_glfw.hpp"
@@ -51,6 +52,15 @@ namespace avk
 		
 		mLogicalDevice.waitIdle();
 
+		// The staging rings' buffers must be gone before their allocator:
+		destroy_staging_rings();
+
+		if (mPipelineCache) {
+			save_pipeline_cache();
+			mLogicalDevice.destroyPipelineCache(mPipelineCache);
+			mPipelineCache = nullptr;
+		}
+
 #if defined(AVK_USE_VMA)
 		vmaDestroyAllocator(mMemoryAllocator);
 #endif
@@ -232,7 +242,14 @@ namespace avk
 			.setShadingRateCoarseSampleOrder(VK_TRUE);
 		auto activateShadingRateImage = shading_rate_image_extension_requested() && supports_shading_rate_image(context().physical_device());
 
-		auto queueCreateInfos = avk::queue::get_queue_config_for_DeviceCreateInfo(std::begin(mQueues), std::end(mQueues));
+		// Queues which share the handle of another queue (see create_queue) must not be requested twice:
+		std::vector<avk::queue> distinctQueues;
+		for (const auto& q : mQueues) {
+			if (std::none_of(std::begin(distinctQueues), std::end(distinctQueues), [&q](const avk::queue& dq) { return dq.family_index() == q.family_index() && dq.queue_index() == q.queue_index(); })) {
+				distinctQueues.push_back(avk::queue::prepare(this, q.family_index(), q.queue_index(), q.priority()));
+			}
+		}
+		auto queueCreateInfos = avk::queue::get_queue_config_for_DeviceCreateInfo(std::begin(distinctQueues), std::end(distinctQueues));
 		// Iterate over all vk::DeviceQueueCreateInfo entries and set the queue priorities pointers properly (just to be safe!)
 		for (auto i = 0; i < std::get<0>(queueCreateInfos).size(); ++i) {
 			std::get<0>(queueCreateInfos)[i].setPQueuePriorities(std::get<1>(queueCreateInfos)[i].data());
@@ -341,6 +358,8 @@ namespace avk
 			}
 		}
 
+		create_pipeline_cache();
+
 		mContextState = context_state::device_created;
 		work_off_event_handlers();
 		
@@ -366,7 +385,12 @@ namespace avk
 		allocatorInfo.device = device();
 		allocatorInfo.instance = vulkan_instance();
 		if (std::find(std::begin(mSettings.mRequiredDeviceExtensions.mExtensions), std::end(mSettings.mRequiredDeviceExtensions.mExtensions), std::string(VK_KHR_BUFFER_DEVICE_ADDRESS_EXTENSION_NAME)) != std::end(mSettings.mRequiredDeviceExtensions.mExtensions)) {
-			allocatorInfo.flags = VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT;
+			allocatorInfo.flags |= VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT;
+		}
+		if (memory_budget_extension_requested()) {
+			// Let vmaGetHeapBudgets query the driver instead of estimating. It uses vkGetPhysicalDeviceMemoryProperties2, which is core in Vulkan 1.1:
+			allocatorInfo.vulkanApiVersion = VK_API_VERSION_1_1;
+			allocatorInfo.flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
 		}
 		vmaCreateAllocator(&allocatorInfo, &mMemoryAllocator);
 #else
@@ -525,22 +549,26 @@ namespace avk
 			}
 			auto queueFamily = avk::queue::select_queue_family_index(context().physical_device(), aRequiredFlags, aQueueSelectionPreference, surfaceSupport);
 
-			// Do we already have queues with that queue family?
-			auto num = std::count_if(std::begin(mQueues), std::end(mQueues), [queueFamily](const avk::queue& q) { return q.is_prepared() && q.family_index() == queueFamily; });
-#ifdef _DEBUG
-			// The previous queues must be consecutively numbered. If they are not.... I have no explanation for it.
-			std::vector<int> check(num, 0);
-			for (int i = 0; i < num; ++i) {
-				if (mQueues[i].family_index() == queueFamily) {
-					check[mQueues[i].queue_index()]++;
+			// Do we already have queues with that queue family? (Queues which share another one's handle are counted once.)
+			std::set<uint32_t> usedQueueIndices;
+			for (const auto& q : mQueues) {
+				if (q.is_prepared() && q.family_index() == queueFamily) {
+					usedQueueIndices.insert(q.queue_index());
 				}
 			}
-			for (int i = 0; i < num; ++i) {
-				assert(check[i] == 1);
+			const auto num = static_cast<uint32_t>(usedQueueIndices.size());
+			// The previous queues must be consecutively numbered. If they are not.... I have no explanation for it.
+			assert(usedQueueIndices.empty() || *usedQueueIndices.rbegin() + 1 == num);
+
+			const auto familyQueueCount = context().physical_device().getQueueFamilyProperties()[queueFamily].queueCount;
+			if (num >= familyQueueCount) {
+				// The family is exhausted => share the last of its queues instead of failing:
+				LOG_WARNING(std::format("Queue family #{} does not provide another queue. The new queue shares queue #{} of that family.", queueFamily, familyQueueCount - 1));
+				nuQu = avk::queue::prepare(this, queueFamily, familyQueueCount - 1, aQueuePriority);
+			}
+			else {
+				nuQu = avk::queue::prepare(this, queueFamily, num, aQueuePriority);
 			}
-#endif
-			
-			nuQu = avk::queue::prepare(this, queueFamily, static_cast<uint32_t>(num), aQueuePriority);
 
 			return true;
 		});
@@ -954,6 +982,12 @@ namespace avk
 		return std::find(std::begin(devex), std::end(devex), std::string(VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME)) != std::end(devex);
 	}
 
+	bool context_vulkan::memory_budget_extension_requested()
+	{
+		const auto& devex = get_all_enabled_device_extensions();
+		return std::find(std::begin(devex), std::end(devex), std::string(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME)) != std::end(devex);
+	}
+
 #if VK_HEADER_VERSION >= 162
 	bool context_vulkan::ray_tracing_pipeline_extension_requested()
 	{
@@ -1135,6 +1169,84 @@ namespace avk
 		LOG_INFO(std::format("Going to use {}", mPhysicalDevice.getProperties().deviceName.data()));
 	}
 
+	void context_vulkan::create_pipeline_cache()
+	{
+		std::vector<uint8_t> initialData;
+		const auto& path = mSettings.mPipelineCacheFile.mValue;
+		if (!path.empty() && std::filesystem::exists(path)) {
+			std::ifstream file(path, std::ios::binary);
+			initialData.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+			// Validate the header (see VkPipelineCacheHeaderVersionOne): the driver would ignore data of another
+			// device or driver version anyways, but we must not even pass it data which is malformed.
+			struct
+			{
+				uint32_t mHeaderSize;
+				uint32_t mHeaderVersion;
+				uint32_t mVendorId;
+				uint32_t mDeviceId;
+				uint8_t mPipelineCacheUuid[VK_UUID_SIZE];
+			} header{};
+			static_assert(sizeof(header) == 16 + VK_UUID_SIZE);
+			const auto props = physical_device().getProperties();
+			if (initialData.size() >= sizeof(header)) {
+				std::memcpy(&header, initialData.data(), sizeof(header));
+			}
+			const char* mismatch = nullptr;
+			if (initialData.size() < sizeof(header) || header.mHeaderSize < sizeof(header) || header.mHeaderSize > initialData.size()) {
+				mismatch = "the file is too small";
+			}
+			else if (header.mHeaderVersion != static_cast<uint32_t>(vk::PipelineCacheHeaderVersion::eOne)) {
+				mismatch = "the header version is unknown";
+			}
+			else if (header.mVendorId != props.vendorID || header.mDeviceId != props.deviceID) {
+				mismatch = "it has been written for another device";
+			}
+			else if (0 != std::memcmp(header.mPipelineCacheUuid, props.pipelineCacheUUID.data(), VK_UUID_SIZE)) {
+				mismatch = "it has been written by another driver version";
+			}
+			if (nullptr != mismatch) {
+				LOG_INFO(std::format("Ignoring pipeline cache file '{}', because {}.", path, mismatch));
+				initialData.clear();
+			}
+		}
+
+		auto createInfo = vk::PipelineCacheCreateInfo{}
+			.setInitialDataSize(initialData.size())
+			.setPInitialData(initialData.empty() ? nullptr : initialData.data());
+		mPipelineCache = device().createPipelineCache(createInfo, nullptr, dispatch_loader_core());
+		mPipelineCacheLoadedFromFile = !initialData.empty();
+		if (mPipelineCacheLoadedFromFile) {
+			LOG_INFO(std::format("Loaded {} bytes of pipeline cache data from '{}'.", initialData.size(), path));
+		}
+	}
+
+	void context_vulkan::save_pipeline_cache() const
+	{
+		const auto& path = mSettings.mPipelineCacheFile.mValue;
+		if (path.empty() || !mPipelineCache) {
+			return;
+		}
+		const auto data = mLogicalDevice.getPipelineCacheData(mPipelineCache, dispatch_loader_core());
+		const auto tempPath = path + ".tmp";
+		{
+			std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+			file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+			if (!file.good()) {
+				LOG_WARNING(std::format("Could not write the pipeline cache to '{}'.", tempPath));
+				return;
+			}
+		}
+		std::error_code error;
+		std::filesystem::rename(tempPath, path, error);
+		if (error) {
+			LOG_WARNING(std::format("Could not replace the pipeline cache file '{}': {}", path, error.message()));
+			std::filesystem::remove(tempPath, error);
+			return;
+		}
+		LOG_DEBUG(std::format("Saved {} bytes of pipeline cache data to '{}'.", data.size(), path));
+	}
+
 	glm::uvec2 context_vulkan::get_resolution_for_window(window* aWindow)
 	{
 		auto srfCaps = mPhysicalDevice.getSurfaceCapabilitiesKHR(aWindow->surface());
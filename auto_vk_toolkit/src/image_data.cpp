@@ -300,7 +300,8 @@ namespace avk
 
 		void load()
 		{
-			stbi_set_flip_vertically_on_load(mFlip);
+			// Use the thread-local setting, since images can be loaded on multiple threads concurrently (see parallel_image_loader):
+			stbi_set_flip_vertically_on_load_thread(mFlip);
 
 			int w = 0, h = 0;
 
@@ -511,5 +512,54 @@ namespace avk
 
 		return retval;
 	}
-	
+
+	parallel_image_loader::parallel_image_loader(std::vector<image_data> aImages, uint32_t aNumThreads)
+		: mImages{ std::move(aImages) }
+		, mLoaded(mImages.size())
+		, mNextIndex{ 0 }
+		, mCancelled{ false }
+	{
+		mLoadedFutures.reserve(mLoaded.size());
+		for (auto& p : mLoaded) {
+			mLoadedFutures.push_back(p.get_future());
+		}
+
+		if (0 == aNumThreads) {
+			aNumThreads = std::max(std::thread::hardware_concurrency(), 1u);
+		}
+		const auto numWorkers = std::min(static_cast<size_t>(aNumThreads), mImages.size());
+		mWorkers.reserve(numWorkers);
+		for (size_t i = 0; i < numWorkers; ++i) {
+			mWorkers.emplace_back([this]() { work(); });
+		}
+	}
+
+	parallel_image_loader::~parallel_image_loader()
+	{
+		mCancelled = true;
+		for (auto& w : mWorkers) {
+			w.join();
+		}
+	}
+
+	image_data parallel_image_loader::take(size_t aIndex)
+	{
+		mLoadedFutures[aIndex].get();
+		return std::move(mImages[aIndex]);
+	}
+
+	void parallel_image_loader::work()
+	{
+		// Every worker picks the next image which has not been picked by any other worker. Images are picked
+		// in ascending order, so that the ones which are taken first also tend to be loaded first:
+		for (auto i = mNextIndex++; i < mImages.size() && !mCancelled; i = mNextIndex++) {
+			try {
+				mImages[i].load();
+				mLoaded[i].set_value();
+			}
+			catch (...) {
+				mLoaded[i].set_exception(std::current_exception());
+			}
+		}
+	}
 }
@@ -98,7 +98,7 @@ namespace avk
 		assert(mQueue);
 		init_info.QueueFamily = mQueue->family_index();
 		init_info.Queue = mQueue->handle();
-		init_info.PipelineCache = nullptr; // TODO: Maybe use a pipeline cache?
+		init_info.PipelineCache = context().pipeline_cache();
 
 		// This factor is set to 1000 in the imgui example code but after looking through the vulkan backend code, we never
 		// allocate more than one descriptor set, therefore setting this to 1 should be sufficient.
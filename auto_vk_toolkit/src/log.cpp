@@ -174,97 +174,42 @@ namespace avk
 
 #ifdef LOGGING_ON_SEPARATE_THREAD
 
-	void dispatch_log(log_pack pToBeLogged)
+	static log_queue_config& log_queue_configuration()
 	{
-		static std::mutex sLogMutex;
-		static std::condition_variable sCondVar;
-		static std::queue<log_pack> sLogQueue;
-		static bool sContinueLogging = true;
-		static std::thread sLogThread = std::thread([]() {
-			
-			avk::set_console_output_color(avk::log_type::system, avk::log_importance::important);
-			std::cout << "Logger thread started...";
-			avk::reset_console_output_color();
-			std::cout << std::endl;
-
-			while (sContinueLogging) {
-				// Process all messages
-				{
-					log_pack front;
-					bool empty;
-					// 1st lock => See if there is something
-					{
-						std::scoped_lock<std::mutex> guard(sLogMutex);
-						empty = sLogQueue.empty();
-						if (!empty)
-						{
-							front = sLogQueue.front();
-							sLogQueue.pop();
-						}
-					}
-
-					if (!sContinueLogging) continue;
-
-					// If we were able to successfully pop an element => handle it, i.e. print it
-					if (!empty)
-					{
-						// ACTUAL LOGGING:
-						avk::set_console_output_color(front.mLogType, front.mLogImportance);
-						std::cout << front.mMessage;
-						if (!front.mStacktrace.empty()) {
-							avk::set_console_output_color_for_stacktrace(front.mLogType, front.mLogImportance);
-							std::cout << front.mStacktrace;
-						}
-						avk::reset_console_output_color();
-
-						// 2nd lock => get correct empty-value
-						{
-							std::scoped_lock<std::mutex> guard(sLogMutex);
-							empty = sLogQueue.empty();
-							if (!empty) continue;
-						}
-					}
-				}
+		static log_queue_config sConfig;
+		return sConfig;
+	}
 
-				// No more messages => wait
-				{
-					std::unique_lock<std::mutex> lock(sLogMutex);
-					if (!sContinueLogging) {
-						break;
-					}
-					
-					sCondVar.wait(lock);
-				}
-			}
+	static log_queue& global_log_queue()
+	{
+		static log_queue sLogQueue{ log_queue_configuration() };
+		return sLogQueue;
+	}
 
-			avk::set_console_output_color(avk::log_type::system, avk::log_importance::important);
-			std::cout << "Logger thread terminating.";
-			avk::reset_console_output_color();
-			std::cout << std::endl;
-		});
-		
-		static struct thread_stopper {
-			~thread_stopper() {
-				{
-					std::unique_lock<std::mutex> lock(sLogMutex);
-					sContinueLogging = false;
-				}
-				sCondVar.notify_one();
-				sLogThread.join();
-			}
-		} sThreadStopper;
+	void configure_log_queue(log_queue_config aConfig)
+	{
+		log_queue_configuration() = std::move(aConfig);
+	}
 
-		// Enqueue the message and wake the logger thread
-		{
-			std::scoped_lock<std::mutex> guard(sLogMutex);
+	void dispatch_log(log_pack pToBeLogged)
+	{
 #if defined(_WIN32) && defined (_DEBUG) && defined (PRINT_STACKTRACE)
-			if (pToBeLogged.mLogType == log_type::error || pToBeLogged.mLogType == log_type::warning) {
-				pToBeLogged.mStacktrace = get_current_callstack();
-			}
-#endif
-			sLogQueue.push(pToBeLogged);
+		if (pToBeLogged.mLogType == log_type::error || pToBeLogged.mLogType == log_type::warning) {
+			pToBeLogged.mStacktrace = get_current_callstack();
 		}
-		sCondVar.notify_one();
+#endif
+		// Lock-free => the calling thread never waits for the logger thread (unless an error meets a full queue):
+		global_log_queue().push(pToBeLogged);
+	}
+
+	void flush_log()
+	{
+		global_log_queue().flush();
+	}
+
+	uint64_t num_dropped_log_messages()
+	{
+		return global_log_queue().num_dropped();
 	}
 #else
 	void dispatch_log(log_pack pToBeLogged)
@@ -279,6 +224,21 @@ namespace avk
 #endif
 		avk::reset_console_output_color();
 	}
+
+	void configure_log_queue(log_queue_config aConfig)
+	{
+		// Messages are written synchronously => there is no queue to configure
+	}
+
+	void flush_log()
+	{
+		std::cout.flush();
+	}
+
+	uint64_t num_dropped_log_messages()
+	{
+		return 0;
+	}
 #endif
 
 	std::string to_string(const glm::mat4& pMatrix)
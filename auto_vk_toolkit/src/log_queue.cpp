@@ -0,0 +1,246 @@
+#include "log_queue.hpp"
+
+namespace avk
+{
+	log_queue::log_queue(log_queue_config aConfig)
+		: mConfig{ std::move(aConfig) }
+		, mEnqueuePosition{ 0 }
+		, mNumDropped{ 0 }
+		, mPendingSignal{ false }
+		, mNumWritten{ 0 }
+		, mStop{ false }
+		, mDequeuePosition{ 0 }
+		, mNumReportedDrops{ 0 }
+		, mRingBufferNext{ 0 }
+		, mRingBufferWrapped{ false }
+	{
+		size_t capacity = 2;
+		while (capacity < mConfig.mCapacity) {
+			capacity *= 2;
+		}
+		mMask = capacity - 1;
+		mConfig.mMaxBatchSize = std::max<size_t>(mConfig.mMaxBatchSize, 1);
+
+		mSlots = std::vector<slot>(capacity);
+		for (uint64_t i = 0; i < capacity; ++i) {
+			mSlots[i].mSequence.store(i, std::memory_order_relaxed);
+			mSlots[i].mPack.mMessage.reserve(mConfig.mReservedMessageLength);
+		}
+		mBatch.reserve(mConfig.mMaxBatchSize * mConfig.mReservedMessageLength);
+		mRuns.reserve(mConfig.mMaxBatchSize * 2 + 1);
+		mRingBuffer.resize(mConfig.mRingBufferSinkSize);
+
+		if (!mConfig.mFileSinkPath.empty()) {
+			mFile.open(mConfig.mFileSinkPath, std::ios::out | std::ios::trunc | std::ios::binary);
+			if (!mFile.is_open()) {
+				throw avk::runtime_error("Could not open log file " + mConfig.mFileSinkPath);
+			}
+		}
+
+		mWriter = std::thread([this]() { writer_loop(); });
+	}
+
+	log_queue::~log_queue()
+	{
+		mStop.store(true);
+		wake_writer();
+		mWriter.join();
+	}
+
+	bool log_queue::try_push(const log_pack& aPack)
+	{
+		if (!enqueue(aPack)) {
+			mNumDropped.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+		return true;
+	}
+
+	void log_queue::push(const log_pack& aPack)
+	{
+		if (log_type::error != aPack.mLogType) {
+			try_push(aPack);
+			return;
+		}
+		while (!enqueue(aPack)) {
+			std::this_thread::yield();
+		}
+	}
+
+	bool log_queue::enqueue(const log_pack& aPack)
+	{
+		slot* target;
+		auto position = mEnqueuePosition.load(std::memory_order_relaxed);
+		while (true) {
+			target = &mSlots[position & mMask];
+			const auto sequence = target->mSequence.load(std::memory_order_acquire);
+			const auto difference = static_cast<int64_t>(sequence - position);
+			if (0 == difference) {
+				// The slot is free => try to claim it:
+				if (mEnqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+					break;
+				}
+			}
+			else if (difference < 0) {
+				// The slot still holds the message from one lap before => the queue is full:
+				return false;
+			}
+			else {
+				// Another producer has claimed this position in the meantime:
+				position = mEnqueuePosition.load(std::memory_order_relaxed);
+			}
+		}
+
+		// Copy into the slot's preallocated strings instead of moving, s.t. their capacity is retained:
+		target->mPack.mMessage.assign(aPack.mMessage);
+		target->mPack.mStacktrace.assign(aPack.mStacktrace);
+		target->mPack.mLogType = aPack.mLogType;
+		target->mPack.mLogImportance = aPack.mLogImportance;
+		// Publish the message. Sequentially consistent, s.t. either the writer thread sees this message after it has
+		// reset mPendingSignal, or wake_writer sees the reset signal:
+		target->mSequence.store(position + 1);
+
+		wake_writer();
+		return true;
+	}
+
+	void log_queue::flush()
+	{
+		// All positions up to here have been claimed; the writer thread advances past each of them once it is published:
+		const auto target = mEnqueuePosition.load();
+		auto written = mNumWritten.load(std::memory_order_acquire);
+		while (written < target) {
+			mNumWritten.wait(written, std::memory_order_acquire);
+			written = mNumWritten.load(std::memory_order_acquire);
+		}
+		// The writer thread updates mNumWritten after it has written to the sinks, but stdout might be buffered elsewhere:
+		if (mConfig.mConsoleSink) {
+			std::cout.flush();
+		}
+	}
+
+	std::vector<std::string> log_queue::recent_messages() const
+	{
+		std::scoped_lock lock(mRingBufferMutex);
+		std::vector<std::string> result;
+		if (mRingBufferWrapped) {
+			result.insert(result.end(), mRingBuffer.begin() + mRingBufferNext, mRingBuffer.end());
+		}
+		result.insert(result.end(), mRingBuffer.begin(), mRingBuffer.begin() + mRingBufferNext);
+		return result;
+	}
+
+	void log_queue::wake_writer()
+	{
+		// Only the first producer after the writer thread has gone to sleep pays for the notification:
+		if (!mPendingSignal.load() && !mPendingSignal.exchange(true)) {
+			mPendingSignal.notify_one();
+		}
+	}
+
+	void log_queue::writer_loop()
+	{
+		while (true) {
+			// Reset the signal before draining, s.t. messages which are published from now on wake us up again:
+			mPendingSignal.store(false);
+			while (write_batch() > 0) {
+			}
+			if (mStop.load()) {
+				// Messages might have been published since the last batch:
+				while (write_batch() > 0) {
+				}
+				break;
+			}
+			mPendingSignal.wait(false);
+		}
+		if (mConfig.mConsoleSink) {
+			std::fflush(stdout);
+		}
+	}
+
+	size_t log_queue::write_batch()
+	{
+		mBatch.clear();
+		mRuns.clear();
+
+		const auto dropped = mNumDropped.load(std::memory_order_relaxed);
+		if (dropped > mNumReportedDrops) {
+			append_to_batch(std::format("LOG:  {} messages dropped, because the log queue was full\n", dropped - mNumReportedDrops), log_type::system, log_importance::important, false);
+			mNumReportedDrops = dropped;
+		}
+
+		size_t count = 0;
+		while (count < mConfig.mMaxBatchSize) {
+			auto& source = mSlots[mDequeuePosition & mMask];
+			if (source.mSequence.load() != mDequeuePosition + 1) {
+				// Empty, or the producer of the next message has not finished copying it yet:
+				break;
+			}
+			append_to_batch(source.mPack.mMessage, source.mPack.mLogType, source.mPack.mLogImportance, false);
+			if (!source.mPack.mStacktrace.empty()) {
+				append_to_batch(source.mPack.mStacktrace, source.mPack.mLogType, source.mPack.mLogImportance, true);
+			}
+			if (!mRingBuffer.empty()) {
+				std::scoped_lock lock(mRingBufferMutex);
+				mRingBuffer[mRingBufferNext].assign(source.mPack.mMessage);
+				if (++mRingBufferNext == mRingBuffer.size()) {
+					mRingBufferNext = 0;
+					mRingBufferWrapped = true;
+				}
+			}
+			// Hand the slot back to the producers as soon as its contents have been copied:
+			source.mSequence.store(mDequeuePosition + mSlots.size(), std::memory_order_release);
+			++mDequeuePosition;
+			++count;
+		}
+
+		if (!mBatch.empty()) {
+			write_to_sinks();
+		}
+		if (count > 0) {
+			mNumWritten.store(mDequeuePosition, std::memory_order_release);
+			mNumWritten.notify_all();
+		}
+		return count;
+	}
+
+	void log_queue::append_to_batch(const std::string& aText, log_type aLogType, log_importance aLogImportance, bool aIsStacktrace)
+	{
+		mBatch.append(aText);
+		if (!mRuns.empty() && mRuns.back().mLogType == aLogType && mRuns.back().mLogImportance == aLogImportance && mRuns.back().mIsStacktrace == aIsStacktrace) {
+			mRuns.back().mEnd = mBatch.size();
+		}
+		else {
+			mRuns.push_back(text_run{ aLogType, aLogImportance, aIsStacktrace, mBatch.size() });
+		}
+	}
+
+	void log_queue::write_to_sinks()
+	{
+		if (mConfig.mConsoleSink) {
+#ifdef _WIN32
+			// Console colors apply to everything which is written after they have been set => one write per run:
+			size_t begin = 0;
+			for (const auto& run : mRuns) {
+				if (run.mIsStacktrace) {
+					set_console_output_color_for_stacktrace(run.mLogType, run.mLogImportance);
+				}
+				else {
+					set_console_output_color(run.mLogType, run.mLogImportance);
+				}
+				std::fwrite(mBatch.data() + begin, 1, run.mEnd - begin, stdout);
+				std::fflush(stdout);
+				begin = run.mEnd;
+			}
+			reset_console_output_color();
+#else
+			std::fwrite(mBatch.data(), 1, mBatch.size(), stdout);
+			std::fflush(stdout);
+#endif
+		}
+		if (mFile.is_open()) {
+			mFile.write(mBatch.data(), static_cast<std::streamsize>(mBatch.size()));
+			mFile.flush();
+		}
+	}
+}
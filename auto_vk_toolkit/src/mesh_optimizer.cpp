@@ -0,0 +1,337 @@
+#include <numeric>
+
+#include "mesh_optimizer.hpp"
+
+namespace avk
+{
+	namespace
+	{
+		/** Simulates a FIFO post-transform vertex cache. A vertex is in the cache if fewer than mSize misses happened since its own miss. */
+		class fifo_cache_simulation
+		{
+		public:
+			fifo_cache_simulation(size_t aNumVertices, uint32_t aSize)
+				: mMissedAt(aNumVertices, 0)
+				, mSize{ aSize }
+				, mTime{ aSize + 1 }
+			{
+			}
+
+			/** Returns 1 if aVertex had to be transformed, 0 if it was in the cache */
+			uint32_t access(uint32_t aVertex)
+			{
+				if (mTime - mMissedAt[aVertex] > mSize) {
+					mMissedAt[aVertex] = mTime++;
+					return 1u;
+				}
+				return 0u;
+			}
+
+			/** Returns the number of vertices of triangle aTriangle which had to be transformed */
+			uint32_t access_triangle(const std::vector<uint32_t>& aIndices, size_t aTriangle)
+			{
+				return access(aIndices[aTriangle * 3]) + access(aIndices[aTriangle * 3 + 1]) + access(aIndices[aTriangle * 3 + 2]);
+			}
+
+			/** Evicts all vertices */
+			void clear()
+			{
+				mTime += mSize + 1;
+			}
+
+		private:
+			std::vector<uint32_t> mMissedAt;
+			uint32_t mSize;
+			uint32_t mTime;
+		};
+
+		// Parameters of Forsyth's vertex scores:
+		constexpr uint32_t cForsythCacheSize = 32;
+		constexpr float cForsythCacheDecayPower = 1.5f;
+		constexpr float cForsythLastTriangleScore = 0.75f;
+		constexpr float cForsythValenceBoostScale = 2.0f;
+		constexpr float cForsythValenceBoostPower = 0.5f;
+
+		constexpr uint32_t cForsythMaxTabulatedValence = 64;
+
+		/** Forsyth's vertex score, with the powers tabulated for cache positions and small numbers of remaining triangles */
+		class forsyth_vertex_scores
+		{
+		public:
+			forsyth_vertex_scores()
+			{
+				for (uint32_t i = 0; i < cForsythCacheSize; ++i) {
+					// Used by the last triangle => deliberately lower, s.t. strips do not just go back and forth:
+					mCacheScores[i] = i < 3 ? cForsythLastTriangleScore : std::pow(1.0f - static_cast<float>(i - 3) / static_cast<float>(cForsythCacheSize - 3), cForsythCacheDecayPower);
+				}
+				mValenceScores[0] = 0.0f;
+				for (uint32_t i = 1; i <= cForsythMaxTabulatedValence; ++i) {
+					mValenceScores[i] = valence_score(i);
+				}
+			}
+
+			float operator()(int aCachePosition, uint32_t aNumLiveTriangles) const
+			{
+				if (0 == aNumLiveTriangles) {
+					// No triangle left which could benefit from this vertex:
+					return -1.0f;
+				}
+				const auto cacheScore = aCachePosition >= 0 ? mCacheScores[aCachePosition] : 0.0f;
+				// Boost vertices with few remaining triangles, s.t. these are finished first:
+				return cacheScore + (aNumLiveTriangles <= cForsythMaxTabulatedValence ? mValenceScores[aNumLiveTriangles] : valence_score(aNumLiveTriangles));
+			}
+
+		private:
+			static float valence_score(uint32_t aNumLiveTriangles)
+			{
+				return cForsythValenceBoostScale * std::pow(static_cast<float>(aNumLiveTriangles), -cForsythValenceBoostPower);
+			}
+
+			std::array<float, cForsythCacheSize> mCacheScores;
+			std::array<float, cForsythMaxTabulatedValence + 1> mValenceScores;
+		};
+	}
+
+	vertex_cache_statistics analyze_vertex_cache(const std::vector<uint32_t>& aIndices, size_t aNumVertices, uint32_t aCacheSize)
+	{
+		fifo_cache_simulation cache{ aNumVertices, aCacheSize };
+		std::vector<bool> referenced(aNumVertices, false);
+		uint32_t numReferenced = 0;
+		uint32_t numTransformed = 0;
+		for (const auto index : aIndices) {
+			numTransformed += cache.access(index);
+			if (!referenced[index]) {
+				referenced[index] = true;
+				++numReferenced;
+			}
+		}
+
+		vertex_cache_statistics result;
+		result.mVerticesTransformed = numTransformed;
+		result.mAcmr = aIndices.size() >= 3 ? static_cast<float>(numTransformed) / static_cast<float>(aIndices.size() / 3) : 0.0f;
+		result.mAtvr = numReferenced > 0 ? static_cast<float>(numTransformed) / static_cast<float>(numReferenced) : 0.0f;
+		return result;
+	}
+
+	std::vector<uint32_t> optimize_vertex_cache(const std::vector<uint32_t>& aIndices, size_t aNumVertices)
+	{
+		const auto numTriangles = aIndices.size() / 3;
+		std::vector<uint32_t> result;
+		result.reserve(numTriangles * 3);
+		if (0 == numTriangles) {
+			return result;
+		}
+
+		// The triangles which reference each vertex and have not been emitted yet ("live" triangles):
+		std::vector<uint32_t> numLive(aNumVertices, 0);
+		for (size_t i = 0; i < numTriangles * 3; ++i) {
+			++numLive[aIndices[i]];
+		}
+		std::vector<uint32_t> liveBegin(aNumVertices + 1, 0);
+		for (size_t v = 0; v < aNumVertices; ++v) {
+			liveBegin[v + 1] = liveBegin[v] + numLive[v];
+		}
+		std::vector<uint32_t> liveTriangles(numTriangles * 3);
+		{
+			auto fill = liveBegin;
+			for (size_t i = 0; i < numTriangles * 3; ++i) {
+				liveTriangles[fill[aIndices[i]]++] = static_cast<uint32_t>(i / 3);
+			}
+		}
+
+		const forsyth_vertex_scores scoreOf;
+		std::vector<float> vertexScore(aNumVertices);
+		for (size_t v = 0; v < aNumVertices; ++v) {
+			vertexScore[v] = scoreOf(-1, numLive[v]);
+		}
+		std::vector<float> triangleScore(numTriangles);
+		for (size_t t = 0; t < numTriangles; ++t) {
+			triangleScore[t] = vertexScore[aIndices[t * 3]] + vertexScore[aIndices[t * 3 + 1]] + vertexScore[aIndices[t * 3 + 2]];
+		}
+		std::vector<bool> emitted(numTriangles, false);
+
+		// LRU cache; three additional entries for the vertices of the emitted triangle, which push older ones out:
+		std::array<uint32_t, cForsythCacheSize + 3> cache;
+		std::array<uint32_t, cForsythCacheSize + 3> newCache;
+		size_t cacheCount = 0;
+
+		constexpr auto none = std::numeric_limits<size_t>::max();
+		auto bestTriangle = static_cast<size_t>(std::distance(triangleScore.begin(), std::max_element(triangleScore.begin(), triangleScore.end())));
+		size_t nextInInputOrder = 0;
+		for (size_t n = 0; n < numTriangles; ++n) {
+			if (none == bestTriangle) {
+				// No vertex in the cache belongs to a remaining triangle => continue in input order:
+				while (emitted[nextInInputOrder]) {
+					++nextInInputOrder;
+				}
+				bestTriangle = nextInInputOrder;
+			}
+			const auto t = bestTriangle;
+			const uint32_t vertices[3] = { aIndices[t * 3], aIndices[t * 3 + 1], aIndices[t * 3 + 2] };
+			result.insert(result.end(), std::begin(vertices), std::end(vertices));
+			emitted[t] = true;
+
+			size_t newCount = 0;
+			for (const auto v : vertices) {
+				// The triangle is not live anymore:
+				auto* live = liveTriangles.data() + liveBegin[v];
+				auto* it = std::find(live, live + numLive[v], static_cast<uint32_t>(t));
+				if (it != live + numLive[v]) {
+					*it = live[--numLive[v]];
+				}
+				// The triangle's vertices move to the front of the cache (degenerate triangles reference a vertex more than once):
+				if (std::find(newCache.begin(), newCache.begin() + newCount, v) == newCache.begin() + newCount) {
+					newCache[newCount++] = v;
+				}
+			}
+			for (size_t i = 0; i < cacheCount; ++i) {
+				if (cache[i] != vertices[0] && cache[i] != vertices[1] && cache[i] != vertices[2]) {
+					newCache[newCount++] = cache[i];
+				}
+			}
+
+			// Update the scores of all vertices whose cache position has changed (including the ones which have just been evicted):
+			for (size_t i = 0; i < newCount; ++i) {
+				const auto v = newCache[i];
+				const auto score = scoreOf(i < cForsythCacheSize ? static_cast<int>(i) : -1, numLive[v]);
+				const auto delta = score - vertexScore[v];
+				vertexScore[v] = score;
+				for (auto j = liveBegin[v]; j < liveBegin[v] + numLive[v]; ++j) {
+					triangleScore[liveTriangles[j]] += delta;
+				}
+			}
+
+			// The next triangle is the best one which has at least one vertex in the cache:
+			cacheCount = std::min<size_t>(newCount, cForsythCacheSize);
+			bestTriangle = none;
+			float bestScore = std::numeric_limits<float>::lowest();
+			for (size_t i = 0; i < cacheCount; ++i) {
+				const auto v = newCache[i];
+				cache[i] = v;
+				for (auto j = liveBegin[v]; j < liveBegin[v] + numLive[v]; ++j) {
+					const auto candidate = liveTriangles[j];
+					if (triangleScore[candidate] > bestScore) {
+						bestScore = triangleScore[candidate];
+						bestTriangle = candidate;
+					}
+				}
+			}
+		}
+
+		return result;
+	}
+
+	std::vector<uint32_t> optimize_overdraw(const std::vector<uint32_t>& aIndices, const std::vector<glm::vec3>& aPositions, float aThreshold)
+	{
+		constexpr uint32_t cacheSize = 16;
+		const auto numTriangles = aIndices.size() / 3;
+		if (0 == numTriangles) {
+			return aIndices;
+		}
+
+		// Hard boundaries: wherever the cache-optimized order starts over, i.e., a triangle misses all of its vertices:
+		std::vector<size_t> hardBoundaries;
+		std::vector<uint32_t> misses(numTriangles);
+		{
+			fifo_cache_simulation cache{ aPositions.size(), cacheSize };
+			for (size_t t = 0; t < numTriangles; ++t) {
+				misses[t] = cache.access_triangle(aIndices, t);
+				if (0 == t || 3 == misses[t]) {
+					hardBoundaries.push_back(t);
+				}
+			}
+			hardBoundaries.push_back(numTriangles);
+		}
+
+		// Soft boundaries: split every hard cluster wherever its ACMR up to that point (starting with an empty cache) is
+		// within aThreshold of the whole hard cluster's ACMR, s.t. the splits only cost a bounded number of cache misses:
+		std::vector<size_t> boundaries;
+		{
+			fifo_cache_simulation cache{ aPositions.size(), cacheSize };
+			for (size_t c = 0; c + 1 < hardBoundaries.size(); ++c) {
+				const auto begin = hardBoundaries[c];
+				const auto end = hardBoundaries[c + 1];
+				uint32_t clusterMisses = 0;
+				for (auto t = begin; t < end; ++t) {
+					clusterMisses += misses[t];
+				}
+				const auto maxAcmr = static_cast<float>(clusterMisses) / static_cast<float>(end - begin) * aThreshold;
+
+				boundaries.push_back(begin);
+				cache.clear();
+				auto start = begin;
+				uint32_t startMisses = 0;
+				for (auto t = begin; t < end; ++t) {
+					startMisses += cache.access_triangle(aIndices, t);
+					if (t + 1 < end && static_cast<float>(startMisses) / static_cast<float>(t + 1 - start) <= maxAcmr) {
+						boundaries.push_back(t + 1);
+						cache.clear();
+						start = t + 1;
+						startMisses = 0;
+					}
+				}
+			}
+			boundaries.push_back(numTriangles);
+		}
+
+		// Sort the clusters by how much they face away from the center of the mesh; those facing outwards occlude the others:
+		glm::vec3 meshCentroid{ 0.0f };
+		float meshArea = 0.0f;
+		const auto numClusters = boundaries.size() - 1;
+		std::vector<glm::vec3> clusterCentroids(numClusters, glm::vec3{ 0.0f });
+		std::vector<glm::vec3> clusterNormals(numClusters, glm::vec3{ 0.0f });
+		std::vector<float> clusterAreas(numClusters, 0.0f);
+		for (size_t c = 0; c < numClusters; ++c) {
+			for (auto t = boundaries[c]; t < boundaries[c + 1]; ++t) {
+				const auto& a = aPositions[aIndices[t * 3]];
+				const auto& b = aPositions[aIndices[t * 3 + 1]];
+				const auto& d = aPositions[aIndices[t * 3 + 2]];
+				// Area-weighted:
+				const auto n = glm::cross(b - a, d - a);
+				const auto area = glm::length(n);
+				clusterCentroids[c] += (a + b + d) * (area / 3.0f);
+				clusterNormals[c] += n;
+				clusterAreas[c] += area;
+			}
+			meshCentroid += clusterCentroids[c];
+			meshArea += clusterAreas[c];
+		}
+		if (meshArea > 0.0f) {
+			meshCentroid /= meshArea;
+		}
+
+		std::vector<float> sortKeys(numClusters);
+		for (size_t c = 0; c < numClusters; ++c) {
+			const auto centroid = clusterAreas[c] > 0.0f ? clusterCentroids[c] / clusterAreas[c] : aPositions[aIndices[boundaries[c] * 3]];
+			const auto normalLength = glm::length(clusterNormals[c]);
+			const auto normal = normalLength > 0.0f ? clusterNormals[c] / normalLength : glm::vec3{ 0.0f };
+			sortKeys[c] = glm::dot(centroid - meshCentroid, normal);
+		}
+		std::vector<size_t> clusterOrder(numClusters);
+		std::iota(clusterOrder.begin(), clusterOrder.end(), size_t{ 0 });
+		std::stable_sort(clusterOrder.begin(), clusterOrder.end(), [&sortKeys](size_t a, size_t b) { return sortKeys[a] > sortKeys[b]; });
+
+		std::vector<uint32_t> result;
+		result.reserve(numTriangles * 3);
+		for (const auto c : clusterOrder) {
+			result.insert(result.end(), aIndices.begin() + boundaries[c] * 3, aIndices.begin() + boundaries[c + 1] * 3);
+		}
+		return result;
+	}
+
+	std::vector<uint32_t> optimize_vertex_fetch(std::vector<uint32_t>& aIndices, size_t aNumVertices)
+	{
+		constexpr auto unassigned = std::numeric_limits<uint32_t>::max();
+		std::vector<uint32_t> oldToNew(aNumVertices, unassigned);
+		std::vector<uint32_t> newToOld;
+		newToOld.reserve(aNumVertices);
+		for (auto& index : aIndices) {
+			if (unassigned == oldToNew[index]) {
+				oldToNew[index] = static_cast<uint32_t>(newToOld.size());
+				newToOld.push_back(index);
+			}
+			index = oldToNew[index];
+		}
+		return newToOld;
+	}
+}
@@ -4,6 +4,130 @@
 
 namespace avk
 {
+	namespace
+	{
+		/** Uniform grid over the centroids of triangles, which finds the closest triangle that has not been assigned to a meshlet yet. */
+		class triangle_grid
+		{
+		public:
+			explicit triangle_grid(const std::vector<glm::vec3>& aCentroids)
+				: mCentroids{ aCentroids }
+				, mNumRemaining{ aCentroids.size() }
+			{
+				mMin = glm::vec3{ std::numeric_limits<float>::max() };
+				glm::vec3 max{ std::numeric_limits<float>::lowest() };
+				for (const auto& c : aCentroids) {
+					mMin = glm::min(mMin, c);
+					max = glm::max(max, c);
+				}
+				// Roughly 32 triangles per cell:
+				const auto numCellsPerAxis = std::clamp(static_cast<int>(std::cbrt(static_cast<double>(aCentroids.size()) / 32.0)), 1, 128);
+				mNumCells = glm::ivec3{ numCellsPerAxis };
+				mCellSize = glm::max((max - mMin) / static_cast<float>(numCellsPerAxis), glm::vec3{ 1e-6f });
+
+				// Sort the triangles by cell:
+				const auto numCells = static_cast<size_t>(numCellsPerAxis) * numCellsPerAxis * numCellsPerAxis;
+				mCellBegin.assign(numCells + 1, 0);
+				for (const auto& c : aCentroids) {
+					++mCellBegin[cell_index(cell_of(c)) + 1];
+				}
+				for (size_t i = 0; i < numCells; ++i) {
+					mCellBegin[i + 1] += mCellBegin[i];
+				}
+				mCellCount.resize(numCells);
+				for (size_t i = 0; i < numCells; ++i) {
+					mCellCount[i] = mCellBegin[i + 1] - mCellBegin[i];
+				}
+				mTriangles.resize(aCentroids.size());
+				auto fill = mCellBegin;
+				for (uint32_t t = 0; t < static_cast<uint32_t>(aCentroids.size()); ++t) {
+					mTriangles[fill[cell_index(cell_of(aCentroids[t]))]++] = t;
+				}
+			}
+
+			/** Must be invoked for every triangle which has been assigned to a meshlet */
+			void mark_used()
+			{
+				--mNumRemaining;
+			}
+
+			/** Returns the unassigned triangle whose centroid is closest to aPosition, if there is any left. */
+			std::optional<uint32_t> find_nearest(const glm::vec3& aPosition, const std::vector<bool>& aUsed)
+			{
+				if (0 == mNumRemaining) {
+					return {};
+				}
+				const auto center = cell_of(aPosition);
+				const auto maxRing = std::max({ mNumCells.x, mNumCells.y, mNumCells.z });
+				const auto minCellSize = std::min({ mCellSize.x, mCellSize.y, mCellSize.z });
+				std::optional<uint32_t> best;
+				float bestDistance2 = std::numeric_limits<float>::max();
+				for (int ring = 0; ring <= maxRing; ++ring) {
+					// Visit all cells with a Chebyshev distance of exactly ring:
+					for (int z = center.z - ring; z <= center.z + ring; ++z) {
+						for (int y = center.y - ring; y <= center.y + ring; ++y) {
+							for (int x = center.x - ring; x <= center.x + ring; ++x) {
+								if (std::max({ std::abs(x - center.x), std::abs(y - center.y), std::abs(z - center.z) }) != ring) {
+									continue;
+								}
+								if (x < 0 || y < 0 || z < 0 || x >= mNumCells.x || y >= mNumCells.y || z >= mNumCells.z) {
+									continue;
+								}
+								visit_cell(cell_index({ x, y, z }), aPosition, aUsed, best, bestDistance2);
+							}
+						}
+					}
+					// Cells of the next ring are at least this far away:
+					const auto reach = static_cast<float>(ring) * minCellSize;
+					if (best.has_value() && bestDistance2 <= reach * reach) {
+						break;
+					}
+				}
+				return best;
+			}
+
+		private:
+			glm::ivec3 cell_of(const glm::vec3& aPosition) const
+			{
+				return glm::clamp(glm::ivec3((aPosition - mMin) / mCellSize), glm::ivec3{ 0 }, mNumCells - 1);
+			}
+
+			size_t cell_index(const glm::ivec3& aCell) const
+			{
+				return (static_cast<size_t>(aCell.z) * mNumCells.y + aCell.y) * mNumCells.x + aCell.x;
+			}
+
+			void visit_cell(size_t aCell, const glm::vec3& aPosition, const std::vector<bool>& aUsed, std::optional<uint32_t>& aBest, float& aBestDistance2)
+			{
+				auto* triangles = mTriangles.data() + mCellBegin[aCell];
+				auto& count = mCellCount[aCell];
+				for (size_t i = 0; i < count;) {
+					const auto t = triangles[i];
+					if (aUsed[t]) {
+						// Remove assigned triangles lazily, s.t. they are not visited again:
+						triangles[i] = triangles[--count];
+						continue;
+					}
+					const auto d = mCentroids[t] - aPosition;
+					const auto distance2 = glm::dot(d, d);
+					if (distance2 < aBestDistance2) {
+						aBestDistance2 = distance2;
+						aBest = t;
+					}
+					++i;
+				}
+			}
+
+			const std::vector<glm::vec3>& mCentroids;
+			glm::vec3 mMin;
+			glm::vec3 mCellSize;
+			glm::ivec3 mNumCells;
+			std::vector<size_t> mCellBegin;
+			std::vector<size_t> mCellCount;
+			std::vector<uint32_t> mTriangles;
+			size_t mNumRemaining;
+		};
+	}
 
 	std::vector<meshlet> divide_into_meshlets(std::vector<std::tuple<avk::model, std::vector<mesh_index_t>>>& aModelsAndMeshletIndices,
 		const bool aCombineSubmeshes, const uint32_t aMaxVertices, const uint32_t aMaxIndices)
@@ -50,5 +174,223 @@ namespace avk
 
 		return result;
 	}
-}
 
+	std::vector<meshlet> cluster_meshlets_builder(const std::vector<glm::vec3>& aVertices,
+		const std::vector<uint32_t>& aIndices,
+		const model_t& aModel,
+		std::optional<mesh_index_t> aMeshIndex,
+		uint32_t aMaxVertices, uint32_t aMaxIndices)
+	{
+		// Local vertex indices are stored as uint8_t, and the GPU representations store the vertex count as uint8_t:
+		const auto maxVertices = std::min(aMaxVertices, 255u);
+		const auto maxTriangles = aMaxIndices / 3u;
+		if (maxVertices < 3u || 0u == maxTriangles) {
+			throw avk::logic_error("A meshlet must be able to hold at least one triangle.");
+		}
+
+		const auto numTriangles = aIndices.size() / 3;
+		const auto numVertices = aVertices.size();
+
+		// The triangles which reference each vertex:
+		std::vector<uint32_t> vertexTrianglesBegin(numVertices + 1, 0);
+		for (size_t i = 0; i < numTriangles * 3; ++i) {
+			++vertexTrianglesBegin[aIndices[i] + 1];
+		}
+		for (size_t v = 0; v < numVertices; ++v) {
+			vertexTrianglesBegin[v + 1] += vertexTrianglesBegin[v];
+		}
+		std::vector<uint32_t> vertexTriangles(numTriangles * 3);
+		{
+			auto fill = vertexTrianglesBegin;
+			for (size_t i = 0; i < numTriangles * 3; ++i) {
+				vertexTriangles[fill[aIndices[i]]++] = static_cast<uint32_t>(i / 3);
+			}
+		}
+
+		std::vector<glm::vec3> centroids(numTriangles);
+		for (size_t t = 0; t < numTriangles; ++t) {
+			centroids[t] = (aVertices[aIndices[t * 3]] + aVertices[aIndices[t * 3 + 1]] + aVertices[aIndices[t * 3 + 2]]) / 3.0f;
+		}
+		triangle_grid grid{ centroids };
+
+		std::vector<bool> used(numTriangles, false);
+		// The meshlet in which a triangle has last been added to the candidates, to add it only once per meshlet:
+		std::vector<uint32_t> candidateOf(numTriangles, std::numeric_limits<uint32_t>::max());
+		// Index of a vertex within the current meshlet, or -1:
+		std::vector<int16_t> localIndex(numVertices, -1);
+		std::vector<uint32_t> candidates;
+
+		std::vector<meshlet> result;
+		glm::vec3 center = centroids.empty() ? glm::vec3{ 0.0f } : centroids[0];
+		while (true) {
+			const auto seed = grid.find_nearest(center, used);
+			if (!seed.has_value()) {
+				break;
+			}
+			const auto meshletId = static_cast<uint32_t>(result.size());
+			auto& ml = result.emplace_back();
+			ml.mMeshIndex = aMeshIndex;
+			ml.mVertices.reserve(maxVertices);
+			// Padded to a multiple of four, see convert_for_gpu_usage:
+			ml.mIndices.reserve((maxTriangles * 3 + 3) / 4 * 4);
+			candidates.clear();
+			glm::vec3 centroidSum{ 0.0f };
+
+			auto numNewVertices = [&](uint32_t aTriangle) {
+				return (localIndex[aIndices[aTriangle * 3]] < 0 ? 1u : 0u)
+					+ (localIndex[aIndices[aTriangle * 3 + 1]] < 0 ? 1u : 0u)
+					+ (localIndex[aIndices[aTriangle * 3 + 2]] < 0 ? 1u : 0u);
+			};
+
+			auto add = [&](uint32_t aTriangle) {
+				for (size_t k = 0; k < 3; ++k) {
+					const auto v = aIndices[aTriangle * 3 + k];
+					if (localIndex[v] < 0) {
+						localIndex[v] = static_cast<int16_t>(ml.mVertices.size());
+						ml.mVertices.push_back(v);
+					}
+					ml.mIndices.push_back(static_cast<uint8_t>(localIndex[v]));
+				}
+				used[aTriangle] = true;
+				grid.mark_used();
+				centroidSum += centroids[aTriangle];
+				// All triangles which share a vertex with the meshlet are candidates for the next step:
+				for (size_t k = 0; k < 3; ++k) {
+					const auto v = aIndices[aTriangle * 3 + k];
+					for (auto i = vertexTrianglesBegin[v]; i < vertexTrianglesBegin[v + 1]; ++i) {
+						const auto neighbour = vertexTriangles[i];
+						if (!used[neighbour] && candidateOf[neighbour] != meshletId) {
+							candidateOf[neighbour] = meshletId;
+							candidates.push_back(neighbour);
+						}
+					}
+				}
+			};
+
+			add(seed.value());
+			while (ml.mIndices.size() / 3 < maxTriangles) {
+				center = centroidSum / static_cast<float>(ml.mIndices.size() / 3);
+
+				// Prefer the triangle which adds the fewest vertices, and among those, the one closest to the center:
+				std::optional<uint32_t> best;
+				uint32_t bestNewVertices = 4u;
+				float bestDistance2 = std::numeric_limits<float>::max();
+				for (size_t i = 0; i < candidates.size();) {
+					const auto t = candidates[i];
+					if (used[t]) {
+						candidates[i] = candidates.back();
+						candidates.pop_back();
+						continue;
+					}
+					++i;
+					const auto newVertices = numNewVertices(t);
+					if (ml.mVertices.size() + newVertices > maxVertices || newVertices > bestNewVertices) {
+						continue;
+					}
+					const auto d = centroids[t] - center;
+					const auto distance2 = glm::dot(d, d);
+					if (newVertices < bestNewVertices || distance2 < bestDistance2) {
+						best = t;
+						bestNewVertices = newVertices;
+						bestDistance2 = distance2;
+					}
+				}
+
+				if (!best.has_value()) {
+					// No adjacent triangle fits (e.g., at the end of a connected component) => continue with the closest one:
+					if (ml.mVertices.size() + 3 > maxVertices) {
+						break;
+					}
+					best = grid.find_nearest(center, used);
+					if (!best.has_value()) {
+						break;
+					}
+				}
+				add(best.value());
+			}
+
+			for (const auto v : ml.mVertices) {
+				localIndex[v] = -1;
+			}
+			ml.mVertexCount = static_cast<uint32_t>(ml.mVertices.size());
+			ml.mIndexCount = static_cast<uint32_t>(ml.mIndices.size());
+			ml.mIndices.resize((ml.mIndices.size() + 3) / 4 * 4, 0);
+			ml.mBounds = compute_meshlet_bounds(ml, aVertices);
+			center = centroidSum / static_cast<float>(ml.mIndexCount / 3);
+		}
+
+		return result;
+	}
+
+	meshlet_bounds compute_meshlet_bounds(const meshlet& aMeshlet, const std::vector<glm::vec3>& aVertices)
+	{
+		meshlet_bounds result;
+
+		// Sphere around the center of the bounding box:
+		glm::vec3 min{ std::numeric_limits<float>::max() };
+		glm::vec3 max{ std::numeric_limits<float>::lowest() };
+		for (uint32_t i = 0; i < aMeshlet.mVertexCount; ++i) {
+			min = glm::min(min, aVertices[aMeshlet.mVertices[i]]);
+			max = glm::max(max, aVertices[aMeshlet.mVertices[i]]);
+		}
+		const auto center = (min + max) * 0.5f;
+		float radius2 = 0.0f;
+		for (uint32_t i = 0; i < aMeshlet.mVertexCount; ++i) {
+			const auto d = aVertices[aMeshlet.mVertices[i]] - center;
+			radius2 = std::max(radius2, glm::dot(d, d));
+		}
+		result.mBoundingSphere = glm::vec4{ center, std::sqrt(radius2) };
+
+		// Normal cone around the average of the triangles' normals:
+		auto normalOf = [&](uint32_t aTriangle) {
+			const auto& a = aVertices[aMeshlet.mVertices[aMeshlet.mIndices[aTriangle * 3]]];
+			const auto& b = aVertices[aMeshlet.mVertices[aMeshlet.mIndices[aTriangle * 3 + 1]]];
+			const auto& c = aVertices[aMeshlet.mVertices[aMeshlet.mIndices[aTriangle * 3 + 2]]];
+			const auto n = glm::cross(b - a, c - a);
+			const auto length = glm::length(n);
+			return length > 0.0f ? n / length : glm::vec3{ 0.0f };
+		};
+		const auto numTriangles = aMeshlet.mIndexCount / 3;
+		glm::vec3 normalSum{ 0.0f };
+		for (uint32_t t = 0; t < numTriangles; ++t) {
+			normalSum += normalOf(t);
+		}
+		const auto sumLength = glm::length(normalSum);
+		if (sumLength <= 1e-6f) {
+			result.mNormalCone = glm::vec4{ 0.0f, 0.0f, 1.0f, 1.0f };
+			return result;
+		}
+		const auto axis = normalSum / sumLength;
+		float minDot = 1.0f;
+		for (uint32_t t = 0; t < numTriangles; ++t) {
+			const auto n = normalOf(t);
+			if (glm::dot(n, n) > 0.0f) {
+				minDot = std::min(minDot, glm::dot(axis, n));
+			}
+		}
+		// Beyond an opening angle of 90 degrees, the meshlet is never entirely back-facing:
+		const auto cutoff = minDot <= 0.0f ? 1.0f : std::sqrt(1.0f - minDot * minDot);
+		result.mNormalCone = glm::vec4{ axis, cutoff };
+		return result;
+	}
+
+	std::vector<meshlet_bounds> convert_bounds_for_gpu_usage(const std::vector<meshlet>& aMeshlets)
+	{
+		std::vector<meshlet_bounds> gpuBounds;
+		gpuBounds.reserve(aMeshlets.size());
+		for (const auto& meshlet : aMeshlets) {
+			gpuBounds.push_back(meshlet.mBounds.value_or(meshlet_bounds::unbounded()));
+		}
+		return gpuBounds;
+	}
+
+	std::vector<meshlet_bounds> convert_bounds_for_gpu_usage_cached(serializer& aSerializer, const std::vector<meshlet>& aMeshlets)
+	{
+		std::vector<meshlet_bounds> gpuBounds;
+		if (aSerializer.mode() == serializer::mode::serialize) {
+			gpuBounds = convert_bounds_for_gpu_usage(aMeshlets);
+		}
+		aSerializer.archive(gpuBounds);
+		return gpuBounds;
+	}
+}
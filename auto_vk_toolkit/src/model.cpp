@@ -1376,6 +1376,8 @@ namespace avk
 			}
 		}
 
+		// Repack all keys for sampling:
+		result.pack_keys();
 		return result;
 	}
 
@@ -1404,18 +1406,63 @@ namespace avk
 		}
 	}
 
+	namespace
+	{
+		/** One tangent frame per element, stored as structure of arrays s.t. the loops over all elements can be vectorized */
+		struct tangent_frames_soa
+		{
+			explicit tangent_frames_soa(size_t aCount)
+				: mTx(aCount, 0.0f), mTy(aCount, 0.0f), mTz(aCount, 0.0f)
+				, mBx(aCount, 0.0f), mBy(aCount, 0.0f), mBz(aCount, 0.0f)
+			{ }
+
+			std::vector<float> mTx, mTy, mTz;
+			std::vector<float> mBx, mBy, mBz;
+		};
+
+		/** Projects the tangents and bitangents into the planes given by the normals and normalizes them (unless they have zero length) */
+		void orthonormalize(tangent_frames_soa& aFrames, const std::vector<float>& aNx, const std::vector<float>& aNy, const std::vector<float>& aNz)
+		{
+			const auto n = aNx.size();
+			float* tx = aFrames.mTx.data(); float* ty = aFrames.mTy.data(); float* tz = aFrames.mTz.data();
+			float* bx = aFrames.mBx.data(); float* by = aFrames.mBy.data(); float* bz = aFrames.mBz.data();
+			const float* nx = aNx.data(); const float* ny = aNy.data(); const float* nz = aNz.data();
+			for (size_t i = 0; i < n; ++i) {
+				const float dt = tx[i] * nx[i] + ty[i] * ny[i] + tz[i] * nz[i];
+				const float db = bx[i] * nx[i] + by[i] * ny[i] + bz[i] * nz[i];
+				tx[i] -= nx[i] * dt; ty[i] -= ny[i] * dt; tz[i] -= nz[i] * dt;
+				bx[i] -= nx[i] * db; by[i] -= ny[i] * db; bz[i] -= nz[i] * db;
+				// Like aiVector3D::NormalizeSafe:
+				const float lt = std::sqrt(tx[i] * tx[i] + ty[i] * ty[i] + tz[i] * tz[i]);
+				const float lb = std::sqrt(bx[i] * bx[i] + by[i] * by[i] + bz[i] * bz[i]);
+				const float it = lt > 0.0f ? 1.0f / lt : 1.0f;
+				const float ib = lb > 0.0f ? 1.0f / lb : 1.0f;
+				tx[i] *= it; ty[i] *= it; tz[i] *= it;
+				bx[i] *= ib; by[i] *= ib; bz[i] *= ib;
+			}
+		}
+	}
+
 	void model_t::calculate_tangent_space_for_mesh(mesh_index_t aMeshIndex, uint32_t aConfigSourceUV)
 	{
 		mTangentsAndBitangents[aMeshIndex] = std::make_tuple(std::vector<glm::vec3>{}, std::vector<glm::vec3>{});
 		auto& [meshTang, meshBitang] = mTangentsAndBitangents[aMeshIndex];
+		calculate_tangent_space_into(aMeshIndex, aConfigSourceUV, meshTang, meshBitang);
+	}
+
+	void model_t::calculate_tangent_space_into(mesh_index_t aMeshIndex, uint32_t aConfigSourceUV, std::vector<glm::vec3>& aTangents, std::vector<glm::vec3>& aBitangents) const
+	{
 		auto numVerts = number_of_vertices_for_mesh(aMeshIndex);
 		// create space for the tangents and bitangents
-		meshTang.resize(numVerts);
-		meshBitang.resize(numVerts);
+		aTangents.resize(numVerts);
+		aBitangents.resize(numVerts);
 
-		// The following is mostly a copy&paste from ASSIMP's code (but not necessarily from the latest version,
+		// The following is based on ASSIMP's code (but not necessarily on the latest version,
 		// since at some point, incorrect tangents/bitangents calculation has been introduced, namely s.t.
 		// the bitangents would always be orthogonal to the tangents. This is wrong.)
+		// ASSIMP writes the tangent frame of every face into all of its vertices, face by face, i.e., every vertex ends up
+		// with the frame of the last face which references it. The same result is computed here in separate passes over
+		// faces and vertices, s.t. the arithmetic runs over contiguous arrays.
 
 		const aiMesh* pMesh = mScene->mMeshes[aMeshIndex];
 
@@ -1437,35 +1484,35 @@ namespace avk
 		    return;
 		}
 
-		const float angleEpsilon = 0.9999f;
-
-		std::vector<bool> vertexDone(pMesh->mNumVertices, false);
 		const float qnan = std::numeric_limits<ai_real>::quiet_NaN();
+		constexpr uint32_t noFace = std::numeric_limits<uint32_t>::max();
 
 		const aiVector3D *meshPos = pMesh->mVertices;
 		const aiVector3D *meshNorm = pMesh->mNormals;
 		const aiVector3D *meshTex = pMesh->mTextureCoords[aConfigSourceUV];
+		const auto numFaces = pMesh->mNumFaces;
+
+		// the last face which references each vertex determines its tangent and bitangent
+		std::vector<uint32_t> lastFace(numVerts, noFace);
+		for (unsigned int a = 0; a < numFaces; a++) {
+		    const aiFace &face = pMesh->mFaces[a];
+		    for (unsigned int i = 0; i < face.mNumIndices; ++i) {
+		        lastFace[face.mIndices[i]] = a;
+		    }
+		}
 
 		// calculate the tangent and bitangent for every face
-		for (unsigned int a = 0; a < pMesh->mNumFaces; a++) {
+		tangent_frames_soa faceFrames(numFaces);
+		for (unsigned int a = 0; a < numFaces; a++) {
 		    const aiFace &face = pMesh->mFaces[a];
 		    if (face.mNumIndices < 3) {
 		        // There are less than three indices, thus the tangent vector
-		        // is not defined. We are finished with these vertices now,
-		        // their tangent vectors are set to qnan.
-		        for (unsigned int i = 0; i < face.mNumIndices; ++i) {
-		            unsigned int idx = face.mIndices[i];
-		            vertexDone[idx] = true;
-		            meshTang[idx] = to_vec3(aiVector3D(qnan));
-		            meshBitang[idx] = to_vec3(aiVector3D(qnan));
-		        }
-
+		        // is not defined. Its vertices' tangent vectors are set to qnan below.
 		        continue;
 		    }
 
 		    // triangle or polygon... we always use only the first three indices. A polygon
 		    // is supposed to be planar anyways....
-		    // FIXME: (thom) create correct calculation for multi-vertex polygons maybe?
 		    const unsigned int p0 = face.mIndices[0], p1 = face.mIndices[1], p2 = face.mIndices[2];
 
 		    // position differences p1->p2 and p1->p3
@@ -1485,41 +1532,60 @@ namespace avk
 
 		    // tangent points in the direction where to positive X axis of the texture coord's would point in model space
 		    // bitangent's points along the positive Y axis of the texture coord's, respectively
-		    aiVector3D tangent, bitangent;
-		    tangent.x = (w.x * sy - v.x * ty) * dirCorrection;
-		    tangent.y = (w.y * sy - v.y * ty) * dirCorrection;
-		    tangent.z = (w.z * sy - v.z * ty) * dirCorrection;
-		    bitangent.x = (w.x * sx - v.x * tx) * dirCorrection;
-		    bitangent.y = (w.y * sx - v.y * tx) * dirCorrection;
-		    bitangent.z = (w.z * sx - v.z * tx) * dirCorrection;
-
-		    // store for every vertex of that face
-		    for (unsigned int b = 0; b < face.mNumIndices; ++b) {
-		        unsigned int p = face.mIndices[b];
-
-		        // project tangent and bitangent into the plane formed by the vertex' normal
-		        aiVector3D localTangent = tangent - meshNorm[p] * (tangent * meshNorm[p]);
-		        aiVector3D localBitangent = bitangent - meshNorm[p] * (bitangent * meshNorm[p]);
-		        localTangent.NormalizeSafe();
-		        localBitangent.NormalizeSafe();
-
-		        // reconstruct tangent/bitangent according to normal and bitangent/tangent when it's infinite or NaN.
-		        bool invalid_tangent = is_special_float(localTangent.x) || is_special_float(localTangent.y) || is_special_float(localTangent.z);
-		        bool invalid_bitangent = is_special_float(localBitangent.x) || is_special_float(localBitangent.y) || is_special_float(localBitangent.z);
-		        if (invalid_tangent != invalid_bitangent) {
-		            if (invalid_tangent) {
-		                localTangent = meshNorm[p] ^ localBitangent;
-		                localTangent.NormalizeSafe();
-		            } else {
-		                localBitangent = localTangent ^ meshNorm[p];
-		                localBitangent.NormalizeSafe();
-		            }
-		        }
+		    faceFrames.mTx[a] = (w.x * sy - v.x * ty) * dirCorrection;
+		    faceFrames.mTy[a] = (w.y * sy - v.y * ty) * dirCorrection;
+		    faceFrames.mTz[a] = (w.z * sy - v.z * ty) * dirCorrection;
+		    faceFrames.mBx[a] = (w.x * sx - v.x * tx) * dirCorrection;
+		    faceFrames.mBy[a] = (w.y * sx - v.y * tx) * dirCorrection;
+		    faceFrames.mBz[a] = (w.z * sx - v.z * tx) * dirCorrection;
+		}
+
+		// gather every vertex' face frame and normal...
+		tangent_frames_soa vertexFrames(numVerts);
+		std::vector<float> nx(numVerts, 0.0f), ny(numVerts, 0.0f), nz(numVerts, 0.0f);
+		for (size_t p = 0; p < numVerts; ++p) {
+		    const auto a = lastFace[p];
+		    if (noFace == a) {
+		        continue;
+		    }
+		    vertexFrames.mTx[p] = faceFrames.mTx[a]; vertexFrames.mTy[p] = faceFrames.mTy[a]; vertexFrames.mTz[p] = faceFrames.mTz[a];
+		    vertexFrames.mBx[p] = faceFrames.mBx[a]; vertexFrames.mBy[p] = faceFrames.mBy[a]; vertexFrames.mBz[p] = faceFrames.mBz[a];
+		    nx[p] = meshNorm[p].x; ny[p] = meshNorm[p].y; nz[p] = meshNorm[p].z;
+		}
 
-		        // and write it into the mesh.
-		        meshTang[p] = to_vec3(localTangent);
-		        meshBitang[p] = to_vec3(localBitangent);
+		// ...project tangent and bitangent into the plane formed by the vertex' normal...
+		orthonormalize(vertexFrames, nx, ny, nz);
+
+		// ...and write them into the mesh.
+		for (size_t p = 0; p < numVerts; ++p) {
+		    const auto a = lastFace[p];
+		    if (noFace == a) {
+		        continue;
 		    }
+		    if (pMesh->mFaces[a].mNumIndices < 3) {
+		        aTangents[p] = to_vec3(aiVector3D(qnan));
+		        aBitangents[p] = to_vec3(aiVector3D(qnan));
+		        continue;
+		    }
+
+		    aiVector3D localTangent(vertexFrames.mTx[p], vertexFrames.mTy[p], vertexFrames.mTz[p]);
+		    aiVector3D localBitangent(vertexFrames.mBx[p], vertexFrames.mBy[p], vertexFrames.mBz[p]);
+
+		    // reconstruct tangent/bitangent according to normal and bitangent/tangent when it's infinite or NaN.
+		    bool invalid_tangent = is_special_float(localTangent.x) || is_special_float(localTangent.y) || is_special_float(localTangent.z);
+		    bool invalid_bitangent = is_special_float(localBitangent.x) || is_special_float(localBitangent.y) || is_special_float(localBitangent.z);
+		    if (invalid_tangent != invalid_bitangent) {
+		        if (invalid_tangent) {
+		            localTangent = meshNorm[p] ^ localBitangent;
+		            localTangent.NormalizeSafe();
+		        } else {
+		            localBitangent = localTangent ^ meshNorm[p];
+		            localBitangent.NormalizeSafe();
+		        }
+		    }
+
+		    aTangents[p] = to_vec3(localTangent);
+		    aBitangents[p] = to_vec3(localBitangent);
 		}
 	}
 
@@ -1530,4 +1596,19 @@ namespace avk
 			calculate_tangent_space_for_mesh(i, aConfigSourceUV);
 		}
 	}
+
+	void model_t::calculate_tangent_space_for_all_meshes(work_stealing_pool& aPool, uint32_t aConfigSourceUV)
+	{
+		// The map must not be modified concurrently => create all entries up front:
+		auto n = mScene->mNumMeshes;
+		std::vector<std::tuple<std::vector<glm::vec3>, std::vector<glm::vec3>>*> targets(n);
+		for (decltype(n) i = 0; i < n; ++i) {
+			mTangentsAndBitangents[i] = std::make_tuple(std::vector<glm::vec3>{}, std::vector<glm::vec3>{});
+			targets[i] = &mTangentsAndBitangents[i];
+		}
+		aPool.parallel_for(n, [&](size_t i) {
+			auto& [meshTang, meshBitang] = *targets[i];
+			calculate_tangent_space_into(i, aConfigSourceUV, meshTang, meshBitang);
+		});
+	}
 }
@@ -0,0 +1,47 @@
+#include "pipeline_compiler.hpp"
+
+namespace avk
+{
+	pipeline_compiler::pipeline_compiler(uint32_t aNumThreads)
+		: mStop{ false }
+	{
+		if (0 == aNumThreads) {
+			aNumThreads = std::max(std::thread::hardware_concurrency(), 1u);
+		}
+		mWorkers.reserve(aNumThreads);
+		for (uint32_t i = 0; i < aNumThreads; ++i) {
+			mWorkers.emplace_back([this]() { worker_loop(); });
+		}
+	}
+
+	pipeline_compiler::~pipeline_compiler()
+	{
+		{
+			std::scoped_lock lock(mMutex);
+			mStop = true;
+		}
+		mTaskAvailable.notify_all();
+		for (auto& w : mWorkers) {
+			w.join();
+		}
+	}
+
+	void pipeline_compiler::worker_loop()
+	{
+		for (;;) {
+			std::function<void()> task;
+			{
+				std::unique_lock lock(mMutex);
+				mTaskAvailable.wait(lock, [this]() { return mStop || !mTasks.empty(); });
+				// Pending tasks are still worked off when stopping, because someone might wait for their futures:
+				if (mTasks.empty()) {
+					return;
+				}
+				task = std::move(mTasks.front());
+				mTasks.pop_front();
+			}
+			// Exceptions end up in the task's future:
+			task();
+		}
+	}
+}
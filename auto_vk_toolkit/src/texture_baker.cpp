@@ -0,0 +1,292 @@
+#include <stb_dxt.h>
+#include <stb_image_resize.h>
+#include <gli/save_ktx.hpp>
+#include <gli/texture2d.hpp>
+
+#include "texture_baker.hpp"
+
+namespace avk
+{
+	namespace
+	{
+		/** Size of an uncompressed RGBA8 image with a full mip chain, like create_image_from_image_data_cached creates it */
+		size_t rgba8_bytes_with_mip_chain(uint32_t aWidth, uint32_t aHeight)
+		{
+			size_t bytes = static_cast<size_t>(aWidth) * aHeight * 4;
+			while (aWidth > 1 || aHeight > 1) {
+				aWidth = std::max(aWidth / 2, 1u);
+				aHeight = std::max(aHeight / 2, 1u);
+				bytes += static_cast<size_t>(aWidth) * aHeight * 4;
+			}
+			return bytes;
+		}
+
+		uint64_t fnv1a(std::string_view aData)
+		{
+			uint64_t hash = 14695981039346656037ull;
+			for (const char c : aData) {
+				hash ^= static_cast<uint8_t>(c);
+				hash *= 1099511628211ull;
+			}
+			return hash;
+		}
+
+		const char* block_format_name(gli::format aFormat)
+		{
+			switch (aFormat) {
+			case gli::FORMAT_RGB_DXT1_UNORM_BLOCK8:
+			case gli::FORMAT_RGB_DXT1_SRGB_BLOCK8:
+				return "BC1";
+			case gli::FORMAT_RGBA_DXT5_UNORM_BLOCK16:
+			case gli::FORMAT_RGBA_DXT5_SRGB_BLOCK16:
+				return "BC3";
+			case gli::FORMAT_R_ATI1N_UNORM_BLOCK8:
+				return "BC4";
+			case gli::FORMAT_RG_ATI2N_UNORM_BLOCK16:
+				return "BC5";
+			default:
+				return "unknown";
+			}
+		}
+
+		/** Filtering a normal map shortens its normals => bring them back to unit length */
+		void renormalize(std::vector<uint8_t>& aPixels)
+		{
+			for (size_t i = 0; i + 3 < aPixels.size(); i += 4) {
+				glm::vec3 n = glm::vec3{ aPixels[i], aPixels[i + 1], aPixels[i + 2] } / 127.5f - 1.0f;
+				const auto length = glm::length(n);
+				n = length > 1e-6f ? n / length : glm::vec3{ 0.0f, 0.0f, 1.0f };
+				for (glm::length_t c = 0; c < 3; ++c) {
+					aPixels[i + c] = static_cast<uint8_t>(std::clamp(std::lround((n[c] + 1.0f) * 127.5f), 0l, 255l));
+				}
+			}
+		}
+
+		/** Writes into a temporary file first, s.t. an interrupted write does not leave a broken file in the cache */
+		void save_atomically(const gli::texture& aTexture, const std::string& aPath)
+		{
+			const auto tmpPath = aPath + ".tmp";
+			if (!gli::save_ktx(aTexture, tmpPath)) {
+				throw avk::runtime_error(std::format("Could not write baked texture '{}'", tmpPath));
+			}
+			std::filesystem::rename(tmpPath, aPath);
+		}
+	}
+
+	texture_baker::texture_baker(std::string aCacheDirectory, uint32_t aNumThreads)
+		: mCacheDirectory{ std::move(aCacheDirectory) }
+		, mPool{ aNumThreads }
+	{
+		std::filesystem::create_directories(mCacheDirectory);
+	}
+
+	std::string texture_baker::bake(const std::string& aPath, texture_content aContent, bool aSrgb, bool aFlip)
+	{
+		const auto cachePath = cache_path(aPath, aContent, aSrgb, aFlip);
+		int w = 0, h = 0, channels = 0;
+		const bool isStbImage = 0 != stbi_info(aPath.c_str(), &w, &h, &channels);
+
+		if (std::filesystem::exists(cachePath)) {
+			++mStatistics.mNumFromCache;
+			if (isStbImage) {
+				mStatistics.mUncompressedBytes += rgba8_bytes_with_mip_chain(static_cast<uint32_t>(w), static_cast<uint32_t>(h));
+				mStatistics.mBakedBytes += static_cast<size_t>(std::filesystem::file_size(cachePath));
+			}
+			return cachePath;
+		}
+
+		const auto begin = std::chrono::steady_clock::now();
+		if (isStbImage) {
+			bake_image(aPath, aContent, aSrgb, aFlip, cachePath);
+		}
+		else {
+			copy_gli_texture(aPath, aFlip, cachePath);
+		}
+		++mStatistics.mNumBaked;
+		mStatistics.mBakeSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+		return cachePath;
+	}
+
+	void texture_baker::bake_material_textures(std::vector<material_config>& aMaterialConfigs, bool aLoadTexturesInSrgb, bool aFlipTextures)
+	{
+		struct usages
+		{
+			texture_content mContent;
+			bool mSrgb;
+			std::vector<std::string*> mPaths;
+		};
+		// Ordered, s.t. the textures are baked in the same order every time:
+		std::map<std::string, usages> texturesToUsages;
+		auto addUsage = [&texturesToUsages](std::string& bPath, texture_content bContent, bool bSrgb) {
+			if (bPath.empty()) {
+				return;
+			}
+			auto [it, inserted] = texturesToUsages.try_emplace(avk::clean_up_path(bPath), usages{ bContent, bSrgb, {} });
+			if (it->second.mContent != bContent) {
+				it->second.mContent = texture_content::color; // Keeps all channels
+			}
+			it->second.mSrgb = it->second.mSrgb || bSrgb;
+			it->second.mPaths.push_back(&bPath);
+		};
+
+		// The same slots are loaded in sRGB as in convert_for_gpu_usage_cached:
+		for (auto& mc : aMaterialConfigs) {
+			addUsage(mc.mDiffuseTex,      texture_content::color,          aLoadTexturesInSrgb);
+			addUsage(mc.mSpecularTex,     texture_content::color,          false);
+			addUsage(mc.mAmbientTex,      texture_content::color,          aLoadTexturesInSrgb);
+			addUsage(mc.mEmissiveTex,     texture_content::color,          false);
+			addUsage(mc.mHeightTex,       texture_content::single_channel, false);
+			addUsage(mc.mNormalsTex,      texture_content::normal_map,     false);
+			addUsage(mc.mShininessTex,    texture_content::single_channel, false);
+			addUsage(mc.mOpacityTex,      texture_content::single_channel, false);
+			addUsage(mc.mDisplacementTex, texture_content::single_channel, false);
+			addUsage(mc.mReflectionTex,   texture_content::color,          false);
+			addUsage(mc.mLightmapTex,     texture_content::color,          false);
+			addUsage(mc.mExtraTex,        texture_content::color,          aLoadTexturesInSrgb);
+		}
+
+		for (auto& [path, u] : texturesToUsages) {
+			const auto bakedPath = bake(path, u.mContent, u.mSrgb, aFlipTextures);
+			for (auto* p : u.mPaths) {
+				*p = bakedPath;
+			}
+		}
+	}
+
+	std::string texture_baker::cache_path(const std::string& aPath, texture_content aContent, bool aSrgb, bool aFlip) const
+	{
+		std::error_code ec;
+		const auto size = std::filesystem::file_size(aPath, ec);
+		if (ec) {
+			throw avk::runtime_error(std::format("Could not find texture file '{}': {}", aPath, ec.message()));
+		}
+		const auto modified = std::filesystem::last_write_time(aPath, ec).time_since_epoch().count();
+		const auto key = std::format("{}|{}|{}|{}|{}|{}|{}", std::filesystem::absolute(aPath).string(), size, modified, static_cast<int>(aContent), aSrgb, aFlip, cFormatVersion);
+		const auto fileName = std::format("{}_{:016x}.ktx", std::filesystem::path(aPath).stem().string(), fnv1a(key));
+		return (std::filesystem::path(mCacheDirectory) / fileName).string();
+	}
+
+	void texture_baker::bake_image(const std::string& aPath, texture_content aContent, bool aSrgb, bool aFlip, const std::string& aCachePath)
+	{
+		// Use the thread-local setting, like image_data_stb:
+		stbi_set_flip_vertically_on_load_thread(aFlip);
+		int w = 0, h = 0, channelsInFile = 0;
+		std::unique_ptr<stbi_uc, decltype(&stbi_image_free)> data(stbi_load(aPath.c_str(), &w, &h, &channelsInFile, STBI_rgb_alpha), &stbi_image_free);
+		if (!data) {
+			throw avk::runtime_error(std::format("Couldn't load image from '{}' using stbi_load: {}", aPath, stbi_failure_reason()));
+		}
+		std::vector<uint8_t> pixels(data.get(), data.get() + static_cast<size_t>(w) * h * 4);
+		data.reset();
+
+		bool opaque = true;
+		for (size_t i = 3; i < pixels.size() && opaque; i += 4) {
+			opaque = 255 == pixels[i];
+		}
+
+		gli::format format;
+		if (texture_content::normal_map == aContent) {
+			format = gli::FORMAT_RG_ATI2N_UNORM_BLOCK16;
+		}
+		else if (texture_content::single_channel == aContent && opaque) {
+			format = gli::FORMAT_R_ATI1N_UNORM_BLOCK8;
+		}
+		else if (opaque) {
+			format = aSrgb ? gli::FORMAT_RGB_DXT1_SRGB_BLOCK8 : gli::FORMAT_RGB_DXT1_UNORM_BLOCK8;
+		}
+		else {
+			format = aSrgb ? gli::FORMAT_RGBA_DXT5_SRGB_BLOCK16 : gli::FORMAT_RGBA_DXT5_UNORM_BLOCK16;
+		}
+		const bool weightByAlpha = !opaque && texture_content::normal_map != aContent;
+		const auto colorspace = aSrgb ? STBIR_COLORSPACE_SRGB : STBIR_COLORSPACE_LINEAR;
+
+		// A complete mip chain:
+		gli::texture2d texture(format, gli::extent2d{ w, h });
+		for (size_t level = 0; level < texture.levels(); ++level) {
+			const auto extent = texture.extent(level);
+			if (level > 0) {
+				// Filter the previous level down. Textures are mostly tiled => wrap around at the edges:
+				const auto previousExtent = texture.extent(level - 1);
+				std::vector<uint8_t> filtered(static_cast<size_t>(extent.x) * extent.y * 4);
+				const auto success = stbir_resize_uint8_generic(
+					pixels.data(), previousExtent.x, previousExtent.y, 0,
+					filtered.data(), extent.x, extent.y, 0,
+					4, weightByAlpha ? 3 : STBIR_ALPHA_CHANNEL_NONE, 0,
+					STBIR_EDGE_WRAP, STBIR_FILTER_MITCHELL, colorspace, nullptr);
+				if (!success) {
+					throw avk::runtime_error(std::format("Could not filter level {} of '{}'", level, aPath));
+				}
+				pixels = std::move(filtered);
+				if (texture_content::normal_map == aContent) {
+					renormalize(pixels);
+				}
+			}
+			compress_level(pixels, static_cast<uint32_t>(extent.x), static_cast<uint32_t>(extent.y), format, texture.data<uint8_t>(0, 0, level));
+		}
+		save_atomically(texture, aCachePath);
+
+		mStatistics.mUncompressedBytes += rgba8_bytes_with_mip_chain(static_cast<uint32_t>(w), static_cast<uint32_t>(h));
+		mStatistics.mBakedBytes += texture.size();
+		LOG_INFO(std::format("Baked texture '{}' ({}x{}, {} levels) as {} into '{}'", aPath, w, h, texture.levels(), block_format_name(format), aCachePath));
+	}
+
+	void texture_baker::copy_gli_texture(const std::string& aPath, bool aFlip, const std::string& aCachePath)
+	{
+		auto texture = gli::load(aPath);
+		if (texture.empty()) {
+			throw avk::runtime_error(std::format("Could not load image from '{}'", aPath));
+		}
+		if (aFlip) {
+			// Same restriction as in image_data_gli:
+			if (gli::is_compressed(texture.format()) && !gli::is_s3tc_compressed(texture.format())) {
+				throw avk::runtime_error(std::format("The texture '{}' should be flipped, but its format does not support flipping", aPath));
+			}
+			texture = gli::flip(texture);
+		}
+		save_atomically(texture, aCachePath);
+	}
+
+	void texture_baker::compress_level(const std::vector<uint8_t>& aPixels, uint32_t aWidth, uint32_t aHeight, gli::format aFormat, uint8_t* aBlocks)
+	{
+		const uint32_t blocksX = (aWidth + 3) / 4;
+		const uint32_t blocksY = (aHeight + 3) / 4;
+		const auto blockSize = gli::block_size(aFormat);
+
+		// One row of blocks per task; blocks which exceed the level's extent repeat its last row and column:
+		mPool.parallel_for(blocksY, [&](size_t aBlockY) {
+			std::array<uint8_t, 64> rgba;
+			std::array<uint8_t, 32> rg;
+			std::array<uint8_t, 16> r;
+			for (uint32_t blockX = 0; blockX < blocksX; ++blockX) {
+				for (uint32_t y = 0; y < 4; ++y) {
+					const auto sy = std::min(static_cast<uint32_t>(aBlockY) * 4 + y, aHeight - 1);
+					for (uint32_t x = 0; x < 4; ++x) {
+						const auto sx = std::min(blockX * 4 + x, aWidth - 1);
+						const auto* src = &aPixels[(static_cast<size_t>(sy) * aWidth + sx) * 4];
+						const auto i = y * 4 + x;
+						std::copy_n(src, 4, &rgba[i * 4]);
+						rg[i * 2] = src[0];
+						rg[i * 2 + 1] = src[1];
+						r[i] = src[0];
+					}
+				}
+
+				auto* dest = aBlocks + (aBlockY * blocksX + blockX) * blockSize;
+				switch (aFormat) {
+				case gli::FORMAT_R_ATI1N_UNORM_BLOCK8:
+					stb_compress_bc4_block(dest, r.data());
+					break;
+				case gli::FORMAT_RG_ATI2N_UNORM_BLOCK16:
+					stb_compress_bc5_block(dest, rg.data());
+					break;
+				case gli::FORMAT_RGBA_DXT5_UNORM_BLOCK16:
+				case gli::FORMAT_RGBA_DXT5_SRGB_BLOCK16:
+					stb_compress_dxt_block(dest, rgba.data(), 1, STB_DXT_HIGHQUAL);
+					break;
+				default:
+					stb_compress_dxt_block(dest, rgba.data(), 0, STB_DXT_HIGHQUAL);
+					break;
+				}
+			}
+		});
+	}
+}
@@ -0,0 +1,170 @@
+#include "work_stealing_pool.hpp"
+
+namespace avk
+{
+	work_stealing_pool::work_stealing_pool(uint32_t aNumThreads)
+		: mFunc{ nullptr }
+		, mGrainSize{ 1 }
+		, mGeneration{ 0 }
+		, mNumActiveWorkers{ 0 }
+		, mStop{ false }
+		, mRemaining{ 0 }
+	{
+		if (0 == aNumThreads) {
+			aNumThreads = std::max(std::thread::hardware_concurrency(), 1u);
+		}
+		// Slot 0 belongs to the thread which invokes parallel_for:
+		for (uint32_t i = 0; i < aNumThreads; ++i) {
+			mRanges.push_back(std::make_unique<index_range>());
+		}
+		mWorkers.reserve(aNumThreads - 1);
+		for (uint32_t i = 1; i < aNumThreads; ++i) {
+			mWorkers.emplace_back([this, i]() { worker_loop(i); });
+		}
+	}
+
+	work_stealing_pool::~work_stealing_pool()
+	{
+		{
+			std::scoped_lock lock(mMutex);
+			mStop = true;
+		}
+		mStarted.notify_all();
+		for (auto& w : mWorkers) {
+			w.join();
+		}
+	}
+
+	void work_stealing_pool::parallel_for(size_t aCount, const std::function<void(size_t)>& aFunc, size_t aGrainSize)
+	{
+		if (0 == aCount) {
+			return;
+		}
+
+		std::scoped_lock loopLock(mLoopMutex);
+		{
+			std::scoped_lock lock(mMutex);
+			mFunc = &aFunc;
+			mGrainSize = std::max<size_t>(aGrainSize, 1);
+			mException = nullptr;
+			mRemaining = aCount;
+
+			// Split the index range evenly among all slots:
+			const auto n = mRanges.size();
+			for (size_t i = 0; i < n; ++i) {
+				std::scoped_lock rangeLock(mRanges[i]->mMutex);
+				mRanges[i]->mBegin = aCount * i / n;
+				mRanges[i]->mEnd = aCount * (i + 1) / n;
+			}
+			++mGeneration;
+		}
+		mStarted.notify_all();
+
+		work(0);
+
+		std::exception_ptr exception;
+		{
+			// All indices have been processed, but workers might still be about to leave work():
+			std::unique_lock lock(mMutex);
+			mFinished.wait(lock, [this]() { return 0 == mRemaining && 0 == mNumActiveWorkers; });
+			mFunc = nullptr;
+			exception = mException;
+		}
+		if (exception) {
+			std::rethrow_exception(exception);
+		}
+	}
+
+	void work_stealing_pool::worker_loop(size_t aSlot)
+	{
+		uint64_t lastGeneration = 0;
+		while (true) {
+			{
+				std::unique_lock lock(mMutex);
+				mStarted.wait(lock, [this, lastGeneration]() { return mStop || mGeneration != lastGeneration; });
+				if (mStop) {
+					return;
+				}
+				lastGeneration = mGeneration;
+				// Do not join a loop which has already been completed by the other threads:
+				if (0 == mRemaining) {
+					continue;
+				}
+				++mNumActiveWorkers;
+			}
+
+			work(aSlot);
+
+			{
+				std::scoped_lock lock(mMutex);
+				--mNumActiveWorkers;
+			}
+			mFinished.notify_all();
+		}
+	}
+
+	void work_stealing_pool::work(size_t aSlot)
+	{
+		auto& own = *mRanges[aSlot];
+		do {
+			while (true) {
+				size_t begin, end;
+				{
+					std::scoped_lock lock(own.mMutex);
+					if (own.mBegin >= own.mEnd) {
+						break;
+					}
+					begin = own.mBegin;
+					end = std::min(own.mBegin + mGrainSize, own.mEnd);
+					own.mBegin = end;
+				}
+
+				try {
+					for (auto i = begin; i < end; ++i) {
+						(*mFunc)(i);
+					}
+				}
+				catch (...) {
+					std::scoped_lock lock(mMutex);
+					if (!mException) {
+						mException = std::current_exception();
+					}
+				}
+
+				if (mRemaining.fetch_sub(end - begin) == end - begin) {
+					// This was the last chunk of the loop:
+					std::scoped_lock lock(mMutex);
+					mFinished.notify_all();
+				}
+			}
+		} while (steal(aSlot));
+	}
+
+	bool work_stealing_pool::steal(size_t aSlot)
+	{
+		const auto n = mRanges.size();
+		for (size_t offset = 1; offset < n; ++offset) {
+			auto& victim = *mRanges[(aSlot + offset) % n];
+			size_t begin, end;
+			{
+				std::scoped_lock lock(victim.mMutex);
+				const auto remaining = victim.mEnd - std::min(victim.mBegin, victim.mEnd);
+				if (0 == remaining) {
+					continue;
+				}
+				// Take the back half, but the whole rest if it does not exceed one chunk:
+				const auto count = remaining <= mGrainSize ? remaining : remaining / 2;
+				end = victim.mEnd;
+				begin = end - count;
+				victim.mEnd = begin;
+			}
+
+			auto& own = *mRanges[aSlot];
+			std::scoped_lock lock(own.mMutex);
+			own.mBegin = begin;
+			own.mEnd = end;
+			return true;
+		}
+		return false;
+	}
+}
@@ -0,0 +1,24 @@
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+
+#include "auto_vk_toolkit.hpp"
+#include "animation_benchmark.hpp"
+
+// Measures the bone matrix throughput of avk::animation by clip length, during playback, with random access, and of the
+// compressed clips, and how the batch evaluation of a crowd scales with the number of threads (see animation_benchmark).
+// CPU only, i.e., neither a window nor a Vulkan device is needed.
+// Usage: avk_animation_benchmark [report.json]
+int main(int argc, char** argv)
+{
+	try {
+		animation_benchmark benchmark;
+		benchmark.run();
+		benchmark.write_json(argc > 1 ? argv[1] : "animation_benchmark.json");
+	}
+	catch (const std::exception& e) {
+		std::cerr << "Animation benchmark failed: " << e.what() << std::endl;
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,261 @@
+#pragma once
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "auto_vk_toolkit.hpp"
+#include "animation.hpp"
+#include "compressed_animation_helpers.hpp"
+
+/** CPU microbenchmark which measures how many bone matrices avk::animation evaluates per second, depending on the clip length.
+ *
+ *  A synthetic skeleton (a chain of bones) is animated with clips of increasing numbers of keys per channel. Every clip is
+ *  evaluated twice: once with monotonically increasing animation times (i.e., regular playback, where the keys are found
+ *  via the per-node cursors), and once with random animation times (where the keys are found via binary search).
+ *  Every clip is also compressed (see animation::compress_clip), and the compressed clip's memory usage, errors, and
+ *  playback throughput are reported.
+ *  Afterwards, a crowd of instances is evaluated via animation::animate_batch_into_strided_targets with an increasing
+ *  number of threads, to show how the batch evaluation scales. The results are logged and written into a JSON report.
+ *
+ *  Usage example:
+ *
+ *	animation_benchmark benchmark;
+ *	benchmark.run();
+ *	benchmark.write_json("animation_benchmark.json");
+ */
+class animation_benchmark
+{
+	struct result
+	{
+		size_t mNumKeysPerChannel;
+		double mMonotonicBoneMatricesPerSecond;
+		double mRandomAccessBoneMatricesPerSecond;
+		double mCompressedBoneMatricesPerSecond;
+		avk::animation_compression_statistics mCompression;
+	};
+
+	struct crowd_result
+	{
+		uint32_t mNumThreads;
+		double mBoneMatricesPerSecond;
+	};
+
+public:
+	/**	@param	aNumBones			Number of bones of the synthetic skeleton
+	 *	@param	aNumEvaluations		Number of times the whole skeleton is evaluated per clip and mode
+	 */
+	explicit animation_benchmark(size_t aNumBones = 64, size_t aNumEvaluations = 4096)
+		: mNumBones{ aNumBones }
+		, mNumEvaluations{ aNumEvaluations }
+	{
+	}
+
+	/** Measures all clip lengths, and the crowd evaluation */
+	void run()
+	{
+		mResults.clear();
+		mCrowdResults.clear();
+		for (size_t numKeys : { 16, 64, 256, 1024, 4096, 16384 }) {
+			auto ani = create_animation(numKeys);
+			const avk::animation_clip_data clip{ 0u, cTicksPerSecond, 0.0, static_cast<double>(numKeys - 1) };
+			std::vector<glm::mat4> boneMatrices(mNumBones);
+
+			// Regular playback at 60 frames per second, wrapping around at the end of the clip:
+			std::vector<double> times(mNumEvaluations);
+			for (size_t i = 0; i < mNumEvaluations; ++i) {
+				times[i] = std::fmod(static_cast<double>(i) / 60.0, clip.end_time());
+			}
+			const auto monotonic = measure(ani, clip, times, boneMatrices);
+
+			// Random access, e.g., when seeking:
+			std::mt19937 rng{ 42u };
+			std::uniform_real_distribution<double> dist{ 0.0, clip.end_time() };
+			for (auto& t : times) {
+				t = dist(rng);
+			}
+			const auto randomAccess = measure(ani, clip, times, boneMatrices);
+
+			// Playback of the compressed clip:
+			const auto compressed = ani.compress_clip(clip);
+			for (size_t i = 0; i < mNumEvaluations; ++i) {
+				times[i] = std::fmod(static_cast<double>(i) / 60.0, clip.end_time());
+			}
+			const auto compressedPlayback = measure(ani, compressed, times, boneMatrices);
+
+			mResults.push_back({ numKeys, monotonic, randomAccess, compressedPlayback, compressed.statistics() });
+			LOG_INFO_EM(std::format("Animation benchmark: {} keys per channel => {:.2f} M bone matrices/s during playback, {:.2f} M bone matrices/s with random access, {:.2f} M bone matrices/s compressed",
+				numKeys, monotonic * 1e-6, randomAccess * 1e-6, compressedPlayback * 1e-6));
+			avk::log_animation_compression_statistics(std::format("{} keys per channel", numKeys), compressed);
+		}
+
+		run_crowd();
+	}
+
+	/**	Writes the results of the last run.
+	 *	@param	aPath		Path of the JSON file, which is overwritten
+	 */
+	void write_json(const std::string& aPath) const
+	{
+		nlohmann::json report;
+		report["num_bones"] = mNumBones;
+		report["num_evaluations"] = mNumEvaluations;
+		auto results = nlohmann::json::array();
+		for (const auto& r : mResults) {
+			results.push_back({
+				{ "keys_per_channel", r.mNumKeysPerChannel },
+				{ "monotonic_bone_matrices_per_second", r.mMonotonicBoneMatricesPerSecond },
+				{ "random_access_bone_matrices_per_second", r.mRandomAccessBoneMatricesPerSecond },
+				{ "compressed_bone_matrices_per_second", r.mCompressedBoneMatricesPerSecond },
+				{ "raw_bytes", r.mCompression.mRawBytes },
+				{ "compressed_bytes", r.mCompression.mCompressedBytes },
+				{ "compression_ratio", r.mCompression.compression_ratio() },
+				{ "max_position_error", r.mCompression.mMaxPositionError },
+				{ "max_rotation_error", r.mCompression.mMaxRotationError },
+				{ "max_scale_error", r.mCompression.mMaxScaleError }
+			});
+		}
+		report["results"] = std::move(results);
+		report["crowd_instances"] = cNumCrowdInstances;
+		auto crowd = nlohmann::json::array();
+		for (const auto& r : mCrowdResults) {
+			crowd.push_back({
+				{ "threads", r.mNumThreads },
+				{ "bone_matrices_per_second", r.mBoneMatricesPerSecond }
+			});
+		}
+		report["crowd_results"] = std::move(crowd);
+
+		std::ofstream file(aPath, std::ios::out | std::ios::trunc);
+		if (!file.is_open()) {
+			throw avk::runtime_error("Could not open file " + aPath);
+		}
+		file << report.dump(1, '\t') << '\n';
+		LOG_INFO_EM("Animation benchmark report written to '" + aPath + "'");
+	}
+
+private:
+	static constexpr double cTicksPerSecond = 30.0;
+	static constexpr size_t cNumCrowdInstances = 512;
+	static constexpr size_t cNumCrowdKeys = 1024;
+	static constexpr size_t cNumCrowdFrames = 64;
+
+	/** Evaluates a crowd with 1, 2, 4, ... threads up to the hardware concurrency */
+	void run_crowd()
+	{
+		auto ani = create_animation(cNumCrowdKeys);
+		const avk::animation_clip_data clip{ 0u, cTicksPerSecond, 0.0, static_cast<double>(cNumCrowdKeys - 1) };
+
+		// Every instance plays the clip with a different offset, and keeps its own cursors:
+		std::vector<glm::mat4> boneMatrices(cNumCrowdInstances * mNumBones);
+		std::vector<std::vector<avk::keyframe_cursor>> cursors(cNumCrowdInstances);
+		std::vector<avk::animation_instance> instances(cNumCrowdInstances);
+		for (size_t i = 0; i < cNumCrowdInstances; ++i) {
+			instances[i] = avk::animation_instance{ clip, 0.0, &boneMatrices[i * mNumBones], 0, sizeof(glm::mat4), &cursors[i] };
+		}
+		auto setTimes = [&](size_t aFrame) {
+			for (size_t i = 0; i < cNumCrowdInstances; ++i) {
+				instances[i].mTime = std::fmod(static_cast<double>(aFrame) / 60.0 + static_cast<double>(i) * 0.37, clip.end_time());
+			}
+		};
+
+		const auto maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+		for (uint32_t numThreads = 1; ; numThreads = std::min(numThreads * 2, maxThreads)) {
+			avk::work_stealing_pool pool{ numThreads };
+			const auto begin = std::chrono::high_resolution_clock::now();
+			for (size_t f = 0; f < cNumCrowdFrames; ++f) {
+				setTimes(f);
+				ani.animate_batch_into_strided_targets(instances, pool);
+			}
+			const auto seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - begin).count();
+			const auto throughput = static_cast<double>(cNumCrowdFrames * cNumCrowdInstances * mNumBones) / std::max(seconds, 1e-9);
+			mCrowdResults.push_back({ numThreads, throughput });
+			LOG_INFO_EM(std::format("Animation benchmark: crowd of {} instances with {} threads => {:.2f} M bone matrices/s",
+				cNumCrowdInstances, numThreads, throughput * 1e-6));
+			if (numThreads == maxThreads) {
+				break;
+			}
+		}
+
+		// The batch evaluation must produce the same bone matrices as the single-instance path:
+		std::vector<glm::mat4> reference(mNumBones);
+		for (size_t i = 0; i < cNumCrowdInstances; ++i) {
+			ani.animate_into_strided_target_per_mesh(clip, instances[i].mTime, reference.data(), 0);
+			if (0 != std::memcmp(reference.data(), &boneMatrices[i * mNumBones], mNumBones * sizeof(glm::mat4))) {
+				LOG_WARNING_EM(std::format("Animation benchmark: batch result of instance {} differs from the single-instance result", i));
+			}
+		}
+	}
+
+	/** Creates a chain of bones, every one of which has aNumKeys keys per channel at the ticks 0, 1, 2, ...
+	 *  The bones move smoothly, with some noise on top, similar to motion capture data.
+	 */
+	avk::animation create_animation(size_t aNumKeys) const
+	{
+		std::mt19937 rng{ 7u };
+		std::uniform_real_distribution<float> dist{ -1.0f, 1.0f };
+
+		std::vector<avk::animated_node> nodes(mNumBones);
+		for (size_t bi = 0; bi < mNumBones; ++bi) {
+			auto& anode = nodes[bi];
+			const auto phase = dist(rng) * 3.14159f;
+			const auto axis = glm::normalize(glm::vec3{ dist(rng), dist(rng), dist(rng) });
+			for (size_t k = 0; k < aNumKeys; ++k) {
+				const auto t = static_cast<double>(k);
+				const auto s = std::sin(static_cast<float>(k) * 0.05f + phase);
+				anode.mPositionKeys.push_back({ t, glm::vec3{ s, 0.5f * s, 0.1f } + glm::vec3{ dist(rng), dist(rng), dist(rng) } * 1e-5f });
+				anode.mRotationKeys.push_back({ t, glm::angleAxis(s + dist(rng) * 1e-4f, axis) });
+				anode.mScalingKeys.push_back({ t, glm::vec3{ 1.0f } });
+			}
+			// Search every channel separately, which is the worst case:
+			anode.mSameRotationAndPositionKeyTimes = false;
+			anode.mSameScalingAndPositionKeyTimes = false;
+			anode.mLocalTransform = glm::mat4{ 1.0f };
+			anode.mGlobalTransform = glm::mat4{ 1.0f };
+			anode.mParentTransform = glm::mat4{ 1.0f };
+			if (bi > 0) {
+				anode.mAnimatedParentIndex = bi - 1;
+			}
+			avk::bone_mesh_data target{};
+			target.mInverseBindPoseMatrix = glm::mat4{ 1.0f };
+			target.mInverseMeshRootMatrix = glm::mat4{ 1.0f };
+			target.mMeshBoneInfo = avk::mesh_bone_info{ 0, 0, static_cast<uint32_t>(bi), 0 };
+			anode.mBoneMeshTargets.push_back(target);
+		}
+		return avk::animation::from_animated_nodes(std::move(nodes), 0u, mNumBones);
+	}
+
+	/** Evaluates the compressed clip at all given times, and returns the number of bone matrices per second */
+	double measure(avk::animation& aAnimation, const avk::compressed_animation_clip& aClip, const std::vector<double>& aTimes, std::vector<glm::mat4>& aBoneMatrices) const
+	{
+		auto* target = aBoneMatrices.data();
+		const auto begin = std::chrono::high_resolution_clock::now();
+		for (const auto t : aTimes) {
+			aAnimation.animate(aClip, t, [target](avk::mesh_bone_info aInfo, const glm::mat4& aInverseMeshRootMatrix, const glm::mat4& aTransformMatrix, const glm::mat4& aInverseBindPoseMatrix) {
+				target[aInfo.mGlobalBoneIndexOffset + aInfo.mMeshLocalBoneIndex] = aInverseMeshRootMatrix * aTransformMatrix * aInverseBindPoseMatrix;
+			});
+		}
+		const auto seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - begin).count();
+		return static_cast<double>(aTimes.size() * mNumBones) / std::max(seconds, 1e-9);
+	}
+
+	/** Evaluates the animation at all given times, and returns the number of bone matrices per second */
+	double measure(avk::animation& aAnimation, const avk::animation_clip_data& aClip, const std::vector<double>& aTimes, std::vector<glm::mat4>& aBoneMatrices) const
+	{
+		const auto begin = std::chrono::high_resolution_clock::now();
+		for (const auto t : aTimes) {
+			aAnimation.animate_into_single_target_buffer(aClip, t, aBoneMatrices.data());
+		}
+		const auto seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - begin).count();
+		return static_cast<double>(aTimes.size() * mNumBones) / std::max(seconds, 1e-9);
+	}
+
+	size_t mNumBones;
+	size_t mNumEvaluations;
+	std::vector<result> mResults;
+	std::vector<crowd_result> mCrowdResults;
+};
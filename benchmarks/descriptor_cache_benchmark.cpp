@@ -0,0 +1,27 @@
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+
+#include "auto_vk_toolkit.hpp"
+#include "configure_and_compose.hpp"
+#include "descriptor_cache_benchmark.hpp"
+
+// Measures the cache hits per second of avk::descriptor_cache_t with and without its lookup table, for the descriptor sets
+// of the demo's rasterization pass and of a post-processing pass (see descriptor_cache_benchmark).
+// Needs a Vulkan device, but no window. Fails if both paths return different descriptor sets.
+// Usage: avk_descriptor_cache_benchmark [report.json]
+int main(int argc, char** argv)
+{
+	try {
+		// A context without windows; the composition is not started:
+		auto composition = avk::configure_and_compose(avk::application_name("avk_descriptor_cache_benchmark"));
+		descriptor_cache_benchmark benchmark;
+		const bool passed = benchmark.run();
+		benchmark.write_json(argc > 1 ? argv[1] : "descriptor_cache_benchmark.json");
+		return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+	catch (const std::exception& e) {
+		std::cerr << "Descriptor cache benchmark failed: " << e.what() << std::endl;
+		return EXIT_FAILURE;
+	}
+}
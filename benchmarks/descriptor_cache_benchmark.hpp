@@ -0,0 +1,177 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "auto_vk_toolkit.hpp"
+
+/** Measures how many cache hits per second avk::descriptor_cache_t delivers, with and without its lookup table.
+ *
+ *  Buffers and aNumImageSamplers 1x1 px image samplers are bound like in two of the demo's passes: the rasterization pass
+ *  (an array of all image samplers and two uniform buffers in set 0, three storage buffers in set 1), and a post-processing
+ *  pass (two combined image samplers and a uniform buffer). After one request has put their descriptor sets into the cache,
+ *  the same bindings are requested aNumIterations times via find_or_alloc_descriptor_sets, which prepares complete descriptor
+ *  sets for every request like get_or_create_descriptor_sets did before it had a lookup table, and aNumIterations times via
+ *  get_or_create_descriptor_sets. Both must return the same descriptor sets.
+ *  Requires an initialized context. The results are logged and written into a JSON report.
+ *
+ *  Usage example:
+ *
+ *	descriptor_cache_benchmark benchmark;
+ *	const bool passed = benchmark.run();
+ *	benchmark.write_json("descriptor_cache_benchmark.json");
+ */
+class descriptor_cache_benchmark
+{
+	struct result
+	{
+		std::string mScenario;
+		double mPreparedHitsPerSecond;
+		double mLookupHitsPerSecond;
+		bool mSameSets;
+	};
+
+public:
+	/**	@param	aNumImageSamplers	Number of image samplers in the rasterization pass's array
+	 *	@param	aNumIterations		Number of requests per scenario and path
+	 */
+	explicit descriptor_cache_benchmark(uint32_t aNumImageSamplers = 256, uint32_t aNumIterations = 100000)
+		: mNumImageSamplers{ aNumImageSamplers }
+		, mNumIterations{ aNumIterations }
+	{
+	}
+
+	/**	Measures both scenarios.
+	 *	@return	true if both paths have returned the same descriptor sets
+	 */
+	bool run()
+	{
+		mResults.clear();
+		create_resources();
+
+		measure("rasterization", [this](auto aGetSets) {
+			return aGetSets({
+				avk::descriptor_binding(0, 0, mCombinedImageSamplers),
+				avk::descriptor_binding(0, 1, mUniformBuffers[0]),
+				avk::descriptor_binding(0, 2, mUniformBuffers[1]),
+				avk::descriptor_binding(1, 0, mStorageBuffers[0]),
+				avk::descriptor_binding(1, 1, mStorageBuffers[1]),
+				avk::descriptor_binding(1, 2, mStorageBuffers[2])
+			});
+		});
+		measure("post-processing", [this](auto aGetSets) {
+			return aGetSets({
+				avk::descriptor_binding(0, 0, mImageSamplers[0]->as_combined_image_sampler(avk::layout::shader_read_only_optimal)),
+				avk::descriptor_binding(0, 1, mImageSamplers[1]->as_combined_image_sampler(avk::layout::shader_read_only_optimal)),
+				avk::descriptor_binding(0, 2, mUniformBuffers[0])
+			});
+		});
+		return std::all_of(mResults.begin(), mResults.end(), [](const result& r) { return r.mSameSets; });
+	}
+
+	/** Writes all results of the last run into a JSON file */
+	void write_json(const std::string& aPath) const
+	{
+		nlohmann::json report;
+		report["image_samplers"] = mNumImageSamplers;
+		report["iterations"] = mNumIterations;
+		auto results = nlohmann::json::array();
+		for (const auto& r : mResults) {
+			results.push_back({
+				{ "scenario", r.mScenario },
+				{ "prepared_hits_per_second", r.mPreparedHitsPerSecond },
+				{ "lookup_hits_per_second", r.mLookupHitsPerSecond },
+				{ "speedup", r.mLookupHitsPerSecond / r.mPreparedHitsPerSecond },
+				{ "same_sets", r.mSameSets }
+			});
+		}
+		report["results"] = std::move(results);
+
+		std::ofstream file(aPath, std::ios::out | std::ios::trunc);
+		if (!file.is_open()) {
+			throw avk::runtime_error("Could not open file " + aPath);
+		}
+		file << report.dump(1, '\t') << '\n';
+		LOG_INFO_EM("Descriptor cache report written to '" + aPath + "'");
+	}
+
+private:
+	static std::size_t checksum(const std::vector<avk::descriptor_set>& aSets)
+	{
+		std::size_t h = 0;
+		for (const auto& set : aSets) {
+			avk::hash_combine(h, static_cast<VkDescriptorSet>(set.handle()));
+		}
+		return h;
+	}
+
+	void create_resources()
+	{
+		if (mCache.has_value()) {
+			return;
+		}
+		mCache = avk::context().create_descriptor_cache("descriptor_cache_benchmark");
+		for (int i = 0; i < 2; ++i) {
+			mUniformBuffers.push_back(avk::context().create_buffer(avk::memory_usage::device, {}, avk::uniform_buffer_meta::create_from_size(sizeof(glm::mat4))));
+		}
+		for (int i = 0; i < 3; ++i) {
+			mStorageBuffers.push_back(avk::context().create_buffer(avk::memory_usage::device, {}, avk::storage_buffer_meta::create_from_size(1024)));
+		}
+		auto sampler = avk::context().create_sampler(avk::filter_mode::bilinear, avk::border_handling_mode::repeat);
+		sampler.enable_shared_ownership();
+		for (uint32_t i = 0; i < std::max(mNumImageSamplers, 2u); ++i) {
+			auto image = avk::context().create_image(1, 1, vk::Format::eR8G8B8A8Unorm, 1, avk::memory_usage::device, avk::image_usage::general_texture);
+			mImageSamplers.push_back(avk::context().create_image_sampler(avk::context().create_image_view(std::move(image)), sampler));
+		}
+		// Gathered once, so that only the cache is measured:
+		mCombinedImageSamplers = avk::as_combined_image_samplers(mImageSamplers, avk::layout::shader_read_only_optimal);
+	}
+
+	/** Requests the scenario's bindings via both paths; aRequest gets a function which takes the bindings and returns the sets' checksum */
+	template <typename R>
+	void measure(const std::string& aScenario, R aRequest)
+	{
+		const auto prepared = [this](std::initializer_list<avk::binding_data> aBindings) {
+			return checksum(mCache->find_or_alloc_descriptor_sets(aBindings));
+		};
+		const auto lookup = [this](std::initializer_list<avk::binding_data> aBindings) {
+			return checksum(mCache->get_or_create_descriptor_sets(aBindings));
+		};
+
+		// Allocates the sets, and puts them into the lookup table:
+		const auto expected = aRequest(lookup);
+		result r{ aScenario };
+		r.mSameSets = aRequest(prepared) == expected;
+		r.mPreparedHitsPerSecond = hits_per_second([&]() { return aRequest(prepared); }, expected, r.mSameSets);
+		r.mLookupHitsPerSecond = hits_per_second([&]() { return aRequest(lookup); }, expected, r.mSameSets);
+
+		LOG_INFO(std::format("Descriptor cache, {}: {:.0f} hits/s with prepared sets, {:.0f} hits/s with the lookup table ({:.1f}x){}",
+			aScenario, r.mPreparedHitsPerSecond, r.mLookupHitsPerSecond, r.mLookupHitsPerSecond / r.mPreparedHitsPerSecond,
+			r.mSameSets ? "" : ", DIFFERENT SETS"));
+		mResults.push_back(std::move(r));
+	}
+
+	template <typename F>
+	double hits_per_second(F aRequest, std::size_t aExpected, bool& aSameSets) const
+	{
+		const auto begin = std::chrono::steady_clock::now();
+		for (uint32_t i = 0; i < mNumIterations; ++i) {
+			aSameSets = aRequest() == aExpected && aSameSets;
+		}
+		const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+		return static_cast<double>(mNumIterations) / std::max(seconds, 1e-9);
+	}
+
+	uint32_t mNumImageSamplers;
+	uint32_t mNumIterations;
+	std::vector<result> mResults;
+
+	avk::descriptor_cache mCache;
+	std::vector<avk::buffer> mUniformBuffers;
+	std::vector<avk::buffer> mStorageBuffers;
+	std::vector<avk::image_sampler> mImageSamplers;
+	std::vector<avk::combined_image_sampler_descriptor_info> mCombinedImageSamplers;
+};
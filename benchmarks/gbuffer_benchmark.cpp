@@ -0,0 +1,27 @@
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+
+#include "auto_vk_toolkit.hpp"
+#include "gbuffer_benchmark.hpp"
+
+// Measures the precision of the compact G-buffer's reconstructed positions and normals against the full-precision layout,
+// with the demo's camera planes, and reports the memory of both layouts (see gbuffer_benchmark).
+// CPU only, i.e., neither a window nor a Vulkan device is needed. Fails if an error exceeds its bound.
+// Usage: avk_gbuffer_benchmark [report.json]
+int main(int argc, char** argv)
+{
+	// The near and far planes of the demo's cameras:
+	constexpr float cNear = 0.3f;
+	constexpr float cFar = 1000.0f;
+	try {
+		gbuffer_benchmark benchmark(cNear, cFar);
+		const bool passed = benchmark.run();
+		benchmark.write_json(argc > 1 ? argv[1] : "gbuffer_benchmark.json");
+		return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+	catch (const std::exception& e) {
+		std::cerr << "G-buffer benchmark failed: " << e.what() << std::endl;
+		return EXIT_FAILURE;
+	}
+}
@@ -0,0 +1,196 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "auto_vk_toolkit.hpp"
+#include "gbuffer_layout.hpp"
+
+/** CPU-only precision checks of the gbuffer_format::compact layout (see gbuffer_layout.hpp) against the full-precision one.
+ *
+ *  Random view-space points within the camera's frustum are projected into a D32 depth value, as the rasterization pass
+ *  stores it, and reconstructed again, as the SSAO pass does. The largest error relative to the point's distance is compared
+ *  against the precision of the depth buffer at that distance, for distance ranges from the near plane to the far plane.
+ *  Random normals are encoded into RG16 SNORM and decoded again, both in view space and transformed into world space via
+ *  random inverse view matrices, and their largest angular errors are compared against cMaxNormalErrorDegrees.
+ *  Additionally, the memory of both layouts is reported for common resolutions.
+ *  The results are logged and written into a JSON report.
+ *
+ *  Usage example:
+ *
+ *	gbuffer_benchmark benchmark(CAM_NEAR, CAM_FAR);
+ *	const bool passed = benchmark.run();
+ *	benchmark.write_json("gbuffer_benchmark.json");
+ */
+class gbuffer_benchmark
+{
+	struct result
+	{
+		std::string mCheck;
+		double mMaxError;
+		double mBound;
+		bool mPassed;
+	};
+
+public:
+	/**	@param	aNear			Near plane distance of the camera
+	 *	@param	aFar			Far plane distance of the camera
+	 *	@param	aNumSamples		Number of random points and normals per check
+	 */
+	gbuffer_benchmark(float aNear, float aFar, size_t aNumSamples = 1000000)
+		: mNear{ aNear }
+		, mFar{ aFar }
+		, mNumSamples{ aNumSamples }
+	{
+	}
+
+	/**	Runs all checks.
+	 *	@return	true if all errors are within their bounds
+	 */
+	bool run()
+	{
+		mResults.clear();
+		std::mt19937 rng{ 42u };
+		// The same projection as the demo's cameras use:
+		avk::camera camera;
+		camera.set_perspective_projection(glm::radians(30.0f), 16.0f / 9.0f, mNear, mFar);
+		for (float from = mNear; from < mFar; from *= 10.0f) {
+			check_positions(rng, camera.projection_matrix(), from, std::min(from * 10.0f, mFar));
+		}
+		check_normals(rng);
+		report_memory();
+		return std::all_of(mResults.begin(), mResults.end(), [](const result& r) { return r.mPassed; });
+	}
+
+	/** Writes all results of the last run into a JSON file */
+	void write_json(const std::string& aPath) const
+	{
+		nlohmann::json report;
+		report["samples"] = mNumSamples;
+		report["bytes_per_pixel_full_precision"] = gbuffer_layout::bytes_per_pixel(gbuffer_format::full_precision);
+		report["bytes_per_pixel_compact"] = gbuffer_layout::bytes_per_pixel(gbuffer_format::compact);
+		auto results = nlohmann::json::array();
+		for (const auto& r : mResults) {
+			results.push_back({
+				{ "check", r.mCheck },
+				{ "max_error", r.mMaxError },
+				{ "bound", r.mBound },
+				{ "passed", r.mPassed }
+			});
+		}
+		report["results"] = std::move(results);
+
+		std::ofstream file(aPath, std::ios::out | std::ios::trunc);
+		if (!file.is_open()) {
+			throw avk::runtime_error("Could not open file " + aPath);
+		}
+		file << report.dump(1, '\t') << '\n';
+		LOG_INFO_EM("G-buffer report written to '" + aPath + "'");
+	}
+
+private:
+	static constexpr double cMaxNormalErrorDegrees = 0.005;
+
+	static glm::vec3 random_unit_vector(std::mt19937& aRng)
+	{
+		std::normal_distribution<float> dist;
+		glm::vec3 v;
+		do {
+			v = glm::vec3{ dist(aRng), dist(aRng), dist(aRng) };
+		} while (glm::dot(v, v) < 1e-6f);
+		return glm::normalize(v);
+	}
+
+	static double angle_degrees(const glm::dvec3& a, const glm::dvec3& b)
+	{
+		// Not via acos, which would be off by up to 0.02 degrees near 1:
+		return glm::degrees(std::atan2(glm::length(glm::cross(a, b)), glm::dot(a, b)));
+	}
+
+	void check_positions(std::mt19937& aRng, const glm::mat4& aProjection, float aFrom, float aTo)
+	{
+		const auto inverseProjection = glm::inverse(aProjection);
+		std::uniform_real_distribution<float> ndc{ -1.0f, 1.0f };
+		std::uniform_real_distribution<float> distance{ aFrom, aTo };
+
+		double maxError = 0.0;
+		for (size_t i = 0; i < mNumSamples; ++i) {
+			// A point at the given distance which is visible at the given normalized device coordinates:
+			const auto direction = glm::normalize(glm::vec3{ inverseProjection * glm::vec4{ ndc(aRng), ndc(aRng), 1.0f, 1.0f } });
+			const auto p = direction * distance(aRng);
+
+			// What the rasterization pass stores, and what the screen-space pass interpolates:
+			const auto clip = aProjection * glm::vec4{ p, 1.0f };
+			const float depth = clip.z / clip.w;
+			const glm::vec2 texCoord = glm::vec2{ clip } / clip.w * 0.5f + 0.5f;
+
+			const auto reconstructed = gbuffer_layout::reconstruct_view_position(texCoord, depth, inverseProjection);
+			maxError = std::max(maxError, glm::length(glm::dvec3{ reconstructed } - glm::dvec3{ p }) / glm::length(glm::dvec3{ p }));
+		}
+		// The depth value's derivative w.r.t. the distance z is about near / z^2, i.e., a float rounding error of the depth value,
+		// or a cancellation in the projection or in its inverse, changes the distance relative to z by about epsilon * z / near:
+		const double epsilon = std::numeric_limits<float>::epsilon();
+		report({ std::format("positions at {:g}-{:g} m (error / distance)", aFrom, aTo), maxError, 2.0 * epsilon * aTo / mNear + 16.0 * epsilon });
+	}
+
+	void check_normals(std::mt19937& aRng)
+	{
+		std::vector<glm::vec3> normals;
+		// The axes and the seams of the folded octahedron are the edge cases:
+		for (const auto& n : { glm::vec3{ 1, 0, 0 }, glm::vec3{ -1, 0, 0 }, glm::vec3{ 0, 1, 0 }, glm::vec3{ 0, -1, 0 }, glm::vec3{ 0, 0, 1 }, glm::vec3{ 0, 0, -1 },
+		                       glm::vec3{ 1, 1, 0 }, glm::vec3{ -1, 1, 0 }, glm::vec3{ 1, -1, 0 }, glm::vec3{ -1, -1, 0 }, glm::vec3{ 1, 1, -1 }, glm::vec3{ -1, -1, -1 } }) {
+			normals.push_back(glm::normalize(n));
+		}
+		while (normals.size() < mNumSamples) {
+			normals.push_back(random_unit_vector(aRng));
+		}
+
+		std::uniform_real_distribution<float> angle{ 0.0f, glm::two_pi<float>() };
+		double maxErrorVS = 0.0;
+		double maxErrorWS = 0.0;
+		for (const auto& n : normals) {
+			const auto decoded = gbuffer_layout::decode_normal(gbuffer_layout::encode_normal(n));
+			maxErrorVS = std::max(maxErrorVS, angle_degrees(glm::dvec3{ decoded }, glm::dvec3{ n }));
+
+			// The illumination pass transforms the decoded normal with the inverse view matrix of a rigid camera:
+			const auto inverseView = glm::rotate(glm::mat4{ 1.0f }, angle(aRng), random_unit_vector(aRng));
+			const auto decodedWS = glm::mat3{ inverseView } * decoded;
+			const auto expectedWS = glm::dmat3{ glm::dmat4{ inverseView } } * glm::dvec3{ n };
+			maxErrorWS = std::max(maxErrorWS, angle_degrees(glm::dvec3{ decodedWS }, expectedWS));
+		}
+		report({ "view-space normals (degrees)", maxErrorVS, cMaxNormalErrorDegrees });
+		report({ "world-space normals (degrees)", maxErrorWS, cMaxNormalErrorDegrees });
+	}
+
+	void report_memory() const
+	{
+		const auto full = gbuffer_layout::bytes_per_pixel(gbuffer_format::full_precision);
+		const auto compact = gbuffer_layout::bytes_per_pixel(gbuffer_format::compact);
+		for (const auto& [w, h] : { std::pair{ 1920u, 1080u }, std::pair{ 2560u, 1440u }, std::pair{ 3840u, 2160u } }) {
+			LOG_INFO(std::format("G-buffer at {}x{}: {:.1f} MiB -> {:.1f} MiB ({} -> {} bytes per pixel)", w, h,
+				static_cast<double>(full) * w * h / (1024.0 * 1024.0), static_cast<double>(compact) * w * h / (1024.0 * 1024.0), full, compact));
+		}
+	}
+
+	void report(result aResult)
+	{
+		aResult.mPassed = aResult.mMaxError <= aResult.mBound;
+		const auto message = std::format("{:<45} max. error {:.3e}, bound {:.3e}", aResult.mCheck, aResult.mMaxError, aResult.mBound);
+		if (aResult.mPassed) {
+			LOG_INFO(message);
+		}
+		else {
+			LOG_ERROR("FAILED: " + message);
+		}
+		mResults.push_back(aResult);
+	}
+
+	float mNear;
+	float mFar;
+	size_t mNumSamples;
+	std::vector<result> mResults;
+};
@@ -0,0 +1,24 @@
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+
+#include "auto_vk_toolkit.hpp"
+#include "log_benchmark.hpp"
+
+// Measures how much logging costs 1, 2, 4, ... producer threads at once, with avk::log_queue and with the mutex-protected
+// queue which it has replaced as the baseline (see log_benchmark).
+// CPU only, i.e., neither a window nor a Vulkan device is needed.
+// Usage: avk_log_benchmark [report.json]
+int main(int argc, char** argv)
+{
+	try {
+		log_benchmark benchmark;
+		benchmark.run();
+		benchmark.write_json(argc > 1 ? argv[1] : "log_benchmark.json");
+	}
+	catch (const std::exception& e) {
+		std::cerr << "Log benchmark failed: " << e.what() << std::endl;
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
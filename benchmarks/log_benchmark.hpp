@@ -0,0 +1,228 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "auto_vk_toolkit.hpp"
+#include "log_queue.hpp"
+
+/** CPU microbenchmark which measures how much logging from several threads at once costs the logging threads.
+ *
+ *  N producer threads log the same number of messages each, with N = 1, 2, 4, ... up to the number of hardware threads.
+ *  Every configuration is measured twice: with avk::log_queue, and with a mutex-protected std::queue whose consumer
+ *  pops one message at a time (i.e., the way dispatch_log used to work). No sink is attached in both cases, so that only
+ *  the hand-over between producers and the writer thread is measured. Reported are the producers' throughput, their
+ *  mean and 99th percentile time per message, and the number of messages which log_queue has dropped.
+ *  The results are logged and written into a JSON report.
+ *
+ *  Usage example:
+ *
+ *	log_benchmark benchmark;
+ *	benchmark.run();
+ *	benchmark.write_json("log_benchmark.json");
+ */
+class log_benchmark
+{
+	struct result
+	{
+		std::string mQueue;
+		uint32_t mNumProducers;
+		double mMessagesPerSecond;
+		double mMeanNanosecondsPerMessage;
+		double mP99NanosecondsPerMessage;
+		uint64_t mNumDropped;
+	};
+
+public:
+	/**	@param	aNumMessagesPerProducer		Number of messages which every producer thread logs per configuration
+	 */
+	explicit log_benchmark(size_t aNumMessagesPerProducer = 100000)
+		: mNumMessagesPerProducer{ aNumMessagesPerProducer }
+	{
+	}
+
+	/** Measures all numbers of producer threads with both queues */
+	void run()
+	{
+		mResults.clear();
+		const auto maxProducers = std::max(std::thread::hardware_concurrency(), 1u);
+		for (uint32_t numProducers = 1; ; numProducers = std::min(numProducers * 2, maxProducers)) {
+			{
+				avk::log_queue queue{ avk::log_queue_config{ .mConsoleSink = false } };
+				auto r = measure(numProducers, [&queue](const avk::log_pack& aPack) { queue.push(aPack); });
+				queue.flush();
+				r.mQueue = "log_queue";
+				r.mNumDropped = queue.num_dropped();
+				report(r);
+			}
+			{
+				mutex_queue queue;
+				auto r = measure(numProducers, [&queue](const avk::log_pack& aPack) { queue.push(aPack); });
+				r.mQueue = "mutex_queue";
+				r.mNumDropped = 0;
+				report(r);
+			}
+			if (numProducers == maxProducers) {
+				break;
+			}
+		}
+	}
+
+	/** Writes all results of the last run into a JSON file */
+	void write_json(const std::string& aPath) const
+	{
+		nlohmann::json report;
+		report["messages_per_producer"] = mNumMessagesPerProducer;
+		auto results = nlohmann::json::array();
+		for (const auto& r : mResults) {
+			results.push_back({
+				{ "queue", r.mQueue },
+				{ "producers", r.mNumProducers },
+				{ "messages_per_second", r.mMessagesPerSecond },
+				{ "mean_ns_per_message", r.mMeanNanosecondsPerMessage },
+				{ "p99_ns_per_message", r.mP99NanosecondsPerMessage },
+				{ "dropped", r.mNumDropped }
+			});
+		}
+		report["results"] = std::move(results);
+
+		std::ofstream file(aPath, std::ios::out | std::ios::trunc);
+		if (!file.is_open()) {
+			throw avk::runtime_error("Could not open file " + aPath);
+		}
+		file << report.dump(1, '\t') << '\n';
+		LOG_INFO_EM("Log benchmark report written to '" + aPath + "'");
+	}
+
+private:
+	// Every this many messages, the time of a single message is sampled for the percentile:
+	static constexpr size_t cSampleInterval = 16;
+
+	/** The way dispatch_log used to hand messages to the logger thread: one lock per push, two locks per pop. */
+	class mutex_queue
+	{
+	public:
+		mutex_queue()
+			: mContinue{ true }
+			, mThread{ [this]() { consume(); } }
+		{
+		}
+
+		~mutex_queue()
+		{
+			{
+				std::scoped_lock lock(mMutex);
+				mContinue = false;
+			}
+			mCondVar.notify_one();
+			mThread.join();
+		}
+
+		void push(const avk::log_pack& aPack)
+		{
+			{
+				std::scoped_lock lock(mMutex);
+				mQueue.push(aPack);
+			}
+			mCondVar.notify_one();
+		}
+
+	private:
+		void consume()
+		{
+			std::string sink;
+			while (true) {
+				avk::log_pack front;
+				bool empty;
+				{
+					std::scoped_lock lock(mMutex);
+					empty = mQueue.empty();
+					if (!empty) {
+						front = std::move(mQueue.front());
+						mQueue.pop();
+					}
+				}
+				if (!empty) {
+					sink.assign(front.mMessage);
+					std::scoped_lock lock(mMutex);
+					if (!mQueue.empty()) {
+						continue;
+					}
+				}
+				std::unique_lock lock(mMutex);
+				if (!mContinue && mQueue.empty()) {
+					break;
+				}
+				mCondVar.wait(lock, [this]() { return !mContinue || !mQueue.empty(); });
+			}
+		}
+
+		std::mutex mMutex;
+		std::condition_variable mCondVar;
+		std::queue<avk::log_pack> mQueue;
+		bool mContinue;
+		std::thread mThread;
+	};
+
+	template <typename F>
+	result measure(uint32_t aNumProducers, F aPush) const
+	{
+		std::vector<std::vector<double>> samples(aNumProducers);
+		std::vector<std::thread> producers;
+		const auto begin = std::chrono::high_resolution_clock::now();
+		for (uint32_t p = 0; p < aNumProducers; ++p) {
+			producers.emplace_back([this, p, &samples, &aPush]() {
+				auto& mySamples = samples[p];
+				mySamples.reserve(mNumMessagesPerProducer / cSampleInterval + 1);
+				avk::log_pack pack{ std::string(), avk::log_type::verbose, avk::log_importance::normal };
+				for (size_t i = 0; i < mNumMessagesPerProducer; ++i) {
+					pack.mMessage = std::format("VRBS: Producer {} submits message #{} of this frame | file[log_benchmark.hpp] line[0]\n", p, i);
+					if (0 == i % cSampleInterval) {
+						const auto t0 = std::chrono::high_resolution_clock::now();
+						aPush(pack);
+						mySamples.push_back(std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now() - t0).count());
+					}
+					else {
+						aPush(pack);
+					}
+				}
+			});
+		}
+		for (auto& t : producers) {
+			t.join();
+		}
+		const auto seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - begin).count();
+
+		std::vector<double> all;
+		for (const auto& s : samples) {
+			all.insert(all.end(), s.begin(), s.end());
+		}
+		std::sort(all.begin(), all.end());
+		const auto numMessages = static_cast<double>(mNumMessagesPerProducer) * aNumProducers;
+
+		result r;
+		r.mNumProducers = aNumProducers;
+		r.mMessagesPerSecond = numMessages / seconds;
+		// Every producer was busy for the whole time:
+		r.mMeanNanosecondsPerMessage = seconds * 1e9 * aNumProducers / numMessages;
+		r.mP99NanosecondsPerMessage = all.empty() ? 0.0 : all[std::min(all.size() - 1, all.size() * 99 / 100)];
+		return r;
+	}
+
+	void report(const result& aResult)
+	{
+		LOG_INFO(std::format("{:>11} with {:>2} producers: {:>12.0f} messages/s, mean {:>8.1f} ns, p99 {:>8.1f} ns per message, {} dropped",
+			aResult.mQueue, aResult.mNumProducers, aResult.mMessagesPerSecond, aResult.mMeanNanosecondsPerMessage, aResult.mP99NanosecondsPerMessage, aResult.mNumDropped));
+		mResults.push_back(aResult);
+	}
+
+	size_t mNumMessagesPerProducer;
+	std::vector<result> mResults;
+};
@@ -0,0 +1,24 @@
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+
+#include "auto_vk_toolkit.hpp"
+#include "meshlet_benchmark.hpp"
+
+// Measures the build time, the fill rate, and the vertex reuse ratio of the meshlets of a scene with the basic divider,
+// and with the cluster builder on one thread and on all threads of a work_stealing_pool (see meshlet_benchmark).
+// CPU only, i.e., neither a window nor a Vulkan device is needed.
+// Usage: avk_meshlet_benchmark [scene file] [report.json]
+int main(int argc, char** argv)
+{
+	try {
+		meshlet_benchmark benchmark(argc > 1 ? argv[1] : "assets/fullScene.fbx");
+		benchmark.run();
+		benchmark.write_json(argc > 2 ? argv[2] : "meshlet_benchmark.json");
+	}
+	catch (const std::exception& e) {
+		std::cerr << "Meshlet benchmark failed: " << e.what() << std::endl;
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
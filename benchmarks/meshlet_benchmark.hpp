@@ -0,0 +1,133 @@
+#pragma once
+
+#include <chrono>
+#include <fstream>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "auto_vk_toolkit.hpp"
+#include "meshlet_helpers.hpp"
+#include "work_stealing_pool.hpp"
+
+/** CPU benchmark which divides all meshes of a scene into meshlets, with different meshlet dividers.
+ *
+ *  The meshes are divided with avk::basic_meshlets_divider, and with avk::cluster_meshlets_builder on a single thread and on
+ *  all threads of a work_stealing_pool. For each of them, the build time, the number of meshlets, their average fill rate,
+ *  and the vertex reuse ratio (i.e., the number of indices per meshlet vertex; 1.0 means that every vertex is duplicated
+ *  for every triangle that uses it) are measured. The results are logged and written into a JSON report.
+ *
+ *  Usage example:
+ *
+ *	meshlet_benchmark benchmark("assets/sponza.obj");
+ *	benchmark.run();
+ *	benchmark.write_json("meshlet_benchmark.json");
+ */
+class meshlet_benchmark
+{
+	struct result
+	{
+		std::string mDivider;
+		uint32_t mNumThreads;
+		double mBuildMilliseconds;
+		size_t mNumMeshlets;
+		double mAverageVertices;
+		double mAverageTriangles;
+		double mVertexReuseRatio;
+	};
+
+public:
+	/**	@param	aSceneFile		Path of the scene whose meshes are divided into meshlets
+	 */
+	explicit meshlet_benchmark(std::string aSceneFile)
+		: mSceneFile{ std::move(aSceneFile) }
+	{
+	}
+
+	/** Divides the scene with all dividers */
+	void run()
+	{
+		mResults.clear();
+		auto scene = avk::model_t::load_from_file(mSceneFile, aiProcess_Triangulate | aiProcess_PreTransformVertices);
+		std::vector<avk::mesh_index_t> meshIndices(scene->num_meshes());
+		std::iota(meshIndices.begin(), meshIndices.end(), avk::mesh_index_t{ 0 });
+		std::vector<std::tuple<avk::model, std::vector<avk::mesh_index_t>>> selection;
+		selection.emplace_back(std::move(scene), std::move(meshIndices));
+
+		measure("basic_meshlets_divider", 1u, [&]() {
+			return avk::divide_into_meshlets(selection, avk::basic_meshlets_divider, false, cMaxVertices, cMaxIndices);
+		});
+		measure("cluster_meshlets_builder", 1u, [&]() {
+			return avk::divide_into_meshlets(selection, avk::cluster_meshlets_builder, false, cMaxVertices, cMaxIndices);
+		});
+		avk::work_stealing_pool pool;
+		measure("cluster_meshlets_builder", pool.num_threads(), [&]() {
+			return avk::divide_into_meshlets(selection, avk::cluster_meshlets_builder, pool, false, cMaxVertices, cMaxIndices);
+		});
+	}
+
+	/** Writes all results of the last run into a JSON file */
+	void write_json(const std::string& aPath) const
+	{
+		nlohmann::json report;
+		report["scene"] = mSceneFile;
+		report["max_vertices"] = cMaxVertices;
+		report["max_indices"] = cMaxIndices;
+		auto results = nlohmann::json::array();
+		for (const auto& r : mResults) {
+			results.push_back({
+				{ "divider", r.mDivider },
+				{ "threads", r.mNumThreads },
+				{ "build_ms", r.mBuildMilliseconds },
+				{ "meshlets", r.mNumMeshlets },
+				{ "average_vertices", r.mAverageVertices },
+				{ "average_triangles", r.mAverageTriangles },
+				{ "vertex_reuse_ratio", r.mVertexReuseRatio }
+			});
+		}
+		report["results"] = std::move(results);
+
+		std::ofstream file(aPath, std::ios::out | std::ios::trunc);
+		if (!file.is_open()) {
+			throw avk::runtime_error("Could not open file " + aPath);
+		}
+		file << report.dump(1, '\t') << '\n';
+		LOG_INFO_EM("Meshlet benchmark report written to '" + aPath + "'");
+	}
+
+private:
+	// Same limits as avk::meshlet_gpu_data's defaults:
+	static constexpr uint32_t cMaxVertices = 64;
+	static constexpr uint32_t cMaxIndices = 378;
+
+	template <typename F>
+	void measure(const std::string& aDivider, uint32_t aNumThreads, F aDivide)
+	{
+		const auto begin = std::chrono::high_resolution_clock::now();
+		const auto meshlets = aDivide();
+		const auto milliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - begin).count();
+
+		size_t numVertices = 0;
+		size_t numIndices = 0;
+		for (const auto& ml : meshlets) {
+			numVertices += ml.mVertexCount;
+			numIndices += ml.mIndexCount;
+		}
+		const auto numMeshlets = std::max<size_t>(meshlets.size(), 1);
+
+		result r;
+		r.mDivider = aDivider;
+		r.mNumThreads = aNumThreads;
+		r.mBuildMilliseconds = milliseconds;
+		r.mNumMeshlets = meshlets.size();
+		r.mAverageVertices = static_cast<double>(numVertices) / numMeshlets;
+		r.mAverageTriangles = static_cast<double>(numIndices) / 3.0 / numMeshlets;
+		r.mVertexReuseRatio = numVertices > 0 ? static_cast<double>(numIndices) / numVertices : 0.0;
+		LOG_INFO(std::format("{:>24} on {:>2} threads: {:>9.1f} ms, {:>7} meshlets, {:>5.1f} vertices and {:>5.1f} triangles per meshlet, vertex reuse {:.2f}",
+			r.mDivider, r.mNumThreads, r.mBuildMilliseconds, r.mNumMeshlets, r.mAverageVertices, r.mAverageTriangles, r.mVertexReuseRatio));
+		mResults.push_back(r);
+	}
+
+	std::string mSceneFile;
+	std::vector<result> mResults;
+};
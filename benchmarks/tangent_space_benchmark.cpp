@@ -0,0 +1,24 @@
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+
+#include "auto_vk_toolkit.hpp"
+#include "tangent_space_benchmark.hpp"
+
+// Measures the speedup of model_t::calculate_tangent_space_for_all_meshes over the former face-by-face implementation, on
+// one thread and on a work_stealing_pool with 1, 2, 4, ... threads, and checks that all results match (see tangent_space_benchmark).
+// CPU only, i.e., neither a window nor a Vulkan device is needed. Fails if a result deviates from the baseline.
+// Usage: avk_tangent_space_benchmark [scene file] [report.json]
+int main(int argc, char** argv)
+{
+	try {
+		tangent_space_benchmark benchmark(argc > 1 ? argv[1] : "assets/fullScene.fbx");
+		const bool passed = benchmark.run();
+		benchmark.write_json(argc > 2 ? argv[2] : "tangent_space_benchmark.json");
+		return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+	catch (const std::exception& e) {
+		std::cerr << "Tangent space benchmark failed: " << e.what() << std::endl;
+		return EXIT_FAILURE;
+	}
+}
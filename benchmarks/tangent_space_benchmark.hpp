@@ -0,0 +1,246 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "auto_vk_toolkit.hpp"
+#include "model.hpp"
+#include "work_stealing_pool.hpp"
+#include <assimp/qnan.h>
+
+/** CPU benchmark which calculates the tangent space for all meshes of a scene, on different numbers of threads.
+ *
+ *  The baseline is a replica of the face-by-face implementation which avk::model_t::calculate_tangent_space_for_mesh used
+ *  to have. It is compared against model_t::calculate_tangent_space_for_all_meshes on a single thread, and on a
+ *  work_stealing_pool with 1, 2, 4, ... threads up to the number of hardware threads. For each of them, the time and
+ *  the speedup over the baseline are measured, and the largest deviation of any tangent or bitangent from the baseline's.
+ *  A run fails if any deviation exceeds cTolerance, or if a vector is NaN in one result but not in the other.
+ *  The results are logged and written into a JSON report.
+ *
+ *  Usage example:
+ *
+ *	tangent_space_benchmark benchmark("assets/sponza.obj");
+ *	const bool passed = benchmark.run();
+ *	benchmark.write_json("tangent_space_benchmark.json");
+ */
+class tangent_space_benchmark
+{
+	struct result
+	{
+		std::string mImplementation;
+		uint32_t mNumThreads;
+		double mMilliseconds;
+		double mSpeedup;
+		float mMaxDeviation;
+		bool mPassed;
+	};
+
+	using tangent_space = std::vector<std::tuple<std::vector<glm::vec3>, std::vector<glm::vec3>>>;
+
+public:
+	/**	@param	aSceneFile		Path of the scene whose meshes' tangent spaces are calculated
+	 *	@param	aNumRepetitions	Every implementation is run this many times, and the fastest run is reported
+	 */
+	explicit tangent_space_benchmark(std::string aSceneFile, uint32_t aNumRepetitions = 5)
+		: mSceneFile{ std::move(aSceneFile) }
+		, mNumRepetitions{ std::max(aNumRepetitions, 1u) }
+	{
+	}
+
+	/**	Measures all implementations.
+	 *	@return	true if all implementations match the baseline within cTolerance
+	 */
+	bool run()
+	{
+		mResults.clear();
+		auto scene = avk::model_t::load_from_file(mSceneFile, aiProcess_Triangulate | aiProcess_PreTransformVertices);
+		size_t numVertices = 0;
+		for (size_t i = 0; i < scene->num_meshes(); ++i) {
+			numVertices += scene->number_of_vertices_for_mesh(i);
+		}
+		LOG_INFO(std::format("Calculating the tangent space of {} meshes with {} vertices in total", scene->num_meshes(), numVertices));
+
+		tangent_space reference;
+		const auto baseline = fastest_of([&]() { reference = calculate_reference(*scene); });
+		report({ "face-by-face baseline", 1u, baseline, 1.0, 0.0f, true });
+
+		const auto serial = fastest_of([&]() { scene->calculate_tangent_space_for_all_meshes(); });
+		compare("structure of arrays", 1u, baseline, serial, reference, *scene);
+
+		const auto maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+		for (uint32_t numThreads = 1; ; numThreads = std::min(numThreads * 2, maxThreads)) {
+			avk::work_stealing_pool pool{ numThreads };
+			const auto parallel = fastest_of([&]() { scene->calculate_tangent_space_for_all_meshes(pool); });
+			compare("work_stealing_pool", numThreads, baseline, parallel, reference, *scene);
+			if (numThreads == maxThreads) {
+				break;
+			}
+		}
+
+		return std::all_of(mResults.begin(), mResults.end(), [](const result& r) { return r.mPassed; });
+	}
+
+	/** Writes all results of the last run into a JSON file */
+	void write_json(const std::string& aPath) const
+	{
+		nlohmann::json report;
+		report["scene"] = mSceneFile;
+		report["tolerance"] = cTolerance;
+		auto results = nlohmann::json::array();
+		for (const auto& r : mResults) {
+			results.push_back({
+				{ "implementation", r.mImplementation },
+				{ "threads", r.mNumThreads },
+				{ "ms", r.mMilliseconds },
+				{ "speedup", r.mSpeedup },
+				{ "max_deviation", r.mMaxDeviation },
+				{ "passed", r.mPassed }
+			});
+		}
+		report["results"] = std::move(results);
+
+		std::ofstream file(aPath, std::ios::out | std::ios::trunc);
+		if (!file.is_open()) {
+			throw avk::runtime_error("Could not open file " + aPath);
+		}
+		file << report.dump(1, '\t') << '\n';
+		LOG_INFO_EM("Tangent space benchmark report written to '" + aPath + "'");
+	}
+
+private:
+	static constexpr float cTolerance = 1e-4f;
+
+	template <typename F>
+	double fastest_of(F aFunc) const
+	{
+		double fastest = std::numeric_limits<double>::max();
+		for (uint32_t i = 0; i < mNumRepetitions; ++i) {
+			const auto begin = std::chrono::high_resolution_clock::now();
+			aFunc();
+			fastest = std::min(fastest, std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - begin).count());
+		}
+		return fastest;
+	}
+
+	/** The face-by-face implementation which model_t::calculate_tangent_space_for_mesh used to have: every face writes its frame into all of its vertices */
+	static tangent_space calculate_reference(const avk::model_t& aModel)
+	{
+		const aiScene* scene = aModel.handle();
+		tangent_space result(scene->mNumMeshes);
+		for (unsigned int m = 0; m < scene->mNumMeshes; ++m) {
+			const aiMesh* pMesh = scene->mMeshes[m];
+			auto& [meshTang, meshBitang] = result[m];
+			meshTang.resize(pMesh->mNumVertices);
+			meshBitang.resize(pMesh->mNumVertices);
+			if (!(pMesh->mPrimitiveTypes & (aiPrimitiveType_TRIANGLE | aiPrimitiveType_POLYGON)) || nullptr == pMesh->mNormals || nullptr == pMesh->mTextureCoords[0]) {
+				continue;
+			}
+
+			const float qnan = std::numeric_limits<ai_real>::quiet_NaN();
+			const aiVector3D* meshPos = pMesh->mVertices;
+			const aiVector3D* meshNorm = pMesh->mNormals;
+			const aiVector3D* meshTex = pMesh->mTextureCoords[0];
+			for (unsigned int a = 0; a < pMesh->mNumFaces; a++) {
+				const aiFace& face = pMesh->mFaces[a];
+				if (face.mNumIndices < 3) {
+					for (unsigned int i = 0; i < face.mNumIndices; ++i) {
+						meshTang[face.mIndices[i]] = glm::vec3(qnan);
+						meshBitang[face.mIndices[i]] = glm::vec3(qnan);
+					}
+					continue;
+				}
+
+				const unsigned int p0 = face.mIndices[0], p1 = face.mIndices[1], p2 = face.mIndices[2];
+				aiVector3D v = meshPos[p1] - meshPos[p0], w = meshPos[p2] - meshPos[p0];
+				float sx = meshTex[p1].x - meshTex[p0].x, sy = meshTex[p1].y - meshTex[p0].y;
+				float tx = meshTex[p2].x - meshTex[p0].x, ty = meshTex[p2].y - meshTex[p0].y;
+				float dirCorrection = (tx * sy - ty * sx) < 0.0f ? -1.0f : 1.0f;
+				if (sx * ty == sy * tx) {
+					sx = 0.0; sy = 1.0; tx = 1.0; ty = 0.0;
+				}
+				aiVector3D tangent, bitangent;
+				tangent.x = (w.x * sy - v.x * ty) * dirCorrection;
+				tangent.y = (w.y * sy - v.y * ty) * dirCorrection;
+				tangent.z = (w.z * sy - v.z * ty) * dirCorrection;
+				bitangent.x = (w.x * sx - v.x * tx) * dirCorrection;
+				bitangent.y = (w.y * sx - v.y * tx) * dirCorrection;
+				bitangent.z = (w.z * sx - v.z * tx) * dirCorrection;
+
+				for (unsigned int b = 0; b < face.mNumIndices; ++b) {
+					unsigned int p = face.mIndices[b];
+					aiVector3D localTangent = tangent - meshNorm[p] * (tangent * meshNorm[p]);
+					aiVector3D localBitangent = bitangent - meshNorm[p] * (bitangent * meshNorm[p]);
+					localTangent.NormalizeSafe();
+					localBitangent.NormalizeSafe();
+					bool invalidTangent = is_special_float(localTangent.x) || is_special_float(localTangent.y) || is_special_float(localTangent.z);
+					bool invalidBitangent = is_special_float(localBitangent.x) || is_special_float(localBitangent.y) || is_special_float(localBitangent.z);
+					if (invalidTangent != invalidBitangent) {
+						if (invalidTangent) {
+							localTangent = meshNorm[p] ^ localBitangent;
+							localTangent.NormalizeSafe();
+						}
+						else {
+							localBitangent = localTangent ^ meshNorm[p];
+							localBitangent.NormalizeSafe();
+						}
+					}
+					meshTang[p] = glm::vec3(localTangent.x, localTangent.y, localTangent.z);
+					meshBitang[p] = glm::vec3(localBitangent.x, localBitangent.y, localBitangent.z);
+				}
+			}
+		}
+		return result;
+	}
+
+	/** Largest component-wise deviation between two sets of vectors; infinity if one of them is NaN where the other one is not */
+	static float max_deviation(const std::vector<glm::vec3>& aExpected, const std::vector<glm::vec3>& aActual)
+	{
+		if (aExpected.size() != aActual.size()) {
+			return std::numeric_limits<float>::infinity();
+		}
+		float result = 0.0f;
+		for (size_t i = 0; i < aExpected.size(); ++i) {
+			for (glm::length_t c = 0; c < 3; ++c) {
+				if (std::isnan(aExpected[i][c]) != std::isnan(aActual[i][c])) {
+					return std::numeric_limits<float>::infinity();
+				}
+				if (!std::isnan(aExpected[i][c])) {
+					result = std::max(result, std::abs(aExpected[i][c] - aActual[i][c]));
+				}
+			}
+		}
+		return result;
+	}
+
+	void compare(const std::string& aImplementation, uint32_t aNumThreads, double aBaselineMilliseconds, double aMilliseconds, const tangent_space& aReference, const avk::model_t& aModel)
+	{
+		float deviation = 0.0f;
+		for (size_t i = 0; i < aReference.size(); ++i) {
+			deviation = std::max(deviation, max_deviation(std::get<0>(aReference[i]), aModel.tangents_for_mesh(i)));
+			deviation = std::max(deviation, max_deviation(std::get<1>(aReference[i]), aModel.bitangents_for_mesh(i)));
+		}
+		report({ aImplementation, aNumThreads, aMilliseconds, aBaselineMilliseconds / aMilliseconds, deviation, deviation <= cTolerance });
+	}
+
+	void report(const result& aResult)
+	{
+		const auto message = std::format("{:>22} on {:>2} threads: {:>9.2f} ms, speedup {:>5.2f}, max. deviation {:.2e}",
+			aResult.mImplementation, aResult.mNumThreads, aResult.mMilliseconds, aResult.mSpeedup, aResult.mMaxDeviation);
+		if (aResult.mPassed) {
+			LOG_INFO(message);
+		}
+		else {
+			LOG_ERROR("FAILED: " + message);
+		}
+		mResults.push_back(aResult);
+	}
+
+	std::string mSceneFile;
+	uint32_t mNumRepetitions;
+	std::vector<result> mResults;
+};
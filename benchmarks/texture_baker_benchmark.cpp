@@ -0,0 +1,24 @@
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+
+#include "auto_vk_toolkit.hpp"
+#include "texture_baker_benchmark.hpp"
+
+// Bakes synthetic textures into BC1/BC3/BC4/BC5, checks their errors and the cache, and reports the sizes and the times
+// of baking and of the cache hits (see texture_baker_benchmark).
+// CPU only, i.e., neither a window nor a Vulkan device is needed. Fails if an error exceeds its bound.
+// Usage: avk_texture_baker_benchmark [report.json]
+int main(int argc, char** argv)
+{
+	try {
+		texture_baker_benchmark benchmark;
+		const bool passed = benchmark.run();
+		benchmark.write_json(argc > 1 ? argv[1] : "texture_baker_benchmark.json");
+		return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+	catch (const std::exception& e) {
+		std::cerr << "Texture baker benchmark failed: " << e.what() << std::endl;
+		return EXIT_FAILURE;
+	}
+}
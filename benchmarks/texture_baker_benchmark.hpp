@@ -0,0 +1,311 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <gli/core/bc.hpp>
+#include <stb_image_write.h>
+
+#include "auto_vk_toolkit.hpp"
+#include "texture_baker.hpp"
+
+/** CPU-only quality checks and measurements of avk::texture_baker.
+ *
+ *  Synthetic textures of every texture_content (an opaque color texture, a color texture with alpha, a normal map, and a
+ *  height map) are written as PNG files into a temporary directory and baked into a cache there. The baked KTX files are
+ *  loaded via gli like the demo loads them, and checked for their format and for a complete mip chain. Their first level is
+ *  decoded again and compared against the source image: the RMS errors of colors, alpha, and heights are compared against
+ *  bounds in 8-bit steps, and the RMS angle between the source normals and the normals with reconstructed Z against
+ *  cMaxRmsNormalErrorDegrees. Afterwards, the same textures are requested from a second texture_baker, which must take all
+ *  of them from the cache. The sizes and the times of baking and of the cache hits are reported.
+ *  The results are logged and written into a JSON report.
+ *
+ *  Usage example:
+ *
+ *	texture_baker_benchmark benchmark;
+ *	const bool passed = benchmark.run();
+ *	benchmark.write_json("texture_baker_benchmark.json");
+ */
+class texture_baker_benchmark
+{
+	struct result
+	{
+		std::string mCheck;
+		double mMaxError;
+		double mBound;
+		bool mPassed;
+	};
+
+public:
+	/**	@param	aSize	Width and height of the synthetic textures
+	 */
+	explicit texture_baker_benchmark(int aSize = 1024)
+		: mSize{ aSize }
+	{
+	}
+
+	/**	Runs all checks.
+	 *	@return	true if all errors are within their bounds
+	 */
+	bool run()
+	{
+		mResults.clear();
+		const auto directory = std::filesystem::temp_directory_path() / "texture_baker_benchmark";
+		std::filesystem::remove_all(directory);
+		std::filesystem::create_directories(directory);
+		const auto cacheDirectory = (directory / "cache").string();
+
+		std::vector<std::tuple<std::string, avk::texture_content, std::vector<uint8_t>>> sources;
+		sources.emplace_back("color", avk::texture_content::color, make_color(false));
+		sources.emplace_back("color_alpha", avk::texture_content::color, make_color(true));
+		sources.emplace_back("normals", avk::texture_content::normal_map, make_normals());
+		sources.emplace_back("height", avk::texture_content::single_channel, make_height());
+
+		std::vector<std::string> bakedPaths;
+		avk::texture_baker baker(cacheDirectory);
+		for (const auto& [name, content, pixels] : sources) {
+			const auto path = (directory / (name + ".png")).string();
+			if (0 == stbi_write_png(path.c_str(), mSize, mSize, 4, pixels.data(), mSize * 4)) {
+				throw avk::runtime_error("Could not write " + path);
+			}
+			// Without flipping, s.t. the decoded pixels can be compared against the source pixels directly:
+			bakedPaths.push_back(baker.bake(path, content, avk::texture_content::color == content, false));
+			check_baked(name, content, pixels, bakedPaths.back());
+		}
+		mBakeStatistics = baker.stats();
+
+		avk::texture_baker warmBaker(cacheDirectory);
+		const auto begin = std::chrono::steady_clock::now();
+		bool samePaths = true;
+		for (size_t i = 0; i < sources.size(); ++i) {
+			const auto& [name, content, pixels] = sources[i];
+			samePaths = samePaths && bakedPaths[i] == warmBaker.bake((directory / (name + ".png")).string(), content, avk::texture_content::color == content, false);
+		}
+		mCacheHitSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+		report({ "textures baked again despite the cache", static_cast<double>(warmBaker.stats().mNumBaked + (samePaths ? 0 : 1)), 0.0 });
+
+		std::filesystem::remove_all(directory);
+		report_sizes();
+		return std::all_of(mResults.begin(), mResults.end(), [](const result& r) { return r.mPassed; });
+	}
+
+	/** Writes all results of the last run into a JSON file */
+	void write_json(const std::string& aPath) const
+	{
+		nlohmann::json report;
+		report["texture_size"] = mSize;
+		report["uncompressed_bytes"] = mBakeStatistics.mUncompressedBytes;
+		report["baked_bytes"] = mBakeStatistics.mBakedBytes;
+		report["bake_seconds"] = mBakeStatistics.mBakeSeconds;
+		report["cache_hit_seconds"] = mCacheHitSeconds;
+		auto results = nlohmann::json::array();
+		for (const auto& r : mResults) {
+			results.push_back({
+				{ "check", r.mCheck },
+				{ "max_error", r.mMaxError },
+				{ "bound", r.mBound },
+				{ "passed", r.mPassed }
+			});
+		}
+		report["results"] = std::move(results);
+
+		std::ofstream file(aPath, std::ios::out | std::ios::trunc);
+		if (!file.is_open()) {
+			throw avk::runtime_error("Could not open file " + aPath);
+		}
+		file << report.dump(1, '\t') << '\n';
+		LOG_INFO_EM("Texture baker report written to '" + aPath + "'");
+	}
+
+private:
+	// RMS errors in 8-bit steps, which BC1/BC3/BC4 reach for smooth content like the synthetic textures:
+	static constexpr double cMaxRmsColorError = 3.0;
+	static constexpr double cMaxRmsAlphaError = 0.5;
+	static constexpr double cMaxRmsHeightError = 0.5;
+	static constexpr double cMaxRmsNormalErrorDegrees = 0.5;
+
+	/** Smooth gradients and waves; with alpha, the alpha varies smoothly across the whole range */
+	std::vector<uint8_t> make_color(bool aWithAlpha) const
+	{
+		std::vector<uint8_t> pixels(static_cast<size_t>(mSize) * mSize * 4);
+		for (int y = 0; y < mSize; ++y) {
+			for (int x = 0; x < mSize; ++x) {
+				const float u = static_cast<float>(x) / mSize;
+				const float v = static_cast<float>(y) / mSize;
+				auto* p = &pixels[(static_cast<size_t>(y) * mSize + x) * 4];
+				p[0] = to_unorm8(u);
+				p[1] = to_unorm8(0.5f + 0.5f * std::sin(glm::two_pi<float>() * 4.0f * v));
+				p[2] = to_unorm8(0.5f + 0.5f * std::cos(glm::two_pi<float>() * 3.0f * (u + v)));
+				p[3] = aWithAlpha ? to_unorm8(0.5f + 0.5f * std::sin(glm::two_pi<float>() * 2.0f * u)) : 255;
+			}
+		}
+		return pixels;
+	}
+
+	static float height(float u, float v)
+	{
+		return 0.5f + 0.25f * std::sin(glm::two_pi<float>() * 3.0f * u) * std::cos(glm::two_pi<float>() * 2.0f * v);
+	}
+
+	std::vector<uint8_t> make_height() const
+	{
+		std::vector<uint8_t> pixels(static_cast<size_t>(mSize) * mSize * 4);
+		for (int y = 0; y < mSize; ++y) {
+			for (int x = 0; x < mSize; ++x) {
+				auto* p = &pixels[(static_cast<size_t>(y) * mSize + x) * 4];
+				p[0] = p[1] = p[2] = to_unorm8(height(static_cast<float>(x) / mSize, static_cast<float>(y) / mSize));
+				p[3] = 255;
+			}
+		}
+		return pixels;
+	}
+
+	/** The tangent-space normals of a bumpy height field */
+	std::vector<uint8_t> make_normals() const
+	{
+		std::vector<uint8_t> pixels(static_cast<size_t>(mSize) * mSize * 4);
+		const float h = 1.0f / mSize;
+		for (int y = 0; y < mSize; ++y) {
+			for (int x = 0; x < mSize; ++x) {
+				const float u = static_cast<float>(x) / mSize;
+				const float v = static_cast<float>(y) / mSize;
+				const float dx = (height(u + h, v) - height(u - h, v)) / (2.0f * h);
+				const float dy = (height(u, v + h) - height(u, v - h)) / (2.0f * h);
+				const auto n = glm::normalize(glm::vec3{ -dx * 0.2f, -dy * 0.2f, 1.0f });
+				auto* p = &pixels[(static_cast<size_t>(y) * mSize + x) * 4];
+				for (int c = 0; c < 3; ++c) {
+					p[c] = to_unorm8(n[c] * 0.5f + 0.5f);
+				}
+				p[3] = 255;
+			}
+		}
+		return pixels;
+	}
+
+	static uint8_t to_unorm8(float aValue)
+	{
+		return static_cast<uint8_t>(std::lround(std::clamp(aValue, 0.0f, 1.0f) * 255.0f));
+	}
+
+	/** Decodes the first level of a block-compressed texture into RGBA values in [0, 1] */
+	static std::vector<glm::vec4> decode_first_level(const gli::texture2d& aTexture)
+	{
+		const auto extent = aTexture.extent(0);
+		const auto blocksX = (extent.x + 3) / 4;
+		const auto blocksY = (extent.y + 3) / 4;
+		const auto blockSize = gli::block_size(aTexture.format());
+		const auto* blocks = aTexture.data<uint8_t>(0, 0, 0);
+
+		std::vector<glm::vec4> texels(static_cast<size_t>(extent.x) * extent.y);
+		for (int by = 0; by < blocksY; ++by) {
+			for (int bx = 0; bx < blocksX; ++bx) {
+				const auto* block = blocks + (static_cast<size_t>(by) * blocksX + bx) * blockSize;
+				gli::detail::texel_block4x4 decoded;
+				switch (aTexture.format()) {
+				case gli::FORMAT_RGB_DXT1_UNORM_BLOCK8:
+				case gli::FORMAT_RGB_DXT1_SRGB_BLOCK8:
+					decoded = gli::detail::decompress_dxt1_block(*reinterpret_cast<const gli::detail::dxt1_block*>(block));
+					break;
+				case gli::FORMAT_RGBA_DXT5_UNORM_BLOCK16:
+				case gli::FORMAT_RGBA_DXT5_SRGB_BLOCK16:
+					decoded = gli::detail::decompress_dxt5_block(*reinterpret_cast<const gli::detail::dxt5_block*>(block));
+					break;
+				case gli::FORMAT_R_ATI1N_UNORM_BLOCK8:
+					decoded = gli::detail::decompress_bc4unorm_block(*reinterpret_cast<const gli::detail::bc4_block*>(block));
+					break;
+				case gli::FORMAT_RG_ATI2N_UNORM_BLOCK16:
+					decoded = gli::detail::decompress_bc5unorm_block(*reinterpret_cast<const gli::detail::bc5_block*>(block));
+					break;
+				default:
+					throw avk::runtime_error("Unexpected format of a baked texture");
+				}
+				for (int y = 0; y < 4 && by * 4 + y < extent.y; ++y) {
+					for (int x = 0; x < 4 && bx * 4 + x < extent.x; ++x) {
+						texels[static_cast<size_t>(by * 4 + y) * extent.x + bx * 4 + x] = decoded.Texel[y][x];
+					}
+				}
+			}
+		}
+		return texels;
+	}
+
+	void check_baked(const std::string& aName, avk::texture_content aContent, const std::vector<uint8_t>& aSource, const std::string& aBakedPath)
+	{
+		const gli::texture2d texture(gli::load(aBakedPath));
+		const auto expectedFormat =
+			  avk::texture_content::normal_map == aContent ? gli::FORMAT_RG_ATI2N_UNORM_BLOCK16
+			: avk::texture_content::single_channel == aContent ? gli::FORMAT_R_ATI1N_UNORM_BLOCK8
+			: aSource[3] == 255 ? gli::FORMAT_RGB_DXT1_SRGB_BLOCK8 : gli::FORMAT_RGBA_DXT5_SRGB_BLOCK16;
+		const auto expectedLevels = static_cast<size_t>(std::floor(std::log2(mSize))) + 1;
+		report({ aName + ": wrong format or levels", (texture.format() == expectedFormat && texture.levels() == expectedLevels) ? 0.0 : 1.0, 0.0 });
+		if (texture.format() != expectedFormat) {
+			return;
+		}
+
+		const auto texels = decode_first_level(texture);
+		double colorError = 0.0, alphaError = 0.0, normalError = 0.0;
+		for (size_t i = 0; i < texels.size(); ++i) {
+			const glm::dvec4 source = glm::dvec4{ aSource[i * 4], aSource[i * 4 + 1], aSource[i * 4 + 2], aSource[i * 4 + 3] } / 255.0;
+			const glm::dvec4 decoded{ texels[i] };
+			if (avk::texture_content::normal_map == aContent) {
+				// Like shaders reconstruct it:
+				const glm::dvec2 xy = glm::dvec2{ decoded } * 2.0 - 1.0;
+				const glm::dvec3 n{ xy, std::sqrt(std::max(0.0, 1.0 - glm::dot(xy, xy))) };
+				const auto angle = std::atan2(glm::length(glm::cross(n, glm::normalize(glm::dvec3{ source } * 2.0 - 1.0))), glm::dot(n, glm::normalize(glm::dvec3{ source } * 2.0 - 1.0)));
+				normalError += angle * angle;
+			}
+			else if (avk::texture_content::single_channel == aContent) {
+				colorError += std::pow((decoded.r - source.r) * 255.0, 2.0);
+			}
+			else {
+				const auto d = (glm::dvec3{ decoded } - glm::dvec3{ source }) * 255.0;
+				colorError += glm::dot(d, d) / 3.0;
+				alphaError += std::pow((decoded.a - source.a) * 255.0, 2.0);
+			}
+		}
+		const auto n = static_cast<double>(texels.size());
+		if (avk::texture_content::normal_map == aContent) {
+			report({ aName + ": RMS normal error (degrees)", glm::degrees(std::sqrt(normalError / n)), cMaxRmsNormalErrorDegrees });
+		}
+		else if (avk::texture_content::single_channel == aContent) {
+			report({ aName + ": RMS height error (8-bit steps)", std::sqrt(colorError / n), cMaxRmsHeightError });
+		}
+		else {
+			report({ aName + ": RMS color error (8-bit steps)", std::sqrt(colorError / n), cMaxRmsColorError });
+			if (texture.format() == gli::FORMAT_RGBA_DXT5_SRGB_BLOCK16) {
+				report({ aName + ": RMS alpha error (8-bit steps)", std::sqrt(alphaError / n), cMaxRmsAlphaError });
+			}
+		}
+	}
+
+	void report_sizes() const
+	{
+		const auto& s = mBakeStatistics;
+		LOG_INFO(std::format("{} textures of {}x{}: {:.1f} MiB uncompressed -> {:.1f} MiB baked ({:.1f}x smaller), baked in {:.2f} s, taken from the cache in {:.2f} ms",
+			s.mNumBaked, mSize, mSize, s.mUncompressedBytes / (1024.0 * 1024.0), s.mBakedBytes / (1024.0 * 1024.0),
+			static_cast<double>(s.mUncompressedBytes) / std::max<size_t>(s.mBakedBytes, 1), s.mBakeSeconds, mCacheHitSeconds * 1000.0));
+	}
+
+	void report(result aResult)
+	{
+		aResult.mPassed = aResult.mMaxError <= aResult.mBound;
+		const auto message = std::format("{:<45} max. error {:.3e}, bound {:.3e}", aResult.mCheck, aResult.mMaxError, aResult.mBound);
+		if (aResult.mPassed) {
+			LOG_INFO(message);
+		}
+		else {
+			LOG_ERROR("FAILED: " + message);
+		}
+		mResults.push_back(aResult);
+	}
+
+	int mSize;
+	avk::texture_baker::statistics mBakeStatistics;
+	double mCacheHitSeconds = 0.0;
+	std::vector<result> mResults;
+};
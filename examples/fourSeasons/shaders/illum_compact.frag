@@ -0,0 +1,73 @@
+#version 460
+
+// Same as illum.frag, but for gbuffer_format::compact (see gbuffer_layout.hpp):
+// the world-space normal is derived from the octahedral-encoded view-space normal via the inverse view matrix.
+layout(location = 0) in vec2 texCoord;
+
+layout(location = 0) out vec4 fs_out;
+
+layout(set = 0, binding = 0) uniform sampler2D screenTexture;
+// Binding 1 is not used, it only keeps the descriptor set layout the same as illum.frag's
+layout(set = 0, binding = 2) uniform sampler2D gNormal;
+layout(set = 0, binding = 3) uniform sampler2D gAlbedo;
+layout(set = 0, binding = 4) uniform sampler2D depthTexture;
+
+layout(set = 0, binding = 5) uniform uniformSSAO
+{
+    int enabled;
+    int blur;
+    int illumination;
+} SSAO;
+
+layout(set = 0, binding = 6) uniform Camera {
+    vec3 position;
+} camera;
+
+layout(set = 0, binding = 7) uniform VPMatrices
+{
+	mat4 mViewMatrix;
+	mat4 mProjectionMatrix;
+	mat4 mInverseProjectionMatrix;
+	mat4 mInverseViewMatrix;
+} vp;
+
+// Same as vertex_packing::decode_octahedral
+vec3 octahedral_decode(vec2 e)
+{
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    if (n.z < 0.0) {
+        n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+    }
+    return normalize(n);
+}
+
+void main() {
+    if (SSAO.illumination == 1) {
+        // The view matrix is rigid, hence its inverse's rotation part transforms normals, too:
+        vec3 normal = mat3(vp.mInverseViewMatrix) * octahedral_decode(texture(gNormal, texCoord).rg);
+        vec3 diffuse = texture(gAlbedo, texCoord).rgb;
+        float ao = texture(screenTexture, texCoord).r;
+        
+        vec4 depth = texture(depthTexture, texCoord);
+        
+        if (SSAO.enabled != 1) {
+            ao = 1.0f;
+        }
+
+        const vec3 lightColor = vec3(1.0);
+        vec3 lightDir = vec3(0.5, 0.7, 1.0);
+
+        vec3 diffuseC = max(dot(normal, lightDir), 0.0) * diffuse * lightColor;
+        vec4 erg = vec4(diffuseC * ao, 1.0);
+        //skybox has high depth value; if depth is high, use skybox color (diffuse) instead of erg)
+        if(depth.r < 0.9999) {
+            fs_out = erg;
+        }else{
+            fs_out = vec4(diffuse, 1.0);
+        }
+
+    }
+    else {
+        fs_out = vec4(texture(screenTexture, texCoord).rrr, 1.0);
+    }
+}
@@ -63,6 +63,11 @@ layout(set = 1, binding = 0) buffer Material
 	MaterialGpuData materials[];
 } matSsbo;
 
+layout(set = 1, binding = 2) buffer MipFeedback
+{
+	uint minLod[];
+} feedbackSsbo;
+
 layout (location = 0) in vec3 positionWS;
 layout (location = 1) in vec3 normalWS;
 layout (location = 2) in vec2 texCoord;
@@ -87,11 +92,28 @@ float linearizeDepth(float depth) {
 }
 
 
+// Records the finest mip level which this fragment needs of the given texture, for the texture_streamer.
+// Stored is log2 of the footprint of a pixel in texture coordinates, offset by 32 and in 1/256 steps, i.e.,
+// independent of the texture's size, which the streamer adds in. The buffer is reset to 0xFFFFFFFF every frame.
+// Must be called in uniform control flow, because of the derivatives.
+void write_mip_feedback(int texIndex, vec2 uv)
+{
+	vec2 dx = dFdx(uv);
+	vec2 dy = dFdy(uv);
+	float lod = 0.5 * log2(max(max(dot(dx, dx), dot(dy, dy)), 1e-20));
+	uint encoded = uint(clamp((lod + 32.0) * 256.0, 0.0, 65535.0));
+	// Most fragments request what has been requested already; skip their atomics:
+	if (encoded < feedbackSsbo.minLod[texIndex]) {
+		atomicMin(feedbackSsbo.minLod[texIndex], encoded);
+	}
+}
+
 void main() 
 {
 	int matIndex = materialIndex;
 
 	int diffuseTexIndex = matSsbo.materials[matIndex].mDiffuseTexIndex;
+	write_mip_feedback(diffuseTexIndex, texCoord);
     vec3 color = texture(textures[diffuseTexIndex], texCoord).rgb;
 	vec3 diffuse = matSsbo.materials[matIndex].mDiffuseReflectivity.rgb;
 	
@@ -6,9 +6,23 @@ layout (location = 2) in vec3 inNormal;
 
 layout(push_constant) uniform PushConstants {
 	mat4 mModelMatrix;
-	int mMaterialIndex;
 } pushConstants;
 
+struct PerDrawData
+{
+	mat4 mModelMatrix;
+	int mMaterialIndex;
+	// Dequantization of packed positions, see raster_packed.vert:
+	vec4 mPositionOffset;
+	vec4 mPositionScale;
+};
+
+// One entry per draw call, selected via the draw call's firstInstance:
+layout(set = 1, binding = 1) readonly buffer PerDraw
+{
+	PerDrawData draws[];
+} drawSsbo;
+
 layout(set = 0, binding = 1) uniform CameraTransform
 {
 	mat4 mViewProjMatrix;
@@ -29,22 +43,25 @@ layout (location = 5) out vec3 pos;
 layout (location = 6) out vec3 normal;
 
 void main() {
+	PerDrawData drawData = drawSsbo.draws[gl_InstanceIndex];
+	mat4 modelMatrix = pushConstants.mModelMatrix * drawData.mModelMatrix;
+
 	vec4 pos4 = vec4(inPosition.xyz, 1.0);
-	vec4 posWS = pushConstants.mModelMatrix * pos4;
+	vec4 posWS = modelMatrix * pos4;
 	positionWS = posWS.xyz;
 
     texCoord = inTexCoord;
 
-	normalWS = mat3(pushConstants.mModelMatrix) * inNormal;
-	materialIndex = pushConstants.mMaterialIndex;
+	normalWS = mat3(modelMatrix) * inNormal;
+	materialIndex = drawData.mMaterialIndex;
 
     gl_Position = ubo.mViewProjMatrix * posWS;
 	fragDepth = gl_Position.z / gl_Position.w; // Pass the depth value
 
 	// Position for g-buffer
-	pos = vec3(vp.mViewMatrix * pushConstants.mModelMatrix * pos4);
+	pos = vec3(vp.mViewMatrix * modelMatrix * pos4);
 
 	// Normals for g-buffer
-	mat3 normalMatrix = transpose(inverse(mat3(vp.mViewMatrix * pushConstants.mModelMatrix)));
+	mat3 normalMatrix = transpose(inverse(mat3(vp.mViewMatrix * modelMatrix)));
 	normal = normalMatrix * inNormal;
 }
@@ -0,0 +1,121 @@
+#version 460
+#extension GL_EXT_nonuniform_qualifier : require
+
+layout(set = 0, binding = 0) uniform sampler2D textures[];
+
+struct MaterialGpuData
+{
+	vec4 mDiffuseReflectivity;
+	vec4 mAmbientReflectivity;
+	vec4 mSpecularReflectivity;
+	vec4 mEmissiveColor;
+	vec4 mTransparentColor;
+	vec4 mReflectiveColor;
+	vec4 mAlbedo;
+
+	float mOpacity;
+	float mBumpScaling;
+	float mShininess;
+	float mShininessStrength;
+	
+	float mRefractionIndex;
+	float mReflectivity;
+	float mMetallic;
+	float mSmoothness;
+	
+	float mSheen;
+	float mThickness;
+	float mRoughness;
+	float mAnisotropy;
+	
+	vec4 mAnisotropyRotation;
+	vec4 mCustomData;
+	
+	int mDiffuseTexIndex;
+	int mSpecularTexIndex;
+	int mAmbientTexIndex;
+	int mEmissiveTexIndex;
+	int mHeightTexIndex;
+	int mNormalsTexIndex;
+	int mShininessTexIndex;
+	int mOpacityTexIndex;
+	int mDisplacementTexIndex;
+	int mReflectionTexIndex;
+	int mLightmapTexIndex;
+	int mExtraTexIndex;
+	
+	vec4 mDiffuseTexOffsetTiling;
+	vec4 mSpecularTexOffsetTiling;
+	vec4 mAmbientTexOffsetTiling;
+	vec4 mEmissiveTexOffsetTiling;
+	vec4 mHeightTexOffsetTiling;
+	vec4 mNormalsTexOffsetTiling;
+	vec4 mShininessTexOffsetTiling;
+	vec4 mOpacityTexOffsetTiling;
+	vec4 mDisplacementTexOffsetTiling;
+	vec4 mReflectionTexOffsetTiling;
+	vec4 mLightmapTexOffsetTiling;
+	vec4 mExtraTexOffsetTiling;
+};
+
+layout(set = 1, binding = 0) buffer Material 
+{
+	MaterialGpuData materials[];
+} matSsbo;
+
+layout(set = 1, binding = 2) buffer MipFeedback
+{
+	uint minLod[];
+} feedbackSsbo;
+
+layout (location = 0) in vec3 positionWS;
+layout (location = 1) in vec3 normalWS;
+layout (location = 2) in vec2 texCoord;
+layout (location = 3) flat in int materialIndex;
+layout (location = 4) in float fragDepth;
+layout (location = 5) in vec3 pos;
+layout (location = 6) in vec3 normal;
+
+// Same as raster.frag, but for gbuffer_format::compact (see gbuffer_layout.hpp):
+// positions are reconstructed from the depth attachment, and only the view-space normal is stored, octahedral-encoded.
+layout (location = 0) out vec4 gAlbedo;
+layout (location = 1) out vec2 gNormal;
+
+// Same as vertex_packing::encode_octahedral
+vec2 octahedral_encode(vec3 n)
+{
+	vec2 p = n.xy / (abs(n.x) + abs(n.y) + abs(n.z));
+	if (n.z < 0.0) {
+		p = (1.0 - abs(p.yx)) * vec2(p.x >= 0.0 ? 1.0 : -1.0, p.y >= 0.0 ? 1.0 : -1.0);
+	}
+	return p;
+}
+
+// Records the finest mip level which this fragment needs of the given texture, for the texture_streamer.
+// Stored is log2 of the footprint of a pixel in texture coordinates, offset by 32 and in 1/256 steps, i.e.,
+// independent of the texture's size, which the streamer adds in. The buffer is reset to 0xFFFFFFFF every frame.
+// Must be called in uniform control flow, because of the derivatives.
+void write_mip_feedback(int texIndex, vec2 uv)
+{
+	vec2 dx = dFdx(uv);
+	vec2 dy = dFdy(uv);
+	float lod = 0.5 * log2(max(max(dot(dx, dx), dot(dy, dy)), 1e-20));
+	uint encoded = uint(clamp((lod + 32.0) * 256.0, 0.0, 65535.0));
+	// Most fragments request what has been requested already; skip their atomics:
+	if (encoded < feedbackSsbo.minLod[texIndex]) {
+		atomicMin(feedbackSsbo.minLod[texIndex], encoded);
+	}
+}
+
+void main() 
+{
+	int matIndex = materialIndex;
+
+	int diffuseTexIndex = matSsbo.materials[matIndex].mDiffuseTexIndex;
+	write_mip_feedback(diffuseTexIndex, texCoord);
+	vec3 color = texture(textures[diffuseTexIndex], texCoord).rgb;
+	vec3 diffuse = matSsbo.materials[matIndex].mDiffuseReflectivity.rgb;
+
+	gAlbedo = vec4(color * diffuse, 1.0);
+	gNormal = octahedral_encode(normalize(normal));
+}
@@ -0,0 +1,80 @@
+#version 460
+
+// Same as raster.vert, but for vertex_format::interleaved_quantized (see vertex_packing.hpp):
+// positions are unsigned normalized within the draw call's AABB, and normals are octahedral-encoded.
+layout (location = 0) in vec4 inPosition;
+layout (location = 1) in vec2 inTexCoord;
+layout (location = 2) in vec2 inNormal;
+
+layout(push_constant) uniform PushConstants {
+	mat4 mModelMatrix;
+} pushConstants;
+
+struct PerDrawData
+{
+	mat4 mModelMatrix;
+	int mMaterialIndex;
+	// Dequantization of packed positions:
+	vec4 mPositionOffset;
+	vec4 mPositionScale;
+};
+
+// One entry per draw call, selected via the draw call's firstInstance:
+layout(set = 1, binding = 1) readonly buffer PerDraw
+{
+	PerDrawData draws[];
+} drawSsbo;
+
+layout(set = 0, binding = 1) uniform CameraTransform
+{
+	mat4 mViewProjMatrix;
+} ubo;
+
+layout(set = 0, binding = 2) uniform VPMatrices
+{
+	mat4 mViewMatrix;
+	mat4 mProjectionMatrix;
+} vp;
+
+layout (location = 0) out vec3 positionWS;
+layout (location = 1) out vec3 normalWS;
+layout (location = 2) out vec2 texCoord;
+layout (location = 3) flat out int materialIndex;
+layout (location = 4) out float fragDepth;
+layout (location = 5) out vec3 pos;
+layout (location = 6) out vec3 normal;
+
+// Same as vertex_packing::decode_octahedral
+vec3 octahedral_decode(vec2 e)
+{
+	vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+	if (n.z < 0.0) {
+		n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+	}
+	return normalize(n);
+}
+
+void main() {
+	PerDrawData drawData = drawSsbo.draws[gl_InstanceIndex];
+	mat4 modelMatrix = pushConstants.mModelMatrix * drawData.mModelMatrix;
+
+	vec4 pos4 = vec4(drawData.mPositionOffset.xyz + inPosition.xyz * drawData.mPositionScale.xyz, 1.0);
+	vec3 inNormal3 = octahedral_decode(inNormal);
+	vec4 posWS = modelMatrix * pos4;
+	positionWS = posWS.xyz;
+
+    texCoord = inTexCoord;
+
+	normalWS = mat3(modelMatrix) * inNormal3;
+	materialIndex = drawData.mMaterialIndex;
+
+    gl_Position = ubo.mViewProjMatrix * posWS;
+	fragDepth = gl_Position.z / gl_Position.w; // Pass the depth value
+
+	// Position for g-buffer
+	pos = vec3(vp.mViewMatrix * modelMatrix * pos4);
+
+	// Normals for g-buffer
+	mat3 normalMatrix = transpose(inverse(mat3(vp.mViewMatrix * modelMatrix)));
+	normal = normalMatrix * inNormal3;
+}
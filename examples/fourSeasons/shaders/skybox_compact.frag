@@ -0,0 +1,15 @@
+// Same as skybox.frag, but for gbuffer_format::compact (see gbuffer_layout.hpp)
+#version 450
+
+layout (binding = 1) uniform samplerCube samplerCubeMap;
+
+layout (location = 0) in vec3 inUVW;
+
+layout (location = 0) out vec4 outFragColor;
+layout (location = 1) out vec2 outNormal;
+
+void main() 
+{
+	outFragColor = texture(samplerCubeMap, inUVW);
+	outNormal = vec2(0.0);
+}
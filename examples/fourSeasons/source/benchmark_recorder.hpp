@@ -0,0 +1,157 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "auto_vk_toolkit.hpp"
+
+/** Collects per-frame measurements of a benchmark run and writes them into a JSON report.
+ *
+ *  CPU times are reported immediately, GPU times arrive with a latency of a few frames (see gpu_profiler).
+ *  Both are matched by frame id. The peak memory is sampled per memory heap from VMA's budget (vmaGetHeapBudgets),
+ *  i.e., the device memory which the process uses, and how much it may use, on every platform.
+ *  The budget comes from the driver if VK_EXT_memory_budget is enabled, otherwise VMA estimates it.
+ *
+ *  Usage example:
+ *
+ *	mBenchmark.emplace(1000u);
+ *	mGpuProfiler->set_results_handler([this](auto aFrameId, const auto& aNames, const auto& aDurations) {
+ *		mBenchmark->record_gpu_times(aFrameId, aNames, aDurations);
+ *	});
+ *	...
+ *	mBenchmark->record_cpu_time(mTarget->current_frame(), cpuMilliseconds);
+ *	...
+ *	mBenchmark->write_json("benchmark_report.json");
+ */
+class benchmark_recorder
+{
+	struct frame_record
+	{
+		double mCpuMilliseconds = 0.0;
+		std::vector<float> mGpuMilliseconds;
+	};
+
+	struct heap_record
+	{
+		bool mDeviceLocal = false;
+		uint64_t mSize = 0;
+		// Peak of the memory which the process uses in the heap, and of the memory which VMA has allocated in it:
+		uint64_t mPeakUsageBytes = 0;
+		uint64_t mPeakBlockBytes = 0;
+		// The budget when the usage has peaked:
+		uint64_t mBudgetBytes = 0;
+	};
+
+public:
+	/**	@param	aNumFrames		Number of frames which the benchmark renders */
+	explicit benchmark_recorder(uint32_t aNumFrames)
+		: mNumFrames{ aNumFrames }
+	{
+	}
+
+	/** The number of frames which the benchmark renders */
+	uint32_t num_frames() const { return mNumFrames; }
+
+	/**	Stores the CPU time of a frame, and samples the memory usage
+	 *	@param	aFrameId			The frame's id
+	 *	@param	aMilliseconds		CPU time which has been spent on the frame
+	 */
+	void record_cpu_time(avk::window::frame_id_t aFrameId, double aMilliseconds)
+	{
+		mFrames[aFrameId].mCpuMilliseconds = aMilliseconds;
+		sample_memory();
+	}
+
+	/**	Stores the GPU times of a frame
+	 *	@param	aFrameId			The frame's id
+	 *	@param	aPassNames			Names of the measured passes
+	 *	@param	aMilliseconds		GPU time of every pass, plus the whole frame as last element
+	 */
+	void record_gpu_times(avk::window::frame_id_t aFrameId, const std::vector<std::string>& aPassNames, const std::vector<float>& aMilliseconds)
+	{
+		if (mPassNames.empty()) {
+			mPassNames = aPassNames;
+			mPassNames.push_back("Frame");
+		}
+		mFrames[aFrameId].mGpuMilliseconds = aMilliseconds;
+	}
+
+	/**	Writes the report. It contains one entry per frame with the CPU time and the GPU time of every pass, and the peak memory usage.
+	 *	@param	aPath		Path of the JSON file, which is overwritten
+	 */
+	void write_json(const std::string& aPath) const
+	{
+		nlohmann::json report;
+		report["device"] = std::string(avk::context().physical_device().getProperties().deviceName.data());
+		report["num_frames"] = mFrames.size();
+		report["gpu_passes"] = mPassNames;
+		auto heaps = nlohmann::json::array();
+		for (size_t i = 0; i < mHeaps.size(); ++i) {
+			const auto& h = mHeaps[i];
+			heaps.push_back({
+				{ "heap", i },
+				{ "device_local", h.mDeviceLocal },
+				{ "size_bytes", h.mSize },
+				{ "peak_usage_bytes", h.mPeakUsageBytes },
+				{ "peak_block_bytes", h.mPeakBlockBytes },
+				{ "budget_bytes", h.mBudgetBytes }
+			});
+		}
+		report["memory_heaps"] = std::move(heaps);
+		report["memory_budget_from_driver"] = avk::context().memory_budget_extension_requested();
+
+		auto frames = nlohmann::json::array();
+		double cpuTotal = 0.0;
+		double gpuTotal = 0.0;
+		for (const auto& [frameId, record] : mFrames) {
+			frames.push_back({
+				{ "frame", frameId },
+				{ "cpu_ms", record.mCpuMilliseconds },
+				{ "gpu_ms", record.mGpuMilliseconds }
+			});
+			cpuTotal += record.mCpuMilliseconds;
+			gpuTotal += record.mGpuMilliseconds.empty() ? 0.0 : static_cast<double>(record.mGpuMilliseconds.back());
+		}
+		report["frames"] = std::move(frames);
+		const auto n = static_cast<double>(std::max<size_t>(mFrames.size(), 1));
+		report["avg_cpu_ms"] = cpuTotal / n;
+		report["avg_gpu_ms"] = gpuTotal / n;
+
+		std::ofstream file(aPath, std::ios::out | std::ios::trunc);
+		if (!file.is_open()) {
+			throw avk::runtime_error("Could not open file " + aPath);
+		}
+		file << report.dump(1, '\t') << '\n';
+		LOG_INFO_EM("Benchmark report written to '" + aPath + "'");
+	}
+
+private:
+	void sample_memory()
+	{
+		auto& allocator = avk::context().memory_allocator();
+		const VkPhysicalDeviceMemoryProperties* memoryProperties = nullptr;
+		vmaGetMemoryProperties(allocator, &memoryProperties);
+		std::array<VmaBudget, VK_MAX_MEMORY_HEAPS> budgets{};
+		vmaGetHeapBudgets(allocator, budgets.data());
+		mHeaps.resize(memoryProperties->memoryHeapCount);
+		for (uint32_t i = 0; i < memoryProperties->memoryHeapCount; ++i) {
+			auto& h = mHeaps[i];
+			h.mDeviceLocal = (memoryProperties->memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0;
+			h.mSize = memoryProperties->memoryHeaps[i].size;
+			if (budgets[i].usage >= h.mPeakUsageBytes) {
+				h.mPeakUsageBytes = budgets[i].usage;
+				h.mBudgetBytes = budgets[i].budget;
+			}
+			h.mPeakBlockBytes = std::max<uint64_t>(h.mPeakBlockBytes, budgets[i].statistics.blockBytes);
+		}
+	}
+
+	uint32_t mNumFrames;
+	std::vector<std::string> mPassNames;
+	std::map<avk::window::frame_id_t, frame_record> mFrames;
+	std::vector<heap_record> mHeaps;
+};
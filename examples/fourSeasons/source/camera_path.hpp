@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <optional>
 #include <vector>
 #include <memory>
 #include <fstream>
@@ -17,6 +19,8 @@ public:
         , mSpeed{ 1.0f } // How fast does it move
         , mStartTime{ avk::time().time_since_start() }
         , mRecordingDensity(0.5f) // Default recording density is 0.05 seconds
+        , mStep{ 0 }
+        , mCompletedOnce{ false }
     {
         std::vector<glm::vec3> positions = {};
         std::vector<glm::vec3> rotations = {};
@@ -51,19 +55,45 @@ public:
         }
     }
 
+    /** Advances along the path by a fixed amount per update() call instead of by the elapsed time.
+     *  This makes the visited views independent of the frame rate, e.g., for benchmarks.
+     *  @param aNumStepsForWholePath   Number of update() calls which it takes to traverse the whole path
+     */
+    void use_fixed_steps(uint32_t aNumStepsForWholePath)
+    {
+        mNumFixedSteps = std::max(aNumStepsForWholePath, 2u);
+        mStep = 0;
+        mCompletedOnce = false;
+    }
+
+    /** True after the whole path has been traversed at least once */
+    bool has_completed_once() const { return mCompletedOnce; }
+
     void update()
     {
-        // Use the RecordingDensity to move the camera along the path
-        // Assume each control point is recorded at exactly RecordingDensity seconds
+        float percentage;
+        if (mNumFixedSteps.has_value()) {
+            percentage = static_cast<float>(mStep) / static_cast<float>(*mNumFixedSteps - 1);
+            if (++mStep == *mNumFixedSteps) {
+                // restart the path
+                mStep = 0;
+                mCompletedOnce = true;
+            }
+        }
+        else {
+            // Use the RecordingDensity to move the camera along the path
+            // Assume each control point is recorded at exactly RecordingDensity seconds
 
-        auto t = (avk::time().time_since_start() - mStartTime);
-        auto numberOfControlPoints = mPathPositions.size() * 4 + 1;
-        auto total_time_span = mRecordingDensity * numberOfControlPoints;
-        auto percentage = t / total_time_span * mSpeed;
-        if (percentage > 1.0f) {
-            // restart the path
-            mStartTime = avk::time().time_since_start();
-            percentage = 0.0f;
+            auto t = (avk::time().time_since_start() - mStartTime);
+            auto numberOfControlPoints = mPathPositions.size() * 4 + 1;
+            auto total_time_span = mRecordingDensity * numberOfControlPoints;
+            percentage = t / total_time_span * mSpeed;
+            if (percentage > 1.0f) {
+                // restart the path
+                mStartTime = avk::time().time_since_start();
+                percentage = 0.0f;
+                mCompletedOnce = true;
+            }
         }
 
         // Determine which bezier curve to use
@@ -83,6 +113,10 @@ private:
     float mSpeed;
     float mStartTime;
     float mRecordingDensity;
+    // If set, the path is traversed in this many steps, regardless of the time:
+    std::optional<uint32_t> mNumFixedSteps;
+    uint32_t mStep;
+    bool mCompletedOnce;
     std::vector<std::unique_ptr<avk::bezier_curve>> mPathPositions;
     std::vector<std::unique_ptr<avk::bezier_curve>> mRotationPath;
 };
\ No newline at end of file
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <vector>
+
+#include "auto_vk_toolkit.hpp"
+
+/** Command buffers and semaphores which are created once per in-flight index and recycled afterwards.
+ *
+ *  Every frame gets its own command pool. When a frame begins, the window has already waited on the
+ *  fence of the frame that has used the same in-flight index before. Hence, all of that frame's
+ *  command buffers have finished executing, its semaphores have been waited on, and the whole
+ *  command pool can be reset at once. After the first few frames, no Vulkan objects are created
+ *  anymore, which can be checked via num_objects_created_in_current_frame().
+ *
+ *  Usage example:
+ *
+ *	mFrameResources.emplace(*mQueue, 9u, 10u);
+ *	...
+ *	mFrameResources->begin_frame(mainWnd->current_in_flight_index());
+ *	avk::context().record({ ... })
+ *		.into_command_buffer(mFrameResources->command_buffer(0))
+ *		.then_submit_to(*mQueue)
+ *		.signaling_upon_completion(avk::stage::color_attachment_output >> mFrameResources->semaphore(0))
+ *		.submit();
+ */
+class frame_resource_pool
+{
+	struct per_frame_resources
+	{
+		avk::command_pool mCommandPool;
+		std::vector<avk::command_buffer> mCommandBuffers;
+		std::vector<avk::semaphore> mSemaphores;
+	};
+
+public:
+	/**	Creates an empty pool. The resources of an in-flight index are created when it is used for the first time.
+	 *	@param	aQueue						The queue which the command buffers will be submitted to
+	 *	@param	aNumCommandBuffersPerFrame	Number of command buffers per frame
+	 *	@param	aNumSemaphoresPerFrame		Number of binary semaphores per frame
+	 */
+	frame_resource_pool(avk::queue& aQueue, uint32_t aNumCommandBuffersPerFrame, uint32_t aNumSemaphoresPerFrame)
+		: mQueue{ &aQueue }
+		, mNumCommandBuffersPerFrame{ aNumCommandBuffersPerFrame }
+		, mNumSemaphoresPerFrame{ aNumSemaphoresPerFrame }
+		, mCurrentFrame{ nullptr }
+		, mNumObjectsCreated{ 0 }
+		, mNumObjectsCreatedInCurrentFrame{ 0 }
+	{
+	}
+
+	frame_resource_pool(frame_resource_pool&&) noexcept = delete;
+	frame_resource_pool(const frame_resource_pool&) = delete;
+	frame_resource_pool& operator=(frame_resource_pool&&) noexcept = delete;
+	frame_resource_pool& operator=(const frame_resource_pool&) = delete;
+	~frame_resource_pool() = default;
+
+	/**	Recycles the resources of the given in-flight index. Call this once per frame, before any of the
+	 *	frame's resources are used, and only after the window has waited on the frame's fence (i.e., in render()).
+	 *	@param	aInFlightIndex		The current frame's in-flight index
+	 */
+	void begin_frame(avk::window::frame_id_t aInFlightIndex)
+	{
+		const auto ifi = static_cast<size_t>(aInFlightIndex);
+		mNumObjectsCreatedInCurrentFrame = 0;
+
+		// The number of concurrent frames can be changed at runtime => create missing in-flight slots lazily:
+		if (ifi >= mFrames.size()) {
+			mFrames.resize(ifi + 1);
+		}
+		auto& frame = mFrames[ifi];
+
+		if (!frame.mCommandPool.has_value()) {
+			frame.mCommandPool = avk::context().create_command_pool(mQueue->family_index(), vk::CommandPoolCreateFlagBits::eTransient);
+			frame.mCommandBuffers = frame.mCommandPool->alloc_command_buffers(mNumCommandBuffersPerFrame, vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
+			for (uint32_t i = 0; i < mNumSemaphoresPerFrame; ++i) {
+				frame.mSemaphores.push_back(avk::context().create_semaphore());
+			}
+			mNumObjectsCreatedInCurrentFrame = 1 + mNumCommandBuffersPerFrame + mNumSemaphoresPerFrame;
+			mNumObjectsCreated += mNumObjectsCreatedInCurrentFrame;
+		}
+		else {
+			// The previous frame with this in-flight index is done => release whatever its command buffers kept alive...
+			for (auto& cb : frame.mCommandBuffers) {
+				cb->prepare_for_reuse();
+			}
+			// ...and reset all of them at once:
+			frame.mCommandPool->reset();
+		}
+
+		mCurrentFrame = &frame;
+	}
+
+	/** The current frame's command buffer at the given index */
+	avk::command_buffer_t& command_buffer(uint32_t aIndex)
+	{
+		assert(nullptr != mCurrentFrame);
+		return mCurrentFrame->mCommandBuffers[aIndex].get();
+	}
+
+	/** The current frame's semaphore at the given index */
+	avk::semaphore_t& semaphore(uint32_t aIndex)
+	{
+		assert(nullptr != mCurrentFrame);
+		return mCurrentFrame->mSemaphores[aIndex].get();
+	}
+
+	/** Total number of Vulkan objects (command pools, command buffers, semaphores) which have been created by this pool */
+	uint64_t num_objects_created() const { return mNumObjectsCreated; }
+
+	/** Number of Vulkan objects which have been created in the current frame. This is zero in steady state. */
+	uint64_t num_objects_created_in_current_frame() const { return mNumObjectsCreatedInCurrentFrame; }
+
+private:
+	avk::queue* mQueue;
+	uint32_t mNumCommandBuffersPerFrame;
+	uint32_t mNumSemaphoresPerFrame;
+	std::vector<per_frame_resources> mFrames;
+	per_frame_resources* mCurrentFrame;
+	uint64_t mNumObjectsCreated;
+	uint64_t mNumObjectsCreatedInCurrentFrame;
+};
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <optional>
+#include <vector>
+
+#include "auto_vk_toolkit.hpp"
+
+/** What model_loader_app renders its frames into: the back buffers of a window, or, for headless benchmarks, an offscreen
+ *  framebuffer with the same attachments as the window's back buffers, i.e., a color and a depth attachment.
+ *
+ *  Offscreen frames are neither acquired from a swapchain nor presented. Like all intermediate framebuffers of the demo,
+ *  the offscreen framebuffer is shared by all frames in flight, whose submissions are ordered by the render graph's
+ *  timeline semaphore. begin_frame and end_frame throttle the host with one fence per in-flight index, like
+ *  window::sync_before_render does, and count the frames. With a window, they do nothing, because the composition syncs it.
+ *
+ *  Usage example:
+ *
+ *	mTarget->begin_frame();
+ *	auto ifi = mTarget->current_in_flight_index();
+ *	...
+ *	mRenderGraph->add_pass("DoF composition").rendering_into(mTarget->current_backbuffer_reference())...
+ *	mRenderGraph->execute(*mFrameResources);
+ *	mTarget->end_frame();
+ */
+class frame_target
+{
+public:
+	/** Renders into the back buffers of the given window */
+	explicit frame_target(avk::window* aWindow)
+		: mWindow{ aWindow }
+		, mQueue{ nullptr }
+		, mResolution{ 0u, 0u }
+		, mCurrentFrame{ 0 }
+	{
+	}
+
+	/**	Renders into an offscreen framebuffer
+	 *	@param	aQueue					The queue which all frames are submitted to
+	 *	@param	aResolution				Resolution of the framebuffer
+	 *	@param	aColorFormat			Format of the color attachment
+	 *	@param	aDepthFormat			Format of the depth attachment
+	 *	@param	aNumFramesInFlight		Number of frames which the host may record ahead of the device
+	 */
+	frame_target(avk::queue& aQueue, glm::uvec2 aResolution, vk::Format aColorFormat, vk::Format aDepthFormat, avk::window::frame_id_t aNumFramesInFlight)
+		: mWindow{ nullptr }
+		, mQueue{ &aQueue }
+		, mResolution{ aResolution }
+		, mColorFormat{ aColorFormat }
+		, mDepthFormat{ aDepthFormat }
+		, mCurrentFrame{ 0 }
+	{
+		auto color = avk::context().create_image_view(avk::context().create_image(aResolution.x, aResolution.y, aColorFormat, 1, avk::memory_usage::device, avk::image_usage::general_color_attachment));
+		auto depth = avk::context().create_depth_image_view(avk::context().create_depth_image(aResolution.x, aResolution.y, aDepthFormat, 1, avk::memory_usage::device, avk::image_usage::general_depth_stencil_attachment));
+		mFramebuffer = avk::context().create_framebuffer({
+			avk::attachment::declare(aColorFormat, avk::on_load::clear.from_previous_layout(avk::layout::undefined), avk::usage::color(0), avk::on_store::store),
+			avk::attachment::declare(aDepthFormat, avk::on_load::clear.from_previous_layout(avk::layout::undefined), avk::usage::depth_stencil, avk::on_store::dont_care)
+		}, std::move(color), std::move(depth));
+		for (avk::window::frame_id_t i = 0; i < aNumFramesInFlight; ++i) {
+			mFences.push_back(avk::context().create_fence(true));
+		}
+	}
+
+	frame_target(frame_target&&) noexcept = delete;
+	frame_target(const frame_target&) = delete;
+	frame_target& operator=(frame_target&&) noexcept = delete;
+	frame_target& operator=(const frame_target&) = delete;
+	~frame_target() = default;
+
+	/** True if there is no window, i.e., nothing is presented */
+	bool is_headless() const { return nullptr == mWindow; }
+
+	glm::uvec2 resolution() const { return is_headless() ? mResolution : mWindow->resolution(); }
+
+	float aspect_ratio() const { return is_headless() ? static_cast<float>(mResolution.x) / static_cast<float>(mResolution.y) : mWindow->aspect_ratio(); }
+
+	vk::Format color_format() const { return is_headless() ? mColorFormat : avk::format_from_window_color_buffer(mWindow); }
+
+	vk::Format depth_format() const { return is_headless() ? mDepthFormat : avk::format_from_window_depth_buffer(mWindow); }
+
+	/** The render pass of the back buffers, which final passes must be compatible with */
+	const avk::renderpass_t& renderpass_reference() const { return is_headless() ? mFramebuffer->renderpass_reference() : mWindow->renderpass_reference(); }
+
+	const avk::framebuffer_t& backbuffer_reference_at_index(size_t aIndex) const { return is_headless() ? mFramebuffer.get() : mWindow->backbuffer_reference_at_index(aIndex); }
+
+	/** The framebuffer which the current frame's final pass renders into */
+	const avk::framebuffer_t& current_backbuffer_reference() const { return is_headless() ? mFramebuffer.get() : mWindow->current_backbuffer_reference(); }
+
+	avk::window::frame_id_t current_frame() const { return is_headless() ? mCurrentFrame : mWindow->current_frame(); }
+
+	avk::window::frame_id_t number_of_frames_in_flight() const { return is_headless() ? static_cast<avk::window::frame_id_t>(mFences.size()) : mWindow->number_of_frames_in_flight(); }
+
+	avk::window::frame_id_t current_in_flight_index() const { return current_frame() % number_of_frames_in_flight(); }
+
+	/** The semaphore which the current frame's final pass must wait on before it renders into the back buffer, if there is a window */
+	std::optional<avk::semaphore> consume_current_image_available_semaphore()
+	{
+		if (is_headless()) {
+			return {};
+		}
+		return mWindow->consume_current_image_available_semaphore();
+	}
+
+	/** Waits until the frame which has used the current in-flight index before has completed on the device. Call it before render(). */
+	void begin_frame()
+	{
+		if (is_headless()) {
+			auto& fence = mFences[current_in_flight_index()];
+			fence->wait_until_signalled();
+			fence->reset();
+		}
+	}
+
+	/** Marks the end of the current frame after all of its submissions, and advances to the next frame. Call it after render(). */
+	void end_frame()
+	{
+		if (is_headless()) {
+			// A submission without command buffers signals its fence after all previously submitted work has completed:
+			mQueue->handle().submit({}, mFences[current_in_flight_index()]->handle());
+			++mCurrentFrame;
+		}
+	}
+
+private:
+	avk::window* mWindow;
+	avk::queue* mQueue;
+	glm::uvec2 mResolution;
+	vk::Format mColorFormat = vk::Format::eUndefined;
+	vk::Format mDepthFormat = vk::Format::eUndefined;
+	avk::framebuffer mFramebuffer;
+	std::vector<avk::fence> mFences;
+	avk::window::frame_id_t mCurrentFrame;
+};
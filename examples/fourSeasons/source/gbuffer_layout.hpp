@@ -0,0 +1,99 @@
+#pragma once
+
+#include <vector>
+
+#include <glm/gtc/packing.hpp>
+
+#include "auto_vk_toolkit.hpp"
+#include "vertex_packing.hpp"
+
+/** The layouts of the G-buffer which the rasterization pass writes, and the SSAO and illumination passes read */
+enum struct gbuffer_format
+{
+	/** Albedo (RGBA8), view-space and world-space positions and normals (4 x RGBA32F), and depth (D32): 72 bytes per pixel */
+	full_precision,
+	/** Albedo (RGBA8), one octahedral-encoded view-space normal (RG16 SNORM), and depth (D32): 12 bytes per pixel */
+	compact
+};
+
+/** Describes both G-buffer layouts to the passes which write and read them, and mirrors the compact layout's encodings on the CPU.
+ *
+ *  In the gbuffer_format::compact layout, positions are not stored at all: the SSAO pass reconstructs view-space positions from
+ *  the depth attachment and the inverse projection matrix. Only the view-space normal is stored, octahedral-encoded like the
+ *  normals of vertex_format::interleaved_quantized (see vertex_packing.hpp); the illumination pass derives the world-space
+ *  normal from it via the inverse view matrix.
+ *
+ *  Usage example:
+ *
+ *	for (auto format : gbuffer_layout::color_formats(gbuffer_format::compact)) {
+ *		attachments.push_back(avk::context().create_image(w, h, format, ...));
+ *	}
+ *	avk::fragment_shader(gbuffer_layout::ssao_fragment_shader_path(gbuffer_format::compact)),
+ */
+class gbuffer_layout
+{
+public:
+	static constexpr vk::Format cDepthFormat = vk::Format::eD32Sfloat;
+
+	/** The formats of the color attachments of the given layout, in the order of their locations in the rasterization pass */
+	static std::vector<vk::Format> color_formats(gbuffer_format aFormat)
+	{
+		if (gbuffer_format::compact == aFormat) {
+			return { vk::Format::eR8G8B8A8Unorm, vk::Format::eR16G16Snorm };
+		}
+		return { vk::Format::eR8G8B8A8Unorm, vk::Format::eR32G32B32A32Sfloat, vk::Format::eR32G32B32A32Sfloat, vk::Format::eR32G32B32A32Sfloat, vk::Format::eR32G32B32A32Sfloat };
+	}
+
+	/** Number of bytes of one pixel in the given layout, summed over all of its attachments including depth */
+	static constexpr size_t bytes_per_pixel(gbuffer_format aFormat)
+	{
+		return gbuffer_format::compact == aFormat
+			? 4 + 4 + 4
+			: 4 + 4 * 16 + 4;
+	}
+
+	/** The fragment shader of the rasterization pass which writes the given layout */
+	static const char* raster_fragment_shader_path(gbuffer_format aFormat)
+	{
+		return gbuffer_format::compact == aFormat ? "shaders/raster_compact.frag" : "shaders/raster.frag";
+	}
+
+	/** The fragment shader of the skybox, which is rendered into the G-buffer, too */
+	static const char* skybox_fragment_shader_path(gbuffer_format aFormat)
+	{
+		return gbuffer_format::compact == aFormat ? "shaders/skybox_compact.frag" : "shaders/skybox.frag";
+	}
+
+	/** The fragment shader of the SSAO pass which reads the given layout */
+	static const char* ssao_fragment_shader_path(gbuffer_format aFormat)
+	{
+		return gbuffer_format::compact == aFormat ? "shaders/ssao_compact.frag" : "shaders/ssao.frag";
+	}
+
+	/** The fragment shader of the illumination pass which reads the given layout */
+	static const char* illumination_fragment_shader_path(gbuffer_format aFormat)
+	{
+		return gbuffer_format::compact == aFormat ? "shaders/illum_compact.frag" : "shaders/illum.frag";
+	}
+
+	/** Encodes a unit normal like shaders/raster_compact.frag does, as it is stored in the RG16 SNORM attachment */
+	static glm::i16vec2 encode_normal(const glm::vec3& aNormal)
+	{
+		return glm::packSnorm<int16_t>(vertex_packing::encode_octahedral(aNormal));
+	}
+
+	/** Decodes a normal like shaders/ssao_compact.frag and shaders/illum_compact.frag do */
+	static glm::vec3 decode_normal(const glm::i16vec2& aEncoded)
+	{
+		return vertex_packing::decode_octahedral(glm::unpackSnorm<float>(aEncoded));
+	}
+
+	/** Reconstructs a view-space position from the texture coordinates of a screen-space pass and the depth value at that pixel,
+	 *  like view_position in shaders/ssao_compact.frag does.
+	 */
+	static glm::vec3 reconstruct_view_position(const glm::vec2& aTexCoord, float aDepth, const glm::mat4& aInverseProjection)
+	{
+		const auto p = aInverseProjection * glm::vec4{ aTexCoord * 2.0f - 1.0f, aDepth, 1.0f };
+		return glm::vec3{ p } / p.w;
+	}
+};
@@ -0,0 +1,386 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <future>
+#include <limits>
+#include <optional>
+#include <vector>
+
+#include "auto_vk_toolkit.hpp"
+#include "pipeline_compiler.hpp"
+#include "upload_batcher.hpp"
+
+/** A small chunk of one draw call's triangles together with its object-space bounding box.
+ *	Matches the layout of struct Cluster in shaders/cull.comp (std430).
+ */
+struct cluster_gpu_data
+{
+	glm::vec4 mAabbMin;
+	glm::vec4 mAabbMax;
+	uint32_t mFirstIndex;
+	uint32_t mIndexCount;
+	int32_t mVertexOffset;
+	uint32_t mDrawIndex; // Index into the per-draw data, passed on as the draw's firstInstance
+};
+
+/**	Splits the triangles of one draw call into clusters of at most aTrianglesPerCluster triangles
+ *	and appends them to aClusters.
+ *	@param	aClusters				The clusters are appended to this vector
+ *	@param	aPositions				The draw call's vertex positions
+ *	@param	aIndices				The draw call's indices, relative to its first vertex
+ *	@param	aFirstIndex				Offset of the draw call's first index within the shared index buffer
+ *	@param	aVertexOffset			Offset of the draw call's first vertex within the shared vertex buffers
+ *	@param	aDrawIndex				Index of the draw call's entry in the per-draw data
+ *	@param	aTrianglesPerCluster	Maximum number of triangles per cluster
+ */
+inline void append_clusters(std::vector<cluster_gpu_data>& aClusters, const std::vector<glm::vec3>& aPositions, const std::vector<uint32_t>& aIndices, uint32_t aFirstIndex, int32_t aVertexOffset, uint32_t aDrawIndex, uint32_t aTrianglesPerCluster = 256)
+{
+	const auto indicesPerCluster = static_cast<size_t>(aTrianglesPerCluster) * 3;
+	for (size_t begin = 0; begin < aIndices.size(); begin += indicesPerCluster) {
+		const auto end = std::min(begin + indicesPerCluster, aIndices.size());
+		glm::vec3 aabbMin{ std::numeric_limits<float>::max() };
+		glm::vec3 aabbMax{ std::numeric_limits<float>::lowest() };
+		for (size_t i = begin; i < end; ++i) {
+			aabbMin = glm::min(aabbMin, aPositions[aIndices[i]]);
+			aabbMax = glm::max(aabbMax, aPositions[aIndices[i]]);
+		}
+		aClusters.push_back(cluster_gpu_data{
+			glm::vec4{ aabbMin, 1.0f }, glm::vec4{ aabbMax, 1.0f },
+			aFirstIndex + static_cast<uint32_t>(begin), static_cast<uint32_t>(end - begin), aVertexOffset, aDrawIndex
+		});
+	}
+}
+
+/** GPU-driven visibility culling of clusters against the view frustum and a hierarchical depth buffer (HiZ).
+ *
+ *  Each frame, a compute pass tests all clusters and writes one indirect draw command per visible
+ *  cluster into a compacted buffer. The number of surviving draws is written into a counter buffer,
+ *  which is consumed by one vkCmdDrawIndexedIndirectCount => the CPU never touches visibility data.
+ *  After the scene has been rendered, the depth buffer is reduced into a max-depth pyramid which is
+ *  used for occlusion culling in the next frame. Since that pyramid contains the previous frame's depth,
+ *  clusters are reprojected with the previous frame's view-projection matrix for the occlusion test.
+ *
+ *  Usage per frame:
+ *
+ *	record_culling(ifi, frame, ...)                   // before the render pass
+ *	draw(indexBuffer, vertexBuffers...)               // inside the render pass
+ *	record_hiz_build(ifi, frame, depthImageSampler)   // after the render pass
+ */
+class gpu_culling
+{
+	// Matches the layout of the CullingData uniform buffer in shaders/cull.comp (std140):
+	struct culling_data
+	{
+		glm::mat4 mSceneModelMatrix;
+		glm::mat4 mViewProjMatrix;
+		glm::mat4 mPrevViewProjMatrix;
+		std::array<glm::vec4, 6> mFrustumPlanes;
+		glm::uvec4 mParams;
+	};
+
+	// Matches the layout of the Counters buffer in shaders/cull.comp:
+	struct counters
+	{
+		uint32_t mDrawCount;
+		uint32_t mNumTrianglesSubmitted;
+	};
+
+public:
+	/**	Uploads the clusters and creates all the resources that are required for culling.
+	 *	@param	aBatcher				The cluster data is staged in this batcher, i.e., it is available after it has been submitted and acquired
+	 *	@param	aClusters				All clusters of the scene
+	 *	@param	aPerDrawDataBuffer		The per-draw data, which contains the model matrix of each draw
+	 *	@param	aDepthResolution		Resolution of the depth buffer from which the HiZ pyramid will be built
+	 *	@param	aMaxFramesInFlight		Maximum number of concurrent frames; per-frame resources are created for each one
+	 *	@param	aPipelineCompiler		Creates the compute pipelines, which are only waited for when they are recorded for the first time
+	 */
+	gpu_culling(upload_batcher& aBatcher, const std::vector<cluster_gpu_data>& aClusters, const avk::buffer& aPerDrawDataBuffer, glm::uvec2 aDepthResolution, size_t aMaxFramesInFlight, avk::pipeline_compiler& aPipelineCompiler)
+		: mNumClusters{ static_cast<uint32_t>(aClusters.size()) }
+		, mNumTrianglesTotal{ 0 }
+	{
+		for (const auto& cluster : aClusters) {
+			mNumTrianglesTotal += cluster.mIndexCount / 3;
+		}
+
+		mClusterBuffer = avk::context().create_buffer(avk::memory_usage::device, {},
+			avk::storage_buffer_meta::create_from_data(aClusters)
+		);
+		aBatcher.stage(mClusterBuffer.as_reference(), 0, aClusters.data(), sizeof(cluster_gpu_data) * aClusters.size());
+
+		// Written by the culling pass, read as indirect draw parameters:
+		mDrawCommandsBuffer = avk::context().create_buffer(avk::memory_usage::device, {},
+			avk::storage_buffer_meta::create_from_size(sizeof(vk::DrawIndexedIndirectCommand) * std::max(mNumClusters, 1u)),
+			avk::indirect_buffer_meta::create_from_num_elements_for_draw_indexed_indirect(std::max(mNumClusters, 1u))
+		);
+		mCountersBuffer = avk::context().create_buffer(avk::memory_usage::device, vk::BufferUsageFlagBits::eTransferSrc,
+			avk::storage_buffer_meta::create_from_size(sizeof(counters)),
+			avk::indirect_buffer_meta::create_from_size(sizeof(counters))
+		);
+
+		for (size_t i = 0; i < aMaxFramesInFlight; ++i) {
+			mCullingDataBuffers.push_back(avk::context().create_buffer(
+				avk::memory_usage::host_coherent, {},
+				avk::uniform_buffer_meta::create_from_data(culling_data{})
+			));
+			// The counters are copied in here after each frame, s.t. the host can read them without stalling:
+			mStatisticsBuffers.push_back(avk::context().create_buffer(
+				avk::memory_usage::host_coherent, vk::BufferUsageFlagBits::eTransferDst,
+				avk::generic_buffer_meta::create_from_size(sizeof(counters))
+			));
+		}
+		mStatisticsPending.resize(aMaxFramesInFlight, false);
+
+		// The HiZ pyramid's level 0 has half the resolution of the depth buffer:
+		const auto w = std::max(aDepthResolution.x / 2u, 1u);
+		const auto h = std::max(aDepthResolution.y / 2u, 1u);
+		mHiZImage = avk::context().create_image(w, h, vk::Format::eR32Sfloat, 1, avk::memory_usage::device, avk::image_usage::general_storage_image | avk::image_usage::mip_mapped);
+		mHiZImage.enable_shared_ownership(); // One view per level + one view of the whole chain
+		const auto numLevels = mHiZImage->create_info().mipLevels;
+		auto sampler = avk::context().create_sampler(avk::filter_mode::nearest_neighbor, avk::border_handling_mode::clamp_to_edge, static_cast<float>(numLevels));
+		sampler.enable_shared_ownership();
+		for (uint32_t level = 0; level < numLevels; ++level) {
+			auto levelView = avk::context().create_image_view(mHiZImage, {}, {}, [level](avk::image_view_t& aView) {
+				aView.create_info().subresourceRange.setBaseMipLevel(level).setLevelCount(1);
+			});
+			levelView.enable_shared_ownership();
+			mHiZLevelViews.push_back(levelView);
+			mHiZLevelSamplers.push_back(avk::context().create_image_sampler(levelView, sampler));
+		}
+		mHiZSampler = avk::context().create_image_sampler(avk::context().create_image_view(mHiZImage), sampler);
+
+		mDescriptorCache = avk::context().create_descriptor_cache("gpu_culling");
+
+		mCullPipelineFuture = aPipelineCompiler.create_compute_pipeline_for(
+			avk::compute_shader("shaders/cull.comp"),
+			avk::descriptor_binding(0, 0, mCullingDataBuffers[0]),
+			avk::descriptor_binding(0, 1, mClusterBuffer),
+			avk::descriptor_binding(0, 2, aPerDrawDataBuffer),
+			avk::descriptor_binding(0, 3, mDrawCommandsBuffer),
+			avk::descriptor_binding(0, 4, mCountersBuffer),
+			avk::descriptor_binding(0, 5, mHiZSampler->as_combined_image_sampler(avk::layout::general))
+		);
+		mHiZReducePipelineFuture = aPipelineCompiler.create_compute_pipeline_for(
+			avk::compute_shader("shaders/hiz_reduce.comp"),
+			avk::descriptor_binding(0, 0, mHiZLevelSamplers[0]->as_combined_image_sampler(avk::layout::general)),
+			avk::descriptor_binding(0, 1, mHiZLevelViews[0]->as_storage_image(avk::layout::general))
+		);
+	}
+
+	gpu_culling(gpu_culling&&) noexcept = delete;
+	gpu_culling(const gpu_culling&) = delete;
+	gpu_culling& operator=(gpu_culling&&) noexcept = delete;
+	gpu_culling& operator=(const gpu_culling&) = delete;
+	~gpu_culling() = default;
+
+	/**	Records the commands which cull all clusters into the compacted draw commands buffer.
+	 *	Also picks up the statistics of the last frame which has used the same in-flight index.
+	 *	@param	aInFlightIndex			The current frame's in-flight index
+	 *	@param	aCurrentFrame			The current frame's id
+	 *	@param	aPerDrawDataBuffer		The per-draw data, which contains the model matrix of each draw
+	 *	@param	aSceneModelMatrix		Model matrix which is applied to the whole scene
+	 *	@param	aViewProjMatrix			The current frame's view-projection matrix
+	 *	@param	aOcclusionCulling		Whether to test the clusters against the previous frame's HiZ pyramid
+	 */
+	std::vector<avk::recorded_commands_t> record_culling(avk::window::frame_id_t aInFlightIndex, avk::window::frame_id_t aCurrentFrame, const avk::buffer& aPerDrawDataBuffer, const glm::mat4& aSceneModelMatrix, const glm::mat4& aViewProjMatrix, bool aOcclusionCulling)
+	{
+		wait_for_pipelines();
+		const auto ifi = static_cast<size_t>(aInFlightIndex);
+		if (mStatisticsPending[ifi]) {
+			// The frame which has used this in-flight index before has finished on the device:
+			counters stats;
+			auto emptyCmd = mStatisticsBuffers[ifi]->read_into(&stats, 0);
+			mNumVisibleClusters = stats.mDrawCount;
+			mNumTrianglesSubmitted = stats.mNumTrianglesSubmitted;
+			mStatisticsPending[ifi] = false;
+		}
+
+		// The pyramid can only be used if it has been built in the directly preceding frame:
+		const bool hiZValid = mHiZBuiltInFrame.has_value() && mHiZBuiltInFrame.value() + 1 == aCurrentFrame;
+
+		culling_data data;
+		data.mSceneModelMatrix = aSceneModelMatrix;
+		data.mViewProjMatrix = aViewProjMatrix;
+		data.mPrevViewProjMatrix = hiZValid ? mPrevViewProjMatrix : aViewProjMatrix;
+		data.mFrustumPlanes = extract_frustum_planes(aViewProjMatrix);
+		data.mParams = glm::uvec4{ mNumClusters, 1u, (aOcclusionCulling && hiZValid) ? 1u : 0u, 0u };
+		auto emptyCmd = mCullingDataBuffers[ifi]->fill(&data, 0);
+		mPrevViewProjMatrix = aViewProjMatrix;
+
+		std::vector<avk::recorded_commands_t> result;
+		if (!mHiZInitialized) {
+			result.push_back(avk::sync::image_memory_barrier(mHiZImage.as_reference(),
+				avk::stage::none >> avk::stage::compute_shader,
+				avk::access::none >> (avk::access::shader_storage_write | avk::access::shader_sampled_read)
+			).with_layout_transition(avk::layout::undefined >> avk::layout::general));
+			mHiZInitialized = true;
+		}
+
+		// The previous frame's indirect draw and statistics copy must be done before the counters are reset:
+		result.push_back(avk::sync::global_memory_barrier(
+			(avk::stage::draw_indirect | avk::stage::copy) >> avk::stage::clear,
+			(avk::access::indirect_command_read | avk::access::transfer_read) >> avk::access::transfer_write
+		));
+		result.push_back(avk::command::custom_commands([lHandle = mCountersBuffer->handle()](avk::command_buffer_t& cb) {
+			cb.handle().fillBuffer(lHandle, 0, sizeof(counters), 0u);
+		}));
+		result.push_back(avk::sync::global_memory_barrier(
+			(avk::stage::clear | avk::stage::compute_shader | avk::stage::draw_indirect) >> avk::stage::compute_shader,
+			(avk::access::transfer_write | avk::access::shader_storage_write) >> (avk::access::shader_storage_read | avk::access::shader_storage_write | avk::access::shader_sampled_read)
+		));
+
+		result.push_back(avk::command::bind_pipeline(mCullPipeline.as_reference()));
+		result.push_back(avk::command::bind_descriptors(mCullPipeline->layout(), mDescriptorCache->get_or_create_descriptor_sets({
+			avk::descriptor_binding(0, 0, mCullingDataBuffers[ifi]),
+			avk::descriptor_binding(0, 1, mClusterBuffer),
+			avk::descriptor_binding(0, 2, aPerDrawDataBuffer),
+			avk::descriptor_binding(0, 3, mDrawCommandsBuffer),
+			avk::descriptor_binding(0, 4, mCountersBuffer),
+			avk::descriptor_binding(0, 5, mHiZSampler->as_combined_image_sampler(avk::layout::general))
+		})));
+		result.push_back(avk::command::dispatch((mNumClusters + 63u) / 64u, 1u, 1u));
+
+		// Make the draw commands and the draw count visible to the indirect draw:
+		result.push_back(avk::sync::global_memory_barrier(
+			avk::stage::compute_shader >> (avk::stage::draw_indirect | avk::stage::copy),
+			avk::access::shader_storage_write >> (avk::access::indirect_command_read | avk::access::transfer_read)
+		));
+		return result;
+	}
+
+	/**	Draws all clusters which have survived culling with one indirect draw call.
+	 *	Must be recorded inside of a render pass, after record_culling has been recorded for the same frame.
+	 *	@param	aIndexBuffer		The index buffer which is shared by all clusters
+	 *	@param	aVertexBuffers		The vertex buffers which are shared by all clusters
+	 */
+	template <typename... Bfrs>
+	avk::command::action_type_command draw(const avk::buffer_t& aIndexBuffer, const Bfrs&... aVertexBuffers) const
+	{
+		return avk::command::draw_indexed_indirect_count(
+			mDrawCommandsBuffer.as_reference(), aIndexBuffer, mNumClusters,
+			mCountersBuffer.as_reference(), aVertexBuffers...
+		);
+	}
+
+	/**	Records the commands which build the HiZ pyramid from the given depth buffer and
+	 *	which copy this frame's statistics into host-visible memory.
+	 *	Must be recorded after the render pass which has written the depth buffer.
+	 *	@param	aInFlightIndex		The current frame's in-flight index
+	 *	@param	aCurrentFrame		The current frame's id
+	 *	@param	aDepth				The depth buffer, in layout avk::layout::attachment_optimal
+	 */
+	std::vector<avk::recorded_commands_t> record_hiz_build(avk::window::frame_id_t aInFlightIndex, avk::window::frame_id_t aCurrentFrame, const avk::image_sampler& aDepth)
+	{
+		wait_for_pipelines();
+		const auto ifi = static_cast<size_t>(aInFlightIndex);
+		std::vector<avk::recorded_commands_t> result;
+
+		result.push_back(avk::sync::global_memory_barrier(
+			(avk::stage::late_fragment_tests | avk::stage::compute_shader) >> avk::stage::compute_shader,
+			(avk::access::depth_stencil_attachment_write | avk::access::shader_sampled_read) >> (avk::access::shader_sampled_read | avk::access::shader_storage_write)
+		));
+		result.push_back(avk::command::bind_pipeline(mHiZReducePipeline.as_reference()));
+		for (size_t level = 0; level < mHiZLevelViews.size(); ++level) {
+			if (level > 0) {
+				result.push_back(avk::sync::global_memory_barrier(
+					avk::stage::compute_shader >> avk::stage::compute_shader,
+					avk::access::shader_storage_write >> avk::access::shader_sampled_read
+				));
+			}
+			result.push_back(avk::command::bind_descriptors(mHiZReducePipeline->layout(), mDescriptorCache->get_or_create_descriptor_sets({
+				level == 0
+					? avk::descriptor_binding(0, 0, aDepth->as_combined_image_sampler(avk::layout::attachment_optimal))
+					: avk::descriptor_binding(0, 0, mHiZLevelSamplers[level - 1]->as_combined_image_sampler(avk::layout::general)),
+				avk::descriptor_binding(0, 1, mHiZLevelViews[level]->as_storage_image(avk::layout::general))
+			})));
+			const auto w = std::max(mHiZImage->width() >> level, 1u);
+			const auto h = std::max(mHiZImage->height() >> level, 1u);
+			result.push_back(avk::command::dispatch((w + 7u) / 8u, (h + 7u) / 8u, 1u));
+		}
+		// The next frame's culling pass samples the pyramid; the next frame's render pass overwrites the depth buffer:
+		result.push_back(avk::sync::global_memory_barrier(
+			avk::stage::compute_shader >> (avk::stage::compute_shader | avk::stage::early_fragment_tests),
+			avk::access::shader_storage_write >> avk::access::shader_sampled_read
+		));
+
+		// Copy the counters of this frame for the host. They are read when this in-flight index comes around again:
+		result.push_back(avk::command::custom_commands([lSrc = mCountersBuffer->handle(), lDst = mStatisticsBuffers[ifi]->handle()](avk::command_buffer_t& cb) {
+			cb.handle().copyBuffer(lSrc, lDst, vk::BufferCopy{ 0, 0, sizeof(counters) });
+		}));
+		result.push_back(avk::sync::global_memory_barrier(
+			avk::stage::copy >> avk::stage::host,
+			avk::access::transfer_write >> avk::access::host_read
+		));
+		mStatisticsPending[ifi] = true;
+		mHiZBuiltInFrame = aCurrentFrame;
+		return result;
+	}
+
+	/** Total number of clusters in the scene */
+	uint32_t num_clusters() const { return mNumClusters; }
+
+	/** Total number of triangles in the scene */
+	uint32_t num_triangles() const { return mNumTrianglesTotal; }
+
+	/** Number of clusters which have survived culling, as of the most recent frame whose statistics have arrived */
+	uint32_t num_visible_clusters() const { return mNumVisibleClusters; }
+
+	/** Number of triangles which have been submitted for rendering, as of the most recent frame whose statistics have arrived */
+	uint32_t num_triangles_submitted() const { return mNumTrianglesSubmitted; }
+
+private:
+	/** Takes the compute pipelines over from the pipeline compiler, waiting for them if they are not ready yet */
+	void wait_for_pipelines()
+	{
+		if (mCullPipelineFuture.valid()) {
+			mCullPipeline = mCullPipelineFuture.get();
+			mHiZReducePipeline = mHiZReducePipelineFuture.get();
+		}
+	}
+
+	/** Extracts the six frustum planes (pointing inwards) from a view-projection matrix with a [0,1] depth range */
+	static std::array<glm::vec4, 6> extract_frustum_planes(const glm::mat4& aViewProjMatrix)
+	{
+		const auto m = glm::transpose(aViewProjMatrix); // => m[i] is the i-th row
+		std::array<glm::vec4, 6> planes = {
+			m[3] + m[0], // left
+			m[3] - m[0], // right
+			m[3] + m[1], // bottom
+			m[3] - m[1], // top
+			m[2],        // near
+			m[3] - m[2]  // far
+		};
+		for (auto& plane : planes) {
+			plane /= glm::length(glm::vec3(plane));
+		}
+		return planes;
+	}
+
+	uint32_t mNumClusters;
+	uint32_t mNumTrianglesTotal;
+	uint32_t mNumVisibleClusters = 0;
+	uint32_t mNumTrianglesSubmitted = 0;
+
+	avk::buffer mClusterBuffer;
+	avk::buffer mDrawCommandsBuffer;
+	avk::buffer mCountersBuffer;
+	std::vector<avk::buffer> mCullingDataBuffers;
+	std::vector<avk::buffer> mStatisticsBuffers;
+	std::vector<bool> mStatisticsPending;
+
+	avk::image mHiZImage;
+	std::vector<avk::image_view> mHiZLevelViews;
+	std::vector<avk::image_sampler> mHiZLevelSamplers;
+	avk::image_sampler mHiZSampler;
+	bool mHiZInitialized = false;
+	std::optional<avk::window::frame_id_t> mHiZBuiltInFrame;
+	glm::mat4 mPrevViewProjMatrix{ 1.0f };
+
+	avk::descriptor_cache mDescriptorCache;
+	// Valid until the pipelines have been taken over by wait_for_pipelines:
+	std::future<avk::compute_pipeline> mCullPipelineFuture;
+	std::future<avk::compute_pipeline> mHiZReducePipelineFuture;
+	avk::compute_pipeline mCullPipeline;
+	avk::compute_pipeline mHiZReducePipeline;
+};
@@ -0,0 +1,353 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "imgui.h"
+#include "auto_vk_toolkit.hpp"
+
+/** Measures the GPU time of every pass of a frame with timestamp queries.
+ *
+ *  Every in-flight index has its own query pool. The results of a frame are read back when its in-flight index
+ *  is used again, i.e., after the window has waited on that frame's fence. Therefore, the CPU never waits for
+ *  query results; they arrive with a latency of "number of concurrent frames".
+ *
+ *  The duration of the whole frame is the sum of its submissions' durations, from the first timestamp to the last one of each.
+ *  Hence, the time during which the device waits between them, e.g., for the swapchain image to become available, is not counted.
+ *  Timestamps are masked to the queue family's timestampValidBits before durations are computed from them.
+ *
+ *  For every pass, the durations of the last frames are kept to compute rolling min/avg/p95/p99 statistics,
+ *  which can be displayed with draw_imgui_window(). Optionally, the durations of every frame are written
+ *  into a CSV file (one row per frame, one column per pass) for offline comparisons.
+ *
+ *  Usage example:
+ *
+ *	mGpuProfiler.emplace(*mQueue, 16u);
+ *	...
+ *	mGpuProfiler->begin_frame(mainWnd->current_in_flight_index(), mainWnd->current_frame());
+ *	mGpuProfiler->begin_submission();
+ *	auto commands = avk::command::gather(mGpuProfiler->reset_queries(), mGpuProfiler->bracket("SSAO", { ... }));
+ */
+class gpu_profiler
+{
+	struct per_frame_queries
+	{
+		avk::query_pool mQueryPool;
+		// The passes which have written timestamps (two per pass) into the query pool:
+		std::vector<std::string> mPassNames;
+		// The first pass of every submission:
+		std::vector<size_t> mSubmissionBegins;
+		avk::window::frame_id_t mFrameId = -1;
+	};
+
+	struct pass_history
+	{
+		// Ring buffer of the last durations in milliseconds:
+		std::vector<float> mSamples;
+		size_t mNext = 0;
+		float mLast = 0.0f;
+	};
+
+public:
+	/** Rolling statistics of one pass, all values in milliseconds */
+	struct pass_statistics
+	{
+		float mLast;
+		float mMin;
+		float mAvg;
+		float mP95;
+		float mP99;
+	};
+
+	/**	Creates a profiler. The query pools are created lazily per in-flight index.
+	 *	@param	aQueue				The queue which the bracketed passes are submitted to
+	 *	@param	aMaxPassesPerFrame	Maximum number of passes which can be bracketed per frame
+	 *	@param	aHistoryLength		Number of frames which the rolling statistics are computed over
+	 */
+	gpu_profiler(const avk::queue& aQueue, uint32_t aMaxPassesPerFrame, size_t aHistoryLength = 240)
+		: mMaxPassesPerFrame{ aMaxPassesPerFrame }
+		, mHistoryLength{ aHistoryLength }
+		, mTimestampPeriod{ avk::context().physical_device().getProperties().limits.timestampPeriod }
+		, mCurrentFrame{ nullptr }
+	{
+		const auto validBits = avk::context().physical_device().getQueueFamilyProperties()[aQueue.family_index()].timestampValidBits;
+		if (0 == validBits) {
+			LOG_WARNING_EM("The queue family does not support timestamps. All GPU timings will be zero.");
+		}
+		mTimestampMask = validBits >= 64 ? ~uint64_t{ 0 } : (uint64_t{ 1 } << validBits) - 1;
+	}
+
+	gpu_profiler(gpu_profiler&&) noexcept = delete;
+	gpu_profiler(const gpu_profiler&) = delete;
+	gpu_profiler& operator=(gpu_profiler&&) noexcept = delete;
+	gpu_profiler& operator=(const gpu_profiler&) = delete;
+	~gpu_profiler() = default;
+
+	/**	Collects the results of the frame which has used the given in-flight index before, and prepares the index for reuse.
+	 *	Call this once per frame in render(), i.e., after the window has waited on the frame's fence.
+	 *	@param	aInFlightIndex		The current frame's in-flight index
+	 *	@param	aFrameId			The current frame's id, which is written into the CSV file
+	 */
+	void begin_frame(avk::window::frame_id_t aInFlightIndex, avk::window::frame_id_t aFrameId)
+	{
+		const auto ifi = static_cast<size_t>(aInFlightIndex);
+		if (ifi >= mFrames.size()) {
+			mFrames.resize(ifi + 1);
+		}
+		auto& frame = mFrames[ifi];
+
+		if (!frame.mQueryPool.has_value()) {
+			frame.mQueryPool = avk::context().create_query_pool_for_timestamp_queries(2u * mMaxPassesPerFrame);
+		}
+		else if (!frame.mPassNames.empty()) {
+			collect_results(frame);
+		}
+
+		frame.mPassNames.clear();
+		frame.mSubmissionBegins.clear();
+		frame.mFrameId = aFrameId;
+		mCurrentFrame = &frame;
+	}
+
+	/**	Starts a new submission of the current frame: Passes which are bracketed from now on are submitted after the
+	 *	previous ones, possibly after the device has waited on a semaphore. Call this before the first bracketed pass, too.
+	 */
+	void begin_submission()
+	{
+		assert(nullptr != mCurrentFrame);
+		mCurrentFrame->mSubmissionBegins.push_back(mCurrentFrame->mPassNames.size());
+	}
+
+	/** Resets the current frame's queries. Must be recorded before the first bracketed pass, outside of a render pass. */
+	avk::command::action_type_command reset_queries()
+	{
+		assert(nullptr != mCurrentFrame);
+		return mCurrentFrame->mQueryPool->reset(0u, 2u * mMaxPassesPerFrame);
+	}
+
+	/**	Surrounds the given commands with timestamp queries
+	 *	@param	aPassName		Name of the pass, which identifies it in the statistics
+	 *	@param	aCommands		The pass' commands
+	 *	@return	The commands with a timestamp before and after them
+	 */
+	std::vector<avk::recorded_commands_t> bracket(std::string aPassName, std::vector<avk::recorded_commands_t> aCommands)
+	{
+		assert(nullptr != mCurrentFrame);
+		const auto passIndex = static_cast<uint32_t>(mCurrentFrame->mPassNames.size());
+		if (passIndex >= mMaxPassesPerFrame) {
+			LOG_WARNING_EM("Too many passes for gpu_profiler. Pass '" + aPassName + "' is not measured.");
+			return aCommands;
+		}
+		mCurrentFrame->mPassNames.push_back(std::move(aPassName));
+
+		std::vector<avk::recorded_commands_t> result;
+		result.reserve(aCommands.size() + 2);
+		// Both timestamps are written after all previous commands have completed => the difference is the time of this pass only:
+		result.push_back(mCurrentFrame->mQueryPool->write_timestamp(2u * passIndex, avk::stage::all_commands));
+		std::move(std::begin(aCommands), std::end(aCommands), std::back_inserter(result));
+		result.push_back(mCurrentFrame->mQueryPool->write_timestamp(2u * passIndex + 1u, avk::stage::all_commands));
+		return result;
+	}
+
+	/**	Writes the durations of every frame into the given CSV file from now on.
+	 *	@param	aPath		Path of the file, which is overwritten
+	 */
+	void open_csv(const std::string& aPath)
+	{
+		mCsv.open(aPath, std::ios::out | std::ios::trunc);
+		if (!mCsv.is_open()) {
+			LOG_WARNING_EM("Could not open '" + aPath + "' for writing GPU timings.");
+		}
+		mCsvColumns.clear();
+	}
+
+	/**	Sets a function which is invoked with the durations of every frame as soon as they have been read back.
+	 *	The durations are in milliseconds, one per pass, plus the whole frame as last element.
+	 */
+	void set_results_handler(std::function<void(avk::window::frame_id_t, const std::vector<std::string>&, const std::vector<float>&)> aHandler)
+	{
+		mResultsHandler = std::move(aHandler);
+	}
+
+	/**	Reads back the results of all frames which have not been collected yet. Only call this after the device has become idle,
+	 *	e.g., at the end of a benchmark run. Frames are collected in submission order.
+	 */
+	void flush()
+	{
+		std::vector<per_frame_queries*> pending;
+		for (auto& frame : mFrames) {
+			if (frame.mQueryPool.has_value() && !frame.mPassNames.empty()) {
+				pending.push_back(&frame);
+			}
+		}
+		std::sort(std::begin(pending), std::end(pending), [](const per_frame_queries* a, const per_frame_queries* b) { return a->mFrameId < b->mFrameId; });
+		for (auto* frame : pending) {
+			collect_results(*frame);
+			frame->mPassNames.clear();
+			frame->mSubmissionBegins.clear();
+		}
+		mCurrentFrame = nullptr;
+	}
+
+	/** Names of all passes which have been measured so far, in the order in which they were first seen. The last one is the whole frame. */
+	const std::vector<std::string>& pass_names() const { return mPassNames; }
+
+	/** Rolling statistics of the pass with the given name, or all zeros if it has not been measured yet */
+	pass_statistics statistics(const std::string& aPassName) const
+	{
+		const auto it = mHistories.find(aPassName);
+		if (std::end(mHistories) == it || it->second.mSamples.empty()) {
+			return pass_statistics{ 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+		}
+
+		auto sorted = it->second.mSamples;
+		std::sort(std::begin(sorted), std::end(sorted));
+		const auto percentile = [&sorted](float p) {
+			const auto index = static_cast<size_t>(std::ceil(p * static_cast<float>(sorted.size())));
+			return sorted[std::clamp(index, size_t{ 1 }, sorted.size()) - 1];
+		};
+		float sum = 0.0f;
+		for (auto s : sorted) {
+			sum += s;
+		}
+		return pass_statistics{ it->second.mLast, sorted.front(), sum / static_cast<float>(sorted.size()), percentile(0.95f), percentile(0.99f) };
+	}
+
+	/** Draws a window with the statistics of all passes. Call this from within an imgui_manager callback. */
+	void draw_imgui_window()
+	{
+		ImGui::Begin("GPU Profiler");
+		ImGui::SetWindowPos(ImVec2(1.0f, 600.0f), ImGuiCond_FirstUseEver);
+		ImGui::Text("Last %zu frames, in ms:", mHistoryLength);
+		if (ImGui::BeginTable("passes", 6, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+			ImGui::TableSetupColumn("Pass");
+			ImGui::TableSetupColumn("last");
+			ImGui::TableSetupColumn("min");
+			ImGui::TableSetupColumn("avg");
+			ImGui::TableSetupColumn("p95");
+			ImGui::TableSetupColumn("p99");
+			ImGui::TableHeadersRow();
+			for (const auto& name : mPassNames) {
+				const auto s = statistics(name);
+				ImGui::TableNextRow();
+				ImGui::TableNextColumn(); ImGui::TextUnformatted(name.c_str());
+				ImGui::TableNextColumn(); ImGui::Text("%.3f", s.mLast);
+				ImGui::TableNextColumn(); ImGui::Text("%.3f", s.mMin);
+				ImGui::TableNextColumn(); ImGui::Text("%.3f", s.mAvg);
+				ImGui::TableNextColumn(); ImGui::Text("%.3f", s.mP95);
+				ImGui::TableNextColumn(); ImGui::Text("%.3f", s.mP99);
+			}
+			ImGui::EndTable();
+		}
+		ImGui::End();
+	}
+
+private:
+	static constexpr const char* sFrameName = "Frame";
+
+	void collect_results(per_frame_queries& aFrame)
+	{
+		const auto numQueries = static_cast<uint32_t>(2 * aFrame.mPassNames.size());
+		std::vector<uint64_t> timestamps(numQueries);
+		// The frame's fence has been waited on => all results are available and this does not block:
+		const auto result = avk::context().device().getQueryPoolResults(
+			aFrame.mQueryPool->handle(), 0u, numQueries,
+			timestamps.size() * sizeof(uint64_t), timestamps.data(), sizeof(uint64_t),
+			vk::QueryResultFlagBits::e64
+		);
+		if (vk::Result::eSuccess != result) {
+			return;
+		}
+
+		std::vector<float> durations(aFrame.mPassNames.size() + 1);
+		for (size_t i = 0; i < aFrame.mPassNames.size(); ++i) {
+			durations[i] = to_milliseconds(ticks_between(timestamps[2 * i], timestamps[2 * i + 1]));
+			add_sample(aFrame.mPassNames[i], durations[i]);
+		}
+		// Every submission from its first pass' begin to its last pass' end, but not the waits in between:
+		uint64_t frameTicks = 0;
+		for (size_t s = 0; s < aFrame.mSubmissionBegins.size(); ++s) {
+			const auto first = aFrame.mSubmissionBegins[s];
+			const auto end = s + 1 < aFrame.mSubmissionBegins.size() ? aFrame.mSubmissionBegins[s + 1] : aFrame.mPassNames.size();
+			if (first < end) {
+				frameTicks += ticks_between(timestamps[2 * first], timestamps[2 * end - 1]);
+			}
+		}
+		durations.back() = to_milliseconds(frameTicks);
+		add_sample(sFrameName, durations.back());
+
+		write_csv_row(aFrame, durations);
+		if (mResultsHandler) {
+			mResultsHandler(aFrame.mFrameId, aFrame.mPassNames, durations);
+		}
+	}
+
+	/** The ticks from aBegin to aEnd, of which only the queue family's valid bits count; the counter might have wrapped around in between */
+	uint64_t ticks_between(uint64_t aBegin, uint64_t aEnd) const
+	{
+		return ((aEnd & mTimestampMask) - (aBegin & mTimestampMask)) & mTimestampMask;
+	}
+
+	float to_milliseconds(uint64_t aTicks) const
+	{
+		return static_cast<float>(static_cast<double>(aTicks) * static_cast<double>(mTimestampPeriod) * 1e-6);
+	}
+
+	void add_sample(const std::string& aPassName, float aMilliseconds)
+	{
+		auto [it, inserted] = mHistories.try_emplace(aPassName);
+		if (inserted) {
+			// Keep the whole frame as the last entry:
+			const auto frameIt = std::find(std::begin(mPassNames), std::end(mPassNames), sFrameName);
+			mPassNames.insert(aPassName == sFrameName ? std::end(mPassNames) : frameIt, aPassName);
+		}
+		auto& history = it->second;
+		if (history.mSamples.size() < mHistoryLength) {
+			history.mSamples.push_back(aMilliseconds);
+		}
+		else {
+			history.mSamples[history.mNext] = aMilliseconds;
+		}
+		history.mNext = (history.mNext + 1) % mHistoryLength;
+		history.mLast = aMilliseconds;
+	}
+
+	void write_csv_row(const per_frame_queries& aFrame, const std::vector<float>& aDurations)
+	{
+		if (!mCsv.is_open()) {
+			return;
+		}
+		// (Re-)write the header whenever the set of passes changes:
+		if (mCsvColumns != aFrame.mPassNames) {
+			mCsvColumns = aFrame.mPassNames;
+			mCsv << "frame";
+			for (const auto& name : mCsvColumns) {
+				mCsv << ',' << name;
+			}
+			mCsv << ',' << sFrameName << '\n';
+		}
+		mCsv << aFrame.mFrameId;
+		for (auto d : aDurations) {
+			mCsv << ',' << d;
+		}
+		mCsv << '\n';
+	}
+
+	uint32_t mMaxPassesPerFrame;
+	size_t mHistoryLength;
+	float mTimestampPeriod;
+	uint64_t mTimestampMask;
+	std::vector<per_frame_queries> mFrames;
+	per_frame_queries* mCurrentFrame;
+	std::vector<std::string> mPassNames;
+	std::unordered_map<std::string, pass_history> mHistories;
+	std::ofstream mCsv;
+	std::vector<std::string> mCsvColumns;
+	std::function<void(avk::window::frame_id_t, const std::vector<std::string>&, const std::vector<float>&)> mResultsHandler;
+};
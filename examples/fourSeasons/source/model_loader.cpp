@@ -6,14 +6,30 @@
 #include "imgui_manager.hpp"
 #include "invokee.hpp"
 #include "material_image_helpers.hpp"
+#include "pipeline_compiler.hpp"
 #include "model.hpp"
+#include "work_stealing_pool.hpp"
 #include "sequential_invoker.hpp"
 #include "ui_helper.hpp"
 #include "vk_convenience_functions.hpp"
 #include "camera_path_recorder.hpp"
 #include "math_utils.hpp"
+#include "serializer.hpp"
+#include "upload_batcher.hpp"
+#include "gpu_culling.hpp"
+#include "frame_resource_pool.hpp"
+#include "render_graph.hpp"
+#include "gpu_profiler.hpp"
+#include "benchmark_recorder.hpp"
+#include "mesh_optimizer.hpp"
+#include "vertex_packing.hpp"
+#include "gbuffer_layout.hpp"
+#include "texture_baker.hpp"
+#include "texture_streamer.hpp"
+#include "frame_target.hpp"
 #include <Windows.h>
 
+#include <cctype>
 #include <random>
 
 #include "auto_vk_toolkit.hpp"
@@ -26,6 +42,11 @@ namespace g_ssao {
 	constexpr size_t noiseSize = 16;
 }
 
+namespace g_scene_cache {
+	// Increment whenever the layout of the data stored in the scene cache file changes:
+	constexpr uint32_t formatVersion = 3;
+}
+
 
 struct startOptions
 {
@@ -33,6 +54,21 @@ struct startOptions
 	int width;
 	int height;
 	std::string sceneFile;
+	std::string gpuTimingsCsvFile;
+	// Reorder the scene's triangles and vertices for the vertex cache, overdraw, and vertex fetch after loading:
+	int optimizeMeshes;
+	// Layout of the vertex data in the G-buffer pass:
+	vertex_format vertexFormat;
+	// Bake the scene's textures into block-compressed KTX files with mip chains (see avk::texture_baker) before loading them:
+	int bakeTextures;
+	// Stream the textures' mip levels as the renderer needs them (see texture_streamer), within a memory budget:
+	int streamTextures;
+	uint32_t textureBudgetMiB;
+	// Layout of the G-buffer which the SSAO and illumination passes read:
+	gbuffer_format gbufferFormat;
+	// Benchmark mode (see parse_command_line), disabled if zero:
+	uint32_t benchmarkFrames = 0;
+	std::string benchmarkReportFile = "benchmark_report.json";
 };
 static startOptions mStartOptions;
 
@@ -53,17 +89,39 @@ class model_loader_app : public avk::invokee
 		avk::buffer mIndexBuffer;
 
 		int mMaterialIndex;
+
+		// Bounding box which the positions are quantized relative to, if the vertex format is vertex_format::interleaved_quantized:
+		position_quantization mQuantization{ glm::vec3{ 0.0f }, glm::vec3{ 1.0f } };
+
+		// Range of this draw call within the shared scene buffers:
+		uint32_t mFirstIndex = 0;
+		uint32_t mIndexCount = 0;
+		uint32_t mVertexOffset = 0;
+		uint32_t mVertexCount = 0;
 	};
 
+	// Scene-wide transformation, set once per frame via push constants:
 	struct transformation_matrices {
 		glm::mat4 mModelMatrix;
+	};
+
+	// Per-draw data, stored in an SSBO and indexed by gl_InstanceIndex (=firstInstance) in the vertex shader:
+	struct per_draw_data {
+		glm::mat4 mModelMatrix;
 		int mMaterialIndex;
+		int mPadding[3]; // std430 aligns the following vec4 to 16 bytes
+		// Dequantization of the positions (offset + position * scale) if the vertex format is vertex_format::interleaved_quantized:
+		glm::vec4 mPositionOffset;
+		glm::vec4 mPositionScale;
 	};
 
 	//for SSAO/GBuffer
 	struct vp_matrices {
 		glm::mat4 mViewMatrix;
 		glm::mat4 mProjectionMatrix;
+		// For reconstructing positions from depth and world-space normals with the compact G-buffer:
+		glm::mat4 mInverseProjectionMatrix;
+		glm::mat4 mInverseViewMatrix;
 	};
 
 	//for skybox
@@ -127,9 +185,10 @@ class model_loader_app : public avk::invokee
 
 	
 public: // v== avk::invokee overrides which will be invoked by the framework ==v
-	model_loader_app(avk::queue& aQueue)
+	model_loader_app(avk::queue& aQueue, avk::queue& aTransferQueue)
 		: mQueue{ &aQueue }
 		, mScale{1.0f, 1.0f, 1.0f}
+		, mTransferQueue{ &aTransferQueue }
 	{}
 
 	void init_ui()
@@ -169,7 +228,8 @@ public: // v== avk::invokee overrides which will be invoked by the framework ==v
 			true, // <-- load in sRGB if applicable
 			false // <-- flip along the y-axis
 		);
-		avk::context().record_and_submit_with_fence({ std::move(loadImageCommand) }, *mQueue)->wait_until_signalled();
+		// The cube map is not uploaded through mUploader, which only handles images with one layer => recorded into the first frame:
+		mPendingUploadCommands.push_back(std::move(loadImageCommand));
 		auto cubemapSampler = avk::context().create_sampler(avk::filter_mode::trilinear, avk::border_handling_mode::clamp_to_edge, static_cast<float>(cubemapImage->create_info().mipLevels));
 		auto cubemapImageView = avk::context().create_image_view(cubemapImage, {}, avk::image_usage::general_cube_map_texture);
 		mImageSamplerCubemap = avk::context().create_image_sampler(cubemapImageView, cubemapSampler);
@@ -190,122 +250,301 @@ public: // v== avk::invokee overrides which will be invoked by the framework ==v
 		auto modelMeshSelection = avk::make_model_references_and_mesh_indices_selection(cube, indices);
 
 		auto [mPositionsBuffer, mIndexBuffer, geometryCommands] = avk::create_vertex_and_index_buffers({ modelMeshSelection });
-		avk::context().record_and_submit_with_fence({ std::move(geometryCommands) }, *mQueue)->wait_until_signalled();
+		mPendingUploadCommands.push_back(std::move(geometryCommands));
 
 		newElement.mPositionsBuffer = std::move(mPositionsBuffer);
 		newElement.mIndexBuffer = std::move(mIndexBuffer);
 		
-		//Create Buffer for skybox
-		mViewProjBufferSkybox = avk::context().create_buffer(
-			avk::memory_usage::host_coherent, {},
-			avk::uniform_buffer_meta::create_from_data(view_projection_matrices())
-		);
+		//Create Buffers for skybox (one for each frame in flight)
+		for (auto& buffer : mViewProjBuffersSkybox) {
+			buffer = avk::context().create_buffer(
+				avk::memory_usage::host_coherent, {},
+				avk::uniform_buffer_meta::create_from_data(view_projection_matrices())
+			);
+		}
+	}
+
+	/**	Invokes aDraw with the scene's vertex buffers in the order of the vertex shader's input bindings, which depends on the vertex format.
+	 *	@param	aDraw		Function which records a draw command with the given vertex buffers
+	 */
+	template <typename F>
+	avk::command::action_type_command with_scene_vertex_buffers(F aDraw) const
+	{
+		if (vertex_format::interleaved_quantized == mStartOptions.vertexFormat) {
+			return aDraw(mScenePackedVerticesBuffer.as_reference());
+		}
+		return aDraw(mScenePositionsBuffer.as_reference(), mSceneTexCoordsBuffer.as_reference(), mSceneNormalsBuffer.as_reference());
+	}
+
+	// The materials' textures, which the texture streamer replaces whenever their resident levels change:
+	const std::vector<avk::image_sampler>& material_image_samplers() const
+	{
+		return mTextureStreamer.has_value() ? mTextureStreamer->image_samplers() : mImageSamplers;
+	}
+
+	const avk::buffer& mip_feedback_buffer() const
+	{
+		return mTextureStreamer.has_value() ? mTextureStreamer->feedback_buffer() : mMipFeedbackBuffer;
+	}
+
+	// The G-buffer samplers which the SSAO and illumination passes bind. The compact layout has no position attachments, and its
+	// shaders do not read these bindings; the depth and normal attachments are bound instead to keep the descriptor set layouts:
+	const avk::image_sampler& gbuffer_position_sampler() const
+	{
+		return gbuffer_format::compact == mStartOptions.gbufferFormat ? mImageSamplerRasterFBDepth : mImageSamplerRasterFBPosition;
+	}
+
+	const avk::image_sampler& gbuffer_position_ws_sampler() const
+	{
+		return gbuffer_format::compact == mStartOptions.gbufferFormat ? mImageSamplerRasterFBDepth : mImageSamplerRasterFBPositionWS;
+	}
+
+	const avk::image_sampler& gbuffer_normals_ws_sampler() const
+	{
+		return gbuffer_format::compact == mStartOptions.gbufferFormat ? mImageSamplerRasterFBNormals : mImageSamplerRasterFBNormalsWS;
+	}
+
+	/**	Reorders the triangles of a draw call for the post-transform vertex cache and for less overdraw, and afterwards its
+	 *	vertices for the vertex fetch. The submeshes of a material have been concatenated in arbitrary order before, so that
+	 *	this is done per draw call rather than per submesh. Logs the simulated vertex cache statistics before and after.
+	 *	@param	aDrawCall		Draw call whose indices and vertex attributes are reordered in place
+	 *	@param	aName			Name of the draw call's material, used for the log
+	 */
+	static void optimize_draw_call_geometry(data_for_draw_call& aDrawCall, const std::string& aName)
+	{
+		const auto numVertices = aDrawCall.mPositions.size();
+		const auto before = avk::analyze_vertex_cache(aDrawCall.mIndices, numVertices);
+
+		aDrawCall.mIndices = avk::optimize_vertex_cache(aDrawCall.mIndices, numVertices);
+		aDrawCall.mIndices = avk::optimize_overdraw(aDrawCall.mIndices, aDrawCall.mPositions);
+		const auto newToOld = avk::optimize_vertex_fetch(aDrawCall.mIndices, numVertices);
+		aDrawCall.mPositions = avk::remap_vertices(aDrawCall.mPositions, newToOld);
+		aDrawCall.mTexCoords = avk::remap_vertices(aDrawCall.mTexCoords, newToOld);
+		aDrawCall.mNormals = avk::remap_vertices(aDrawCall.mNormals, newToOld);
+
+		const auto after = avk::analyze_vertex_cache(aDrawCall.mIndices, newToOld.size());
+		LOG_INFO(std::format("Material '{}': {} triangles, ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}, {} -> {} vertices",
+			aName, aDrawCall.mIndices.size() / 3, before.mAcmr, after.mAcmr, before.mAtvr, after.mAtvr, numVertices, newToOld.size()));
 	}
 
-	void init_scene()
+	void init_scene(avk::pipeline_compiler& aPipelineCompiler)
 	{
-		// Load a model from file:
-		auto sponza = avk::model_t::load_from_file("assets/" + mStartOptions.sceneFile, aiProcess_Triangulate | aiProcess_PreTransformVertices);
-		// Get all the different materials of the model:
-		auto distinctMaterials = sponza->distinct_material_configs();
-
-		// The following might be a bit tedious still, but maybe it's not. For what it's worth, it is expressive.
-		// The following loop gathers all the vertex and index data PER MATERIAL and constructs the buffers and materials.
-		// Later, we'll use ONE draw call PER MATERIAL to draw the whole scene.
+		// The per-material geometry and the material configs are stored in a binary cache file next to the scene file.
+		// On a warm start, the data is read from the cache directly into staging buffers and Assimp is not involved at all.
+		// The cache is recreated automatically whenever the contents of the scene file change.
+		// Every combination of mesh optimization and vertex format is cached in a different file, s.t. toggling the options takes effect immediately.
+		const std::string sceneFile = "assets/" + mStartOptions.sceneFile;
+		const std::string cacheFile = sceneFile
+			+ (mStartOptions.optimizeMeshes ? ".optimized" : "")
+			+ (vertex_format::interleaved_quantized == mStartOptions.vertexFormat ? ".packed" : "")
+			+ ".cache";
+		auto serializer = avk::create_serializer_for_source_file(cacheFile, sceneFile, g_scene_cache::formatVersion);
+
 		std::vector<avk::material_config> allMatConfigs;
-		for (const auto& pair : distinctMaterials) {
-			auto& newElement = mDrawCalls.emplace_back();
-			allMatConfigs.push_back(pair.first);
-			newElement.mMaterialIndex = static_cast<int>(allMatConfigs.size() - 1);
-
-			// 1. Gather all the vertex and index data from the sub meshes:
-			for (auto index : pair.second) {
-				avk::append_indices_and_vertex_data(
-					avk::additional_index_data(	newElement.mIndices,	[&]() { return sponza->indices_for_mesh<uint32_t>(index);					} ),
-					avk::additional_vertex_data(newElement.mPositions,	[&]() { return sponza->positions_for_mesh(index);							} ),
-					avk::additional_vertex_data(newElement.mTexCoords,	[&]() { return sponza->texture_coordinates_for_mesh<glm::vec2>(index, 0);	} ),
-					avk::additional_vertex_data(newElement.mNormals,	[&]() { return sponza->normals_for_mesh(index);								} )
-				);
+		if (serializer.mode() == avk::serializer::mode::serialize) {
+			// Load a model from file:
+			auto sponza = avk::model_t::load_from_file(sceneFile, aiProcess_Triangulate | aiProcess_PreTransformVertices);
+			// Get all the different materials of the model:
+			auto distinctMaterials = sponza->distinct_material_configs();
+			// Calculate the tangent spaces of all meshes on all cores, if any of the materials is bump mapped:
+			if (std::ranges::any_of(distinctMaterials, [](const auto& pair) { return !pair.first.mNormalsTex.empty() || !pair.first.mHeightTex.empty(); })) {
+				avk::work_stealing_pool pool;
+				sponza->calculate_tangent_space_for_all_meshes(pool);
 			}
 
-			// 2. Build all the buffers for the GPU
-			// 2.1 Positions:
-			newElement.mPositionsBuffer = avk::context().create_buffer(
-				avk::memory_usage::device, {},
-				avk::vertex_buffer_meta::create_from_data(newElement.mPositions)
-			);
-			auto posFillCmd = newElement.mPositionsBuffer->fill(newElement.mPositions.data(), 0);
+			// The following might be a bit tedious still, but maybe it's not. For what it's worth, it is expressive.
+			// The following loop gathers all the vertex and index data PER MATERIAL and constructs the buffers and materials.
+			// Later, we'll use ONE draw call PER MATERIAL to draw the whole scene.
+			for (const auto& pair : distinctMaterials) {
+				auto& newElement = mDrawCalls.emplace_back();
+				allMatConfigs.push_back(pair.first);
+				newElement.mMaterialIndex = static_cast<int>(allMatConfigs.size() - 1);
+
+				// Gather all the vertex and index data from the sub meshes:
+				for (auto index : pair.second) {
+					avk::append_indices_and_vertex_data(
+						avk::additional_index_data(	newElement.mIndices,	[&]() { return sponza->indices_for_mesh<uint32_t>(index);					} ),
+						avk::additional_vertex_data(newElement.mPositions,	[&]() { return sponza->positions_for_mesh(index);							} ),
+						avk::additional_vertex_data(newElement.mTexCoords,	[&]() { return sponza->texture_coordinates_for_mesh<glm::vec2>(index, 0);	} ),
+						avk::additional_vertex_data(newElement.mNormals,	[&]() { return sponza->normals_for_mesh(index);								} )
+					);
+				}
+				if (mStartOptions.optimizeMeshes) {
+					optimize_draw_call_geometry(newElement, pair.first.mName);
+				}
+			}
+		}
 
-			// 2.2 Texture Coordinates:
-			newElement.mTexCoordsBuffer = avk::context().create_buffer(
-				avk::memory_usage::device, {},
-				avk::vertex_buffer_meta::create_from_data(newElement.mTexCoords)
-			);
-			auto tcoFillCmd = newElement.mTexCoordsBuffer->fill(newElement.mTexCoords.data(), 0);
+		// Store the material configs and the number of draw calls to, or restore them from the cache:
+		serializer.archive(allMatConfigs);
+		size_t numDrawCalls = mDrawCalls.size();
+		serializer.archive(numDrawCalls);
+		mDrawCalls.resize(numDrawCalls);
+
+		// All draw calls share the same few big buffers. Each draw call only remembers its range within them:
+		uint32_t totalVertices = 0;
+		uint32_t totalIndices = 0;
+		for (auto& drawCall : mDrawCalls) {
+			auto numVertices = static_cast<uint32_t>(drawCall.mPositions.size());
+			auto numIndices = static_cast<uint32_t>(drawCall.mIndices.size());
+			serializer.archive(drawCall.mMaterialIndex);
+			serializer.archive(numVertices);
+			serializer.archive(numIndices);
+			if (vertex_format::interleaved_quantized == mStartOptions.vertexFormat) {
+				if (serializer.mode() == avk::serializer::mode::serialize) {
+					drawCall.mQuantization = position_quantization::from_positions(drawCall.mPositions);
+				}
+				serializer.archive_memory(&drawCall.mQuantization, sizeof(position_quantization));
+			}
 
-			// 2.3 Normals:
-			newElement.mNormalsBuffer = avk::context().create_buffer(
-				avk::memory_usage::device, {},
-				avk::vertex_buffer_meta::create_from_data(newElement.mNormals)
-			);
-			auto nrmFillCmd = newElement.mNormalsBuffer->fill(newElement.mNormals.data(), 0);
+			drawCall.mVertexOffset = totalVertices;
+			drawCall.mFirstIndex = totalIndices;
+			drawCall.mIndexCount = numIndices;
+			drawCall.mVertexCount = numVertices;
+			totalVertices += numVertices;
+			totalIndices += numIndices;
+		}
 
-			// 2.4 Indices:
-			newElement.mIndexBuffer = avk::context().create_buffer(
-				avk::memory_usage::device, {},
-				avk::index_buffer_meta::create_from_data(newElement.mIndices)
+		// Split all draw calls into small clusters for GPU culling. Their bounding boxes are cached as well:
+		std::vector<cluster_gpu_data> clusters;
+		if (serializer.mode() == avk::serializer::mode::serialize) {
+			for (uint32_t i = 0; i < static_cast<uint32_t>(mDrawCalls.size()); ++i) {
+				const auto& drawCall = mDrawCalls[i];
+				append_clusters(clusters, drawCall.mPositions, drawCall.mIndices, drawCall.mFirstIndex, static_cast<int32_t>(drawCall.mVertexOffset), i);
+			}
+		}
+		size_t numClusters = clusters.size();
+		serializer.archive(numClusters);
+		clusters.resize(numClusters);
+		serializer.archive_memory(clusters.data(), sizeof(cluster_gpu_data) * numClusters);
+
+		if (vertex_format::interleaved_quantized == mStartOptions.vertexFormat) {
+			mScenePackedVerticesBuffer = avk::context().create_buffer(avk::memory_usage::device, {},
+				avk::vertex_buffer_meta::create_from_total_size(sizeof(packed_vertex) * totalVertices, totalVertices)
+					.describe_member(offsetof(packed_vertex, mPosition), vk::Format::eR16G16B16A16Unorm, avk::content_description::position)
+					.describe_member(offsetof(packed_vertex, mTexCoord), vk::Format::eR16G16Sfloat, avk::content_description::texture_coordinate)
+					.describe_member(offsetof(packed_vertex, mNormal), vk::Format::eR16G16Snorm, avk::content_description::normal)
 			);
-			auto idxFillCmd = newElement.mIndexBuffer->fill(newElement.mIndices.data(), 0);
-
-			// Submit all the fill commands to the queue:
-			auto fence = avk::context().record_and_submit_with_fence({
-				std::move(posFillCmd),
-				std::move(tcoFillCmd),
-				std::move(nrmFillCmd),
-				std::move(idxFillCmd)
-				// ^ No need for any synchronization in-between, because the commands do not depend on each other.
-			}, *mQueue);
-			// Wait on the host until the device is done:
-			fence->wait_until_signalled();
 		}
+		else {
+			mScenePositionsBuffer = avk::context().create_buffer(avk::memory_usage::device, {},
+				avk::vertex_buffer_meta::create_from_total_size(sizeof(glm::vec3) * totalVertices, totalVertices).describe_member(0, avk::format_for<glm::vec3>(), avk::content_description::position)
+			);
+			mSceneTexCoordsBuffer = avk::context().create_buffer(avk::memory_usage::device, {},
+				avk::vertex_buffer_meta::create_from_total_size(sizeof(glm::vec2) * totalVertices, totalVertices).describe_member(0, avk::format_for<glm::vec2>(), avk::content_description::texture_coordinate)
+			);
+			mSceneNormalsBuffer = avk::context().create_buffer(avk::memory_usage::device, {},
+				avk::vertex_buffer_meta::create_from_total_size(sizeof(glm::vec3) * totalVertices, totalVertices).describe_member(0, avk::format_for<glm::vec3>(), avk::content_description::normal)
+			);
+		}
+		mSceneIndexBuffer = avk::context().create_buffer(avk::memory_usage::device, {},
+			avk::index_buffer_meta::create_from_total_size(sizeof(uint32_t) * totalIndices, totalIndices).describe_member(0, avk::format_for<uint32_t>(), avk::content_description::index)
+		);
+
+		// Copy all the geometry through one persistent staging ring and submit it in ONE submission for the whole scene.
+		// When reading from the cache, the data is streamed from file directly into the staging memory:
+		auto& batcher = mUploader.value();
+		auto stage = [&](const avk::buffer_t& aDstBuffer, size_t aDstOffset, auto& aData, size_t aSize) {
+			if (serializer.mode() == avk::serializer::mode::serialize) {
+				serializer.archive_memory(aData.data(), aSize);
+				batcher.stage(aDstBuffer, aDstOffset, aData.data(), aSize);
+			}
+			else {
+				batcher.stage(aDstBuffer, aDstOffset, aSize, [&serializer](void* aStagingMemory, size_t aChunkSize) {
+					serializer.archive_memory(aStagingMemory, aChunkSize);
+				});
+			}
+		};
+
+		// Per-draw data and the draw parameters for rendering the whole scene with one indirect draw call:
+		std::vector<per_draw_data> perDrawData;
+		std::vector<vk::DrawIndexedIndirectCommand> drawCommands;
+		for (uint32_t i = 0; i < static_cast<uint32_t>(mDrawCalls.size()); ++i) {
+			const auto& drawCall = mDrawCalls[i];
+			perDrawData.push_back(per_draw_data{ glm::mat4{ 1.0f }, drawCall.mMaterialIndex, {}, glm::vec4{ drawCall.mQuantization.mOffset, 0.0f }, glm::vec4{ drawCall.mQuantization.mScale, 1.0f } });
+			drawCommands.push_back(vk::DrawIndexedIndirectCommand{ drawCall.mIndexCount, 1u, drawCall.mFirstIndex, static_cast<int32_t>(drawCall.mVertexOffset), i });
+		}
+		mPerDrawDataBuffer = avk::context().create_buffer(avk::memory_usage::device, {},
+			avk::storage_buffer_meta::create_from_data(perDrawData)
+		);
+		mDrawCommandsBuffer = avk::context().create_buffer(avk::memory_usage::device, {},
+			avk::indirect_buffer_meta::create_from_num_elements_for_draw_indexed_indirect(drawCommands.size())
+		);
+		batcher.stage(mPerDrawDataBuffer.as_reference(), 0, perDrawData.data(), sizeof(per_draw_data) * perDrawData.size());
+		batcher.stage(mDrawCommandsBuffer.as_reference(), 0, drawCommands.data(), sizeof(vk::DrawIndexedIndirectCommand) * drawCommands.size());
+		mGpuCulling = std::make_unique<gpu_culling>(batcher, clusters, mPerDrawDataBuffer, mTarget->resolution(), mViewProjBuffers.size(), aPipelineCompiler);
+
+		for (auto& drawCall : mDrawCalls) {
+			if (vertex_format::interleaved_quantized == mStartOptions.vertexFormat) {
+				std::vector<packed_vertex> packedVertices;
+				if (serializer.mode() == avk::serializer::mode::serialize) {
+					packedVertices = vertex_packing::pack(drawCall.mPositions, drawCall.mTexCoords, drawCall.mNormals, drawCall.mQuantization);
+				}
+				stage(mScenePackedVerticesBuffer.as_reference(), sizeof(packed_vertex) * drawCall.mVertexOffset, packedVertices, sizeof(packed_vertex) * drawCall.mVertexCount);
+			}
+			else {
+				stage(mScenePositionsBuffer.as_reference(), sizeof(glm::vec3) * drawCall.mVertexOffset, drawCall.mPositions, sizeof(glm::vec3) * drawCall.mVertexCount);
+				stage(mSceneTexCoordsBuffer.as_reference(), sizeof(glm::vec2) * drawCall.mVertexOffset, drawCall.mTexCoords, sizeof(glm::vec2) * drawCall.mVertexCount);
+				stage(mSceneNormalsBuffer.as_reference(),   sizeof(glm::vec3) * drawCall.mVertexOffset, drawCall.mNormals,   sizeof(glm::vec3) * drawCall.mVertexCount);
+			}
+			stage(mSceneIndexBuffer.as_reference(),     sizeof(uint32_t)  * drawCall.mFirstIndex,   drawCall.mIndices,   sizeof(uint32_t)  * drawCall.mIndexCount);
+		}
+		// Not waited for: The transfer queue copies the geometry while the materials are loaded, and the first frame waits for it:
+		mSceneUploadTicket = batcher.submit();
+		serializer.flush();
+		LOG_INFO(std::format("Uploaded {} bytes of scene geometry for {} draw calls in {} submission(s)", batcher.bytes_uploaded(), mDrawCalls.size(), batcher.num_submissions()));
+		LOG_INFO(std::format("Vertex data: {} vertices with {} bytes each", totalVertices, vertex_packing::bytes_per_vertex(mStartOptions.vertexFormat)));
 
 		// For all the different materials, transfer them in structs which are well
 		// suited for GPU-usage (proper alignment, and containing only the relevant data),
 		// also load all the referenced images from file and provide access to them
-		// via samplers; It all happens in `ak::convert_for_gpu_usage`:
-		auto [gpuMaterials, imageSamplers, materialCommands] = avk::convert_for_gpu_usage<avk::material_gpu_data>(
-			allMatConfigs, false, true,
-			avk::image_usage::general_texture,
-			avk::filter_mode::trilinear
-		);
-
-		mImageSamplers = std::move(imageSamplers);
+		// via samplers; It all happens in `ak::convert_for_gpu_usage`.
+		// Baked textures are flipped already, and come with all of their mip levels:
+		// Streamed textures must have been baked, because only the levels of a full mip chain can be streamed:
+		if (mStartOptions.bakeTextures || mStartOptions.streamTextures) {
+			avk::texture_baker baker("texture_cache");
+			baker.bake_material_textures(allMatConfigs, false, true);
+			const auto& s = baker.stats();
+			LOG_INFO(std::format("Textures: {} baked, {} from '{}', {:.1f} MiB uncompressed -> {:.1f} MiB ({:.1f}x smaller), baked in {:.2f} s",
+				s.mNumBaked, s.mNumFromCache, baker.cache_directory(), s.mUncompressedBytes / (1024.0 * 1024.0), s.mBakedBytes / (1024.0 * 1024.0),
+				static_cast<double>(s.mUncompressedBytes) / std::max<size_t>(s.mBakedBytes, 1), s.mBakeSeconds));
+		}
+		std::vector<avk::material_gpu_data> gpuMaterials;
+		avk::command::action_type_command materialCommands;
+		if (mStartOptions.streamTextures) {
+			// Only the mip tails are loaded now, all finer levels are streamed in as the renderer needs them:
+			mTextureStreamer.emplace(mUploader.value(), static_cast<size_t>(mStartOptions.textureBudgetMiB) * 1024 * 1024);
+			// Replaced views must not leave their descriptor sets behind, where a reused handle could find them:
+			mTextureStreamer->set_image_view_retired_handler([this](vk::ImageView aView) {
+				mDescriptorCache->remove_sets_with_handle(aView);
+			});
+			std::tie(gpuMaterials, materialCommands) = mTextureStreamer->convert_for_gpu_usage<avk::material_gpu_data>(allMatConfigs, avk::filter_mode::trilinear);
+		}
+		else {
+			std::vector<avk::image_sampler> imageSamplers;
+			std::tie(gpuMaterials, imageSamplers, materialCommands) = avk::convert_for_gpu_usage<avk::material_gpu_data>(
+				allMatConfigs, false, !mStartOptions.bakeTextures,
+				avk::image_usage::general_texture,
+				avk::filter_mode::trilinear
+			);
+			mImageSamplers = std::move(imageSamplers);
+			// The shaders write their mip feedback regardless, one uint per image sampler:
+			mMipFeedbackBuffer = avk::context().create_buffer(avk::memory_usage::device, {},
+				avk::storage_buffer_meta::create_from_size(sizeof(uint32_t) * std::max<size_t>(mImageSamplers.size(), 1))
+			);
+		}
 
-		// A buffer to hold all the material data:
+		// A buffer to hold all the material data, which the transfer queue uploads after the scene geometry:
 		mMaterialBuffer = avk::context().create_buffer(
 			avk::memory_usage::device, {},
 			avk::storage_buffer_meta::create_from_data(gpuMaterials)
 		);
+		batcher.stage(mMaterialBuffer.as_reference(), 0, gpuMaterials.data(), sizeof(avk::material_gpu_data) * gpuMaterials.size());
+		// Not waited for either: Tickets increase with every submission, so the first frame's acquire covers the geometry, too:
+		mSceneUploadTicket = batcher.submit();
 
-		// Submit the commands material commands and the materials buffer fill to the device:
-		auto matFence = avk::context().record_and_submit_with_fence({
-			std::move(materialCommands),
-			mMaterialBuffer->fill(gpuMaterials.data(), 0)
-		}, *mQueue);
-		matFence->wait_until_signalled();
-
-		mViewProjBuffer = avk::context().create_buffer(
-			avk::memory_usage::host_coherent, {},
-			avk::uniform_buffer_meta::create_from_data(vp_matrices())
-		);
-
-		// Create a buffer for the transformation matrices in a host coherent memory region (one for each frame in flight):
-		for (int i = 0; i < 10; ++i) { // Up to 10 concurrent frames can be configured through the UI.
-			mViewProjBuffers[i] = avk::context().create_buffer(
-				avk::memory_usage::host_coherent, {},
-				avk::uniform_buffer_meta::create_from_data(glm::mat4())
-			);
-		}
+		// The textures' uploads include layout transitions for the graphics queue => recorded into the first frame:
+		mPendingUploadCommands.push_back(std::move(materialCommands));
 	}
 
 
@@ -357,24 +596,9 @@ public: // v== avk::invokee overrides which will be invoked by the framework ==v
 			4, 4, vk::Format::eR32G32B32A32Sfloat,
 			1, avk::memory_usage::device, avk::image_usage::general_color_attachment
 		);
-		auto noiseBuffer = avk::context().create_buffer(
-			avk::memory_usage::host_coherent, vk::BufferUsageFlagBits::eTransferSrc,
-			avk::generic_buffer_meta::create_from_data(noise)
-		);
-		avk::context().record_and_submit_with_fence(
-			{ noiseBuffer->fill(noise.data(), 0) },
-			*mQueue
-		)->wait_until_signalled();
-
-		avk::context().record_and_submit_with_fence({
-		avk::sync::image_memory_barrier(noiseImage.as_reference(), avk::stage::none >> avk::stage::copy,
-			avk::access::none >> avk::access::transfer_read | avk::access::transfer_write).with_layout_transition(
-				avk::layout::undefined >> avk::layout::transfer_dst),
-		avk::copy_buffer_to_image(noiseBuffer, noiseImage.as_reference(), avk::layout::transfer_dst),
-		avk::sync::image_memory_barrier(noiseImage.as_reference(), avk::stage::copy >> avk::stage::transfer,
-			avk::access::transfer_write >> avk::access::none).with_layout_transition(
-				avk::layout::transfer_dst >> avk::layout::shader_read_only_optimal)
-		}, *mQueue)->wait_until_signalled();
+		// Uploaded together with the scene, and handed over to the graphics queue in the first frame:
+		const auto* noiseBytes = reinterpret_cast<const uint8_t*>(noise.data());
+		mUploader->stage(*noiseImage, { std::vector<uint8_t>(noiseBytes, noiseBytes + sizeof(glm::vec4) * noise.size()) });
 
 		mSSAONoiseTexture = avk::context().create_image_sampler(
 			avk::context().create_image_view(
@@ -473,37 +697,89 @@ public: // v== avk::invokee overrides which will be invoked by the framework ==v
 
 	void initialize() override
 	{
-		init_ui();
+		if (nullptr != avk::context().main_window()) {
+			mTarget.emplace(avk::context().main_window());
+			init_ui();
+		}
+		else {
+			// Same back buffer formats and number of concurrent frames as the window in main():
+			mTarget.emplace(*mQueue, glm::uvec2{ mStartOptions.width, mStartOptions.height }, vk::Format::eB8G8R8A8Unorm, vk::Format::eD32Sfloat, 3);
+		}
 		
 		mInitTime = std::chrono::high_resolution_clock::now();
 
 		// Create a descriptor cache that helps us to conveniently create descriptor sets:
 		mDescriptorCache = avk::context().create_descriptor_cache();
+
+		// Command buffers for all the passes of one frame, recycled per in-flight index.
+		// The render graph needs one command buffer per submission, and synchronizes them with its timeline semaphore:
+		mFrameResources.emplace(*mQueue, 2u, 0u);
+		mRenderGraph.emplace(*mQueue);
+		// Measure every pass of the render graph:
+		mGpuProfiler.emplace(*mQueue, 16u);
+		if (!mStartOptions.gpuTimingsCsvFile.empty()) {
+			mGpuProfiler->open_csv(mStartOptions.gpuTimingsCsvFile);
+		}
+		mRenderGraph->set_profiler(&mGpuProfiler.value());
+		if (mStartOptions.benchmarkFrames > 0) {
+			mBenchmark.emplace(mStartOptions.benchmarkFrames);
+			mGpuProfiler->set_results_handler([this](avk::window::frame_id_t aFrameId, const std::vector<std::string>& aPassNames, const std::vector<float>& aDurations) {
+				if (mBenchmark.has_value()) {
+					mBenchmark->record_gpu_times(aFrameId, aPassNames, aDurations);
+				}
+			});
+		}
 		
+		// All scene geometry, the other static buffers, and streamed textures are uploaded through the transfer queue while the graphics queue renders:
+		mUploader.emplace(*mTransferQueue, *mQueue);
+		LOG_INFO(mUploader->uses_separate_queue()
+			? std::format("Uploading through queue #{} of family #{}", mTransferQueue->queue_index(), mTransferQueue->family_index())
+			: std::string("No separate transfer queue available, uploading through the graphics queue"));
+
+		// All pipelines are compiled concurrently. Those which do not depend on the scene are enqueued before it is loaded.
+		// Each of them is only waited for when the first frame records the pass which uses it, see resolve_pipeline:
+		mPipelinesBegin = std::chrono::steady_clock::now();
+		mPipelineCompiler = std::make_unique<avk::pipeline_compiler>();
+		auto& pipelineCompiler = *mPipelineCompiler;
+
 		init_skybox();
-		init_scene();
+
+		// Create buffers for the transformation matrices in a host coherent memory region (one for each frame in flight):
+		for (int i = 0; i < 10; ++i) { // Up to 10 concurrent frames can be configured through the UI.
+			mViewProjBuffers[i] = avk::context().create_buffer(
+				avk::memory_usage::host_coherent, {},
+				avk::uniform_buffer_meta::create_from_data(glm::mat4())
+			);
+			mVpMatricesBuffers[i] = avk::context().create_buffer(
+				avk::memory_usage::host_coherent, {},
+				avk::uniform_buffer_meta::create_from_data(vp_matrices())
+			);
+		}
 
 		//Create a Framebuffer for the screenspace effects (Main scene renders into this framebuffer, then this
-		const auto r = avk::context().main_window()->resolution();
+		const auto r = mTarget->resolution();
 
 		// mImageViewScreenspaceColor = avk::context().create_image_view(avk::context().create_image(r.x, r.y, vk::Format::eR8G8B8A8Unorm, 1, avk::memory_usage::device, avk::image_usage::general_color_attachment));
 		// mImageViewScreenspaceDepth =  avk::context().create_depth_image_view(avk::context().create_depth_image(r.x, r.y, vk::Format::eD32Sfloat, 1, avk::memory_usage::device, avk::image_usage::general_depth_stencil_attachment));
 
 		//framebuffer is used to render a quad with the screenspace effect).
-		auto colorAttachmentRaster = avk::context().create_image_view(avk::context().create_image(r.x, r.y, vk::Format::eR8G8B8A8Unorm, 1, avk::memory_usage::device, avk::image_usage::general_color_attachment));
+		const auto gBufferFormats = gbuffer_layout::color_formats(mStartOptions.gbufferFormat);
+		auto colorAttachmentRaster = avk::context().create_image_view(avk::context().create_image(r.x, r.y, gBufferFormats[0], 1, avk::memory_usage::device, avk::image_usage::general_color_attachment));
 		auto colorAttachmentDescriptionRaster = avk::attachment::declare_for(colorAttachmentRaster.as_reference(), avk::on_load::load.from_previous_layout(avk::layout::color_attachment_optimal), avk::usage::color(0), avk::on_store::store);
-		auto depthAttachmentRaster = avk::context().create_depth_image_view(avk::context().create_depth_image(r.x, r.y, vk::Format::eD32Sfloat, 1, avk::memory_usage::device, avk::image_usage::general_depth_stencil_attachment));
+		auto depthAttachmentRaster = avk::context().create_depth_image_view(avk::context().create_depth_image(r.x, r.y, gbuffer_layout::cDepthFormat, 1, avk::memory_usage::device, avk::image_usage::general_depth_stencil_attachment));
 		auto depthAttachmentDescription = avk::attachment::declare_for(depthAttachmentRaster.as_reference(), avk::on_load::clear.from_previous_layout(avk::layout::depth_stencil_attachment_optimal), avk::usage::depth_stencil, avk::on_store::store);
 
-		//For G-Buffer we also need some more data
-		auto positionAttachmentRaster = avk::context().create_image_view(avk::context().create_image(r.x, r.y, vk::Format::eR32G32B32A32Sfloat, 1, avk::memory_usage::device, avk::image_usage::general_color_attachment));
-		auto positionAttachmentDescription = avk::attachment::declare_for(positionAttachmentRaster.as_reference(), avk::on_load::clear.from_previous_layout(avk::layout::color_attachment_optimal), avk::usage::color(1), avk::on_store::store);
-		auto normalsAttachmentRaster = avk::context().create_image_view(avk::context().create_image(r.x, r.y, vk::Format::eR32G32B32A32Sfloat, 1, avk::memory_usage::device, avk::image_usage::general_color_attachment));
-		auto normalsAttachmentDescription = avk::attachment::declare_for(normalsAttachmentRaster.as_reference(), avk::on_load::clear.from_previous_layout(avk::layout::color_attachment_optimal), avk::usage::color(2), avk::on_store::store);
-		auto positionWSAttachmentRaster = avk::context().create_image_view(avk::context().create_image(r.x, r.y, vk::Format::eR32G32B32A32Sfloat, 1, avk::memory_usage::device, avk::image_usage::general_color_attachment));
-		auto positionWSAttachmentDescription = avk::attachment::declare_for(positionWSAttachmentRaster.as_reference(), avk::on_load::clear.from_previous_layout(avk::layout::color_attachment_optimal), avk::usage::color(3), avk::on_store::store);
-		auto normalsWSAttachmentRaster = avk::context().create_image_view(avk::context().create_image(r.x, r.y, vk::Format::eR32G32B32A32Sfloat, 1, avk::memory_usage::device, avk::image_usage::general_color_attachment));
-		auto normalsWSAttachmentDescription = avk::attachment::declare_for(normalsAttachmentRaster.as_reference(), avk::on_load::clear.from_previous_layout(avk::layout::color_attachment_optimal), avk::usage::color(4), avk::on_store::store);
+		//For G-Buffer we also need some more data: positions and normals in view space and world space, or only the
+		//view-space normal in the compact layout (see gbuffer_layout.hpp). Their attachments follow the color attachment:
+		std::vector<avk::image_view> gBufferAttachmentsRaster;
+		std::vector<avk::attachment> gBufferAttachmentDescriptions{ colorAttachmentDescriptionRaster };
+		for (uint32_t location = 1; location < static_cast<uint32_t>(gBufferFormats.size()); ++location) {
+			gBufferAttachmentsRaster.push_back(avk::context().create_image_view(avk::context().create_image(r.x, r.y, gBufferFormats[location], 1, avk::memory_usage::device, avk::image_usage::general_color_attachment)));
+			gBufferAttachmentDescriptions.push_back(avk::attachment::declare_for(gBufferAttachmentsRaster.back().as_reference(), avk::on_load::clear.from_previous_layout(avk::layout::color_attachment_optimal), avk::usage::color(location), avk::on_store::store));
+		}
+		gBufferAttachmentDescriptions.push_back(depthAttachmentDescription);
+		LOG_INFO(std::format("G-buffer: {} bytes per pixel, {:.1f} MiB at {}x{}", gbuffer_layout::bytes_per_pixel(mStartOptions.gbufferFormat),
+			static_cast<double>(gbuffer_layout::bytes_per_pixel(mStartOptions.gbufferFormat)) * r.x * r.y / (1024.0 * 1024.0), r.x, r.y));
 
 
 		//SSAO
@@ -531,18 +807,24 @@ public: // v== avk::invokee overrides which will be invoked by the framework ==v
 		
 
 
-		mRasterizerFramebuffer = avk::context().create_framebuffer(
-			{ colorAttachmentDescriptionRaster, positionAttachmentDescription, normalsAttachmentDescription, positionWSAttachmentDescription, normalsWSAttachmentDescription, depthAttachmentDescription }, // Attachment declarations can just be copied => use initializer_list.
-			avk::make_vector( colorAttachmentRaster, positionAttachmentRaster, normalsAttachmentRaster, positionWSAttachmentRaster, normalsWSAttachmentRaster, depthAttachmentRaster )
-		);
+		// Color, the further G-buffer attachments in the order of their locations, and depth:
+		gBufferAttachmentsRaster.insert(gBufferAttachmentsRaster.begin(), std::move(colorAttachmentRaster));
+		gBufferAttachmentsRaster.push_back(std::move(depthAttachmentRaster));
+		mRasterizerFramebuffer = avk::context().create_framebuffer(gBufferAttachmentDescriptions, std::move(gBufferAttachmentsRaster));
 		auto samplerLin = avk::context().create_sampler(avk::filter_mode::trilinear, avk::border_handling_mode::clamp_to_edge, 0);
 		auto samplerNea = avk::context().create_sampler(avk::filter_mode::nearest_neighbor, avk::border_handling_mode::clamp_to_edge, 0);
 		mImageSamplerRasterFBColor = avk::context().create_image_sampler(mRasterizerFramebuffer->image_view_at(0), samplerNea);
-		mImageSamplerRasterFBPosition = avk::context().create_image_sampler(mRasterizerFramebuffer->image_view_at(1), samplerNea);
-		mImageSamplerRasterFBNormals = avk::context().create_image_sampler(mRasterizerFramebuffer->image_view_at(2), samplerNea);
-		mImageSamplerRasterFBPositionWS = avk::context().create_image_sampler(mRasterizerFramebuffer->image_view_at(3), samplerNea);
-		mImageSamplerRasterFBNormalsWS = avk::context().create_image_sampler(mRasterizerFramebuffer->image_view_at(4), samplerNea);
-		mImageSamplerRasterFBDepth = avk::context().create_image_sampler(mRasterizerFramebuffer->image_view_at(5), samplerNea);
+		if (gbuffer_format::compact == mStartOptions.gbufferFormat) {
+			mImageSamplerRasterFBNormals = avk::context().create_image_sampler(mRasterizerFramebuffer->image_view_at(1), samplerNea);
+			mImageSamplerRasterFBDepth = avk::context().create_image_sampler(mRasterizerFramebuffer->image_view_at(2), samplerNea);
+		}
+		else {
+			mImageSamplerRasterFBPosition = avk::context().create_image_sampler(mRasterizerFramebuffer->image_view_at(1), samplerNea);
+			mImageSamplerRasterFBNormals = avk::context().create_image_sampler(mRasterizerFramebuffer->image_view_at(2), samplerNea);
+			mImageSamplerRasterFBPositionWS = avk::context().create_image_sampler(mRasterizerFramebuffer->image_view_at(3), samplerNea);
+			mImageSamplerRasterFBNormalsWS = avk::context().create_image_sampler(mRasterizerFramebuffer->image_view_at(4), samplerNea);
+			mImageSamplerRasterFBDepth = avk::context().create_image_sampler(mRasterizerFramebuffer->image_view_at(5), samplerNea);
+		}
 
 		mSSAOFramebuffer = avk::context().create_framebuffer(
 			{ colorAttachmentDescriptionSSAO }, 
@@ -587,21 +869,23 @@ public: // v== avk::invokee overrides which will be invoked by the framework ==v
 		mImageSamplerDofFarColor = avk::context().create_image_sampler(mDofFarFieldFB->image_view_at(0), samplerLin);
 		
 		
-		//Create Buffer and Data for Screenspace effects
-		mDoFBuffer = avk::context().create_buffer(
-			avk::memory_usage::host_coherent, {},
-			avk::uniform_buffer_meta::create_from_data(DoFData())
-		);
+		//Create Buffers and Data for Screenspace effects (one for each frame in flight, like the transformation matrices)
+		for (int i = 0; i < 10; ++i) {
+			mDoFBuffers[i] = avk::context().create_buffer(
+				avk::memory_usage::host_coherent, {},
+				avk::uniform_buffer_meta::create_from_data(DoFData())
+			);
 
-		mSSAOBuffer = avk::context().create_buffer(
-			avk::memory_usage::host_coherent, {},
-			avk::uniform_buffer_meta::create_from_data(SSAOData())
-		);
+			mSSAOBuffers[i] = avk::context().create_buffer(
+				avk::memory_usage::host_coherent, {},
+				avk::uniform_buffer_meta::create_from_data(SSAOData())
+			);
 
-		mCameraData = avk::context().create_buffer(
-			avk::memory_usage::host_coherent, {},
-			avk::uniform_buffer_meta::create_from_data(CameraData())
-		);
+			mCameraDataBuffers[i] = avk::context().create_buffer(
+				avk::memory_usage::host_coherent, {},
+				avk::uniform_buffer_meta::create_from_data(CameraData())
+			);
+		}
 
 		init_ssao_data();
 
@@ -625,55 +909,20 @@ public: // v== avk::invokee overrides which will be invoked by the framework ==v
 			avk::memory_usage::device, {},
 			avk::storage_buffer_meta::create_from_data(mDoFKernelBufferStruct.gaussianKernel)
 		);
-		// Submit the Vertex Buffer fill command to the device:
-		auto fence = avk::context().record_and_submit_with_fence({
-			mDoFKernelBufferGaussian->fill(mDoFKernelBufferStruct.gaussianKernel.data(), 0)
-		}, *mQueue);
-		// Wait on the host until the device is done:
-		fence->wait_until_signalled();
+		// Uploaded together with the scene, and handed over to the graphics queue in the first frame:
+		mUploader->stage(mDoFKernelBufferGaussian.as_reference(), 0, mDoFKernelBufferStruct.gaussianKernel.data(), sizeof(glm::vec4) * mDoFKernelBufferStruct.gaussianKernel.size());
 
 		mDoFKernelBufferBokeh = avk::context().create_buffer(
 			avk::memory_usage::device, {},
 			avk::storage_buffer_meta::create_from_data(mDoFKernelBufferStruct.bokehKernel)
 		);
-		// Submit the Vertex Buffer fill command to the device:
-		auto fence2 = avk::context().record_and_submit_with_fence({
-			mDoFKernelBufferBokeh->fill(mDoFKernelBufferStruct.bokehKernel.data(), 0)
-		}, *mQueue);
-		// Wait on the host until the device is done:
-		fence2->wait_until_signalled();
+		mUploader->stage(mDoFKernelBufferBokeh.as_reference(), 0, mDoFKernelBufferStruct.bokehKernel.data(), sizeof(glm::vec4) * mDoFKernelBufferStruct.bokehKernel.size());
 		
 		
-		//Create Vertex Buffer for Screenspace Quad
-		{
-			mVertexBufferScreenspace = avk::context().create_buffer(
-				avk::memory_usage::device, {},
-				// Create the buffer on the device, i.e. in GPU memory, (no additional usage flags).
-				// because the screenspace quad is static, we can use device memory
-				avk::vertex_buffer_meta::create_from_data(mScreenspaceQuadVertexData)
-			);
-			// Submit the Vertex Buffer fill command to the device:
-			auto fence3 = avk::context().record_and_submit_with_fence({
-				mVertexBufferScreenspace->fill(mScreenspaceQuadVertexData.data(), 0)
-			}, *mQueue);
-			// Wait on the host until the device is done:
-			fence3->wait_until_signalled();
-
-			mIndexBufferScreenspace = avk::context().create_buffer(
-				avk::memory_usage::device, {},
-				avk::index_buffer_meta::create_from_data(mScreenspaceQuadIndexData)
-			);
-			auto fence2 = avk::context().record_and_submit_with_fence({
-				mIndexBufferScreenspace->fill(mScreenspaceQuadIndexData.data(), 0)
-			}, *mQueue);
-			fence2->wait_until_signalled();
-			
-		}
-
-		mPipelineSkybox = avk::context().create_graphics_pipeline_for(
+		mPipelineSkyboxFuture = pipelineCompiler.create_graphics_pipeline_for(
 			// Specify which shaders the pipeline consists of:
 			avk::vertex_shader("shaders/skybox.vert"),
-			avk::fragment_shader("shaders/skybox.frag"),
+			avk::fragment_shader(gbuffer_layout::skybox_fragment_shader_path(mStartOptions.gbufferFormat)),
 			// The next line defines the format and location of the vertex shader inputs:
 			// (The dummy values (like glm::vec3) tell the pipeline the format of the respective input)
 			avk::from_buffer_binding(0)->stream_per_vertex<glm::vec3>()->to_location(0), // <-- corresponds to vertex shader's inPosition
@@ -682,64 +931,20 @@ public: // v== avk::invokee overrides which will be invoked by the framework ==v
 			avk::cfg::viewport_depth_scissors_config::from_framebuffer(mRasterizerFramebuffer.as_reference()),
 			// We'll render to the framebuffer, only color no depth needed cause skybox is always at infinity
 			// mColorAttachmentDescription,
-			avk::context().create_renderpass(
-			{
-				colorAttachmentDescriptionRaster,
-				positionAttachmentDescription,
-				normalsAttachmentDescription,
-				positionWSAttachmentDescription,
-				normalsWSAttachmentDescription,
-				depthAttachmentDescription
-			}),
+			avk::context().create_renderpass(gBufferAttachmentDescriptions),
 			
 			// The following define additional data which we'll pass to the pipeline:
-			avk::descriptor_binding(0, 0, mViewProjBufferSkybox),
+			avk::descriptor_binding(0, 0, mViewProjBuffersSkybox[0]),
 			avk::descriptor_binding(0, 1, mImageSamplerCubemap->as_combined_image_sampler(avk::layout::general))
 		);
-		
-		auto swapChainFormat = avk::context().main_window()->swap_chain_image_format();
-		// Create our rasterization graphics pipeline with the required configuration:
-		mRasterizePipeline = avk::context().create_graphics_pipeline_for(
-			// Specify which shaders the pipeline consists of:
-			avk::vertex_shader("shaders/raster.vert"),
-			avk::fragment_shader("shaders/raster.frag"),
-			// The next 3 lines define the format and location of the vertex shader inputs:
-			// (The dummy values (like glm::vec3) tell the pipeline the format of the respective input)
-			avk::from_buffer_binding(0) -> stream_per_vertex<glm::vec3>() -> to_location(0), // <-- corresponds to vertex shader's inPosition
-			avk::from_buffer_binding(1) -> stream_per_vertex<glm::vec2>() -> to_location(1), // <-- corresponds to vertex shader's inTexCoord
-			avk::from_buffer_binding(2) -> stream_per_vertex<glm::vec3>() -> to_location(2), // <-- corresponds to vertex shader's inNormal
-			// Some further settings:
-			avk::cfg::front_face::define_front_faces_to_be_counter_clockwise(),
-			avk::cfg::viewport_depth_scissors_config::from_framebuffer(mRasterizerFramebuffer.as_reference()), // Align viewport with framebuffer resolution
-			
-			// We'll render to the framebuffer
-			avk::context().create_renderpass(
-			{
-				colorAttachmentDescriptionRaster,
-				positionAttachmentDescription,
-				normalsAttachmentDescription,
-				positionWSAttachmentDescription,
-				normalsWSAttachmentDescription,
-				depthAttachmentDescription
-			}),
-				
-			
-			// The following define additional data which we'll pass to the pipeline:
-			//   We'll pass two matrices to our vertex shader via push constants:
-			avk::push_constant_binding_data { avk::shader_type::vertex, 0, sizeof(transformation_matrices) },
-			avk::descriptor_binding(0, 0, avk::as_combined_image_samplers(mImageSamplers, avk::layout::shader_read_only_optimal)),
-			avk::descriptor_binding(0, 1, mViewProjBuffers[0]),
-			avk::descriptor_binding(0, 2, mViewProjBuffer), //For view/projection matrices
-			avk::descriptor_binding(1, 0, mMaterialBuffer)
-		);
 
 		//Pipeline for Screenspace Effects (DoF) 
 		//Basically we just need to render a quad with the texture of the result of the previous pipeline and apply the DoF effect
 		//In addition we also need to pass the depth buffer to the pipeline from the previous pipeline
-		mPipelineSSAO = avk::context().create_graphics_pipeline_for(
+		mPipelineSSAOFuture = pipelineCompiler.create_graphics_pipeline_for(
 			// Specify which shaders the pipeline consists of:
 			avk::vertex_shader("shaders/ssao.vert"),
-			avk::fragment_shader("shaders/ssao.frag"),
+			avk::fragment_shader(gbuffer_layout::ssao_fragment_shader_path(mStartOptions.gbufferFormat)),
 			
 			avk::from_buffer_binding(0) -> stream_per_vertex<glm::vec2>() -> to_location(0), // <-- corresponds to vertex shader's inPosition
 
@@ -756,15 +961,15 @@ public: // v== avk::invokee overrides which will be invoked by the framework ==v
 			// we bind the image (in which we copy the result of the previous pipeline) to the fragment shader
 			avk::descriptor_binding(0, 0, mImageSamplerRasterFBColor->as_combined_image_sampler(avk::layout::color_attachment_optimal)),
 			avk::descriptor_binding(0, 1, mImageSamplerRasterFBDepth->as_combined_image_sampler(avk::layout::depth_stencil_read_only_optimal)),
-			avk::descriptor_binding(0, 2, mImageSamplerRasterFBPosition->as_combined_image_sampler(avk::layout::color_attachment_optimal)),
+			avk::descriptor_binding(0, 2, gbuffer_position_sampler()->as_combined_image_sampler(avk::layout::color_attachment_optimal)),
 			avk::descriptor_binding(0, 3, mImageSamplerRasterFBNormals->as_combined_image_sampler(avk::layout::color_attachment_optimal)),
 			avk::descriptor_binding(0, 4, mSSAONoiseTexture->as_combined_image_sampler(avk::layout::shader_read_only_optimal)),
-			avk::descriptor_binding(0, 5, mSSAOBuffer),
+			avk::descriptor_binding(0, 5, mSSAOBuffers[0]),
 			avk::descriptor_binding(0, 6, mSSAOKernel),
-			avk::descriptor_binding(0, 7, mViewProjBuffer)
+			avk::descriptor_binding(0, 7, mVpMatricesBuffers[0])
 		);
 
-		mPipelineSSAOBlur = avk::context().create_graphics_pipeline_for(
+		mPipelineSSAOBlurFuture = pipelineCompiler.create_graphics_pipeline_for(
 			avk::vertex_shader("shaders/ssao.vert"),
 			avk::fragment_shader("shaders/ssao_blur.frag"),
 
@@ -779,12 +984,12 @@ public: // v== avk::invokee overrides which will be invoked by the framework ==v
 			}),
 
 			avk::descriptor_binding(0, 0, mImageSamplerSSAOFBColor->as_combined_image_sampler(avk::layout::color_attachment_optimal)),
-			avk::descriptor_binding(0, 1, mSSAOBuffer)
+			avk::descriptor_binding(0, 1, mSSAOBuffers[0])
 		);
 
-		mPipelineIllumination = avk::context().create_graphics_pipeline_for(
+		mPipelineIlluminationFuture = pipelineCompiler.create_graphics_pipeline_for(
 			avk::vertex_shader("shaders/ssao.vert"),
-			avk::fragment_shader("shaders/illum.frag"),
+			avk::fragment_shader(gbuffer_layout::illumination_fragment_shader_path(mStartOptions.gbufferFormat)),
 
 			avk::from_buffer_binding(0)->stream_per_vertex<glm::vec2>()->to_location(0),
 
@@ -797,17 +1002,18 @@ public: // v== avk::invokee overrides which will be invoked by the framework ==v
 			}),
 
 			avk::descriptor_binding(0, 0, mImageSamplerSSAOBlurFBColor->as_combined_image_sampler(avk::layout::color_attachment_optimal)),
-			avk::descriptor_binding(0, 1, mImageSamplerRasterFBPositionWS->as_combined_image_sampler(avk::layout::color_attachment_optimal)),
-			avk::descriptor_binding(0, 2, mImageSamplerRasterFBNormalsWS->as_combined_image_sampler(avk::layout::color_attachment_optimal)),
+			avk::descriptor_binding(0, 1, gbuffer_position_ws_sampler()->as_combined_image_sampler(avk::layout::color_attachment_optimal)),
+			avk::descriptor_binding(0, 2, gbuffer_normals_ws_sampler()->as_combined_image_sampler(avk::layout::color_attachment_optimal)),
 			avk::descriptor_binding(0, 3, mImageSamplerRasterFBColor->as_combined_image_sampler(avk::layout::color_attachment_optimal)),
 			avk::descriptor_binding(0, 4, mImageSamplerRasterFBDepth->as_combined_image_sampler(avk::layout::depth_stencil_read_only_optimal)),
-			avk::descriptor_binding(0, 5, mSSAOBuffer),
-			avk::descriptor_binding(0, 6, mCameraData)
+			avk::descriptor_binding(0, 5, mSSAOBuffers[0]),
+			avk::descriptor_binding(0, 6, mCameraDataBuffers[0]),
+			avk::descriptor_binding(0, 7, mVpMatricesBuffers[0]) // For the inverse view matrix of the compact G-buffer
 		);
 
 
 
-		mPipelineDofNear = avk::context().create_graphics_pipeline_for(
+		mPipelineDofNearFuture = pipelineCompiler.create_graphics_pipeline_for(
 			// Specify which shaders the pipeline consists of:
 			avk::vertex_shader("shaders/dof1.vert"),
 			avk::fragment_shader("shaders/dof1.frag"),
@@ -827,10 +1033,10 @@ public: // v== avk::invokee overrides which will be invoked by the framework ==v
 			// we bind the image (in which we copy the result of the previous pipeline) to the fragment shader
 			avk::descriptor_binding(0, 0, mImageSamplerIlluminationFBColor->as_combined_image_sampler(avk::layout::color_attachment_optimal)),
 			avk::descriptor_binding(0, 1, mImageSamplerRasterFBDepth->as_combined_image_sampler(avk::layout::depth_stencil_read_only_optimal)),
-			avk::descriptor_binding(0, 2, mDoFBuffer)
+			avk::descriptor_binding(0, 2, mDoFBuffers[0])
 		);
 
-		mPipelineDofNearBleed = avk::context().create_graphics_pipeline_for(
+		mPipelineDofNearBleedFuture = pipelineCompiler.create_graphics_pipeline_for(
 			// Specify which shaders the pipeline consists of:
 			avk::vertex_shader("shaders/dofBleedNearField.vert"),
 			avk::fragment_shader("shaders/dofBleedNearField.frag"),
@@ -850,7 +1056,7 @@ public: // v== avk::invokee overrides which will be invoked by the framework ==v
 			avk::descriptor_binding(0, 0, mImageSamplerDofNearColor->as_combined_image_sampler(avk::layout::color_attachment_optimal))
 		);
 
-		mPipelineDofFar = avk::context().create_graphics_pipeline_for(
+		mPipelineDofFarFuture = pipelineCompiler.create_graphics_pipeline_for(
 			// Specify which shaders the pipeline consists of:
 			avk::vertex_shader("shaders/dof2.vert"),
 			avk::fragment_shader("shaders/dof2.frag"),
@@ -870,10 +1076,10 @@ public: // v== avk::invokee overrides which will be invoked by the framework ==v
 			// we bind the image (in which we copy the result of the previous pipeline) to the fragment shader
 			avk::descriptor_binding(0, 0, mImageSamplerIlluminationFBColor->as_combined_image_sampler(avk::layout::color_attachment_optimal)),
 			avk::descriptor_binding(0, 1, mImageSamplerRasterFBDepth->as_combined_image_sampler(avk::layout::depth_stencil_read_only_optimal)),
-			avk::descriptor_binding(0, 2, mDoFBuffer)
+			avk::descriptor_binding(0, 2, mDoFBuffers[0])
 		);
 
-		mPipelineDofCenter = avk::context().create_graphics_pipeline_for(
+		mPipelineDofCenterFuture = pipelineCompiler.create_graphics_pipeline_for(
 			// Specify which shaders the pipeline consists of:
 			avk::vertex_shader("shaders/dofCenter.vert"),
 			avk::fragment_shader("shaders/dofCenter.frag"),
@@ -893,11 +1099,11 @@ public: // v== avk::invokee overrides which will be invoked by the framework ==v
 			// we bind the image (in which we copy the result of the previous pipeline) to the fragment shader
 			avk::descriptor_binding(0, 0, mImageSamplerIlluminationFBColor->as_combined_image_sampler(avk::layout::color_attachment_optimal)),
 			avk::descriptor_binding(0, 1, mImageSamplerRasterFBDepth->as_combined_image_sampler(avk::layout::depth_stencil_read_only_optimal)),
-			avk::descriptor_binding(0, 2, mDoFBuffer)
+			avk::descriptor_binding(0, 2, mDoFBuffers[0])
 		);
 		
 		
-		mPipelineDofFinal = avk::context().create_graphics_pipeline_for(
+		mPipelineDofFinalFuture = pipelineCompiler.create_graphics_pipeline_for(
 			// Specify which shaders the pipeline consists of:
 			avk::vertex_shader("shaders/dof3.vert"),
 			avk::fragment_shader("shaders/dof3.frag"),
@@ -906,14 +1112,14 @@ public: // v== avk::invokee overrides which will be invoked by the framework ==v
 
 			// Some further settings:
 			avk::cfg::front_face::define_front_faces_to_be_clockwise(),
-			avk::cfg::viewport_depth_scissors_config::from_framebuffer(avk::context().main_window()->backbuffer_reference_at_index(0)),	// Align viewport with main window's resolution
+			avk::cfg::viewport_depth_scissors_config::from_framebuffer(mTarget->backbuffer_reference_at_index(0)),	// Align viewport with the back buffer's resolution
 
 			// We'll render to the back buffer, which has a color attachment always, and in our case additionally a depth
-			// attachment, which has been configured when creating the window. See main() function!
+			// attachment, which has been configured when creating the window (see main() function), or the offscreen target:
 			avk::context().create_renderpass({
-				avk::attachment::declare(avk::format_from_window_color_buffer(avk::context().main_window()), avk::on_load::clear.from_previous_layout(avk::layout::undefined), avk::usage::color(0), avk::on_store::store),
-				avk::attachment::declare(avk::format_from_window_depth_buffer(avk::context().main_window()), avk::on_load::clear.from_previous_layout(avk::layout::undefined), avk::usage::depth_stencil, avk::on_store::dont_care)
-			}, avk::context().main_window()->renderpass_reference().subpass_dependencies()),
+				avk::attachment::declare(mTarget->color_format(), avk::on_load::clear.from_previous_layout(avk::layout::undefined), avk::usage::color(0), avk::on_store::store),
+				avk::attachment::declare(mTarget->depth_format(), avk::on_load::clear.from_previous_layout(avk::layout::undefined), avk::usage::depth_stencil, avk::on_store::dont_care)
+			}, mTarget->renderpass_reference().subpass_dependencies()),
 			
 			// we bind the image (in which we copy the result of the previous pipeline) to the fragment shader
 			avk::descriptor_binding(0, 0, mImageSamplerIlluminationFBColor->as_combined_image_sampler(avk::layout::color_attachment_optimal)),
@@ -921,65 +1127,69 @@ public: // v== avk::invokee overrides which will be invoked by the framework ==v
 			avk::descriptor_binding(0, 2, mImageSamplerDofCenterColor->as_combined_image_sampler(avk::layout::color_attachment_optimal)),
 			avk::descriptor_binding(0, 3, mImageSamplerDofFarColor->as_combined_image_sampler(avk::layout::color_attachment_optimal)),
 			avk::descriptor_binding(0, 4, mImageSamplerRasterFBDepth->as_combined_image_sampler(avk::layout::depth_stencil_read_only_optimal)),
-			avk::descriptor_binding(0, 5, mDoFBuffer),
+			avk::descriptor_binding(0, 5, mDoFBuffers[0]),
 			avk::descriptor_binding(1, 0, mDoFKernelBufferGaussian),
 			avk::descriptor_binding(1, 1, mDoFKernelBufferBokeh)
 
 		);
 
-		
+		// Load the scene while the pipelines above are being compiled. Its culling pipelines are compiled concurrently, too:
+		init_scene(pipelineCompiler);
 
-		// set up updater
-		// we want to use an updater, so create one:
-		mUpdater.emplace();
-		mPipelineSSAO.enable_shared_ownership(); // Make it usable with the updater
-		mPipelineDofFar.enable_shared_ownership(); // Make it usable with the updater
-		mPipelineDofNear.enable_shared_ownership(); // Make it usable with the updater
-		mPipelineDofNearBleed.enable_shared_ownership(); // Make it usable with the updater
-		mPipelineDofFinal.enable_shared_ownership(); // Make it usable with the updater
-		mPipelineSkybox.enable_shared_ownership(); // Make it usable with the updater
-		mRasterizePipeline.enable_shared_ownership(); // Make it usable with the updater
-		mPipelineSSAOBlur.enable_shared_ownership(); // Make it usable with the updater
-		mPipelineIllumination.enable_shared_ownership(); // Make it usable with the updater
-
-		mUpdater->on(avk::swapchain_resized_event(avk::context().main_window())).invoke([this]() {
-			this->mQuakeCam.set_aspect_ratio(avk::context().main_window()->aspect_ratio());
-			this->mOrbitCam.set_aspect_ratio(avk::context().main_window()->aspect_ratio());
-		});
+		// Create our rasterization graphics pipeline with the required configuration:
+		// (The vertex shader and the format and location of its inputs depend on the vertex format, see vertex_packing.hpp)
+		mRasterizePipelineFuture = std::apply([&](auto... aVertexInputs) { return pipelineCompiler.create_graphics_pipeline_for(
+			// Specify which shaders the pipeline consists of:
+			avk::vertex_shader(vertex_packing::vertex_shader_path(mStartOptions.vertexFormat)),
+			avk::fragment_shader(gbuffer_layout::raster_fragment_shader_path(mStartOptions.gbufferFormat)),
+			// inPosition, inTexCoord, and inNormal at locations 0, 1, and 2:
+			aVertexInputs...,
+			// Some further settings:
+			avk::cfg::front_face::define_front_faces_to_be_counter_clockwise(),
+			avk::cfg::viewport_depth_scissors_config::from_framebuffer(mRasterizerFramebuffer.as_reference()), // Align viewport with framebuffer resolution
+			
+			// We'll render to the framebuffer
+			avk::context().create_renderpass(gBufferAttachmentDescriptions),
+				
+			
+			// The following define additional data which we'll pass to the pipeline:
+			//   We'll pass two matrices to our vertex shader via push constants:
+			avk::push_constant_binding_data { avk::shader_type::vertex, 0, sizeof(transformation_matrices) },
+			avk::descriptor_binding(0, 0, avk::as_combined_image_samplers(material_image_samplers(), avk::layout::shader_read_only_optimal)),
+			avk::descriptor_binding(0, 1, mViewProjBuffers[0]),
+			avk::descriptor_binding(0, 2, mVpMatricesBuffers[0]), //For view/projection matrices
+			avk::descriptor_binding(1, 0, mMaterialBuffer),
+			avk::descriptor_binding(1, 1, mPerDrawDataBuffer),
+			avk::descriptor_binding(1, 2, mip_feedback_buffer())
+		); }, vertex_packing::input_description(mStartOptions.vertexFormat));
+
+		//Create Vertex Buffer for Screenspace Quad (while the pipelines are being compiled)
+		{
+			mVertexBufferScreenspace = avk::context().create_buffer(
+				avk::memory_usage::device, {},
+				// Create the buffer on the device, i.e. in GPU memory, (no additional usage flags).
+				// because the screenspace quad is static, we can use device memory
+				avk::vertex_buffer_meta::create_from_data(mScreenspaceQuadVertexData)
+			);
+			mUploader->stage(mVertexBufferScreenspace.as_reference(), 0, mScreenspaceQuadVertexData.data(), sizeof(glm::vec2) * mScreenspaceQuadVertexData.size());
+
+			mIndexBufferScreenspace = avk::context().create_buffer(
+				avk::memory_usage::device, {},
+				avk::index_buffer_meta::create_from_data(mScreenspaceQuadIndexData)
+			);
+			mUploader->stage(mIndexBufferScreenspace.as_reference(), 0, mScreenspaceQuadIndexData.data(), sizeof(uint16_t) * mScreenspaceQuadIndexData.size());
+			// Not waited for: The first frame's acquire covers this submission, too:
+			mSceneUploadTicket = mUploader->submit();
+
+		}
 
-		//first make sure render pass is updated
-		mUpdater->on(avk::swapchain_format_changed_event(avk::context().main_window()),
-					 avk::swapchain_additional_attachments_changed_event(avk::context().main_window())
-		).invoke([this]() {
-			// std::vector<avk::attachment> renderpassAttachments = {
-			// 	avk::attachment::declare(avk::format_from_window_color_buffer(avk::context().main_window()), avk::on_load::clear.from_previous_layout(avk::layout::undefined), avk::usage::color(0),		avk::on_store::store),	 // But not in presentable format, because ImGui comes after
-			// };
-			// if (mAdditionalAttachmentsCheckbox->checked())	{
-			// 	renderpassAttachments.push_back(avk::attachment::declare(avk::format_from_window_depth_buffer(avk::context().main_window()), avk::on_load::clear.from_previous_layout(avk::layout::undefined), avk::usage::depth_stencil, avk::on_store::dont_care));
-			// }
-			// auto renderPass = avk::context().create_renderpass(renderpassAttachments, avk::context().main_window()->renderpass_reference().subpass_dependencies());
-			// avk::context().replace_render_pass_for_pipeline(mPipelineScreenspace, std::move(renderPass));
-			// TODO also for mPipelineSkybox?!?!?
-		}).then_on( // ... next, at this point, we are sure that the render pass is correct -> check if there are events that would update the pipeline
-			avk::swapchain_changed_event(avk::context().main_window()),
-			avk::shader_files_changed_event(mRasterizePipeline.as_reference()),
-			avk::shader_files_changed_event(mPipelineSkybox.as_reference()),
-			avk::shader_files_changed_event(mPipelineSSAO.as_reference()),
-			avk::shader_files_changed_event(mPipelineSSAOBlur.as_reference()),
-			avk::shader_files_changed_event(mPipelineIllumination.as_reference()),
-			avk::shader_files_changed_event(mPipelineDofFar.as_reference()),
-			avk::shader_files_changed_event(mPipelineDofNear.as_reference()),
-			avk::shader_files_changed_event(mPipelineDofNearBleed.as_reference()),
-			avk::shader_files_changed_event(mPipelineDofCenter.as_reference()),
-			avk::shader_files_changed_event(mPipelineDofFinal.as_reference())
-		).update(mRasterizePipeline, mPipelineSkybox, mPipelineDofFinal, mPipelineDofNear,mPipelineDofNearBleed, mPipelineDofCenter, mPipelineDofFar, mPipelineSSAO, mPipelineSSAOBlur, mPipelineIllumination);
 
 		
 		// Add the cameras to the composition (and let them handle updates)
 		mOrbitCam.set_translation({ 0.0f, 0.0f, 0.0f });
 		mQuakeCam.set_translation({ 0.0f, 0.0f, 0.0f });
-		mOrbitCam.set_perspective_projection(glm::radians(30.0f), avk::context().main_window()->aspect_ratio(), CAM_NEAR, CAM_FAR);
-		mQuakeCam.set_perspective_projection(glm::radians(30.0f), avk::context().main_window()->aspect_ratio(), CAM_NEAR, CAM_FAR);
+		mOrbitCam.set_perspective_projection(glm::radians(30.0f), mTarget->aspect_ratio(), CAM_NEAR, CAM_FAR);
+		mQuakeCam.set_perspective_projection(glm::radians(30.0f), mTarget->aspect_ratio(), CAM_NEAR, CAM_FAR);
 		avk::current_composition()->add_element(mOrbitCam);
 		avk::current_composition()->add_element(mQuakeCam);
 		mQuakeCam.enable();
@@ -1040,6 +1250,30 @@ public: // v== avk::invokee overrides which will be invoked by the framework ==v
 				ImGui::Separator();
 				
 				ImGui::DragFloat3("Scale", glm::value_ptr(mScale), 0.005f, 0.01f, 10.0f);
+				ImGui::Checkbox("Multi-draw indirect", &mMultiDrawIndirect);
+				ImGui::Text("%u draw call(s) per frame", (mGpuCullingEnabled || mMultiDrawIndirect) ? 1u : static_cast<uint32_t>(mDrawCalls.size()));
+				ImGui::Checkbox("GPU culling", &mGpuCullingEnabled);
+				if (mGpuCullingEnabled) {
+					ImGui::Checkbox("Occlusion culling (HiZ)", &mOcclusionCullingEnabled);
+					ImGui::Text("%u / %u clusters visible", mGpuCulling->num_visible_clusters(), mGpuCulling->num_clusters());
+					ImGui::Text("%u / %u triangles submitted", mGpuCulling->num_triangles_submitted(), mGpuCulling->num_triangles());
+				}
+				if (mTextureStreamer.has_value()) {
+					const auto& ts = mTextureStreamer->stats();
+					ImGui::Text("Textures: %.1f / %.1f MiB resident (%.1f MiB at full resolution)", ts.mResidentBytes / (1024.0 * 1024.0), ts.mBudgetBytes / (1024.0 * 1024.0), ts.mFullResolutionBytes / (1024.0 * 1024.0));
+					ImGui::Text("Streaming: %.1f MiB/s, %u load(s) in flight, %llu in, %llu evicted", ts.mUploadBytesPerSecond / (1024.0 * 1024.0), ts.mNumPendingLoads,
+						static_cast<unsigned long long>(ts.mNumStreamedIn), static_cast<unsigned long long>(ts.mNumEvicted));
+					std::string requested = "Requested mip:";
+					std::string resident  = "Resident mip: ";
+					for (uint32_t level = 0; level < texture_streamer::cNumHistogramLevels; ++level) {
+						requested += std::format(" {:3}", ts.mRequestedLevels[level]);
+						resident  += std::format(" {:3}", ts.mResidentLevels[level]);
+					}
+					ImGui::TextUnformatted(requested.c_str());
+					ImGui::TextUnformatted(resident.c_str());
+				}
+				ImGui::Text("%llu Vulkan object(s) created this frame", static_cast<unsigned long long>(mFrameResources->num_objects_created_in_current_frame()));
+				ImGui::Text("%u submission(s), %u barrier(s) per frame", mRenderGraph->num_submissions(), mRenderGraph->num_barriers());
 				ImGui::Checkbox("Enable/Disable invokee", &isEnabled);
 				if (isEnabled != this->is_enabled())
 				{
@@ -1056,10 +1290,15 @@ public: // v== avk::invokee overrides which will be invoked by the framework ==v
 				
 
 				ImGui::End();
+
+				mGpuProfiler->draw_imgui_window();
 			});
 		}
 	}
 
+	/**	Writes this frame's uniform data into the buffers of the given in-flight index. They are host-coherent, i.e., fill()
+	 *	writes them right away and returns no commands, and the window has already waited for the frame which has used them before.
+	 */
 	void update_uniform_buffers(avk::window::frame_id_t ifi)
 	{
 		auto viewProjMat = mQuakeCam.is_enabled()
@@ -1089,14 +1328,16 @@ public: // v== avk::invokee overrides which will be invoked by the framework ==v
 		// scale skybox, mirror x axis, cancel out translation
 		viewProjMat2.mModelViewMatrix = avk::cancel_translation_from_matrix(mirroredViewMatrix * mModelMatrixSkybox);
 
-		auto emptyToo = mViewProjBufferSkybox->fill(&viewProjMat2, 0);
+		auto emptyToo = mViewProjBuffersSkybox[ifi]->fill(&viewProjMat2, 0);
 
 		// For Raster step
 		vp_matrices viewProjMat3{
 			viewMatrix,
-			projectionMatrix
+			projectionMatrix,
+			glm::inverse(projectionMatrix),
+			glm::inverse(viewMatrix)
 		};
-		auto emptyThree = mViewProjBuffer->fill(&viewProjMat3, 0);
+		auto emptyThree = mVpMatricesBuffers[ifi]->fill(&viewProjMat3, 0);
 
 		//DoF
 		DoFData dofData;
@@ -1107,34 +1348,78 @@ public: // v== avk::invokee overrides which will be invoked by the framework ==v
 		dofData.mDistOutOfFocus = mDoFDistanceOutOfFocus;
 		dofData.mNearPlane = mQuakeCam.near_plane_distance();// we assume both camera have the same near and far plane
 		dofData.mFarPlane = mQuakeCam.far_plane_distance();
-		auto dofCmd = mDoFBuffer->fill(&dofData, 0);
+		auto emptyFour = mDoFBuffers[ifi]->fill(&dofData, 0);
 		
 		SSAOData ssaoData;
 		ssaoData.mEnabled = mSSAOEnabled;
 		ssaoData.mBlur = mSSAOBlur;
 		ssaoData.mIllumination = mIllumination;
-		auto fence = avk::context().record_and_submit_with_fence({
-			mSSAOBuffer->fill(&ssaoData, 0)
-		}, *mQueue);
-		// Wait on the host until the device is done:
-		fence->wait_until_signalled();
+		auto emptyFive = mSSAOBuffers[ifi]->fill(&ssaoData, 0);
 
 		glm::vec3 camTranslation = mQuakeCam.is_enabled() ? mQuakeCam.translation() : mOrbitCam.translation();
 		glm::vec4 camPosition = glm::vec4(camTranslation, 1.0);
 		CameraData camData;
 		camData.position = camPosition;
-		auto fence2 = avk::context().record_and_submit_with_fence({
-			mCameraData->fill(&camData, 0)
-		}, *mQueue);
-		// Wait on the host until the device is done:
-		fence2->wait_until_signalled();
+		auto emptySix = mCameraDataBuffers[ifi]->fill(&camData, 0);
+	}
+
+	/** Takes a pipeline from its future when it is used for the first time, i.e., blocks only if it has not been compiled yet */
+	static avk::graphics_pipeline& resolve_pipeline(std::future<avk::graphics_pipeline>& aFuture, avk::graphics_pipeline& aPipeline)
+	{
+		if (aFuture.valid()) {
+			aPipeline = aFuture.get();
+			aPipeline.enable_shared_ownership(); // Make it usable with the updater
+		}
+		return aPipeline;
+	}
 
+	/** Sets up the updater, which needs all pipelines. Called at the end of the first frame, which has resolved them. */
+	void set_up_updater()
+	{
+		// we want to use an updater, so create one. It reacts to changes of the window's swapchain, i.e., only with a window:
+		if (!mTarget->is_headless()) {
+			mUpdater.emplace();
+			mUpdater->on(avk::swapchain_resized_event(avk::context().main_window())).invoke([this]() {
+				this->mQuakeCam.set_aspect_ratio(mTarget->aspect_ratio());
+				this->mOrbitCam.set_aspect_ratio(mTarget->aspect_ratio());
+			});
+
+			//first make sure render pass is updated
+			mUpdater->on(avk::swapchain_format_changed_event(avk::context().main_window()),
+						 avk::swapchain_additional_attachments_changed_event(avk::context().main_window())
+			).invoke([this]() {
+				// std::vector<avk::attachment> renderpassAttachments = {
+				// 	avk::attachment::declare(avk::format_from_window_color_buffer(avk::context().main_window()), avk::on_load::clear.from_previous_layout(avk::layout::undefined), avk::usage::color(0),		avk::on_store::store),	 // But not in presentable format, because ImGui comes after
+				// };
+				// if (mAdditionalAttachmentsCheckbox->checked())	{
+				// 	renderpassAttachments.push_back(avk::attachment::declare(avk::format_from_window_depth_buffer(avk::context().main_window()), avk::on_load::clear.from_previous_layout(avk::layout::undefined), avk::usage::depth_stencil, avk::on_store::dont_care));
+				// }
+				// auto renderPass = avk::context().create_renderpass(renderpassAttachments, avk::context().main_window()->renderpass_reference().subpass_dependencies());
+				// avk::context().replace_render_pass_for_pipeline(mPipelineScreenspace, std::move(renderPass));
+				// TODO also for mPipelineSkybox?!?!?
+			}).then_on( // ... next, at this point, we are sure that the render pass is correct -> check if there are events that would update the pipeline
+				avk::swapchain_changed_event(avk::context().main_window()),
+				avk::shader_files_changed_event(mRasterizePipeline.as_reference()),
+				avk::shader_files_changed_event(mPipelineSkybox.as_reference()),
+				avk::shader_files_changed_event(mPipelineSSAO.as_reference()),
+				avk::shader_files_changed_event(mPipelineSSAOBlur.as_reference()),
+				avk::shader_files_changed_event(mPipelineIllumination.as_reference()),
+				avk::shader_files_changed_event(mPipelineDofFar.as_reference()),
+				avk::shader_files_changed_event(mPipelineDofNear.as_reference()),
+				avk::shader_files_changed_event(mPipelineDofNearBleed.as_reference()),
+				avk::shader_files_changed_event(mPipelineDofCenter.as_reference()),
+				avk::shader_files_changed_event(mPipelineDofFinal.as_reference())
+			).update(mRasterizePipeline, mPipelineSkybox, mPipelineDofFinal, mPipelineDofNear,mPipelineDofNearBleed, mPipelineDofCenter, mPipelineDofFar, mPipelineSSAO, mPipelineSSAOBlur, mPipelineIllumination);
+		}
 	}
 
 	void render() override
 	{
-		auto mainWnd = avk::context().main_window();
-		auto ifi = mainWnd->current_in_flight_index();
+		// Without a window, wait for the frame which has used this in-flight index before here, like the window does before render():
+		mTarget->begin_frame();
+		const auto cpuBegin = std::chrono::high_resolution_clock::now();
+		auto ifi = mTarget->current_in_flight_index();
+		auto currentFrame = mTarget->current_frame();
 
 // 		, mRotationSpeed(0.001f)
 // , mMoveSpeed(4.5f) // 4.5 m/s
@@ -1146,275 +1431,302 @@ public: // v== avk::invokee overrides which will be invoked by the framework ==v
 		mQuakeCam.set_rotation_speed(0.0015f);
 		update_uniform_buffers(ifi);
 		
-		// Get a command pool to allocate command buffers from:
-		auto& commandPool = avk::context().get_command_pool_for_single_use_command_buffers(*mQueue);
-		
-		// Create three command buffer:
-		auto cmdBfrs = commandPool->alloc_command_buffers(9u, vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
-
-		//Create semaphores 
-		auto rasterizerComplete = avk::context().create_semaphore();
-		auto ssaoComplete = avk::context().create_semaphore();
-		auto ssaoBComplete = avk::context().create_semaphore();
-
-		auto illumComplete = avk::context().create_semaphore();
-		auto illumComplete2 = avk::context().create_semaphore();
-		auto illumComplete3 = avk::context().create_semaphore();
-
-		auto dofNearComplete = avk::context().create_semaphore();
-		auto dofNearBleedComplete = avk::context().create_semaphore();
-		auto dofCenterComplete = avk::context().create_semaphore();
-		auto dofFarComplete = avk::context().create_semaphore();
+		// Recycle the command buffers of the frame which has used this in-flight index before.
+		// Nothing is created here in steady state:
+		mFrameResources->begin_frame(ifi);
+		// Collects the GPU timings of the frame which has used this in-flight index before:
+		mGpuProfiler->begin_frame(ifi, currentFrame);
 
 		// The swap chain provides us with an "image available semaphore" for the current frame.
 		// Only after the swapchain image has become available, we may start rendering into it.
-		auto imageAvailable = mainWnd->consume_current_image_available_semaphore();
+		// The offscreen target has no swap chain, and provides none:
+		auto imageAvailable = mTarget->consume_current_image_available_semaphore();
 
 		
+		// With GPU culling, a compute pass decides which clusters are drawn, and the depth buffer is reduced into a HiZ pyramid afterwards:
+		const auto sceneModelMatrix = glm::scale(glm::vec3(0.01f) * mScale);
+		auto cullingCommands = mGpuCullingEnabled
+			? mGpuCulling->record_culling(ifi, currentFrame, mPerDrawDataBuffer, sceneModelMatrix, mQuakeCam.is_enabled() ? mQuakeCam.projection_and_view_matrix() : mOrbitCam.projection_and_view_matrix(), mOcclusionCullingEnabled)
+			: std::vector<avk::recorded_commands_t>{};
+		auto hiZCommands = mGpuCullingEnabled
+			? mGpuCulling->record_hiz_build(ifi, currentFrame, mImageSamplerRasterFBDepth)
+			: std::vector<avk::recorded_commands_t>{};
+
+		// All passes of the frame are declared with the images they read and write. The render graph derives the
+		// barriers between them, and only splits them into a second submission where the swapchain image is needed:
+		mRenderGraph->begin_frame();
+
+		// Streams texture levels in and out according to the mip feedback of earlier frames, before the textures are bound.
+		// Only levels whose uploads have completed on the transfer queue are swapped in, and handed over by the next pass:
+		auto streamingCommands = mTextureStreamer.has_value() ? mTextureStreamer->update(ifi, currentFrame, mTarget->number_of_frames_in_flight()) : std::vector<avk::recorded_commands_t>{};
+
+		// Hands everything over which the transfer queue has uploaded so far. Only the uploads of initialize() are waited for,
+		// in the first frame, which also records the uploads of the materials' textures and the skybox:
+		auto& uploadsPass = mRenderGraph->add_pass("Uploads");
+		std::vector<avk::recorded_commands_t> uploadCommands;
+		if (auto handover = mUploader->acquire(mSceneUploadTicket)) {
+			auto& [waitInfo, acquireBarriers] = handover.value();
+			uploadsPass.waiting_for(std::move(waitInfo));
+			uploadCommands = std::move(acquireBarriers);
+		}
+		std::move(mPendingUploadCommands.begin(), mPendingUploadCommands.end(), std::back_inserter(uploadCommands));
+		mPendingUploadCommands.clear();
+		uploadsPass.recording(std::move(uploadCommands));
+		if (mTextureStreamer.has_value()) {
+			mRenderGraph->add_pass("Texture streaming")
+				.recording(std::move(streamingCommands));
+		}
+
 		//First renderpass is the main scene into the rasterizerFramebuffer and creation of the gbuffer
-		avk::context().record({
-		avk::command::render_pass(mPipelineSkybox->renderpass_reference(), mRasterizerFramebuffer.as_reference(), avk::command::gather(
-				avk::command::bind_pipeline(mPipelineSkybox.as_reference()),
-				avk::command::bind_descriptors(mPipelineSkybox->layout(), mDescriptorCache->get_or_create_descriptor_sets({
-					avk::descriptor_binding(0, 0, mViewProjBufferSkybox),
-					avk::descriptor_binding(0, 1, mImageSamplerCubemap->as_combined_image_sampler(avk::layout::general))
-				})),
-				avk::command::one_for_each(mDrawCallsSkybox, [](const data_for_draw_call& drawCall) {
-					return avk::command::draw_indexed(drawCall.mIndexBuffer.as_reference(), drawCall.mPositionsBuffer.as_reference());
-				})
-			)),
-			avk::command::render_pass(mRasterizePipeline->renderpass_reference(), mRasterizerFramebuffer.as_reference(), avk::command::gather(
-				avk::command::bind_pipeline(mRasterizePipeline.as_reference()),
-				avk::command::bind_descriptors(mRasterizePipeline->layout(), mDescriptorCache->get_or_create_descriptor_sets({
-					avk::descriptor_binding(0, 0, avk::as_combined_image_samplers(mImageSamplers, avk::layout::shader_read_only_optimal)),
-					avk::descriptor_binding(0, 1, mViewProjBuffers[ifi]),
-					avk::descriptor_binding(0, 2, mViewProjBuffer),
-					avk::descriptor_binding(1, 0, mMaterialBuffer),
-				})),
-
-				// Draw all the draw calls:
-				avk::command::custom_commands([&,this](avk::command_buffer_t& cb) { // If there is no avk::command::... struct for a particular command, we can always use avk::command::custom_commands
-					for (auto& drawCall : mDrawCalls) {
-						cb.record({
-							// Set the push constants per draw call:
-							avk::command::push_constants(
-								mRasterizePipeline->layout(),
-								transformation_matrices{
-									// Set model matrix for this mesh:
-									glm::scale(glm::vec3(0.01f) * mScale),
-									// Set material index for this mesh:
-									drawCall.mMaterialIndex
-								}
-							),
-
-							// Make the draw call:
-							avk::command::draw_indexed(
-								// Bind and use the index buffer:
-								drawCall.mIndexBuffer.as_reference(),
-								// Bind the vertex input buffers in the right order (corresponding to the layout specifiers in the vertex shader)
-								drawCall.mPositionsBuffer.as_reference(), drawCall.mTexCoordsBuffer.as_reference(), drawCall.mNormalsBuffer.as_reference()
-							)
-						});
-					}
-				})
-			))
-		})
-		.into_command_buffer(cmdBfrs[0])
-		.then_submit_to(*mQueue)
-		// Do not start to render before the image has become available:
-		.waiting_for(imageAvailable >> avk::stage::color_attachment_output)
-		.signaling_upon_completion(avk::stage::color_attachment_output >> rasterizerComplete)
-		.submit();
+		resolve_pipeline(mPipelineSkyboxFuture, mPipelineSkybox);
+		resolve_pipeline(mRasterizePipelineFuture, mRasterizePipeline);
+		mRenderGraph->add_pass("Rasterize")
+			.rendering_into(mRasterizerFramebuffer.as_reference())
+			.recording(avk::command::gather(
+				cullingCommands,
+				avk::command::render_pass(mPipelineSkybox->renderpass_reference(), mRasterizerFramebuffer.as_reference(), avk::command::gather(
+					avk::command::bind_pipeline(mPipelineSkybox.as_reference()),
+					avk::command::bind_descriptors(mPipelineSkybox->layout(), mDescriptorCache->get_or_create_descriptor_sets({
+						avk::descriptor_binding(0, 0, mViewProjBuffersSkybox[ifi]),
+						avk::descriptor_binding(0, 1, mImageSamplerCubemap->as_combined_image_sampler(avk::layout::general))
+					})),
+					avk::command::one_for_each(mDrawCallsSkybox, [](const data_for_draw_call& drawCall) {
+						return avk::command::draw_indexed(drawCall.mIndexBuffer.as_reference(), drawCall.mPositionsBuffer.as_reference());
+					})
+				)),
+				avk::command::render_pass(mRasterizePipeline->renderpass_reference(), mRasterizerFramebuffer.as_reference(), avk::command::gather(
+					avk::command::bind_pipeline(mRasterizePipeline.as_reference()),
+					avk::command::bind_descriptors(mRasterizePipeline->layout(), mDescriptorCache->get_or_create_descriptor_sets({
+						avk::descriptor_binding(0, 0, avk::as_combined_image_samplers(material_image_samplers(), avk::layout::shader_read_only_optimal)),
+						avk::descriptor_binding(0, 1, mViewProjBuffers[ifi]),
+						avk::descriptor_binding(0, 2, mVpMatricesBuffers[ifi]),
+						avk::descriptor_binding(1, 0, mMaterialBuffer),
+						avk::descriptor_binding(1, 1, mPerDrawDataBuffer),
+						avk::descriptor_binding(1, 2, mip_feedback_buffer()),
+					})),
+
+					// Set the scene-wide model matrix. Everything per draw is taken from the per-draw data SSBO:
+					avk::command::push_constants(
+						mRasterizePipeline->layout(),
+						transformation_matrices{ sceneModelMatrix }
+					),
+
+					// Draw all the draw calls:
+					mGpuCullingEnabled
+						// ...with one indirect draw call whose draw count has been determined by the culling pass:
+						? with_scene_vertex_buffers([this](const auto&... aVertexBuffers) {
+							return mGpuCulling->draw(mSceneIndexBuffer.as_reference(), aVertexBuffers...);
+						})
+					: mMultiDrawIndirect
+						// ...with one single indirect draw call for the whole scene:
+						? with_scene_vertex_buffers([this](const auto&... aVertexBuffers) {
+							return avk::command::draw_indexed_indirect(
+								mDrawCommandsBuffer.as_reference(),
+								mSceneIndexBuffer.as_reference(),
+								static_cast<uint32_t>(mDrawCalls.size()),
+								aVertexBuffers...
+							);
+						})
+						// ...or with one draw call per material:
+						: avk::command::custom_commands([&,this](avk::command_buffer_t& cb) { // If there is no avk::command::... struct for a particular command, we can always use avk::command::custom_commands
+							for (uint32_t i = 0; i < static_cast<uint32_t>(mDrawCalls.size()); ++i) {
+								const auto& drawCall = mDrawCalls[i];
+								cb.record(with_scene_vertex_buffers([&](const auto&... aVertexBuffers) {
+									return avk::command::draw_indexed(
+										// Bind the shared index buffer and use this draw call's range of it:
+										std::forward_as_tuple(mSceneIndexBuffer.as_reference(), size_t{ 0 }, drawCall.mIndexCount),
+										// The first instance selects this draw call's entry in the per-draw data SSBO:
+										1u, drawCall.mFirstIndex, drawCall.mVertexOffset, i,
+										aVertexBuffers...
+									);
+								}));
+							}
+						})
+				)),
+				hiZCommands
+			));
 
 		//2. Render SSAO
-		avk::context().record({
-			avk::command::render_pass(mPipelineSSAO->renderpass_reference(), mSSAOFramebuffer.as_reference(), avk::command::gather(
-				avk::command::bind_pipeline(mPipelineSSAO.as_reference()),
-				avk::command::bind_descriptors(mPipelineSSAO->layout(), mDescriptorCache->get_or_create_descriptor_sets({
-					avk::descriptor_binding(0, 0, mImageSamplerRasterFBColor->as_combined_image_sampler(avk::layout::attachment_optimal)),
-					avk::descriptor_binding(0, 1, mImageSamplerRasterFBDepth->as_combined_image_sampler(avk::layout::attachment_optimal)),
-					avk::descriptor_binding(0, 2, mImageSamplerRasterFBPosition->as_combined_image_sampler(avk::layout::attachment_optimal)),
-					avk::descriptor_binding(0, 3, mImageSamplerRasterFBNormals->as_combined_image_sampler(avk::layout::attachment_optimal)),
-					avk::descriptor_binding(0, 4, mSSAONoiseTexture->as_combined_image_sampler(avk::layout::shader_read_only_optimal)),
-					avk::descriptor_binding(0, 5, mSSAOBuffer),
-					avk::descriptor_binding(0, 6, mSSAOKernel),
-					avk::descriptor_binding(0, 7, mViewProjBuffer)
-				})),
-				avk::command::draw_indexed(mIndexBufferScreenspace.as_reference(), mVertexBufferScreenspace.as_reference())
-			))
-		})
-		.into_command_buffer(cmdBfrs[1])
-		.then_submit_to(*mQueue)
-		.waiting_for(rasterizerComplete >> avk::stage::color_attachment_output)
-		.signaling_upon_completion(avk::stage::color_attachment_output >> ssaoComplete)
-		.submit();
-		// Let the command buffer handle the semaphore lifetimes:
-		cmdBfrs[1]->handle_lifetime_of(std::move(rasterizerComplete));
+		resolve_pipeline(mPipelineSSAOFuture, mPipelineSSAO);
+		mRenderGraph->add_pass("SSAO")
+			.reading(mImageSamplerRasterFBColor, mImageSamplerRasterFBDepth, gbuffer_position_sampler(), mImageSamplerRasterFBNormals)
+			.rendering_into(mSSAOFramebuffer.as_reference())
+			.recording({
+				avk::command::render_pass(mPipelineSSAO->renderpass_reference(), mSSAOFramebuffer.as_reference(), avk::command::gather(
+					avk::command::bind_pipeline(mPipelineSSAO.as_reference()),
+					avk::command::bind_descriptors(mPipelineSSAO->layout(), mDescriptorCache->get_or_create_descriptor_sets({
+						avk::descriptor_binding(0, 0, mImageSamplerRasterFBColor->as_combined_image_sampler(avk::layout::attachment_optimal)),
+						avk::descriptor_binding(0, 1, mImageSamplerRasterFBDepth->as_combined_image_sampler(avk::layout::attachment_optimal)),
+						avk::descriptor_binding(0, 2, gbuffer_position_sampler()->as_combined_image_sampler(avk::layout::attachment_optimal)),
+						avk::descriptor_binding(0, 3, mImageSamplerRasterFBNormals->as_combined_image_sampler(avk::layout::attachment_optimal)),
+						avk::descriptor_binding(0, 4, mSSAONoiseTexture->as_combined_image_sampler(avk::layout::shader_read_only_optimal)),
+						avk::descriptor_binding(0, 5, mSSAOBuffers[ifi]),
+						avk::descriptor_binding(0, 6, mSSAOKernel),
+						avk::descriptor_binding(0, 7, mVpMatricesBuffers[ifi])
+					})),
+					avk::command::draw_indexed(mIndexBufferScreenspace.as_reference(), mVertexBufferScreenspace.as_reference())
+				))
+			});
 
 		//2.5 Blur SSAO Result
-		avk::context().record({
-			avk::command::render_pass(mPipelineSSAOBlur->renderpass_reference(), mSSAOBlurFramebuffer.as_reference(), avk::command::gather(
-				avk::command::bind_pipeline(mPipelineSSAOBlur.as_reference()),
-				avk::command::bind_descriptors(mPipelineSSAOBlur->layout(), mDescriptorCache->get_or_create_descriptor_sets({
-					avk::descriptor_binding(0, 0, mImageSamplerSSAOFBColor->as_combined_image_sampler(avk::layout::attachment_optimal)),
-					avk::descriptor_binding(0, 1, mSSAOBuffer)
-				})),
-				avk::command::draw_indexed(mIndexBufferScreenspace.as_reference(), mVertexBufferScreenspace.as_reference())
-			))
-		})
-		.into_command_buffer(cmdBfrs[2])
-		.then_submit_to(*mQueue)
-		.waiting_for(ssaoComplete >> avk::stage::color_attachment_output)
-		.signaling_upon_completion(avk::stage::color_attachment_output >> ssaoBComplete)
-		.submit();
-		cmdBfrs[2]->handle_lifetime_of(std::move(ssaoComplete));
+		resolve_pipeline(mPipelineSSAOBlurFuture, mPipelineSSAOBlur);
+		mRenderGraph->add_pass("SSAO blur")
+			.reading(mImageSamplerSSAOFBColor)
+			.rendering_into(mSSAOBlurFramebuffer.as_reference())
+			.recording({
+				avk::command::render_pass(mPipelineSSAOBlur->renderpass_reference(), mSSAOBlurFramebuffer.as_reference(), avk::command::gather(
+					avk::command::bind_pipeline(mPipelineSSAOBlur.as_reference()),
+					avk::command::bind_descriptors(mPipelineSSAOBlur->layout(), mDescriptorCache->get_or_create_descriptor_sets({
+						avk::descriptor_binding(0, 0, mImageSamplerSSAOFBColor->as_combined_image_sampler(avk::layout::attachment_optimal)),
+						avk::descriptor_binding(0, 1, mSSAOBuffers[ifi])
+					})),
+					avk::command::draw_indexed(mIndexBufferScreenspace.as_reference(), mVertexBufferScreenspace.as_reference())
+				))
+			});
 
 		//Illuminate the scene
-		avk::context().record({
-			avk::command::render_pass(mPipelineIllumination->renderpass_reference(), mIlluminationFramebuffer.as_reference(), avk::command::gather(
-				avk::command::bind_pipeline(mPipelineIllumination.as_reference()),
-				avk::command::bind_descriptors(mPipelineIllumination->layout(), mDescriptorCache->get_or_create_descriptor_sets({
-					avk::descriptor_binding(0, 0, mImageSamplerSSAOBlurFBColor->as_combined_image_sampler(avk::layout::attachment_optimal)),
-					avk::descriptor_binding(0, 1, mImageSamplerRasterFBPositionWS->as_combined_image_sampler(avk::layout::attachment_optimal)),
-					avk::descriptor_binding(0, 2, mImageSamplerRasterFBNormals->as_combined_image_sampler(avk::layout::attachment_optimal)),
-					avk::descriptor_binding(0, 3, mImageSamplerRasterFBColor->as_combined_image_sampler(avk::layout::attachment_optimal)),
-					avk::descriptor_binding(0, 4, mImageSamplerRasterFBDepth->as_combined_image_sampler(avk::layout::attachment_optimal)),
-					avk::descriptor_binding(0, 5, mSSAOBuffer),
-					avk::descriptor_binding(0, 6, mCameraData),
-				})),
-				avk::command::draw_indexed(mIndexBufferScreenspace.as_reference(), mVertexBufferScreenspace.as_reference())
-			))
-			})
-			.into_command_buffer(cmdBfrs[3])
-			.then_submit_to(*mQueue)
-			.waiting_for(ssaoBComplete >> avk::stage::color_attachment_output)
-			.signaling_upon_completion(avk::stage::color_attachment_output >> illumComplete)
-			.signaling_upon_completion(avk::stage::color_attachment_output >> illumComplete2)
-			.signaling_upon_completion(avk::stage::color_attachment_output >> illumComplete3)
-			.submit();
-		cmdBfrs[3]->handle_lifetime_of(std::move(ssaoBComplete));
-
+		resolve_pipeline(mPipelineIlluminationFuture, mPipelineIllumination);
+		mRenderGraph->add_pass("Illumination")
+			.reading(mImageSamplerSSAOBlurFBColor, gbuffer_position_ws_sampler(), gbuffer_normals_ws_sampler(), mImageSamplerRasterFBColor, mImageSamplerRasterFBDepth)
+			.rendering_into(mIlluminationFramebuffer.as_reference())
+			.recording({
+				avk::command::render_pass(mPipelineIllumination->renderpass_reference(), mIlluminationFramebuffer.as_reference(), avk::command::gather(
+					avk::command::bind_pipeline(mPipelineIllumination.as_reference()),
+					avk::command::bind_descriptors(mPipelineIllumination->layout(), mDescriptorCache->get_or_create_descriptor_sets({
+						avk::descriptor_binding(0, 0, mImageSamplerSSAOBlurFBColor->as_combined_image_sampler(avk::layout::attachment_optimal)),
+						avk::descriptor_binding(0, 1, gbuffer_position_ws_sampler()->as_combined_image_sampler(avk::layout::attachment_optimal)),
+						avk::descriptor_binding(0, 2, gbuffer_normals_ws_sampler()->as_combined_image_sampler(avk::layout::attachment_optimal)),
+						avk::descriptor_binding(0, 3, mImageSamplerRasterFBColor->as_combined_image_sampler(avk::layout::attachment_optimal)),
+						avk::descriptor_binding(0, 4, mImageSamplerRasterFBDepth->as_combined_image_sampler(avk::layout::attachment_optimal)),
+						avk::descriptor_binding(0, 5, mSSAOBuffers[ifi]),
+						avk::descriptor_binding(0, 6, mCameraDataBuffers[ifi]),
+						avk::descriptor_binding(0, 7, mVpMatricesBuffers[ifi])
+					})),
+					avk::command::draw_indexed(mIndexBufferScreenspace.as_reference(), mVertexBufferScreenspace.as_reference())
+				))
+			});
 
 		// Render Near Field for DoF
-		avk::context().record({
-			avk::command::render_pass(mPipelineDofNear->renderpass_reference(), mDofNearFieldFB.as_reference(), avk::command::gather(
-				avk::command::bind_pipeline(mPipelineDofNear.as_reference()),
-				avk::command::bind_descriptors(mPipelineDofNear->layout(), mDescriptorCache->get_or_create_descriptor_sets({
-					avk::descriptor_binding(0, 0, mImageSamplerIlluminationFBColor->as_combined_image_sampler(avk::layout::attachment_optimal)),
-					avk::descriptor_binding(0, 1, mImageSamplerRasterFBDepth->as_combined_image_sampler(avk::layout::attachment_optimal)),
-					avk::descriptor_binding(0, 2, mDoFBuffer)
-				})),
-				avk::command::draw_indexed(mIndexBufferScreenspace.as_reference(), mVertexBufferScreenspace.as_reference())
-			)),
-		})
-		.into_command_buffer(cmdBfrs[4])
-		.then_submit_to(*mQueue)
-		.waiting_for(illumComplete >> avk::stage::color_attachment_output)
-		.signaling_upon_completion(avk::stage::color_attachment_output >> dofNearComplete)
-		.submit();
-		// Let the command buffer handle the semaphore lifetimes:
-		cmdBfrs[4]->handle_lifetime_of(std::move(illumComplete));
+		resolve_pipeline(mPipelineDofNearFuture, mPipelineDofNear);
+		mRenderGraph->add_pass("DoF near field")
+			.reading(mImageSamplerIlluminationFBColor, mImageSamplerRasterFBDepth)
+			.rendering_into(mDofNearFieldFB.as_reference())
+			.recording({
+				avk::command::render_pass(mPipelineDofNear->renderpass_reference(), mDofNearFieldFB.as_reference(), avk::command::gather(
+					avk::command::bind_pipeline(mPipelineDofNear.as_reference()),
+					avk::command::bind_descriptors(mPipelineDofNear->layout(), mDescriptorCache->get_or_create_descriptor_sets({
+						avk::descriptor_binding(0, 0, mImageSamplerIlluminationFBColor->as_combined_image_sampler(avk::layout::attachment_optimal)),
+						avk::descriptor_binding(0, 1, mImageSamplerRasterFBDepth->as_combined_image_sampler(avk::layout::attachment_optimal)),
+						avk::descriptor_binding(0, 2, mDoFBuffers[ifi])
+					})),
+					avk::command::draw_indexed(mIndexBufferScreenspace.as_reference(), mVertexBufferScreenspace.as_reference())
+				)),
+			});
 
 		//Bleed Near Field for DoF
-		avk::context().record({
-			avk::command::render_pass(mPipelineDofNearBleed->renderpass_reference(), mDofNearFieldBleedFB.as_reference(), avk::command::gather(
-				avk::command::bind_pipeline(mPipelineDofNearBleed.as_reference()),
-				avk::command::bind_descriptors(mPipelineDofNearBleed->layout(), mDescriptorCache->get_or_create_descriptor_sets({
-					avk::descriptor_binding(0, 0, mImageSamplerDofNearColor->as_combined_image_sampler(avk::layout::attachment_optimal)),
-				})),
-				avk::command::draw_indexed(mIndexBufferScreenspace.as_reference(), mVertexBufferScreenspace.as_reference())
-			)),
-		})
-		.into_command_buffer(cmdBfrs[5])
-		.then_submit_to(*mQueue)
-		.waiting_for(dofNearComplete >> avk::stage::color_attachment_output)
-		.signaling_upon_completion(avk::stage::color_attachment_output >> dofNearBleedComplete)
-		.submit();
-		// Let the command buffer handle the semaphore lifetimes:
-		cmdBfrs[5]->handle_lifetime_of(std::move(dofNearComplete));
+		resolve_pipeline(mPipelineDofNearBleedFuture, mPipelineDofNearBleed);
+		mRenderGraph->add_pass("DoF near field bleed")
+			.reading(mImageSamplerDofNearColor)
+			.rendering_into(mDofNearFieldBleedFB.as_reference())
+			.recording({
+				avk::command::render_pass(mPipelineDofNearBleed->renderpass_reference(), mDofNearFieldBleedFB.as_reference(), avk::command::gather(
+					avk::command::bind_pipeline(mPipelineDofNearBleed.as_reference()),
+					avk::command::bind_descriptors(mPipelineDofNearBleed->layout(), mDescriptorCache->get_or_create_descriptor_sets({
+						avk::descriptor_binding(0, 0, mImageSamplerDofNearColor->as_combined_image_sampler(avk::layout::attachment_optimal)),
+					})),
+					avk::command::draw_indexed(mIndexBufferScreenspace.as_reference(), mVertexBufferScreenspace.as_reference())
+				)),
+			});
 
 		//3. Render Center Field for DoF
-		avk::context().record({
-			avk::command::render_pass(mPipelineDofCenter->renderpass_reference(), mDofCenterFieldFB.as_reference(), avk::command::gather(
-				avk::command::bind_pipeline(mPipelineDofCenter.as_reference()),
-				avk::command::bind_descriptors(mPipelineDofCenter->layout(), mDescriptorCache->get_or_create_descriptor_sets({
-					avk::descriptor_binding(0, 0, mImageSamplerIlluminationFBColor->as_combined_image_sampler(avk::layout::attachment_optimal)),
-					avk::descriptor_binding(0, 1, mImageSamplerRasterFBDepth->as_combined_image_sampler(avk::layout::attachment_optimal)),
-					avk::descriptor_binding(0, 2, mDoFBuffer)
-				})),
-				avk::command::draw_indexed(mIndexBufferScreenspace.as_reference(), mVertexBufferScreenspace.as_reference())
-			)),
-		})
-		.into_command_buffer(cmdBfrs[6])
-		.then_submit_to(*mQueue)
-		.waiting_for(illumComplete3 >> avk::stage::color_attachment_output)
-		.signaling_upon_completion(avk::stage::color_attachment_output >> dofCenterComplete)
-		.submit();
-		// Let the command buffer handle the semaphore lifetimes:
-		cmdBfrs[6]->handle_lifetime_of(std::move(illumComplete3));
-
+		resolve_pipeline(mPipelineDofCenterFuture, mPipelineDofCenter);
+		mRenderGraph->add_pass("DoF center field")
+			.reading(mImageSamplerIlluminationFBColor, mImageSamplerRasterFBDepth)
+			.rendering_into(mDofCenterFieldFB.as_reference())
+			.recording({
+				avk::command::render_pass(mPipelineDofCenter->renderpass_reference(), mDofCenterFieldFB.as_reference(), avk::command::gather(
+					avk::command::bind_pipeline(mPipelineDofCenter.as_reference()),
+					avk::command::bind_descriptors(mPipelineDofCenter->layout(), mDescriptorCache->get_or_create_descriptor_sets({
+						avk::descriptor_binding(0, 0, mImageSamplerIlluminationFBColor->as_combined_image_sampler(avk::layout::attachment_optimal)),
+						avk::descriptor_binding(0, 1, mImageSamplerRasterFBDepth->as_combined_image_sampler(avk::layout::attachment_optimal)),
+						avk::descriptor_binding(0, 2, mDoFBuffers[ifi])
+					})),
+					avk::command::draw_indexed(mIndexBufferScreenspace.as_reference(), mVertexBufferScreenspace.as_reference())
+				)),
+			});
 
 		//4. Render Far Field for DoF
-		avk::context().record({
-			avk::command::render_pass(mPipelineDofFar->renderpass_reference(), mDofFarFieldFB.as_reference(), avk::command::gather(
-				avk::command::bind_pipeline(mPipelineDofFar.as_reference()),
-				avk::command::bind_descriptors(mPipelineDofFar->layout(), mDescriptorCache->get_or_create_descriptor_sets({
-					avk::descriptor_binding(0, 0, mImageSamplerIlluminationFBColor->as_combined_image_sampler(avk::layout::attachment_optimal)),
-					avk::descriptor_binding(0, 1, mImageSamplerRasterFBDepth->as_combined_image_sampler(avk::layout::attachment_optimal)),
-					avk::descriptor_binding(0, 2, mDoFBuffer)
-				})),
-				avk::command::draw_indexed(mIndexBufferScreenspace.as_reference(), mVertexBufferScreenspace.as_reference())
-			)),
-		})
-		.into_command_buffer(cmdBfrs[7])
-		.then_submit_to(*mQueue)
-		.waiting_for(illumComplete2 >> avk::stage::color_attachment_output)
-		.signaling_upon_completion(avk::stage::color_attachment_output >> dofFarComplete)
-		.submit();
-		// Let the command buffer handle the semaphore lifetimes:
-		cmdBfrs[7]->handle_lifetime_of(std::move(illumComplete2));
+		resolve_pipeline(mPipelineDofFarFuture, mPipelineDofFar);
+		mRenderGraph->add_pass("DoF far field")
+			.reading(mImageSamplerIlluminationFBColor, mImageSamplerRasterFBDepth)
+			.rendering_into(mDofFarFieldFB.as_reference())
+			.recording({
+				avk::command::render_pass(mPipelineDofFar->renderpass_reference(), mDofFarFieldFB.as_reference(), avk::command::gather(
+					avk::command::bind_pipeline(mPipelineDofFar.as_reference()),
+					avk::command::bind_descriptors(mPipelineDofFar->layout(), mDescriptorCache->get_or_create_descriptor_sets({
+						avk::descriptor_binding(0, 0, mImageSamplerIlluminationFBColor->as_combined_image_sampler(avk::layout::attachment_optimal)),
+						avk::descriptor_binding(0, 1, mImageSamplerRasterFBDepth->as_combined_image_sampler(avk::layout::attachment_optimal)),
+						avk::descriptor_binding(0, 2, mDoFBuffers[ifi])
+					})),
+					avk::command::draw_indexed(mIndexBufferScreenspace.as_reference(), mVertexBufferScreenspace.as_reference())
+				)),
+			});
 		
 		//5. Render Final DoF
-		avk::context().record({
-			avk::command::render_pass(mPipelineDofFinal->renderpass_reference(), avk::context().main_window()->current_backbuffer_reference(), avk::command::gather(
-				avk::command::bind_pipeline(mPipelineDofFinal.as_reference()),
-				avk::command::bind_descriptors(mPipelineDofFinal->layout(), mDescriptorCache->get_or_create_descriptor_sets({
-					avk::descriptor_binding(0, 0, mImageSamplerIlluminationFBColor->as_combined_image_sampler(avk::layout::attachment_optimal)),
-					avk::descriptor_binding(0, 1, mImageSamplerDofNearBleedColor->as_combined_image_sampler(avk::layout::attachment_optimal)),
-					avk::descriptor_binding(0, 2, mImageSamplerDofCenterColor->as_combined_image_sampler(avk::layout::attachment_optimal)),
-					avk::descriptor_binding(0, 3, mImageSamplerDofFarColor->as_combined_image_sampler(avk::layout::attachment_optimal)),
-					avk::descriptor_binding(0, 4, mImageSamplerRasterFBDepth->as_combined_image_sampler(avk::layout::attachment_optimal)),
-					avk::descriptor_binding(0, 5, mDoFBuffer),
-					avk::descriptor_binding(1, 0, mDoFKernelBufferGaussian),
-					avk::descriptor_binding(1, 1, mDoFKernelBufferBokeh)
-				})),
-				avk::command::draw_indexed(mIndexBufferScreenspace.as_reference(), mVertexBufferScreenspace.as_reference())
-			)),
-		})
-		.into_command_buffer(cmdBfrs[8])
-		.then_submit_to(*mQueue)
-		.waiting_for(dofFarComplete >> avk::stage::color_attachment_output)
-		.waiting_for(dofNearBleedComplete >> avk::stage::color_attachment_output)
-		.waiting_for(dofCenterComplete >> avk::stage::color_attachment_output)
-		.submit();
-		// Let the command buffer handle the semaphore lifetimes:
-		cmdBfrs[8]->handle_lifetime_of(std::move(dofFarComplete));
-		cmdBfrs[8]->handle_lifetime_of(std::move(dofNearBleedComplete));
-		cmdBfrs[8]->handle_lifetime_of(std::move(dofCenterComplete));
+		resolve_pipeline(mPipelineDofFinalFuture, mPipelineDofFinal);
+		auto& finalPass = mRenderGraph->add_pass("DoF composition")
+			.reading(mImageSamplerIlluminationFBColor, mImageSamplerDofNearBleedColor, mImageSamplerDofCenterColor, mImageSamplerDofFarColor, mImageSamplerRasterFBDepth)
+			.rendering_into(mTarget->current_backbuffer_reference());
+		if (imageAvailable.has_value()) {
+			// Do not start to render before the image has become available:
+			finalPass.waiting_for(imageAvailable.value() >> avk::stage::color_attachment_output);
+		}
+		finalPass
+			.recording({
+				avk::command::render_pass(mPipelineDofFinal->renderpass_reference(), mTarget->current_backbuffer_reference(), avk::command::gather(
+					avk::command::bind_pipeline(mPipelineDofFinal.as_reference()),
+					avk::command::bind_descriptors(mPipelineDofFinal->layout(), mDescriptorCache->get_or_create_descriptor_sets({
+						avk::descriptor_binding(0, 0, mImageSamplerIlluminationFBColor->as_combined_image_sampler(avk::layout::attachment_optimal)),
+						avk::descriptor_binding(0, 1, mImageSamplerDofNearBleedColor->as_combined_image_sampler(avk::layout::attachment_optimal)),
+						avk::descriptor_binding(0, 2, mImageSamplerDofCenterColor->as_combined_image_sampler(avk::layout::attachment_optimal)),
+						avk::descriptor_binding(0, 3, mImageSamplerDofFarColor->as_combined_image_sampler(avk::layout::attachment_optimal)),
+						avk::descriptor_binding(0, 4, mImageSamplerRasterFBDepth->as_combined_image_sampler(avk::layout::attachment_optimal)),
+						avk::descriptor_binding(0, 5, mDoFBuffers[ifi]),
+						avk::descriptor_binding(1, 0, mDoFKernelBufferGaussian),
+						avk::descriptor_binding(1, 1, mDoFKernelBufferBokeh)
+					})),
+					avk::command::draw_indexed(mIndexBufferScreenspace.as_reference(), mVertexBufferScreenspace.as_reference())
+				)),
+			});
 
-		
-		// Use a convenience function of avk::window to take care of the command buffers lifetimes:
-		// They will get deleted in the future after #concurrent-frames have passed by.
-		avk::context().main_window()->handle_lifetime(std::move(cmdBfrs[0]));
-		avk::context().main_window()->handle_lifetime(std::move(cmdBfrs[1]));
-		avk::context().main_window()->handle_lifetime(std::move(cmdBfrs[2]));
-		avk::context().main_window()->handle_lifetime(std::move(cmdBfrs[3]));
-		avk::context().main_window()->handle_lifetime(std::move(cmdBfrs[4]));
-		avk::context().main_window()->handle_lifetime(std::move(cmdBfrs[5]));
-		avk::context().main_window()->handle_lifetime(std::move(cmdBfrs[6]));
-		avk::context().main_window()->handle_lifetime(std::move(cmdBfrs[7]));
-		avk::context().main_window()->handle_lifetime(std::move(cmdBfrs[8]));
+		mRenderGraph->execute(*mFrameResources);
+
+		// The passes above have resolved all pipelines in the first frame:
+		if (mPipelinesBegin.has_value()) {
+			LOG_INFO(std::format("Pipelines ready after {:.1f} ms, overlapped with loading the scene and recording the first frame, on {} threads, {:.1f} ms in the driver in total ({})",
+				std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - mPipelinesBegin.value()).count(),
+				mPipelineCompiler->num_threads(),
+				std::chrono::duration<double, std::milli>(avk::context().pipeline_creation_time()).count(),
+				avk::context().pipeline_cache_loaded_from_file() ? "warm start, pipeline cache loaded from file" : "cold start"));
+			mPipelinesBegin.reset();
+			set_up_updater();
+		}
+
+		// Only frames which follow the camera path are part of the benchmark:
+		if (mBenchmark.has_value() && mCameraPath.has_value()) {
+			mBenchmark->record_cpu_time(currentFrame, mCpuMillisecondsInUpdate + std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - cpuBegin).count());
+		}
+		mTarget->end_frame();
+	}
 
+	/** Writes the benchmark report after all frames have completed, and ends the application */
+	void finish_benchmark()
+	{
+		avk::context().device().waitIdle();
+		mGpuProfiler->flush();
+		mBenchmark->write_json(mStartOptions.benchmarkReportFile);
+		mBenchmark.reset();
+		avk::current_composition()->stop();
 	}
 
 	void toggle_auto_camera_path()
@@ -1430,6 +1742,7 @@ public: // v== avk::invokee overrides which will be invoked by the framework ==v
 
 	void update() override
 	{
+		const auto cpuBegin = std::chrono::high_resolution_clock::now();
 		static int counter = 0;
 		if (++counter == 4) {
 			auto current = std::chrono::high_resolution_clock::now();
@@ -1439,6 +1752,10 @@ public: // v== avk::invokee overrides which will be invoked by the framework ==v
 			auto fp_ms = std::chrono::duration<double, std::milli>(time_span).count();
 			printf("Time from init to fourth frame: %d min, %lld sec %lf ms\n", int_min, int_sec - static_cast<decltype(int_sec)>(int_min) * 60, fp_ms - 1000.0 * int_sec);
 			toggle_auto_camera_path();
+			if (mBenchmark.has_value()) {
+				// Visit the same views in every run, regardless of the frame rate:
+				mCameraPath->use_fixed_steps(mBenchmark->num_frames());
+			}
 		}
 
 		if (avk::input().key_pressed(avk::key_code::c)) {
@@ -1446,7 +1763,7 @@ public: // v== avk::invokee overrides which will be invoked by the framework ==v
 			auto resolution = avk::context().main_window()->resolution();
 			avk::context().main_window()->set_cursor_pos({ resolution[0] / 2.0, resolution[1] / 2.0 });
 		}
-		if (!mQuakeCam.is_enabled() && avk::input().key_pressed(avk::key_code::escape) || avk::context().main_window()->should_be_closed()) {
+		if (!mQuakeCam.is_enabled() && avk::input().key_pressed(avk::key_code::escape) || (!mTarget->is_headless() && avk::context().main_window()->should_be_closed())) {
 			// Stop the current composition:
 			avk::current_composition()->stop();
 		}
@@ -1492,6 +1809,9 @@ public: // v== avk::invokee overrides which will be invoked by the framework ==v
 		if(avk::input().key_pressed(avk::key_code::f)) {
 			toggle_auto_camera_path();
 		}
+		if (mBenchmark.has_value() && mCameraPath.has_value() && mCameraPath->has_completed_once()) {
+			finish_benchmark();
+		}
 		if (mCameraPath.has_value()) {
 			mCameraPath->update();
 		}
@@ -1520,19 +1840,25 @@ public: // v== avk::invokee overrides which will be invoked by the framework ==v
 		// 		avk::current_composition()->add_element(mCameraPath.value());
 		// 	}
 		// }
+
+		mCpuMillisecondsInUpdate = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - cpuBegin).count();
 	}
 
 private: // v== Member variables ==v
 
 	std::chrono::high_resolution_clock::time_point mInitTime;
+	// CPU time which has been spent in update() in the current frame:
+	double mCpuMillisecondsInUpdate = 0.0;
+	std::optional<benchmark_recorder> mBenchmark;
 
 	//skybox
 	avk::image_sampler mImageSamplerCubemap;
 	
 	std::vector<data_for_draw_call> mDrawCallsSkybox;
 	avk::graphics_pipeline mPipelineSkybox;
+	std::future<avk::graphics_pipeline> mPipelineSkyboxFuture;
 
-	avk::buffer mViewProjBufferSkybox;
+	std::array<avk::buffer, 10> mViewProjBuffersSkybox;
 
 	//scene:
 
@@ -1542,9 +1868,36 @@ private: // v== Member variables ==v
 	std::array<avk::buffer, 10> mViewProjBuffers;
 	avk::buffer mMaterialBuffer;
 	std::vector<avk::image_sampler> mImageSamplers;
+	// Written by the rasterization shaders, but not read, if the textures are not streamed:
+	avk::buffer mMipFeedbackBuffer;
 
 	std::vector<data_for_draw_call> mDrawCalls;
+	// All draw calls' geometry is suballocated from these:
+	avk::buffer mScenePositionsBuffer;
+	avk::buffer mSceneTexCoordsBuffer;
+	avk::buffer mSceneNormalsBuffer;
+	// The only vertex buffer if the vertex format is vertex_format::interleaved_quantized:
+	avk::buffer mScenePackedVerticesBuffer;
+	avk::buffer mSceneIndexBuffer;
+	// One entry per draw call:
+	avk::buffer mPerDrawDataBuffer;
+	avk::buffer mDrawCommandsBuffer;
+	// Draw the whole scene with one vkCmdDrawIndexedIndirect instead of one draw call per material:
+	bool mMultiDrawIndirect = true;
+	// Compiles all pipelines concurrently, and stays alive until they have been taken from their futures (see resolve_pipeline):
+	std::unique_ptr<avk::pipeline_compiler> mPipelineCompiler;
+	// When the compilation has started, until the first frame has resolved all pipelines:
+	std::optional<std::chrono::steady_clock::time_point> mPipelinesBegin;
+	std::unique_ptr<gpu_culling> mGpuCulling;
+	bool mGpuCullingEnabled = true;
+	bool mOcclusionCullingEnabled = true;
+	// The main window's back buffers, or an offscreen framebuffer if there is no window (see --benchmark):
+	std::optional<frame_target> mTarget;
+	std::optional<frame_resource_pool> mFrameResources;
+	std::optional<render_graph> mRenderGraph;
+	std::optional<gpu_profiler> mGpuProfiler;
 	avk::graphics_pipeline mRasterizePipeline;
+	std::future<avk::graphics_pipeline> mRasterizePipelineFuture;
     glm::vec3 mScale;
 
 	avk::orbit_camera mOrbitCam;
@@ -1555,7 +1908,7 @@ private: // v== Member variables ==v
 
 	//1. rasterizer
 	avk::framebuffer mRasterizerFramebuffer;//Rasterizer and skybox render into this
-	avk::buffer mViewProjBuffer;
+	std::array<avk::buffer, 10> mVpMatricesBuffers;
 	avk::image_sampler mImageSamplerRasterFBColor;
 	avk::image_sampler mImageSamplerRasterFBDepth;
 	avk::image_sampler mImageSamplerRasterFBPosition;
@@ -1565,45 +1918,53 @@ private: // v== Member variables ==v
 
 	//2. SSAO 1. pass (create ssao effect)
 	avk::graphics_pipeline mPipelineSSAO;//renders into ssaoFramebuffer
+	std::future<avk::graphics_pipeline> mPipelineSSAOFuture;
 	avk::framebuffer mSSAOFramebuffer;//SSAO renders into this
-	avk::buffer mSSAOBuffer;
+	std::array<avk::buffer, 10> mSSAOBuffers;
 	avk::image_sampler mImageSamplerSSAOFBColor;
 
 	//2.5 SSAO 2. pass (blur result)
 	avk::graphics_pipeline mPipelineSSAOBlur;
+	std::future<avk::graphics_pipeline> mPipelineSSAOBlurFuture;
 	avk::framebuffer mSSAOBlurFramebuffer;
 	avk::image_sampler mImageSamplerSSAOBlurFBColor;
 
 	//Illumination pass (use ssao output)
 	avk::graphics_pipeline mPipelineIllumination;
+	std::future<avk::graphics_pipeline> mPipelineIlluminationFuture;
 	avk::framebuffer mIlluminationFramebuffer;
 	avk::image_sampler mImageSamplerIlluminationFBColor;
-	avk::buffer mCameraData;
+	std::array<avk::buffer, 10> mCameraDataBuffers;
 
 	//3. DoF 1. pass (renders near field into mDofNearFieldFB)
 	avk::graphics_pipeline mPipelineDofNear;//renders into mDofNearFieldFB
+	std::future<avk::graphics_pipeline> mPipelineDofNearFuture;
 	avk::framebuffer mDofNearFieldFB;//Dof1 renders into this
 	avk::image_sampler mImageSamplerDofNearColor;
 
 	//3.25 DoF 1.25 pass (bleeds nearField with a max filter)
 	avk::graphics_pipeline mPipelineDofNearBleed;//renders into mDofNearFieldFB
+	std::future<avk::graphics_pipeline> mPipelineDofNearBleedFuture;
 	avk::framebuffer mDofNearFieldBleedFB;//Dof1 renders into this
 	avk::image_sampler mImageSamplerDofNearBleedColor;
 
 	//3.5 DoF 1.5 pass (renders center field into  mDofCenterFieldFB)
 	avk::graphics_pipeline mPipelineDofCenter;//renders into mDofCenterFieldFB
+	std::future<avk::graphics_pipeline> mPipelineDofCenterFuture;
 	avk::framebuffer mDofCenterFieldFB;//Dof1 renders into this
 	avk::image_sampler mImageSamplerDofCenterColor;
 
 	//4. DoF 2. pass (renders far field into mDofFarFieldFB)
 	avk::graphics_pipeline mPipelineDofFar;//renders into mDofFarFieldFB
+	std::future<avk::graphics_pipeline> mPipelineDofFarFuture;
 	avk::framebuffer mDofFarFieldFB;//Dof2 renders into this
 	avk::image_sampler mImageSamplerDofFarColor;
 	
 	//5. DoF 3. pass (renders blurred image into main window) - uses near field, far field, depth buffer
 	avk::graphics_pipeline mPipelineDofFinal;//renders directly to the screen
+	std::future<avk::graphics_pipeline> mPipelineDofFinalFuture;
 	
-	avk::buffer mDoFBuffer;
+	std::array<avk::buffer, 10> mDoFBuffers;
 	avk::buffer mDoFKernelBufferGaussian;//gaussian
 	avk::buffer mDoFKernelBufferBokeh;
 
@@ -1611,6 +1972,15 @@ private: // v== Member variables ==v
 	//general screenspace quad
 	avk::buffer mVertexBufferScreenspace;
 	avk::buffer mIndexBufferScreenspace;
+
+	// Uploads through the transfer queue, if the device has one. Declared after the resources which it uploads into:
+	avk::queue* mTransferQueue;
+	std::optional<upload_batcher> mUploader;
+	uint64_t mSceneUploadTicket = 0;
+	// Uploads of the materials' textures and the skybox, which the first frame records before anything uses them:
+	std::vector<avk::recorded_commands_t> mPendingUploadCommands;
+	// Only if the textures are streamed; mImageSamplers is empty then:
+	std::optional<texture_streamer> mTextureStreamer;
 	
 	// imgui elements
 	std::optional<combo_box_container> mPresentationModeCombo;
@@ -1658,6 +2028,17 @@ void load_start_options()
 //
 // [scene]
 // model=fullScene.fbx
+// optimizeMeshes=1
+// packVertices=1
+// bakeTextures=1
+// streamTextures=1
+// textureBudgetMiB=512
+//
+// [rendering]
+// compactGBuffer=1
+//
+// [profiler]
+// csv=gpu_timings.csv
 {
 	LPCSTR ini = "./settings.ini";
 	startOptions options;
@@ -1675,20 +2056,118 @@ void load_start_options()
 		ini               // Path to the ini file
 	);
 	options.sceneFile = sceneFileBuffer; // Assign retrieved string to the structure
+	options.optimizeMeshes = GetPrivateProfileIntA("scene", "optimizeMeshes", 1, ini);
+	options.vertexFormat = GetPrivateProfileIntA("scene", "packVertices", 1, ini) ? vertex_format::interleaved_quantized : vertex_format::separate_full_precision;
+	options.bakeTextures = GetPrivateProfileIntA("scene", "bakeTextures", 1, ini);
+	options.streamTextures = GetPrivateProfileIntA("scene", "streamTextures", 1, ini);
+	options.textureBudgetMiB = GetPrivateProfileIntA("scene", "textureBudgetMiB", 512, ini);
+	options.gbufferFormat = GetPrivateProfileIntA("rendering", "compactGBuffer", 1, ini) ? gbuffer_format::compact : gbuffer_format::full_precision;
+
+	// Optional CSV file which receives the GPU time of every pass, per frame:
+	char csvFileBuffer[256];
+	GetPrivateProfileStringA("profiler", "csv", "", csvFileBuffer, sizeof(csvFileBuffer), ini);
+	options.gpuTimingsCsvFile = csvFileBuffer;
 
 	// Debug output to verify the loaded values
 	std::cout << "Full Screen: " << options.fullScreen << "\n";
 	std::cout << "Width: " << options.width << "\n";
 	std::cout << "Height: " << options.height << "\n";
 	std::cout << "Scene File: " << options.sceneFile << "\n";
+	std::cout << "Optimize Meshes: " << options.optimizeMeshes << "\n";
+	std::cout << "Pack Vertices: " << (vertex_format::interleaved_quantized == options.vertexFormat) << "\n";
+	std::cout << "Bake Textures: " << options.bakeTextures << "\n";
+	std::cout << "Stream Textures: " << options.streamTextures << " (budget: " << options.textureBudgetMiB << " MiB)\n";
+	std::cout << "Compact G-Buffer: " << (gbuffer_format::compact == options.gbufferFormat) << "\n";
+	if (!options.gpuTimingsCsvFile.empty()) {
+		std::cout << "GPU Timings CSV File: " << options.gpuTimingsCsvFile << "\n";
+	}
 	mStartOptions = options;
 }
 
-int main() // <== Starting point ==
+// Command line arguments:
+//   --benchmark [numFrames]      Traverses the camera path once in numFrames frames (default: 1000) without a window,
+//                                writes a JSON report, and exits. The frames are rendered into an offscreen framebuffer
+//                                of the configured resolution, i.e., there is no swapchain, no presentation and no
+//                                vsync, and no display is needed.
+//   --benchmark-report <path>    Path of the report (default: benchmark_report.json)
+void parse_command_line(int argc, char** argv)
+{
+	for (int i = 1; i < argc; ++i) {
+		const std::string arg = argv[i];
+		if (arg == "--benchmark") {
+			mStartOptions.benchmarkFrames = 1000u;
+			if (i + 1 < argc && std::isdigit(static_cast<unsigned char>(argv[i + 1][0]))) {
+				mStartOptions.benchmarkFrames = static_cast<uint32_t>(std::stoul(argv[++i]));
+			}
+		}
+		else if (arg == "--benchmark-report" && i + 1 < argc) {
+			mStartOptions.benchmarkReportFile = argv[++i];
+		}
+	}
+	if (mStartOptions.benchmarkFrames > 0) {
+		std::cout << "Benchmark: " << mStartOptions.benchmarkFrames << " frames, report: " << mStartOptions.benchmarkReportFile << "\n";
+	}
+}
+
+// Compiles all the configuration parameters, and the given windows and invokees into a "composition":
+template <typename... Ts>
+avk::composition compose_demo(Ts&&... aWindowsAndInvokees)
+{
+	return configure_and_compose(
+		avk::application_name("4-Seasons Demo"),
+		[](avk::validation_layers& config) {
+			config.enable_feature(vk::ValidationFeatureEnableEXT::eSynchronizationValidation);
+		},
+		// Lets the benchmark report the memory budget of the driver instead of VMA's estimate, if supported:
+		avk::optional_device_extensions(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME),
+		// Vulkan Device Features 1.0 (drawing the whole scene with one indirect draw call, and writing the mip feedback of the textures)
+		[](vk::PhysicalDeviceFeatures& features) {
+			features.setMultiDrawIndirect(VK_TRUE);
+			features.setDrawIndirectFirstInstance(VK_TRUE);
+			features.setFragmentStoresAndAtomics(VK_TRUE);
+		},
+		// Vulkan Device Features 1.2
+		[](vk::PhysicalDeviceVulkan12Features& features) {
+			features.setSeparateDepthStencilLayouts(VK_TRUE);
+			features.setDrawIndirectCount(VK_TRUE);
+			features.setTimelineSemaphore(VK_TRUE);
+		},
+		// Pass windows and invokees:
+		std::forward<Ts>(aWindowsAndInvokees)...
+	);
+}
+
+// Renders the benchmark into an offscreen framebuffer, without a window (see --benchmark):
+void run_headless_benchmark()
+{
+	auto& singleQueue = avk::context().create_queue();
+	auto& transferQueue = avk::context().create_queue(vk::QueueFlagBits::eTransfer, avk::queue_selection_preference::specialized_queue);
+	auto app = model_loader_app(singleQueue, transferQueue);
+	auto composition = compose_demo(app);
+
+	avk::sequential_invoker invoker;
+	// Loops on this thread until the benchmark has finished. model_loader_app throttles the frames itself (see frame_target):
+	composition.start_headless_render_loop(
+		[&invoker](const std::vector<avk::invokee*>& aToBeInvoked) {
+			invoker.invoke_updates(aToBeInvoked);
+		},
+		[&invoker](const std::vector<avk::invokee*>& aToBeInvoked) {
+			invoker.invoke_renders(aToBeInvoked);
+		}
+	);
+}
+
+int main(int argc, char** argv) // <== Starting point ==
 {
 	load_start_options();
+	parse_command_line(argc, argv);
 	int result = EXIT_FAILURE;
 	try {
+		if (mStartOptions.benchmarkFrames > 0) {
+			run_headless_benchmark();
+			return EXIT_SUCCESS;
+		}
+
 		// Create a window and open it
 		auto mainWnd = avk::context().create_window("4 Seasons");
 		mainWnd->set_resolution({ mStartOptions.width, mStartOptions.height });
@@ -1696,8 +2175,8 @@ int main() // <== Starting point ==
 		mainWnd->set_additional_back_buffer_attachments({
 			avk::attachment::declare(vk::Format::eD32Sfloat, avk::on_load::clear.from_previous_layout(avk::layout::undefined), avk::usage::depth_stencil, avk::on_store::dont_care)
 		});
-		mainWnd->set_presentaton_mode(avk::presentation_mode::mailbox);
 		mainWnd->set_number_of_concurrent_frames(3u);
+		mainWnd->set_presentaton_mode(avk::presentation_mode::mailbox);
 		mainWnd->open();
 
 		if (mStartOptions.fullScreen == 1 || mStartOptions.fullScreen == 2)
@@ -1739,7 +2218,9 @@ int main() // <== Starting point ==
 		mainWnd->set_present_queue(singleQueue);
 
 		// Create an instance of our main avk::element which contains all the functionality:
-		auto app = model_loader_app(singleQueue);
+		// A transfer-only queue for uploads. If the device has none, this shares a queue of another family, possibly singleQueue:
+		auto& transferQueue = avk::context().create_queue(vk::QueueFlagBits::eTransfer, avk::queue_selection_preference::specialized_queue);
+		auto app = model_loader_app(singleQueue, transferQueue);
 		// Create another element for drawing the UI with ImGui
 		auto ui = avk::imgui_manager(singleQueue, "imgui_manager", {}, [](float uiScale) {
 			auto& style = ImGui::GetStyle();
@@ -1749,20 +2230,7 @@ int main() // <== Starting point ==
 		});
 
 		// Compile all the configuration parameters and the invokees into a "composition":
-		auto composition = configure_and_compose(
-			avk::application_name("4-Seasons Demo"),
-			[](avk::validation_layers& config) {
-				config.enable_feature(vk::ValidationFeatureEnableEXT::eSynchronizationValidation);
-			},
-			// Vulkan Device Features 1.2
-			[](vk::PhysicalDeviceVulkan12Features& features) {
-				features.setSeparateDepthStencilLayouts(VK_TRUE);
-			},
-			// Pass windows:
-			mainWnd,
-			// Pass invokees:
-			app, ui
-		);
+		auto composition = compose_demo(mainWnd, app, ui);
 
 		// Create an invoker object, which defines the way how invokees/elements are invoked
 		// (In this case, just sequentially in their execution order):
@@ -0,0 +1,273 @@
+#pragma once
+
+#include <iterator>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include "auto_vk_toolkit.hpp"
+#include "frame_resource_pool.hpp"
+#include "gpu_profiler.hpp"
+
+/** A small per-frame pass graph which replaces chains of binary semaphores between the passes of a frame.
+ *
+ *  Every pass declares which images it samples and which framebuffer it renders into. Passes are executed
+ *  in the order in which they have been added, and as many of them as possible are recorded into the same
+ *  command buffer. Between two passes of the same command buffer, one global memory barrier is derived from
+ *  the declared reads and writes (read-after-write, write-after-read and write-after-write hazards).
+ *
+ *  A new submission is only started when a pass has to wait on an external semaphore (e.g., the swapchain's
+ *  "image available" semaphore). All submissions of all frames are ordered by one timeline semaphore whose
+ *  value increases monotonically: Every submission signals the next value, and waits on the value which the
+ *  previous submission has signalled, i.e., the first submission of a frame waits on the last one of the
+ *  frame before.
+ *
+ *  If a gpu_profiler is set, every pass is bracketed with timestamp queries.
+ *
+ *  Usage example:
+ *
+ *	mRenderGraph->begin_frame();
+ *	mRenderGraph->add_pass("SSAO")
+ *		.reading(mImageSamplerRasterFBDepth, mImageSamplerRasterFBNormals)
+ *		.rendering_into(mSSAOFramebuffer)
+ *		.recording({ avk::command::render_pass(...) });
+ *	...
+ *	mRenderGraph->execute(*mFrameResources);
+ */
+class render_graph
+{
+public:
+	/** A pass of the graph. Configure it via the builder-style member functions. */
+	class pass
+	{
+		friend class render_graph;
+
+	public:
+		explicit pass(std::string aName)
+			: mName{ std::move(aName) }
+		{
+		}
+
+		/** Declares images which are sampled in the fragment shader by this pass */
+		template <typename... Ts>
+		pass& reading(const Ts&... aImageSamplers)
+		{
+			(mReads.push_back(aImageSamplers->get_image().handle()), ...);
+			return *this;
+		}
+
+		/** Declares that this pass renders into all attachments of the given framebuffer */
+		pass& rendering_into(const avk::framebuffer_t& aFramebuffer)
+		{
+			for (const auto& view : aFramebuffer.image_views()) {
+				const auto& image = view->get_image();
+				mWrites.emplace_back(image.handle(), avk::is_depth_format(image.format()));
+			}
+			return *this;
+		}
+
+		/** Declares that this pass must wait on an external semaphore. This starts a new submission. */
+		pass& waiting_for(avk::semaphore_wait_info aWaitInfo)
+		{
+			mWaits.push_back(std::move(aWaitInfo));
+			return *this;
+		}
+
+		/** Sets the commands which are recorded for this pass */
+		pass& recording(std::vector<avk::recorded_commands_t> aCommands)
+		{
+			mCommands = std::move(aCommands);
+			return *this;
+		}
+
+	private:
+		std::string mName;
+		std::vector<vk::Image> mReads;
+		// Written images and whether they are depth attachments:
+		std::vector<std::tuple<vk::Image, bool>> mWrites;
+		std::vector<avk::semaphore_wait_info> mWaits;
+		std::vector<avk::recorded_commands_t> mCommands;
+	};
+
+	/**	Creates the graph and its timeline semaphore.
+	 *	@param	aQueue		The queue which all passes are submitted to
+	 */
+	render_graph(avk::queue& aQueue)
+		: mQueue{ &aQueue }
+		, mTimeline{ avk::context().create_timeline_semaphore(0) }
+		, mTimelineValue{ 0 }
+		, mProfiler{ nullptr }
+		, mNumSubmissionsInLastFrame{ 0 }
+		, mNumBarriersInLastFrame{ 0 }
+	{
+	}
+
+	render_graph(render_graph&&) noexcept = delete;
+	render_graph(const render_graph&) = delete;
+	render_graph& operator=(render_graph&&) noexcept = delete;
+	render_graph& operator=(const render_graph&) = delete;
+	~render_graph() = default;
+
+	/** Removes the passes of the previous frame. Call this before the first add_pass of a frame. */
+	void begin_frame()
+	{
+		mPasses.clear();
+	}
+
+	/** Sets a profiler which measures every pass from now on, or disables profiling if nullptr is passed.
+	 *	The profiler's begin_frame must be called before execute.
+	 */
+	void set_profiler(gpu_profiler* aProfiler)
+	{
+		mProfiler = aProfiler;
+	}
+
+	/** Adds a pass which is executed after all previously added passes */
+	pass& add_pass(std::string aName)
+	{
+		return mPasses.emplace_back(std::move(aName));
+	}
+
+	/**	Records and submits all passes which have been added since begin_frame.
+	 *	@param	aFrameResources		Provides one command buffer per submission; begin_frame must already have been called on it.
+	 */
+	void execute(frame_resource_pool& aFrameResources)
+	{
+		mNumSubmissionsInLastFrame = 0;
+		mNumBarriersInLastFrame = 0;
+
+		size_t passIndex = 0;
+		while (passIndex < mPasses.size()) {
+			// A submission consists of a pass and all subsequent passes which do not wait on external semaphores:
+			const auto firstPass = passIndex;
+			auto lastPass = firstPass + 1;
+			while (lastPass < mPasses.size() && mPasses[lastPass].mWaits.empty()) {
+				++lastPass;
+			}
+			passIndex = lastPass;
+
+			// The semaphore wait at the beginning of the submission makes everything before it available and visible:
+			std::unordered_map<VkImage, image_state> states;
+			std::vector<avk::recorded_commands_t> commands;
+			if (nullptr != mProfiler) {
+				if (0 == firstPass) {
+					commands.push_back(mProfiler->reset_queries());
+				}
+				mProfiler->begin_submission();
+			}
+			for (auto i = firstPass; i < lastPass; ++i) {
+				auto& p = mPasses[i];
+				derive_barrier(p, states, commands);
+				auto passCommands = nullptr != mProfiler
+					? mProfiler->bracket(p.mName, std::move(p.mCommands))
+					: std::move(p.mCommands);
+				std::move(std::begin(passCommands), std::end(passCommands), std::back_inserter(commands));
+			}
+
+			auto submission = avk::context().record(std::move(commands))
+				.into_command_buffer(aFrameResources.command_buffer(mNumSubmissionsInLastFrame))
+				.then_submit_to(*mQueue);
+			for (auto& waitInfo : mPasses[firstPass].mWaits) {
+				submission.waiting_for(std::move(waitInfo));
+			}
+			submission
+				.waiting_for((mTimeline.as_reference() >> avk::stage::all_commands).at_value(mTimelineValue))
+				.signaling_upon_completion((avk::stage::all_commands >> mTimeline.as_reference()).at_value(mTimelineValue + 1));
+			submission.submit();
+
+			++mTimelineValue;
+			++mNumSubmissionsInLastFrame;
+		}
+	}
+
+	/** The timeline semaphore which orders all submissions */
+	const avk::semaphore_t& timeline() const { return mTimeline.get(); }
+
+	/** The value which the timeline semaphore will have after the last submitted pass has completed */
+	uint64_t last_signalled_value() const { return mTimelineValue; }
+
+	/** Number of submissions of the last frame */
+	uint32_t num_submissions() const { return mNumSubmissionsInLastFrame; }
+
+	/** Number of barriers which have been inserted between passes in the last frame */
+	uint32_t num_barriers() const { return mNumBarriersInLastFrame; }
+
+private:
+	struct image_state
+	{
+		// The last write which has not been made visible to fragment shader reads yet:
+		vk::PipelineStageFlags2KHR mWriteStages = vk::PipelineStageFlagBits2KHR::eNone;
+		vk::AccessFlags2KHR mWriteAccess = vk::AccessFlagBits2KHR::eNone;
+		bool mWriteVisibleToReads = true;
+		// Stages which have read the image since the last write:
+		vk::PipelineStageFlags2KHR mReadStages = vk::PipelineStageFlagBits2KHR::eNone;
+	};
+
+	/** Accumulates the hazards of all images which the given pass accesses into one barrier, and updates the image states */
+	void derive_barrier(const pass& aPass, std::unordered_map<VkImage, image_state>& aStates, std::vector<avk::recorded_commands_t>& aCommands)
+	{
+		const vk::PipelineStageFlags2KHR readStage = vk::PipelineStageFlagBits2KHR::eFragmentShader;
+		const vk::AccessFlags2KHR readAccess = vk::AccessFlagBits2KHR::eShaderSampledRead;
+		const vk::PipelineStageFlags2KHR colorStage = vk::PipelineStageFlagBits2KHR::eColorAttachmentOutput;
+		const vk::AccessFlags2KHR colorAccess = vk::AccessFlagBits2KHR::eColorAttachmentWrite | vk::AccessFlagBits2KHR::eColorAttachmentRead;
+		const vk::PipelineStageFlags2KHR depthStage = vk::PipelineStageFlagBits2KHR::eEarlyFragmentTests | vk::PipelineStageFlagBits2KHR::eLateFragmentTests;
+		const vk::AccessFlags2KHR depthAccess = vk::AccessFlagBits2KHR::eDepthStencilAttachmentWrite | vk::AccessFlagBits2KHR::eDepthStencilAttachmentRead;
+
+		vk::PipelineStageFlags2KHR srcStages = vk::PipelineStageFlagBits2KHR::eNone;
+		vk::AccessFlags2KHR srcAccess = vk::AccessFlagBits2KHR::eNone;
+		vk::PipelineStageFlags2KHR dstStages = vk::PipelineStageFlagBits2KHR::eNone;
+		vk::AccessFlags2KHR dstAccess = vk::AccessFlagBits2KHR::eNone;
+
+		for (const auto img : aPass.mReads) {
+			auto& state = aStates[static_cast<VkImage>(img)];
+			// Read after write:
+			if (!state.mWriteVisibleToReads) {
+				srcStages |= state.mWriteStages;
+				srcAccess |= state.mWriteAccess;
+				dstStages |= readStage;
+				dstAccess |= readAccess;
+				state.mWriteVisibleToReads = true;
+			}
+			state.mReadStages |= readStage;
+		}
+
+		for (const auto& [img, isDepth] : aPass.mWrites) {
+			auto& state = aStates[static_cast<VkImage>(img)];
+			const auto writeStages = isDepth ? depthStage : colorStage;
+			const auto writeAccess = isDepth ? depthAccess : colorAccess;
+			// Write after read => an execution dependency suffices:
+			if (state.mReadStages) {
+				srcStages |= state.mReadStages;
+				dstStages |= writeStages;
+			}
+			// Write after write:
+			if (state.mWriteStages) {
+				srcStages |= state.mWriteStages;
+				srcAccess |= state.mWriteAccess;
+				dstStages |= writeStages;
+				dstAccess |= writeAccess;
+			}
+			state.mWriteStages = writeStages;
+			state.mWriteAccess = writeAccess & (vk::AccessFlagBits2KHR::eColorAttachmentWrite | vk::AccessFlagBits2KHR::eDepthStencilAttachmentWrite);
+			state.mWriteVisibleToReads = false;
+			state.mReadStages = vk::PipelineStageFlagBits2KHR::eNone;
+		}
+
+		if (srcStages) {
+			aCommands.push_back(avk::sync::global_memory_barrier(
+				avk::stage::pipeline_stage_flags{ srcStages } >> avk::stage::pipeline_stage_flags{ dstStages },
+				avk::access::memory_access_flags{ srcAccess } >> avk::access::memory_access_flags{ dstAccess }
+			));
+			++mNumBarriersInLastFrame;
+		}
+	}
+
+	avk::queue* mQueue;
+	avk::semaphore mTimeline;
+	uint64_t mTimelineValue;
+	std::vector<pass> mPasses;
+	gpu_profiler* mProfiler;
+	uint32_t mNumSubmissionsInLastFrame;
+	uint32_t mNumBarriersInLastFrame;
+};
@@ -0,0 +1,752 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "auto_vk_toolkit.hpp"
+#include "material_image_helpers.hpp"
+#include "ticket_queue.hpp"
+#include "upload_batcher.hpp"
+
+/** Keeps only the mip levels of the materials' textures resident which the renderer actually needs, within a memory budget.
+ *
+ *  Instead of loading every texture at full resolution like avk::convert_for_gpu_usage, only the mip tail of every texture
+ *  (all levels which are at most aTailExtent texels wide and high) is loaded at startup. Every texture's image only contains
+ *  its resident levels, i.e., its memory shrinks and grows with them.
+ *
+ *  The rasterization pass writes the finest mip level which any of its fragments needs into a feedback buffer, per image sampler
+ *  (see write_mip_feedback in shaders/raster.frag). Only textures which a shader calls write_mip_feedback for are ever streamed
+ *  in: the demo's rasterization shaders only sample, and only report, the diffuse texture (mDiffuseTexIndex). The textures
+ *  of all other material slots keep their mip tail until a shader which samples them reports their feedback as well.
+ *  The feedback of every frame is copied into a host-visible buffer and read
+ *  after the frame has finished on the device. Textures which need finer levels than are resident are loaded on a background
+ *  thread (the new levels and all coarser ones), and staged by update() as soon as they are ready, up to aUploadBytesPerFrame
+ *  per frame. Streaming in means creating a new image with the new set of levels, which the upload_batcher fills via its
+ *  transfer queue; only after that submission has completed, the new image replaces the old one, which is destroyed when no
+ *  frame in flight uses it anymore. Rendering never waits for a texture upload.
+ *  Before a load would exceed the budget, the finest levels of the least recently used textures are evicted by copying the
+ *  remaining levels into a new image on the graphics queue, but only levels which have not been needed for
+ *  cMinFramesBeforeEviction frames, and never the mip tail.
+ *
+ *  Textures are streamed as they are stored, i.e., they are not flipped, and only files which contain complete mip chains
+ *  (like the KTX files of avk::texture_baker) can be streamed. Files without mip levels are loaded completely at startup.
+ *
+ *  Usage example:
+ *
+ *	mTextureStreamer.emplace(uploader, 512 * 1024 * 1024);
+ *	auto [gpuMaterials, commands] = mTextureStreamer->convert_for_gpu_usage<avk::material_gpu_data>(materialConfigs, avk::filter_mode::trilinear);
+ *	...
+ *	// Every frame, before the rasterization pass:
+ *	auto streamingCommands = mTextureStreamer->update(mTarget->current_in_flight_index(), mTarget->current_frame(), mTarget->number_of_frames_in_flight());
+ *	// ... and hand the uploads over to the graphics queue with uploader.acquire() in the same frame
+ *	...
+ *	avk::descriptor_binding(0, 0, avk::as_combined_image_samplers(mTextureStreamer->image_samplers(), avk::layout::shader_read_only_optimal)),
+ *	avk::descriptor_binding(1, 2, mTextureStreamer->feedback_buffer())
+ */
+class texture_streamer
+{
+public:
+	/** Number of mip levels which the histograms distinguish; coarser levels are counted in the last one */
+	static constexpr uint32_t cNumHistogramLevels = 14;
+
+	struct statistics
+	{
+		/** Memory of all textures' resident levels, and the budget for it */
+		size_t mResidentBytes = 0;
+		size_t mBudgetBytes = 0;
+		/** Memory which all textures would occupy at full resolution */
+		size_t mFullResolutionBytes = 0;
+		/** Memory of the levels which are being loaded */
+		size_t mPendingBytes = 0;
+		uint32_t mNumPendingLoads = 0;
+		/** Total number of bytes which have been uploaded since startup, and the rate over the last second */
+		size_t mBytesUploaded = 0;
+		double mUploadBytesPerSecond = 0.0;
+		/** Number of times that finer levels have been streamed in, and that levels have been evicted */
+		uint64_t mNumStreamedIn = 0;
+		uint64_t mNumEvicted = 0;
+		/** Number of textures per level which the renderer has requested, and per level which is resident (0 = full resolution) */
+		std::array<uint32_t, cNumHistogramLevels> mRequestedLevels{};
+		std::array<uint32_t, cNumHistogramLevels> mResidentLevels{};
+	};
+
+	/**	Starts the background thread which loads the textures' levels.
+	 *	@param	aUploader				Uploads the streamed levels. Must outlive this texture_streamer, and its staging memory must be larger than aUploadBytesPerFrame.
+	 *	@param	aBudgetBytes			Memory budget for all textures' levels, beyond their mip tails
+	 *	@param	aUploadBytesPerFrame	Maximum number of bytes which are uploaded per frame, which is also the size of the largest load
+	 *	@param	aTailExtent				Levels up to this width and height are always resident
+	 *	@param	aMaxFramesInFlight		Maximum number of concurrent frames
+	 */
+	texture_streamer(upload_batcher& aUploader, size_t aBudgetBytes, size_t aUploadBytesPerFrame = 32 * 1024 * 1024, uint32_t aTailExtent = 64, uint32_t aMaxFramesInFlight = 10)
+		: mUploader{ &aUploader }
+		, mUploadBytesPerFrame{ aUploadBytesPerFrame }
+		, mTailExtent{ aTailExtent }
+		, mStop{ false }
+	{
+		mStatistics.mBudgetBytes = aBudgetBytes;
+		mFeedbackPending.resize(aMaxFramesInFlight, false);
+		mWindowBegin = std::chrono::steady_clock::now();
+		mWorker = std::thread([this]() { worker_loop(); });
+	}
+
+	texture_streamer(texture_streamer&&) noexcept = delete;
+	texture_streamer(const texture_streamer&) = delete;
+	texture_streamer& operator=(texture_streamer&&) noexcept = delete;
+	texture_streamer& operator=(const texture_streamer&) = delete;
+	/** Drops the pending loads, stops and joins the background thread, and waits for the uploads into images which it owns */
+	~texture_streamer()
+	{
+		if (!mUploading.empty()) {
+			mUploader->wait(*mUploading.newest_ticket());
+		}
+		{
+			std::scoped_lock lock(mMutex);
+			mStop = true;
+		}
+		mRequestAvailable.notify_all();
+		mWorker.join();
+	}
+
+	/**	Converts the given materials like avk::convert_for_gpu_usage does (without flipping or sRGB conversions), but creates
+	 *	the textures with their mip tails only. Must be called once, before the first update.
+	 *	@param	aMaterialConfigs		The materials whose textures are streamed
+	 *	@param	aTextureFilterMode		Filtering mode of the textures' samplers
+	 *	@return	The materials in GPU format, whose texture indices refer to image_samplers(), and the commands which upload the mip tails
+	 */
+	template <typename T>
+	std::tuple<std::vector<T>, avk::command::action_type_command> convert_for_gpu_usage(const std::vector<avk::material_config>& aMaterialConfigs, avk::filter_mode aTextureFilterMode)
+	{
+		// Without texture paths, all materials get the 1x1 px default textures, which come first in the image samplers:
+		auto withoutTextures = aMaterialConfigs;
+		for (auto& mc : withoutTextures) {
+			for (const auto& slot : cSlots) {
+				(mc.*slot.mPath).clear();
+			}
+		}
+		auto [gpuMaterials, imageSamplers, commands] = avk::convert_for_gpu_usage<T>(withoutTextures, false, false, avk::image_usage::general_texture, aTextureFilterMode);
+		mImageSamplers = std::move(imageSamplers);
+
+		// One texture per file, and one image sampler per texture and border handling mode, like convert_for_gpu_usage:
+		std::map<std::string, size_t> pathToTexture;
+		std::map<std::tuple<size_t, avk::border_handling_mode, avk::border_handling_mode>, size_t> samplerIndices;
+		for (size_t m = 0; m < aMaterialConfigs.size(); ++m) {
+			auto& mgd = static_cast<avk::material_gpu_data&>(gpuMaterials[m]);
+			for (const auto& slot : cSlots) {
+				const auto& path = aMaterialConfigs[m].*slot.mPath;
+				if (path.empty()) {
+					continue;
+				}
+				const auto [textureIt, newTexture] = pathToTexture.try_emplace(avk::clean_up_path(path), mTextures.size());
+				if (newTexture) {
+					mTextures.emplace_back().mPath = textureIt->first;
+				}
+				const auto& bhModes = aMaterialConfigs[m].*slot.mBorderHandlingModes;
+				const auto [samplerIt, newSampler] = samplerIndices.try_emplace({ textureIt->second, bhModes[0], bhModes[1] }, mImageSamplers.size());
+				if (newSampler) {
+					mImageSamplers.emplace_back(); // Created with the texture's image below
+					auto sampler = avk::context().create_sampler(aTextureFilterMode, bhModes);
+					sampler.enable_shared_ownership();
+					mTextures[textureIt->second].mSamplers.emplace_back(samplerIt->second, std::move(sampler));
+				}
+				mgd.*slot.mIndex = static_cast<int>(samplerIt->second);
+			}
+		}
+
+		// Decode the files on worker threads, and upload their mip tails:
+		std::vector<avk::image_data> images;
+		for (const auto& t : mTextures) {
+			images.push_back(avk::get_image_data(t.mPath, true, false, false, 4));
+		}
+		avk::parallel_image_loader loader(std::move(images));
+		for (size_t i = 0; i < mTextures.size(); ++i) {
+			auto imageData = loader.take(i);
+			auto& t = mTextures[i];
+			t.mFormat = imageData.get_format();
+			for (uint32_t level = 0; level < imageData.levels(); ++level) {
+				t.mExtents.push_back(imageData.extent(level));
+				t.mLevelSizes.push_back(imageData.size(level));
+			}
+			t.mTailLevel = 0;
+			while (t.mTailLevel + 1 < imageData.levels() && std::max(t.mExtents[t.mTailLevel].width, t.mExtents[t.mTailLevel].height) > mTailExtent) {
+				++t.mTailLevel;
+			}
+			t.mRequestedLevel = t.mTailLevel;
+
+			auto staging = avk::context().create_buffer(
+				AVK_STAGING_BUFFER_MEMORY_USAGE,
+				vk::BufferUsageFlagBits::eTransferSrc,
+				avk::generic_buffer_meta::create_from_size(bytes_of_levels(t, t.mTailLevel, imageData.levels()) + 16 * imageData.levels())
+			);
+			std::vector<vk::DeviceSize> offsets;
+			{
+				avk::scoped_mapping<AVK_MEM_BUFFER_HANDLE> mapping(staging->memory_handle(), avk::mapping_access::write);
+				vk::DeviceSize offset = 0;
+				for (uint32_t level = t.mTailLevel; level < imageData.levels(); ++level) {
+					offsets.push_back(offset);
+					std::memcpy(static_cast<uint8_t*>(mapping.get()) + offset, imageData.get_data(0, 0, level), t.mLevelSizes[level]);
+					offset = align(offset + t.mLevelSizes[level]);
+				}
+			}
+			replace_image(t, t.mTailLevel, staging->handle(), offsets, commands.mNestedCommandsAndSyncInstructions);
+			commands.handle_lifetime_of(std::move(staging));
+
+			mStatistics.mFullResolutionBytes += bytes_of_levels(t, 0, imageData.levels());
+		}
+
+		// Every image sampler gets one entry in the feedback buffer:
+		const auto feedbackSize = sizeof(uint32_t) * mImageSamplers.size();
+		mFeedbackBuffer = avk::context().create_buffer(avk::memory_usage::device, vk::BufferUsageFlagBits::eTransferSrc | vk::BufferUsageFlagBits::eTransferDst,
+			avk::storage_buffer_meta::create_from_size(feedbackSize)
+		);
+		for (size_t i = 0; i < mFeedbackPending.size(); ++i) {
+			mFeedbackReadbackBuffers.push_back(avk::context().create_buffer(
+				avk::memory_usage::host_coherent, vk::BufferUsageFlagBits::eTransferDst,
+				avk::generic_buffer_meta::create_from_size(feedbackSize)
+			));
+		}
+		mFeedback.resize(mImageSamplers.size(), cNotSampled);
+		commands.mNestedCommandsAndSyncInstructions.push_back(avk::command::custom_commands([lFeedback = mFeedbackBuffer->handle()](avk::command_buffer_t& cb) {
+			cb.handle().fillBuffer(lFeedback, 0, VK_WHOLE_SIZE, cNotSampled);
+		}));
+		commands.mNestedCommandsAndSyncInstructions.push_back(avk::sync::global_memory_barrier(
+			avk::stage::clear >> avk::stage::fragment_shader,
+			avk::access::transfer_write >> (avk::access::shader_storage_read | avk::access::shader_storage_write)
+		));
+
+		update_statistics();
+		LOG_INFO(std::format("Texture streaming: {} textures with {:.1f} MiB of mip tails resident, {:.1f} MiB at full resolution",
+			mTextures.size(), mStatistics.mResidentBytes / (1024.0 * 1024.0), mStatistics.mFullResolutionBytes / (1024.0 * 1024.0)));
+		return std::make_tuple(std::move(gpuMaterials), std::move(commands));
+	}
+
+	/**	Picks up the mip feedback of the frame which has used the same in-flight index before, swaps in the images whose
+	 *	uploads have completed, stages the levels which have finished loading, evicts levels if the budget requires it, and
+	 *	requests further loads.
+	 *	Must be called once per frame, before the frame's rasterization pass is recorded, because it replaces image samplers,
+	 *	and before the upload_batcher's acquire() of the same frame, which hands the swapped-in images over to the graphics queue.
+	 *	@param	aInFlightIndex		The current frame's in-flight index
+	 *	@param	aCurrentFrame		The current frame's id
+	 *	@param	aNumFramesInFlight	Number of concurrent frames, after which replaced image samplers are destroyed
+	 *	@return	Commands which must be executed before the rasterization pass
+	 */
+	std::vector<avk::recorded_commands_t> update(avk::window::frame_id_t aInFlightIndex, avk::window::frame_id_t aCurrentFrame, avk::window::frame_id_t aNumFramesInFlight)
+	{
+		const auto ifi = static_cast<size_t>(aInFlightIndex);
+		mCurrentFrame = aCurrentFrame;
+		mNumFramesInFlight = aNumFramesInFlight;
+		if (mFeedbackPending[ifi]) {
+			// The frame which has used this in-flight index before has finished on the device:
+			auto emptyCmd = mFeedbackReadbackBuffers[ifi]->read_into(mFeedback.data(), 0);
+			mFeedbackPending[ifi] = false;
+			apply_feedback(aCurrentFrame);
+		}
+
+		std::vector<avk::recorded_commands_t> commands;
+		retire_image_samplers(aCurrentFrame);
+		swap_in_uploaded_images();
+		stage_loaded_levels();
+		request_loads(aCurrentFrame, commands);
+
+		// Collect the feedback which the previous frame has written, and start over for this frame:
+		commands.push_back(avk::sync::global_memory_barrier(
+			avk::stage::fragment_shader >> (avk::stage::copy | avk::stage::clear),
+			avk::access::shader_storage_write >> (avk::access::transfer_read | avk::access::transfer_write)
+		));
+		commands.push_back(avk::command::custom_commands([lFeedback = mFeedbackBuffer->handle(), lReadback = mFeedbackReadbackBuffers[ifi]->handle(), lSize = sizeof(uint32_t) * mFeedback.size()](avk::command_buffer_t& cb) {
+			cb.handle().copyBuffer(lFeedback, lReadback, vk::BufferCopy{ 0, 0, lSize });
+			cb.handle().fillBuffer(lFeedback, 0, VK_WHOLE_SIZE, cNotSampled);
+		}));
+		commands.push_back(avk::sync::global_memory_barrier(
+			(avk::stage::copy | avk::stage::clear) >> (avk::stage::host | avk::stage::fragment_shader),
+			avk::access::transfer_write >> (avk::access::host_read | avk::access::shader_storage_read | avk::access::shader_storage_write)
+		));
+		mFeedbackPending[ifi] = true;
+
+		update_statistics();
+		return commands;
+	}
+
+	/**	Sets a function which is invoked for every image view that is no longer sampled, after the last frame which might have
+	 *	used it has completed, and right before it is destroyed. Use it to remove descriptor sets which refer to the view, e.g.,
+	 *	via avk::descriptor_cache_t::remove_sets_with_handle, before the view's handle can be reused.
+	 *	@param	aHandler	Invoked from within update()
+	 */
+	void set_image_view_retired_handler(std::function<void(vk::ImageView)> aHandler)
+	{
+		mImageViewRetiredHandler = std::move(aHandler);
+	}
+
+	/** The textures of all materials. Entries are replaced whenever levels are streamed in or evicted. */
+	const std::vector<avk::image_sampler>& image_samplers() const { return mImageSamplers; }
+
+	/** The buffer which the rasterization pass writes the needed mip levels into, one uint per image sampler */
+	const avk::buffer& feedback_buffer() const { return mFeedbackBuffer; }
+
+	/** Statistics as of the last update */
+	const statistics& stats() const { return mStatistics; }
+
+private:
+	// Feedback value of image samplers which no fragment has sampled:
+	static constexpr uint32_t cNotSampled = 0xFFFFFFFFu;
+	// Levels which have been needed within this number of frames are not evicted:
+	static constexpr avk::window::frame_id_t cMinFramesBeforeEviction = 120;
+	// Loads which may be in flight at the same time:
+	static constexpr uint32_t cMaxPendingLoads = 8;
+
+	/** Where the texture of a material slot is referenced in material_config and in material_gpu_data */
+	struct slot
+	{
+		std::string avk::material_config::* mPath;
+		std::array<avk::border_handling_mode, 2> avk::material_config::* mBorderHandlingModes;
+		int avk::material_gpu_data::* mIndex;
+	};
+	static constexpr std::array<slot, 12> cSlots = { {
+		{ &avk::material_config::mDiffuseTex,      &avk::material_config::mDiffuseTexBorderHandlingMode,      &avk::material_gpu_data::mDiffuseTexIndex },
+		{ &avk::material_config::mSpecularTex,     &avk::material_config::mSpecularTexBorderHandlingMode,     &avk::material_gpu_data::mSpecularTexIndex },
+		{ &avk::material_config::mAmbientTex,      &avk::material_config::mAmbientTexBorderHandlingMode,      &avk::material_gpu_data::mAmbientTexIndex },
+		{ &avk::material_config::mEmissiveTex,     &avk::material_config::mEmissiveTexBorderHandlingMode,     &avk::material_gpu_data::mEmissiveTexIndex },
+		{ &avk::material_config::mHeightTex,       &avk::material_config::mHeightTexBorderHandlingMode,       &avk::material_gpu_data::mHeightTexIndex },
+		{ &avk::material_config::mNormalsTex,      &avk::material_config::mNormalsTexBorderHandlingMode,      &avk::material_gpu_data::mNormalsTexIndex },
+		{ &avk::material_config::mShininessTex,    &avk::material_config::mShininessTexBorderHandlingMode,    &avk::material_gpu_data::mShininessTexIndex },
+		{ &avk::material_config::mOpacityTex,      &avk::material_config::mOpacityTexBorderHandlingMode,      &avk::material_gpu_data::mOpacityTexIndex },
+		{ &avk::material_config::mDisplacementTex, &avk::material_config::mDisplacementTexBorderHandlingMode, &avk::material_gpu_data::mDisplacementTexIndex },
+		{ &avk::material_config::mReflectionTex,   &avk::material_config::mReflectionTexBorderHandlingMode,   &avk::material_gpu_data::mReflectionTexIndex },
+		{ &avk::material_config::mLightmapTex,     &avk::material_config::mLightmapTexBorderHandlingMode,     &avk::material_gpu_data::mLightmapTexIndex },
+		{ &avk::material_config::mExtraTex,        &avk::material_config::mExtraTexBorderHandlingMode,        &avk::material_gpu_data::mExtraTexIndex }
+	} };
+
+	struct texture
+	{
+		std::string mPath;
+		vk::Format mFormat = vk::Format::eUndefined;
+		// Extent and size of every level in the file:
+		std::vector<vk::Extent3D> mExtents;
+		std::vector<size_t> mLevelSizes;
+		// The coarsest level which is ever the finest resident one, i.e., the first level of the mip tail:
+		uint32_t mTailLevel = 0;
+		// The finest level which is resident, i.e., level 0 of the current image:
+		uint32_t mResidentLevel = 0;
+		// The finest level which the last feedback has asked for:
+		uint32_t mRequestedLevel = 0;
+		// The finest level of a load which is in flight:
+		std::optional<uint32_t> mPendingLevel;
+		// The last frame whose feedback has needed the finest resident level:
+		avk::window::frame_id_t mLastUsedFrame = 0;
+		bool mFailed = false;
+		// The image samplers which refer to this texture, with their samplers:
+		std::vector<std::tuple<size_t, avk::sampler>> mSamplers;
+	};
+
+	struct load_request
+	{
+		size_t mTexture;
+		std::string mPath;
+		uint32_t mFirstLevel;
+	};
+
+	struct load_result
+	{
+		size_t mTexture;
+		uint32_t mFirstLevel;
+		std::vector<std::vector<uint8_t>> mLevels;
+		std::string mError;
+	};
+
+	/** An image sampler which has been replaced, and the last frame which might have used it */
+	struct retired_image_sampler
+	{
+		avk::image_sampler mImageSampler;
+		avk::window::frame_id_t mLastFrame;
+	};
+
+	/** An image with the levels from mFirstLevel on, which replaces the texture's image when its ticket in mUploading has completed */
+	struct upload
+	{
+		size_t mTexture;
+		uint32_t mFirstLevel;
+		avk::image mImage;
+	};
+
+	static vk::DeviceSize align(vk::DeviceSize aOffset)
+	{
+		// Satisfies the offset alignment of copies into block-compressed images:
+		constexpr vk::DeviceSize alignment = 16;
+		return (aOffset + alignment - 1) & ~(alignment - 1);
+	}
+
+	static size_t bytes_of_levels(const texture& aTexture, uint32_t aFirstLevel, uint32_t aEndLevel)
+	{
+		size_t bytes = 0;
+		for (auto level = aFirstLevel; level < aEndLevel; ++level) {
+			bytes += aTexture.mLevelSizes[level];
+		}
+		return bytes;
+	}
+
+	static size_t resident_bytes(const texture& aTexture)
+	{
+		return bytes_of_levels(aTexture, aTexture.mResidentLevel, static_cast<uint32_t>(aTexture.mLevelSizes.size()));
+	}
+
+	/** Converts a feedback value into the level of the given texture */
+	static uint32_t requested_level(const texture& aTexture, uint32_t aFeedback)
+	{
+		// The feedback is log2 of the texture coordinates' footprint of a pixel, in 1/256 steps and offset by 32, i.e.,
+		// the level is that plus log2 of the texture's size:
+		const auto lod = static_cast<float>(aFeedback) / 256.0f - 32.0f + std::log2(static_cast<float>(std::max(aTexture.mExtents[0].width, aTexture.mExtents[0].height)));
+		return static_cast<uint32_t>(std::clamp(std::floor(lod), 0.0f, static_cast<float>(aTexture.mTailLevel)));
+	}
+
+	void apply_feedback(avk::window::frame_id_t aCurrentFrame)
+	{
+		for (auto& t : mTextures) {
+			t.mRequestedLevel = t.mTailLevel;
+			for (const auto& [index, sampler] : t.mSamplers) {
+				if (cNotSampled != mFeedback[index]) {
+					t.mRequestedLevel = std::min(t.mRequestedLevel, requested_level(t, mFeedback[index]));
+				}
+			}
+			if (t.mRequestedLevel <= t.mResidentLevel && t.mResidentLevel < t.mTailLevel) {
+				t.mLastUsedFrame = aCurrentFrame;
+			}
+		}
+	}
+
+	/** Stages the levels of finished loads into new images, as long as they fit into this frame's upload, and submits them */
+	void stage_loaded_levels()
+	{
+		{
+			std::scoped_lock lock(mMutex);
+			std::move(mFinished.begin(), mFinished.end(), std::back_inserter(mLoaded));
+			mFinished.clear();
+		}
+
+		std::vector<upload> staged;
+		size_t bytesStaged = 0;
+		while (!mLoaded.empty()) {
+			auto& result = mLoaded.front();
+			auto& t = mTextures[result.mTexture];
+			if (!result.mError.empty()) {
+				LOG_WARNING(std::format("Could not stream texture '{}': {}", t.mPath, result.mError));
+				t.mFailed = true;
+				mPendingBytes -= bytes_of_levels(t, result.mFirstLevel, t.mResidentLevel);
+				t.mPendingLevel.reset();
+				mLoaded.pop_front();
+				continue;
+			}
+
+			const auto size = bytes_of_levels(t, result.mFirstLevel, static_cast<uint32_t>(t.mLevelSizes.size()));
+			if (bytesStaged + size > mUploadBytesPerFrame || !mUploader->can_stage_without_waiting(result.mLevels)) {
+				break; // The next frame's turn
+			}
+			auto image = avk::context().create_image(t.mExtents[result.mFirstLevel].width, t.mExtents[result.mFirstLevel].height, t.mFormat, 1, avk::memory_usage::device, avk::image_usage::general_texture, [count = static_cast<uint32_t>(result.mLevels.size())](avk::image_t& aImage) {
+				aImage.create_info().mipLevels = count;
+			});
+			mUploader->stage(*image, result.mLevels);
+			staged.push_back(upload{ result.mTexture, result.mFirstLevel, std::move(image) });
+			bytesStaged += size;
+			mBytesUploadedInWindow += size;
+			mStatistics.mBytesUploaded += size;
+			mLoaded.pop_front();
+		}
+
+		if (!staged.empty()) {
+			const auto ticket = mUploader->submit();
+			for (auto& u : staged) {
+				mUploading.push(ticket, std::move(u));
+			}
+		}
+	}
+
+	/** Replaces the images of all textures whose uploads have completed on the device */
+	void swap_in_uploaded_images()
+	{
+		mUploading.retire(mUploader->completed_ticket(), [this](upload& u) {
+			auto& t = mTextures[u.mTexture];
+			mPendingBytes -= bytes_of_levels(t, u.mFirstLevel, t.mResidentLevel);
+			set_image(t, std::move(u.mImage), u.mFirstLevel);
+			t.mPendingLevel.reset();
+			++mStatistics.mNumStreamedIn;
+		});
+	}
+
+	/** Requests the missing levels of the textures which need them most, and evicts levels to stay within the budget */
+	void request_loads(avk::window::frame_id_t aCurrentFrame, std::vector<avk::recorded_commands_t>& aCommands)
+	{
+		std::vector<size_t> candidates;
+		for (size_t i = 0; i < mTextures.size(); ++i) {
+			const auto& t = mTextures[i];
+			if (!t.mFailed && !t.mPendingLevel.has_value() && t.mRequestedLevel < t.mResidentLevel) {
+				candidates.push_back(i);
+			}
+		}
+		// The textures which are furthest from their requested level first:
+		std::stable_sort(candidates.begin(), candidates.end(), [this](size_t a, size_t b) {
+			return mTextures[a].mResidentLevel - mTextures[a].mRequestedLevel > mTextures[b].mResidentLevel - mTextures[b].mRequestedLevel;
+		});
+
+		size_t residentBytes = 0;
+		for (const auto& t : mTextures) {
+			residentBytes += resident_bytes(t);
+		}
+		std::map<size_t, uint32_t> evictions;
+		for (const auto i : candidates) {
+			if (pending_loads() >= cMaxPendingLoads) {
+				break;
+			}
+			auto& t = mTextures[i];
+			// Not more than one frame's upload at once, which includes the coarser levels; the remaining levels follow with the next load:
+			const auto numLevels = static_cast<uint32_t>(t.mLevelSizes.size());
+			auto firstLevel = t.mRequestedLevel;
+			while (firstLevel < t.mResidentLevel && bytes_of_levels(t, firstLevel, numLevels) + 16 * (numLevels - firstLevel) > mUploadBytesPerFrame) {
+				++firstLevel;
+			}
+			if (firstLevel == t.mResidentLevel) {
+				continue;
+			}
+			const auto bytes = bytes_of_levels(t, firstLevel, t.mResidentLevel);
+			if (!make_room(bytes, aCurrentFrame, residentBytes, evictions)) {
+				break; // Everything else has been needed recently
+			}
+
+			t.mPendingLevel = firstLevel;
+			mPendingBytes += bytes;
+			{
+				std::scoped_lock lock(mMutex);
+				mRequests.push_back(load_request{ i, t.mPath, firstLevel });
+			}
+			mRequestAvailable.notify_one();
+		}
+
+		for (const auto& [i, level] : evictions) {
+			replace_image(mTextures[i], level, nullptr, {}, aCommands);
+			++mStatistics.mNumEvicted;
+		}
+	}
+
+	/** Plans the eviction of the least recently used levels until aBytes more fit into the budget */
+	bool make_room(size_t aBytes, avk::window::frame_id_t aCurrentFrame, size_t& aResidentBytes, std::map<size_t, uint32_t>& aEvictions)
+	{
+		while (aResidentBytes + mPendingBytes + aBytes > mStatistics.mBudgetBytes) {
+			std::optional<size_t> lru;
+			for (size_t i = 0; i < mTextures.size(); ++i) {
+				const auto& t = mTextures[i];
+				const auto level = aEvictions.contains(i) ? aEvictions[i] : t.mResidentLevel;
+				// Only levels which are finer than what has been requested lately, and never the mip tail:
+				const bool evictable = !t.mPendingLevel.has_value() && level < std::min(t.mRequestedLevel, t.mTailLevel)
+					&& t.mLastUsedFrame + cMinFramesBeforeEviction < aCurrentFrame;
+				if (evictable && (!lru.has_value() || t.mLastUsedFrame < mTextures[lru.value()].mLastUsedFrame)) {
+					lru = i;
+				}
+			}
+			if (!lru.has_value()) {
+				return false;
+			}
+			auto& t = mTextures[lru.value()];
+			auto& level = aEvictions.try_emplace(lru.value(), t.mResidentLevel).first->second;
+			aResidentBytes -= t.mLevelSizes[level];
+			++level;
+		}
+		aResidentBytes += aBytes;
+		return true;
+	}
+
+	/**	Replaces the image of the given texture with one which contains the levels from aFirstLevel on, on the graphics queue.
+	 *	Levels which are resident in the current image are copied over, all others are copied from the staging buffer at the given offsets.
+	 */
+	void replace_image(texture& aTexture, uint32_t aFirstLevel, vk::Buffer aStaging, const std::vector<vk::DeviceSize>& aStagingOffsets, std::vector<avk::recorded_commands_t>& aCommands)
+	{
+		const auto numLevels = static_cast<uint32_t>(aTexture.mExtents.size());
+		auto image = avk::context().create_image(aTexture.mExtents[aFirstLevel].width, aTexture.mExtents[aFirstLevel].height, aTexture.mFormat, 1, avk::memory_usage::device, avk::image_usage::general_texture, [count = numLevels - aFirstLevel](avk::image_t& aImage) {
+			aImage.create_info().mipLevels = count;
+		});
+
+		const auto& currentImageSampler = mImageSamplers[std::get<size_t>(aTexture.mSamplers.front())];
+		const bool hasCurrentImage = currentImageSampler.has_value();
+		std::vector<vk::ImageCopy> imageCopies;
+		std::vector<vk::BufferImageCopy> bufferCopies;
+		for (auto level = aFirstLevel; level < numLevels; ++level) {
+			const vk::ImageSubresourceLayers dst{ vk::ImageAspectFlagBits::eColor, level - aFirstLevel, 0, 1 };
+			if (hasCurrentImage && level >= aTexture.mResidentLevel) {
+				const vk::ImageSubresourceLayers src{ vk::ImageAspectFlagBits::eColor, level - aTexture.mResidentLevel, 0, 1 };
+				imageCopies.push_back(vk::ImageCopy{ src, vk::Offset3D{}, dst, vk::Offset3D{}, aTexture.mExtents[level] });
+			}
+			else {
+				bufferCopies.push_back(vk::BufferImageCopy{ aStagingOffsets[level - aFirstLevel], 0, 0, dst, vk::Offset3D{}, aTexture.mExtents[level] });
+			}
+		}
+
+		aCommands.push_back(avk::sync::image_memory_barrier(*image,
+			avk::stage::none >> avk::stage::copy,
+			avk::access::none >> avk::access::transfer_write
+		).with_layout_transition(avk::layout::undefined >> avk::layout::transfer_dst));
+		vk::Image currentHandle{};
+		if (hasCurrentImage) {
+			const auto& currentImage = currentImageSampler->get_image();
+			currentHandle = currentImage.handle();
+			// Frames in flight might still sample it:
+			aCommands.push_back(avk::sync::image_memory_barrier(currentImage,
+				avk::stage::fragment_shader >> (avk::stage::copy | avk::stage::clear),
+				avk::access::none >> avk::access::transfer_read
+			).with_layout_transition(avk::layout::shader_read_only_optimal >> avk::layout::transfer_src));
+		}
+		aCommands.push_back(avk::command::custom_commands([lSrc = currentHandle, lDst = image->handle(), aStaging, imageCopies, bufferCopies](avk::command_buffer_t& cb) {
+			if (!imageCopies.empty()) {
+				cb.handle().copyImage(lSrc, vk::ImageLayout::eTransferSrcOptimal, lDst, vk::ImageLayout::eTransferDstOptimal, imageCopies);
+			}
+			if (!bufferCopies.empty()) {
+				cb.handle().copyBufferToImage(aStaging, lDst, vk::ImageLayout::eTransferDstOptimal, bufferCopies);
+			}
+		}));
+		aCommands.push_back(avk::sync::image_memory_barrier(*image,
+			avk::stage::copy >> avk::stage::fragment_shader,
+			avk::access::transfer_write >> avk::access::shader_sampled_read
+		).with_layout_transition(avk::layout::transfer_dst >> avk::layout::shader_read_only_optimal));
+
+		set_image(aTexture, std::move(image), aFirstLevel);
+	}
+
+	/** Lets all image samplers of the given texture sample aImage, whose level 0 is the texture's level aFirstLevel */
+	void set_image(texture& aTexture, avk::image aImage, uint32_t aFirstLevel)
+	{
+		const auto currentFrame = mCurrentFrame;
+		auto view = avk::context().create_image_view(std::move(aImage));
+		view.enable_shared_ownership();
+		for (auto& [index, sampler] : aTexture.mSamplers) {
+			auto previous = std::move(mImageSamplers[index]);
+			mImageSamplers[index] = avk::context().create_image_sampler(view, sampler);
+			if (previous.has_value()) {
+				// Destroyed by retire_image_samplers when no frame in flight uses it anymore:
+				mRetiredImageSamplers.push_back(retired_image_sampler{ std::move(previous), currentFrame });
+			}
+		}
+		aTexture.mResidentLevel = aFirstLevel;
+	}
+
+	/** Destroys the replaced image samplers which no frame in flight uses anymore, and reports their image views as retired */
+	void retire_image_samplers(avk::window::frame_id_t aCurrentFrame)
+	{
+		const auto framesInFlight = mNumFramesInFlight;
+		// Frame ids increase along the queue:
+		while (!mRetiredImageSamplers.empty() && mRetiredImageSamplers.front().mLastFrame + framesInFlight <= aCurrentFrame) {
+			const auto viewHandle = mRetiredImageSamplers.front().mImageSampler->view_handle();
+			// All image samplers of a texture share one view => only report it together with its last image sampler:
+			const bool viewStillUsed = std::any_of(std::next(mRetiredImageSamplers.begin()), mRetiredImageSamplers.end(), [viewHandle](const retired_image_sampler& r) {
+				return r.mImageSampler->view_handle() == viewHandle;
+			});
+			if (!viewStillUsed && mImageViewRetiredHandler) {
+				mImageViewRetiredHandler(viewHandle);
+			}
+			mRetiredImageSamplers.pop_front();
+		}
+	}
+
+	uint32_t pending_loads() const
+	{
+		return static_cast<uint32_t>(std::count_if(mTextures.begin(), mTextures.end(), [](const texture& t) { return t.mPendingLevel.has_value(); }));
+	}
+
+	void update_statistics()
+	{
+		mStatistics.mResidentBytes = 0;
+		mStatistics.mRequestedLevels.fill(0);
+		mStatistics.mResidentLevels.fill(0);
+		for (const auto& t : mTextures) {
+			mStatistics.mResidentBytes += resident_bytes(t);
+			++mStatistics.mRequestedLevels[std::min(t.mRequestedLevel, cNumHistogramLevels - 1)];
+			++mStatistics.mResidentLevels[std::min(t.mResidentLevel, cNumHistogramLevels - 1)];
+		}
+		mStatistics.mPendingBytes = mPendingBytes;
+		mStatistics.mNumPendingLoads = pending_loads();
+
+		const auto now = std::chrono::steady_clock::now();
+		const auto seconds = std::chrono::duration<double>(now - mWindowBegin).count();
+		if (seconds >= 1.0) {
+			mStatistics.mUploadBytesPerSecond = static_cast<double>(mBytesUploadedInWindow) / seconds;
+			mBytesUploadedInWindow = 0;
+			mWindowBegin = now;
+		}
+	}
+
+	void worker_loop()
+	{
+		for (;;) {
+			load_request request;
+			{
+				std::unique_lock lock(mMutex);
+				mRequestAvailable.wait(lock, [this]() { return mStop || !mRequests.empty(); });
+				if (mStop) {
+					return;
+				}
+				request = std::move(mRequests.front());
+				mRequests.pop_front();
+			}
+
+			load_result result{ request.mTexture, request.mFirstLevel };
+			try {
+				auto imageData = avk::get_image_data(request.mPath, true, false, false, 4);
+				imageData.load();
+				// The coarser levels, too, because the new image is uploaded as a whole:
+				for (auto level = request.mFirstLevel; level < imageData.levels(); ++level) {
+					const auto* data = static_cast<const uint8_t*>(imageData.get_data(0, 0, level));
+					result.mLevels.emplace_back(data, data + imageData.size(level));
+				}
+			}
+			catch (const std::exception& e) {
+				result.mError = e.what();
+			}
+
+			std::scoped_lock lock(mMutex);
+			mFinished.push_back(std::move(result));
+		}
+	}
+
+	upload_batcher* mUploader;
+	size_t mUploadBytesPerFrame;
+	uint32_t mTailExtent;
+
+	std::vector<texture> mTextures;
+	std::vector<avk::image_sampler> mImageSamplers;
+
+	avk::buffer mFeedbackBuffer;
+	std::vector<avk::buffer> mFeedbackReadbackBuffers;
+	std::vector<bool> mFeedbackPending;
+	std::vector<uint32_t> mFeedback;
+
+	// Finished loads which have not been staged yet, and images whose uploads have not completed yet:
+	std::deque<load_result> mLoaded;
+	ticket_queue<upload> mUploading;
+	size_t mPendingBytes = 0;
+
+	// Replaced image samplers which frames in flight might still use, and the frames as of the last update:
+	std::deque<retired_image_sampler> mRetiredImageSamplers;
+	avk::window::frame_id_t mCurrentFrame = 0;
+	avk::window::frame_id_t mNumFramesInFlight = 1;
+	std::function<void(vk::ImageView)> mImageViewRetiredHandler;
+
+	// Shared with the background thread:
+	std::mutex mMutex;
+	std::condition_variable mRequestAvailable;
+	std::deque<load_request> mRequests;
+	std::vector<load_result> mFinished;
+	bool mStop;
+	std::thread mWorker;
+
+	statistics mStatistics;
+	std::chrono::steady_clock::time_point mWindowBegin;
+	size_t mBytesUploadedInWindow = 0;
+};
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <format>
+#include <optional>
+#include <utility>
+
+#include "auto_vk_toolkit.hpp"
+
+/** A FIFO of elements which are waiting for the device, each of which is tagged with the ticket, i.e., the timeline
+ *  semaphore value, after which it is complete.
+ *
+ *  Tickets must not decrease along the queue, i.e., elements must be pushed in submission order. Then, the completed
+ *  elements are always at the front, and retire() can stop at the first element which is not complete yet.
+ *  Several elements may share a ticket if they have been submitted together.
+ *
+ *  It contains no Vulkan objects itself, hence, its ordering can be tested without a device.
+ *
+ *  Usage example:
+ *
+ *	mUploading.push(mUploader->submit(), upload{ ... });
+ *	...
+ *	mUploading.retire(mUploader->completed_ticket(), [this](upload& aUpload) { ... });
+ */
+template <typename T>
+class ticket_queue
+{
+public:
+	/**	Appends an element which is complete as soon as the given ticket is.
+	 *	@param	aTicket		The ticket of the element's submission; must not be less than the ticket of the last element
+	 *	@param	aElement	The element
+	 */
+	void push(uint64_t aTicket, T aElement)
+	{
+		if (!mElements.empty() && aTicket < mElements.back().first) {
+			throw avk::logic_error(std::format("Ticket {} is pushed after ticket {}, but tickets must not decrease along the queue.", aTicket, mElements.back().first));
+		}
+		mElements.emplace_back(aTicket, std::move(aElement));
+	}
+
+	/**	Removes all elements from the front whose tickets are complete, in the order in which they have been pushed.
+	 *	@param	aCompletedTicket	The highest ticket which has completed, e.g., the current value of the timeline semaphore
+	 *	@param	aOnRetire			Invoked with every removed element before it is removed
+	 *	@return	The number of removed elements
+	 */
+	template <typename F>
+	size_t retire(uint64_t aCompletedTicket, F&& aOnRetire)
+	{
+		size_t count = 0;
+		while (!mElements.empty() && mElements.front().first <= aCompletedTicket) {
+			aOnRetire(mElements.front().second);
+			mElements.pop_front();
+			++count;
+		}
+		return count;
+	}
+
+	bool empty() const { return mElements.empty(); }
+
+	size_t size() const { return mElements.size(); }
+
+	/** The ticket of the element which has been pushed first, if any */
+	std::optional<uint64_t> oldest_ticket() const
+	{
+		if (mElements.empty()) {
+			return {};
+		}
+		return mElements.front().first;
+	}
+
+	/** The ticket of the element which has been pushed last, if any. All elements are complete when it is. */
+	std::optional<uint64_t> newest_ticket() const
+	{
+		if (mElements.empty()) {
+			return {};
+		}
+		return mElements.back().first;
+	}
+
+private:
+	std::deque<std::pair<uint64_t, T>> mElements;
+};
@@ -0,0 +1,392 @@
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <optional>
+#include <tuple>
+#include <vector>
+
+#include "auto_vk_toolkit.hpp"
+#include "ticket_queue.hpp"
+#include "upload_ring.hpp"
+
+/** Batches many host -> device uploads into as few submissions as possible, and submits them to a transfer queue
+ *  without waiting for them on the host.
+ *
+ *  All data is written into one persistently mapped staging buffer which is used as a ring:
+ *  Copy regions are collected per destination buffer and image and recorded into ONE command buffer per submit(),
+ *  which is submitted to the transfer queue and signals the next value of a timeline semaphore. That value is the
+ *  submission's ticket. Staging memory is reused as soon as the timeline semaphore shows that the device is done with it;
+ *  only if the ring runs full, the pending copies are submitted early, and the host waits for the oldest submission.
+ *
+ *  Uploaded resources must be handed over to the graphics queue via acquire() before the graphics queue uses them:
+ *  Its next submission must wait on the timeline semaphore, and, if the transfer queue belongs to another queue family,
+ *  record the acquiring halves of the queue family ownership transfers which the transfer queue has released.
+ *  The transfer queue can be the graphics queue itself, e.g., if the device has no transfer-only queue family.
+ *  Then, the uploads are simply ordered by the timeline semaphore, and nothing else changes for the caller.
+ *
+ *  Only upload into buffers and images which the graphics queue has not used before, because the previous contents of
+ *  images are discarded, and buffers are not released by the graphics queue before the transfer queue writes them.
+ *
+ *  Usage example:
+ *
+ *	upload_batcher batcher(transferQueue, *mQueue);
+ *	batcher.stage(positionsPool, 0, positions.data(), positions.size() * sizeof(glm::vec3));
+ *	batcher.stage(indexPool, 0, indices.data(), indices.size() * sizeof(uint32_t));
+ *	const auto ticket = batcher.submit();
+ *	...
+ *	// In the first frame which uses the buffers:
+ *	if (auto handover = batcher.acquire(ticket)) {
+ *		auto& [waitInfo, acquireBarriers] = handover.value();
+ *		mRenderGraph->add_pass("Uploads").waiting_for(std::move(waitInfo)).recording(std::move(acquireBarriers));
+ *	}
+ */
+class upload_batcher
+{
+	struct buffer_copies
+	{
+		const avk::buffer_t* mBuffer = nullptr;
+		std::vector<vk::BufferCopy> mRegions;
+	};
+
+public:
+	/**	Uploads via a transfer queue, and hands the uploaded resources over to the graphics queue.
+	 *	@param	aTransferQueue		The queue which the copies are submitted to; may be the same as aGraphicsQueue
+	 *	@param	aGraphicsQueue		The queue which uses the uploaded resources
+	 *	@param	aStagingCapacity	Size of the staging ring in bytes, which is the largest size of one image upload
+	 */
+	upload_batcher(avk::queue& aTransferQueue, avk::queue& aGraphicsQueue, size_t aStagingCapacity = 64 * 1024 * 1024)
+		: mTransferQueue{ &aTransferQueue }
+		, mGraphicsQueue{ &aGraphicsQueue }
+		, mRing{ aStagingCapacity }
+		, mTimelineValue{ 0 }
+		, mAcquiredValue{ 0 }
+		, mNumSubmissions{ 0 }
+		, mBytesUploaded{ 0 }
+	{
+		mStagingBuffer = avk::context().create_buffer(
+			AVK_STAGING_BUFFER_MEMORY_USAGE,
+			vk::BufferUsageFlagBits::eTransferSrc,
+			avk::generic_buffer_meta::create_from_size(mRing.capacity())
+		);
+		// Keep the staging buffer mapped for the whole lifetime of the batcher:
+		mMapping.emplace(mStagingBuffer->memory_handle(), avk::mapping_access::write);
+		mCommandPool = avk::context().create_command_pool(mTransferQueue->family_index(), vk::CommandPoolCreateFlagBits::eTransient);
+		mTimeline = avk::context().create_timeline_semaphore(0);
+	}
+
+	/**	Uploads via the graphics queue itself.
+	 *	@param	aQueue				The queue which the copies are submitted to, and which uses the uploaded resources
+	 *	@param	aStagingCapacity	Size of the staging ring in bytes
+	 */
+	upload_batcher(avk::queue& aQueue, size_t aStagingCapacity = 64 * 1024 * 1024)
+		: upload_batcher(aQueue, aQueue, aStagingCapacity)
+	{
+	}
+
+	upload_batcher(upload_batcher&&) noexcept = delete;
+	upload_batcher(const upload_batcher&) = delete;
+	upload_batcher& operator=(upload_batcher&&) noexcept = delete;
+	upload_batcher& operator=(const upload_batcher&) = delete;
+	~upload_batcher()
+	{
+		// The device must be done with the staging memory and the command buffers before they are destroyed:
+		wait(submit());
+	}
+
+	/**	Reserve staging memory for an upload of aSize bytes into aDstBuffer at aDstOffset.
+	 *	The writer is invoked once per contiguous chunk of staging memory with the chunk's
+	 *	address and size. Uploads which exceed the ring's free space are split into multiple chunks.
+	 *	@param	aDstBuffer		The (device) buffer to upload to. It must stay alive until the upload has completed.
+	 *	@param	aDstOffset		Offset in bytes into aDstBuffer
+	 *	@param	aSize			Total number of bytes to upload
+	 *	@param	aWriter			Callback of the form void(void* aStagingMemory, size_t aChunkSize) which writes the data.
+	 */
+	template <typename F>
+	void stage(const avk::buffer_t& aDstBuffer, size_t aDstOffset, size_t aSize, F&& aWriter)
+	{
+		size_t written = 0;
+		while (written < aSize) {
+			// Take whatever fits right now, but do not fragment the upload into tiny chunks:
+			retire_completed_submissions();
+			auto chunkSize = std::min(aSize - written, mRing.largest_free_chunk());
+			if (chunkSize < std::min(aSize - written, cMinChunkSize)) {
+				chunkSize = std::min(aSize - written, mRing.capacity() / 2);
+			}
+			const auto offset = allocate(chunkSize);
+			aWriter(static_cast<uint8_t*>(mMapping->get()) + offset, chunkSize);
+
+			auto& pending = mPendingCopies[aDstBuffer.handle()];
+			pending.mBuffer = &aDstBuffer;
+			pending.mRegions.push_back(vk::BufferCopy{ offset, aDstOffset + written, chunkSize });
+			written += chunkSize;
+		}
+		mBytesUploaded += aSize;
+	}
+
+	/**	Copy aSize bytes from aData into staging memory and schedule an upload of them into aDstBuffer at aDstOffset.
+	 *	@param	aDstBuffer		The (device) buffer to upload to. It must stay alive until the upload has completed.
+	 *	@param	aDstOffset		Offset in bytes into aDstBuffer
+	 *	@param	aData			Pointer to the data to be uploaded
+	 *	@param	aSize			Number of bytes to upload
+	 */
+	void stage(const avk::buffer_t& aDstBuffer, size_t aDstOffset, const void* aData, size_t aSize)
+	{
+		const auto* src = static_cast<const uint8_t*>(aData);
+		stage(aDstBuffer, aDstOffset, aSize, [&src](void* aStagingMemory, size_t aChunkSize) {
+			std::memcpy(aStagingMemory, src, aChunkSize);
+			src += aChunkSize;
+		});
+	}
+
+	/**	Copy the given mip levels into staging memory and schedule an upload of them into aDstImage.
+	 *	Afterwards, the image is in layout shader_read_only_optimal.
+	 *	@param	aDstImage		A 2D image with one layer, whose previous contents are discarded. It must stay alive until the upload has completed.
+	 *	@param	aLevels			The data of levels 0, 1, ... of aDstImage, tightly packed
+	 */
+	void stage(const avk::image_t& aDstImage, const std::vector<std::vector<uint8_t>>& aLevels)
+	{
+		// All levels in one piece, so that they end up in the same submission as the image's barriers:
+		auto offset = allocate(staging_size(aLevels));
+		std::vector<vk::BufferImageCopy> copies;
+		for (uint32_t level = 0; level < static_cast<uint32_t>(aLevels.size()); ++level) {
+			const auto& extent = aDstImage.create_info().extent;
+			const vk::Extent3D levelExtent{ std::max(extent.width >> level, 1u), std::max(extent.height >> level, 1u), 1u };
+			std::memcpy(static_cast<uint8_t*>(mMapping->get()) + offset, aLevels[level].data(), aLevels[level].size());
+			copies.push_back(vk::BufferImageCopy{ offset, 0, 0, vk::ImageSubresourceLayers{ vk::ImageAspectFlagBits::eColor, level, 0, 1 }, vk::Offset3D{}, levelExtent });
+			offset = upload_ring::align(offset + aLevels[level].size());
+			mBytesUploaded += aLevels[level].size();
+		}
+		mPendingImageCopies.emplace_back(aDstImage.handle(), std::move(copies));
+
+		mPendingLayoutTransitions.push_back(avk::sync::image_memory_barrier(aDstImage,
+			avk::stage::none >> avk::stage::copy,
+			avk::access::none >> avk::access::transfer_write
+		).with_layout_transition(avk::layout::undefined >> avk::layout::transfer_dst));
+		auto release = avk::sync::image_memory_barrier(aDstImage,
+			avk::stage::copy >> avk::stage::none,
+			avk::access::transfer_write >> avk::access::none
+		).with_layout_transition(avk::layout::transfer_dst >> avk::layout::shader_read_only_optimal);
+		if (transfers_ownership()) {
+			release.with_queue_family_ownership_transfer(mTransferQueue->family_index(), mGraphicsQueue->family_index());
+			// The acquiring half must specify the same layout transition:
+			mPendingAcquires.push_back(avk::sync::image_memory_barrier(aDstImage,
+				avk::stage::none >> avk::stage::all_commands,
+				avk::access::none >> avk::access::shader_sampled_read
+			).with_layout_transition(avk::layout::transfer_dst >> avk::layout::shader_read_only_optimal)
+			 .with_queue_family_ownership_transfer(mTransferQueue->family_index(), mGraphicsQueue->family_index()));
+		}
+		mPendingReleases.push_back(std::move(release));
+	}
+
+	/**	Checks whether an upload of the given levels can be staged right now, without waiting for earlier submissions.
+	 *	Use this for uploads at runtime, which must never stall the frame.
+	 */
+	bool can_stage_without_waiting(const std::vector<std::vector<uint8_t>>& aLevels)
+	{
+		retire_completed_submissions();
+		return mRing.find_space(staging_size(aLevels)).has_value();
+	}
+
+	/**	Records all pending copies into one command buffer and submits it to the transfer queue, without waiting.
+	 *	@return	The ticket of the submission, i.e., the value which the timeline semaphore will have when the copies have completed.
+	 *			If nothing is pending, the ticket of the last submission.
+	 */
+	uint64_t submit()
+	{
+		if (mPendingCopies.empty() && mPendingImageCopies.empty()) {
+			return mTimelineValue;
+		}
+
+		// A buffer might be written by several submissions, hence, only the range which this one has written is transferred:
+		if (transfers_ownership()) {
+			for (const auto& [dstHandle, copies] : mPendingCopies) {
+				vk::DeviceSize begin = std::numeric_limits<vk::DeviceSize>::max();
+				vk::DeviceSize end = 0;
+				for (const auto& region : copies.mRegions) {
+					begin = std::min(begin, region.dstOffset);
+					end = std::max(end, region.dstOffset + region.size);
+				}
+				mPendingReleases.push_back(avk::sync::buffer_memory_barrier(*copies.mBuffer,
+					avk::stage::copy >> avk::stage::none,
+					avk::access::transfer_write >> avk::access::none
+				).for_offset_and_size(begin, end - begin)
+				 .with_queue_family_ownership_transfer(mTransferQueue->family_index(), mGraphicsQueue->family_index()));
+				mPendingAcquires.push_back(avk::sync::buffer_memory_barrier(*copies.mBuffer,
+					avk::stage::none >> avk::stage::all_commands,
+					avk::access::none >> avk::access::memory_read
+				).for_offset_and_size(begin, end - begin)
+				 .with_queue_family_ownership_transfer(mTransferQueue->family_index(), mGraphicsQueue->family_index()));
+			}
+		}
+
+		std::vector<avk::recorded_commands_t> commands;
+		std::move(mPendingLayoutTransitions.begin(), mPendingLayoutTransitions.end(), std::back_inserter(commands));
+		auto stagingHandle = mStagingBuffer->handle();
+		std::vector<std::tuple<vk::Buffer, std::vector<vk::BufferCopy>>> bufferCopies;
+		for (auto& [dstHandle, copies] : mPendingCopies) {
+			bufferCopies.emplace_back(dstHandle, std::move(copies.mRegions));
+		}
+		commands.push_back(avk::command::custom_commands([stagingHandle, copies = std::move(bufferCopies), imageCopies = std::move(mPendingImageCopies)](avk::command_buffer_t& cb) {
+			for (const auto& [dstHandle, regions] : copies) {
+				cb.handle().copyBuffer(stagingHandle, dstHandle, static_cast<uint32_t>(regions.size()), regions.data());
+			}
+			for (const auto& [dstHandle, regions] : imageCopies) {
+				cb.handle().copyBufferToImage(stagingHandle, dstHandle, vk::ImageLayout::eTransferDstOptimal, static_cast<uint32_t>(regions.size()), regions.data());
+			}
+		}));
+		std::move(mPendingReleases.begin(), mPendingReleases.end(), std::back_inserter(commands));
+
+		auto commandBuffer = mCommandPool->alloc_command_buffer(vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
+		++mTimelineValue;
+		avk::context().record(std::move(commands))
+			.into_command_buffer(commandBuffer.as_reference())
+			.then_submit_to(*mTransferQueue)
+			.signaling_upon_completion((avk::stage::all_commands >> mTimeline.as_reference()).at_value(mTimelineValue))
+			.submit();
+
+		mHandovers.push(mTimelineValue, std::move(mPendingAcquires));
+		mRing.submitted(mTimelineValue);
+		mInFlight.push(mTimelineValue, std::move(commandBuffer));
+		mPendingCopies.clear();
+		mPendingImageCopies.clear();
+		mPendingLayoutTransitions.clear();
+		mPendingReleases.clear();
+		mPendingAcquires.clear();
+		++mNumSubmissions;
+		return mTimelineValue;
+	}
+
+	/** Returns the ticket of the last submission which has completed on the device */
+	uint64_t completed_ticket() const
+	{
+		return mTimeline->query_current_value();
+	}
+
+	/** Returns true if the submission with the given ticket has completed on the device */
+	bool is_complete(uint64_t aTicket) const
+	{
+		return completed_ticket() >= aTicket;
+	}
+
+	/** Waits on the host until the submission with the given ticket has completed */
+	void wait(uint64_t aTicket)
+	{
+		if (aTicket > 0) {
+			mTimeline->wait_until_value(aTicket);
+		}
+		retire_completed_submissions();
+	}
+
+	/**	Submits all pending copies, and waits on the host until they have completed.
+	 *	They still have to be handed over to the graphics queue via acquire().
+	 */
+	void submit_and_wait()
+	{
+		wait(submit());
+	}
+
+	/**	Hands all uploads over to the graphics queue which have completed on the device, and all uploads up to the given
+	 *	ticket even if they have not completed yet. Call this once per frame, before the uploaded resources are used.
+	 *	@param	aRequiredTicket		Uploads up to this ticket are handed over in any case, i.e., the graphics queue might wait for them
+	 *	@return	If there are uploads to hand over: the semaphore wait which the graphics queue's next submission must perform,
+	 *			and the barriers which it must record before it uses any of the uploaded resources
+	 */
+	std::optional<std::tuple<avk::semaphore_wait_info, std::vector<avk::recorded_commands_t>>> acquire(uint64_t aRequiredTicket = 0)
+	{
+		const auto value = std::max(std::min(aRequiredTicket, mTimelineValue), mTimeline->query_current_value());
+		if (value <= mAcquiredValue) {
+			return {};
+		}
+		std::vector<avk::recorded_commands_t> barriers;
+		mHandovers.retire(value, [&barriers](std::vector<avk::recorded_commands_t>& aAcquireBarriers) {
+			std::move(aAcquireBarriers.begin(), aAcquireBarriers.end(), std::back_inserter(barriers));
+		});
+		mAcquiredValue = value;
+		return std::make_tuple((mTimeline.as_reference() >> avk::stage::all_commands).at_value(value), std::move(barriers));
+	}
+
+	/** Returns true if the copies are submitted to another queue than the graphics queue */
+	bool uses_separate_queue() const
+	{
+		return mTransferQueue->family_index() != mGraphicsQueue->family_index() || mTransferQueue->queue_index() != mGraphicsQueue->queue_index();
+	}
+
+	/** The number of submissions that have been made so far. Ideally, this is 1 for a whole scene. */
+	size_t num_submissions() const { return mNumSubmissions; }
+
+	/** The total number of bytes uploaded through this batcher */
+	size_t bytes_uploaded() const { return mBytesUploaded; }
+
+private:
+	// Buffer uploads are not split into smaller chunks than this, unless they are smaller:
+	static constexpr size_t cMinChunkSize = 1024 * 1024;
+
+	static size_t staging_size(const std::vector<std::vector<uint8_t>>& aLevels)
+	{
+		size_t size = 0;
+		for (const auto& level : aLevels) {
+			size = upload_ring::align(size + level.size());
+		}
+		return size;
+	}
+
+	bool transfers_ownership() const
+	{
+		return mTransferQueue->family_index() != mGraphicsQueue->family_index();
+	}
+
+	/** Reserves aSize bytes of staging memory; submits the pending copies and waits for earlier submissions if necessary */
+	size_t allocate(size_t aSize)
+	{
+		if (aSize > mRing.capacity()) {
+			throw avk::runtime_error(std::format("An upload of {} bytes does not fit into the staging ring of {} bytes.", aSize, mRing.capacity()));
+		}
+		retire_completed_submissions();
+		auto offset = mRing.find_space(aSize);
+		while (!offset.has_value()) {
+			if (!mPendingCopies.empty() || !mPendingImageCopies.empty()) {
+				submit();
+			}
+			wait(mRing.oldest_ticket().value());
+			offset = mRing.find_space(aSize);
+		}
+		mRing.reserve(offset.value(), aSize);
+		return offset.value();
+	}
+
+	void retire_completed_submissions()
+	{
+		const auto completed = completed_ticket();
+		mRing.retire(completed);
+		mInFlight.retire(completed, [](avk::command_buffer&) {});
+	}
+
+	avk::queue* mTransferQueue;
+	avk::queue* mGraphicsQueue;
+	avk::buffer mStagingBuffer;
+	std::optional<avk::scoped_mapping<AVK_MEM_BUFFER_HANDLE>> mMapping;
+	upload_ring mRing;
+
+	// Not submitted yet:
+	std::map<vk::Buffer, buffer_copies> mPendingCopies;
+	std::vector<std::tuple<vk::Image, std::vector<vk::BufferImageCopy>>> mPendingImageCopies;
+	std::vector<avk::recorded_commands_t> mPendingLayoutTransitions;
+	std::vector<avk::recorded_commands_t> mPendingReleases;
+	std::vector<avk::recorded_commands_t> mPendingAcquires;
+
+	avk::command_pool mCommandPool;
+	avk::semaphore mTimeline;
+	uint64_t mTimelineValue;
+	// The command buffers of the submissions which have not completed yet:
+	ticket_queue<avk::command_buffer> mInFlight;
+	// The acquiring barriers of the submissions which have not been handed over to the graphics queue yet:
+	ticket_queue<std::vector<avk::recorded_commands_t>> mHandovers;
+	uint64_t mAcquiredValue;
+
+	size_t mNumSubmissions;
+	size_t mBytesUploaded;
+};
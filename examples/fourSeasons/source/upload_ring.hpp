@@ -0,0 +1,122 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+
+#include "ticket_queue.hpp"
+
+/** The bookkeeping of upload_batcher's staging ring: which bytes of the ring are in use by which submission, and where
+ *  the next upload fits. It contains no Vulkan objects, hence, it can be tested without a device.
+ *
+ *  The memory in use is [tail, head), wrapped around at the end of the ring if head < tail. Memory is reserved at the
+ *  head, and all memory which has been reserved since the last submission belongs to the next one. It is recycled at
+ *  the tail when the submission's ticket has completed, i.e., in submission order. Whenever nothing is reserved or in
+ *  flight, the ring starts at its beginning again.
+ *
+ *  Usage example:
+ *
+ *	upload_ring ring{ capacity };
+ *	auto offset = ring.find_space(size);	// Retire or wait for submissions while there is no space
+ *	ring.reserve(offset.value(), size);
+ *	...
+ *	ring.submitted(ticket);
+ *	...
+ *	ring.retire(completedTicket);
+ */
+class upload_ring
+{
+public:
+	/** Creates an empty ring of aCapacity bytes */
+	explicit upload_ring(size_t aCapacity)
+		: mCapacity{ aCapacity }
+		, mHead{ 0 }
+		, mTail{ 0 }
+		, mHasReservations{ false }
+	{
+	}
+
+	size_t capacity() const { return mCapacity; }
+
+	/**	Finds aSize contiguous bytes of free memory. A wrapped-around head never reaches the tail, which would mean "empty".
+	 *	@return	The offset of the memory, or nothing if the ring is too full right now
+	 */
+	std::optional<size_t> find_space(size_t aSize) const
+	{
+		const auto head = align(mHead);
+		if (mTail <= mHead) {
+			if (head + aSize <= mCapacity) {
+				return head;
+			}
+			if (aSize < mTail) {
+				return size_t{ 0 }; // The rest of the ring stays unused until the ring wraps around again
+			}
+			return {};
+		}
+		if (head + aSize < mTail) {
+			return head;
+		}
+		return {};
+	}
+
+	/** The size of the largest block of memory which find_space would find right now */
+	size_t largest_free_chunk() const
+	{
+		const auto head = align(mHead);
+		if (mTail <= mHead) {
+			return std::max(mCapacity - std::min(head, mCapacity), mTail > 0 ? mTail - 1 : 0);
+		}
+		return head < mTail ? mTail - head - 1 : 0;
+	}
+
+	/**	Marks aSize bytes at aOffset as in use by the next submission.
+	 *	@param	aOffset		An offset which find_space has just returned for aSize
+	 *	@param	aSize		Number of bytes
+	 */
+	void reserve(size_t aOffset, size_t aSize)
+	{
+		mHead = aOffset + aSize;
+		mHasReservations = true;
+	}
+
+	/** Hands all memory which has been reserved since the last submission over to the submission with the given ticket */
+	void submitted(uint64_t aTicket)
+	{
+		mInFlight.push(aTicket, mHead);
+		mHasReservations = false;
+	}
+
+	/** Recycles the memory of all submissions whose tickets are at most aCompletedTicket */
+	void retire(uint64_t aCompletedTicket)
+	{
+		mInFlight.retire(aCompletedTicket, [this](size_t aEnd) {
+			mTail = aEnd;
+		});
+		// Start at the beginning of the ring whenever it is empty:
+		if (mInFlight.empty() && !mHasReservations) {
+			mHead = 0;
+			mTail = 0;
+		}
+	}
+
+	/** The ticket of the oldest submission whose memory is still in use, which has to complete before any memory is recycled */
+	std::optional<uint64_t> oldest_ticket() const { return mInFlight.oldest_ticket(); }
+
+	/** The number of submissions whose memory is still in use */
+	size_t num_in_flight() const { return mInFlight.size(); }
+
+	static size_t align(size_t aOffset)
+	{
+		// Satisfies the offset alignment of copies into block-compressed images, and keeps the source offsets friendly for the DMA engines:
+		constexpr size_t alignment = 16;
+		return (aOffset + alignment - 1) & ~(alignment - 1);
+	}
+
+private:
+	size_t mCapacity;
+	size_t mHead;
+	size_t mTail;
+	bool mHasReservations;
+	// Where each submission's memory ends in the ring:
+	ticket_queue<size_t> mInFlight;
+};
@@ -0,0 +1,181 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+#include <glm/gtc/packing.hpp>
+
+#include "auto_vk_toolkit.hpp"
+
+/** The layouts in which the scene's vertices can be fed to the G-buffer pass */
+enum struct vertex_format
+{
+	/** Three separate buffers with glm::vec3 positions, glm::vec2 texture coordinates, and glm::vec3 normals: 32 bytes per vertex */
+	separate_full_precision,
+	/** One buffer of interleaved packed_vertex elements: 16 bytes per vertex */
+	interleaved_quantized
+};
+
+/** One vertex of the vertex_format::interleaved_quantized layout */
+struct packed_vertex
+{
+	/** Position within the mesh's AABB, as 16 bit unsigned normalized integers (w is unused) */
+	glm::u16vec4 mPosition;
+	/** Octahedral-encoded normal, as 16 bit signed normalized integers */
+	glm::i16vec2 mNormal;
+	/** Texture coordinates, as half-precision floats */
+	glm::u16vec2 mTexCoord;
+};
+static_assert(sizeof(packed_vertex) == 16, "packed_vertex must match the vertex input description");
+
+/** Maps positions within an axis-aligned bounding box to [0, 1]^3. The vertex shader transforms them back with mOffset + p * mScale. */
+struct position_quantization
+{
+	glm::vec3 mOffset;
+	glm::vec3 mScale;
+
+	/** Returns the quantization for the bounding box of the given positions */
+	static position_quantization from_positions(const std::vector<glm::vec3>& aPositions)
+	{
+		if (aPositions.empty()) {
+			return { glm::vec3{ 0.0f }, glm::vec3{ 1.0f } };
+		}
+		glm::vec3 min{ std::numeric_limits<float>::max() };
+		glm::vec3 max{ std::numeric_limits<float>::lowest() };
+		for (const auto& p : aPositions) {
+			min = glm::min(min, p);
+			max = glm::max(max, p);
+		}
+		return { min, max - min };
+	}
+};
+
+/** Converts vertex data into the vertex_format::interleaved_quantized layout and back, and describes both layouts to the pipeline.
+ *
+ *  Positions are quantized relative to the AABB of the draw call they belong to, s.t. the maximum error is half a step, i.e.,
+ *  0.5 / 65535 of the AABB's extent per axis. Normals are mapped onto an octahedron and its lower half is folded over the
+ *  upper half, which distributes the 2 x 16 bits evenly over the sphere. Texture coordinates are stored as half floats with
+ *  a relative error of at most 2^-11, which covers the repeating texture coordinates of typical scenes.
+ *
+ *  Usage example:
+ *
+ *	auto quantization = position_quantization::from_positions(positions);
+ *	auto vertices = vertex_packing::pack(positions, texCoords, normals, quantization);
+ *	std::apply([&](auto... aInputs) {
+ *		pipeline = avk::context().create_graphics_pipeline_for(..., aInputs..., ...);
+ *	}, vertex_packing::input_description(vertex_format::interleaved_quantized));
+ */
+class vertex_packing
+{
+public:
+	/** Number of bytes of one vertex in the given layout, summed over all of its buffers */
+	static constexpr size_t bytes_per_vertex(vertex_format aFormat)
+	{
+		return vertex_format::interleaved_quantized == aFormat
+			? sizeof(packed_vertex)
+			: sizeof(glm::vec3) + sizeof(glm::vec2) + sizeof(glm::vec3);
+	}
+
+	/** The vertex input description of the given layout, for locations 0 (position), 1 (texture coordinates), and 2 (normal).
+	 *  The vertex buffers must be bound in the same order as the bindings are numbered.
+	 */
+	static std::array<avk::input_binding_to_location_mapping, 3> input_description(vertex_format aFormat)
+	{
+		if (vertex_format::interleaved_quantized == aFormat) {
+			return {
+				avk::from_buffer_binding(0) -> stream_per_vertex(offsetof(packed_vertex, mPosition), vk::Format::eR16G16B16A16Unorm, sizeof(packed_vertex)) -> to_location(0),
+				avk::from_buffer_binding(0) -> stream_per_vertex(offsetof(packed_vertex, mTexCoord), vk::Format::eR16G16Sfloat, sizeof(packed_vertex)) -> to_location(1),
+				avk::from_buffer_binding(0) -> stream_per_vertex(offsetof(packed_vertex, mNormal), vk::Format::eR16G16Snorm, sizeof(packed_vertex)) -> to_location(2)
+			};
+		}
+		return {
+			avk::from_buffer_binding(0) -> stream_per_vertex<glm::vec3>() -> to_location(0),
+			avk::from_buffer_binding(1) -> stream_per_vertex<glm::vec2>() -> to_location(1),
+			avk::from_buffer_binding(2) -> stream_per_vertex<glm::vec3>() -> to_location(2)
+		};
+	}
+
+	/** The G-buffer pass' vertex shader which reads the given layout */
+	static const char* vertex_shader_path(vertex_format aFormat)
+	{
+		return vertex_format::interleaved_quantized == aFormat ? "shaders/raster_packed.vert" : "shaders/raster.vert";
+	}
+
+	/** Maps a unit vector onto the [-1, 1]^2 square via the octahedron; same as octahedral_encode in shaders/raster_packed.vert */
+	static glm::vec2 encode_octahedral(const glm::vec3& aNormal)
+	{
+		const float l1 = std::abs(aNormal.x) + std::abs(aNormal.y) + std::abs(aNormal.z);
+		if (l1 <= 0.0f) {
+			return glm::vec2{ 0.0f };
+		}
+		glm::vec2 p = glm::vec2{ aNormal } / l1;
+		if (aNormal.z < 0.0f) {
+			p = (1.0f - glm::abs(glm::vec2{ p.y, p.x })) * sign_not_zero(p);
+		}
+		return p;
+	}
+
+	/** Inverse of encode_octahedral; same as octahedral_decode in shaders/raster_packed.vert */
+	static glm::vec3 decode_octahedral(const glm::vec2& aEncoded)
+	{
+		glm::vec3 n{ aEncoded.x, aEncoded.y, 1.0f - std::abs(aEncoded.x) - std::abs(aEncoded.y) };
+		if (n.z < 0.0f) {
+			const auto xy = (1.0f - glm::abs(glm::vec2{ n.y, n.x })) * sign_not_zero(glm::vec2{ n });
+			n.x = xy.x;
+			n.y = xy.y;
+		}
+		return glm::normalize(n);
+	}
+
+	/** Packs one vertex */
+	static packed_vertex pack(const glm::vec3& aPosition, const glm::vec2& aTexCoord, const glm::vec3& aNormal, const position_quantization& aQuantization)
+	{
+		const glm::vec3 invScale{
+			aQuantization.mScale.x > 0.0f ? 1.0f / aQuantization.mScale.x : 0.0f,
+			aQuantization.mScale.y > 0.0f ? 1.0f / aQuantization.mScale.y : 0.0f,
+			aQuantization.mScale.z > 0.0f ? 1.0f / aQuantization.mScale.z : 0.0f
+		};
+		packed_vertex result;
+		result.mPosition = glm::packUnorm<uint16_t>(glm::vec4{ (aPosition - aQuantization.mOffset) * invScale, 1.0f });
+		result.mNormal = glm::packSnorm<int16_t>(encode_octahedral(aNormal));
+		result.mTexCoord = glm::packHalf(aTexCoord);
+		return result;
+	}
+
+	/** Packs all vertices of a draw call. All three vectors must have the same size. */
+	static std::vector<packed_vertex> pack(const std::vector<glm::vec3>& aPositions, const std::vector<glm::vec2>& aTexCoords, const std::vector<glm::vec3>& aNormals, const position_quantization& aQuantization)
+	{
+		std::vector<packed_vertex> result;
+		result.reserve(aPositions.size());
+		for (size_t i = 0; i < aPositions.size(); ++i) {
+			result.push_back(pack(aPositions[i], aTexCoords[i], aNormals[i], aQuantization));
+		}
+		return result;
+	}
+
+	/** Decodes a position like the vertex shader does */
+	static glm::vec3 unpack_position(const packed_vertex& aVertex, const position_quantization& aQuantization)
+	{
+		return aQuantization.mOffset + glm::vec3{ glm::unpackUnorm<float>(aVertex.mPosition) } * aQuantization.mScale;
+	}
+
+	/** Decodes a normal like the vertex shader does */
+	static glm::vec3 unpack_normal(const packed_vertex& aVertex)
+	{
+		return decode_octahedral(glm::unpackSnorm<float>(aVertex.mNormal));
+	}
+
+	/** Decodes texture coordinates like the vertex input stage does */
+	static glm::vec2 unpack_tex_coord(const packed_vertex& aVertex)
+	{
+		return glm::unpackHalf(aVertex.mTexCoord);
+	}
+
+private:
+	static glm::vec2 sign_not_zero(const glm::vec2& aValue)
+	{
+		return { aValue.x >= 0.0f ? 1.0f : -1.0f, aValue.y >= 0.0f ? 1.0f : -1.0f };
+	}
+};
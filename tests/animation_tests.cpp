@@ -0,0 +1,221 @@
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "auto_vk_toolkit.hpp"
+#include "animation.hpp"
+#include "compressed_animation_helpers.hpp"
+#include "test_framework.hpp"
+
+// Evaluates a synthetic skeleton (a chain of bones, whose keys are at the ticks 0, 1, 2, ...) with avk::animation, and
+// compares the different ways of finding and evaluating the keys against each other.
+
+namespace
+{
+	constexpr size_t cNumBones = 32;
+	constexpr double cTicksPerSecond = 30.0;
+
+	/** Every bone moves smoothly, with some noise on top, similar to motion capture data */
+	avk::animation create_animation(size_t aNumKeys)
+	{
+		std::mt19937 rng{ 7u };
+		std::uniform_real_distribution<float> dist{ -1.0f, 1.0f };
+
+		std::vector<avk::animated_node> nodes(cNumBones);
+		for (size_t bi = 0; bi < cNumBones; ++bi) {
+			auto& anode = nodes[bi];
+			const auto phase = dist(rng) * 3.14159f;
+			const auto axis = glm::normalize(glm::vec3{ dist(rng), dist(rng), dist(rng) });
+			for (size_t k = 0; k < aNumKeys; ++k) {
+				const auto t = static_cast<double>(k);
+				const auto s = std::sin(static_cast<float>(k) * 0.05f + phase);
+				anode.mPositionKeys.push_back({ t, glm::vec3{ s, 0.5f * s, 0.1f } + glm::vec3{ dist(rng), dist(rng), dist(rng) } * 1e-5f });
+				anode.mRotationKeys.push_back({ t, glm::angleAxis(s + dist(rng) * 1e-4f, axis) });
+				anode.mScalingKeys.push_back({ t, glm::vec3{ 1.0f } });
+			}
+			// Search every channel separately:
+			anode.mSameRotationAndPositionKeyTimes = false;
+			anode.mSameScalingAndPositionKeyTimes = false;
+			anode.mLocalTransform = glm::mat4{ 1.0f };
+			anode.mGlobalTransform = glm::mat4{ 1.0f };
+			anode.mParentTransform = glm::mat4{ 1.0f };
+			if (bi > 0) {
+				anode.mAnimatedParentIndex = bi - 1;
+			}
+			avk::bone_mesh_data target{};
+			target.mInverseBindPoseMatrix = glm::mat4{ 1.0f };
+			target.mInverseMeshRootMatrix = glm::mat4{ 1.0f };
+			target.mMeshBoneInfo = avk::mesh_bone_info{ 0, 0, static_cast<uint32_t>(bi), 0 };
+			anode.mBoneMeshTargets.push_back(target);
+		}
+		return avk::animation::from_animated_nodes(std::move(nodes), 0u, cNumBones);
+	}
+
+	avk::animation_clip_data clip_of(size_t aNumKeys)
+	{
+		return avk::animation_clip_data{ 0u, cTicksPerSecond, 0.0, static_cast<double>(aNumKeys - 1) };
+	}
+}
+
+AVK_TEST(animation_keys_are_hit_exactly)
+{
+	constexpr size_t numKeys = 100;
+	auto ani = create_animation(numKeys);
+	for (size_t bi = 0; bi < cNumBones; ++bi) {
+		const avk::animated_node& anode = ani.get_animated_node_at(bi);
+		for (size_t k = 0; k < numKeys; ++k) {
+			AVK_CHECK(ani.compute_node_local_translation(anode, static_cast<double>(k)) == anode.mPositionKeys[k].mValue);
+		}
+		// After the last key, the last key is held:
+		AVK_CHECK(ani.compute_node_local_translation(anode, static_cast<double>(numKeys)) == anode.mPositionKeys.back().mValue);
+	}
+}
+
+AVK_TEST(animation_cursor_matches_binary_search)
+{
+	for (size_t numKeys : { 2, 16, 1024 }) {
+		auto ani = create_animation(numKeys);
+		const auto clip = clip_of(numKeys);
+
+		// Regular playback at 60 frames per second, which wraps around at the end of the clip, plus random seeking:
+		std::vector<double> ticks;
+		for (size_t i = 0; i < 4 * numKeys; ++i) {
+			ticks.push_back(std::fmod(static_cast<double>(i) / 60.0, clip.end_time()) * cTicksPerSecond);
+		}
+		std::mt19937 rng{ 42u };
+		std::uniform_real_distribution<double> dist{ 0.0, static_cast<double>(numKeys) };
+		for (size_t i = 0; i < numKeys; ++i) {
+			ticks.push_back(dist(rng));
+		}
+
+		for (size_t bi = 0; bi < cNumBones; ++bi) {
+			const avk::animated_node& anode = ani.get_animated_node_at(bi);
+			avk::keyframe_cursor cursor{};
+			bool same = true;
+			for (const auto t : ticks) {
+				same = ani.compute_node_local_transform(anode, t, &cursor) == ani.compute_node_local_transform(anode, t) && same;
+			}
+			AVK_CHECK(same);
+		}
+	}
+}
+
+AVK_TEST(animation_playback_matches_random_access)
+{
+	constexpr size_t numKeys = 256;
+	auto playback = create_animation(numKeys);
+	const auto clip = clip_of(numKeys);
+
+	// The cursors of playback follow the times, the ones of every fresh animation start at the first keys:
+	std::vector<glm::mat4> expected(cNumBones);
+	std::vector<glm::mat4> actual(cNumBones);
+	bool same = true;
+	for (size_t i = 0; i < 1000; ++i) {
+		const auto time = std::fmod(static_cast<double>(i) / 60.0, clip.end_time());
+		playback.animate_into_single_target_buffer(clip, time, actual.data());
+		auto fresh = create_animation(numKeys);
+		fresh.animate_into_single_target_buffer(clip, time, expected.data());
+		same = expected == actual && same;
+	}
+	AVK_CHECK(same);
+}
+
+AVK_TEST(animation_batch_matches_single_instance)
+{
+	constexpr size_t numKeys = 256;
+	constexpr size_t numInstances = 128;
+	auto ani = create_animation(numKeys);
+	const auto clip = clip_of(numKeys);
+
+	// Every instance plays the clip with a different offset, and keeps its own cursors:
+	std::vector<glm::mat4> boneMatrices(numInstances * cNumBones);
+	std::vector<std::vector<avk::keyframe_cursor>> cursors(numInstances);
+	std::vector<avk::animation_instance> instances(numInstances);
+	for (size_t i = 0; i < numInstances; ++i) {
+		instances[i] = avk::animation_instance{ clip, 0.0, &boneMatrices[i * cNumBones], 0, sizeof(glm::mat4), &cursors[i] };
+	}
+
+	avk::work_stealing_pool pool{ 4 };
+	std::vector<glm::mat4> reference(cNumBones);
+	bool same = true;
+	for (size_t f = 0; f < 16; ++f) {
+		for (size_t i = 0; i < numInstances; ++i) {
+			instances[i].mTime = std::fmod(static_cast<double>(f) / 60.0 + static_cast<double>(i) * 0.37, clip.end_time());
+		}
+		ani.animate_batch_into_strided_targets(instances, pool);
+
+		// Bit-identical to the single-instance path:
+		for (size_t i = 0; i < numInstances; ++i) {
+			ani.animate_into_strided_target_per_mesh(clip, instances[i].mTime, reference.data(), 0);
+			same = 0 == std::memcmp(reference.data(), &boneMatrices[i * cNumBones], cNumBones * sizeof(glm::mat4)) && same;
+		}
+	}
+	AVK_CHECK(same);
+}
+
+AVK_TEST(animation_packed_quat_round_trip)
+{
+	// 15 bits for each of the three smallest components, which are at most 1/sqrt(2):
+	constexpr float bound = 2e-4f;
+	std::mt19937 rng{ 42u };
+	std::normal_distribution<float> dist;
+	float maxError = 0.0f;
+	for (size_t i = 0; i < 100000; ++i) {
+		const auto q = glm::normalize(glm::quat{ dist(rng), dist(rng), dist(rng), dist(rng) });
+		const auto d = glm::conjugate(q) * avk::unpack_quat(avk::pack_quat(q));
+		maxError = std::max(maxError, 2.0f * std::atan2(glm::length(glm::vec3{ d.x, d.y, d.z }), std::abs(d.w)));
+	}
+	std::cout << "Max. packed_quat error: " << maxError << " rad" << std::endl;
+	AVK_CHECK(maxError <= bound);
+
+	// The axes are the edge cases of "smallest three":
+	for (const auto& q : { glm::quat{ 1, 0, 0, 0 }, glm::quat{ 0, 1, 0, 0 }, glm::quat{ 0, 0, 1, 0 }, glm::quat{ 0, 0, 0, 1 }, glm::quat{ -1, 0, 0, 0 } }) {
+		const auto unpacked = avk::unpack_quat(avk::pack_quat(q));
+		AVK_CHECK(std::abs(std::abs(glm::dot(q, unpacked)) - 1.0f) < 1e-6f);
+	}
+}
+
+AVK_TEST(animation_compression)
+{
+	const avk::animation_compression_settings settings{};
+	for (size_t numKeys : { 16, 1024, 16384 }) {
+		auto ani = create_animation(numKeys);
+		const auto clip = clip_of(numKeys);
+		const auto compressed = ani.compress_clip(clip, settings);
+		const auto& stats = compressed.statistics();
+		avk::log_animation_compression_statistics(std::to_string(numKeys) + " keys per channel", compressed);
+
+		AVK_CHECK(compressed.number_of_animated_nodes() == cNumBones);
+		AVK_CHECK(stats.mNumRawKeys == 3 * cNumBones * numKeys);
+		AVK_CHECK(stats.mCompressedBytes < stats.mRawBytes);
+
+		// At the keys, the errors are bounded by the tolerances, plus the quantization of the rotations:
+		float maxPositionError = 0.0f;
+		float maxRotationError = 0.0f;
+		float maxScaleError = 0.0f;
+		for (size_t bi = 0; bi < cNumBones; ++bi) {
+			const avk::animated_node& anode = ani.get_animated_node_at(bi);
+			avk::keyframe_cursor cursor{};
+			for (size_t k = 0; k < numKeys; ++k) {
+				const auto t = static_cast<double>(k);
+				maxPositionError = std::max(maxPositionError, glm::length(compressed.compute_node_local_translation(bi, t) - ani.compute_node_local_translation(anode, t)));
+				const auto d = glm::conjugate(ani.compute_node_local_rotation(anode, t)) * compressed.compute_node_local_rotation(bi, t);
+				maxRotationError = std::max(maxRotationError, 2.0f * std::atan2(glm::length(glm::vec3{ d.x, d.y, d.z }), std::abs(d.w)));
+				maxScaleError = std::max(maxScaleError, glm::length(compressed.compute_node_local_scale(bi, t) - ani.compute_node_local_scale(anode, t)));
+
+				// The cursors must find the same keys as the binary search:
+				AVK_CHECK(compressed.compute_node_local_transform(bi, t, &cursor) == compressed.compute_node_local_transform(bi, t));
+			}
+		}
+		std::cout << "Max. errors at the keys: position " << maxPositionError << ", rotation " << maxRotationError << " rad, scale " << maxScaleError << std::endl;
+		AVK_CHECK(maxPositionError <= settings.mMaxPositionError * 1.01f);
+		AVK_CHECK(maxRotationError <= settings.mMaxRotationError + 2e-4f);
+		AVK_CHECK(maxScaleError <= settings.mMaxScaleError * 1.01f);
+
+		// The statistics have measured at least these errors:
+		AVK_CHECK(stats.mMaxPositionError >= maxPositionError);
+		AVK_CHECK(stats.mMaxRotationError >= maxRotationError);
+		AVK_CHECK(stats.mMaxScaleError >= maxScaleError);
+	}
+}
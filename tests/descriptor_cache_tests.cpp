@@ -0,0 +1,214 @@
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "auto_vk_toolkit.hpp"
+#include "configure_and_compose.hpp"
+#include "test_framework.hpp"
+
+// Requests the descriptor sets of two of the demo's passes from an avk::descriptor_cache_t: the rasterization pass (an array
+// of image samplers and two uniform buffers in set 0, three storage buffers in set 1), and a post-processing pass (two
+// combined image samplers and a uniform buffer). The sets which get_or_create_descriptor_sets finds in its lookup table must
+// be the ones which find_or_alloc_descriptor_sets finds among the prepared sets, and once they are in the lookup table,
+// requesting them again must not allocate any memory. Needs a Vulkan device, but no window.
+
+namespace
+{
+	constexpr uint32_t cNumImageSamplers = 256;
+	constexpr int cNumRepetitions = 1000;
+
+	// Allocations of the calling thread are only counted within count_allocations, see the replaced operator new below:
+	thread_local bool tCountAllocations = false;
+	thread_local size_t tNumAllocations = 0;
+
+	/** Returns the number of times which operator new has been called while aFunction has run */
+	template <typename F>
+	size_t count_allocations(F aFunction)
+	{
+		tNumAllocations = 0;
+		tCountAllocations = true;
+		aFunction();
+		tCountAllocations = false;
+		return tNumAllocations;
+	}
+
+	/** Initializes the context once per process; skips the running test if there is no Vulkan device */
+	void require_device()
+	{
+		static const std::string sError = []() -> std::string {
+			try {
+				avk::configure_and_compose(avk::application_name("avk_toolkit_tests"));
+				return {};
+			}
+			catch (const std::exception& e) {
+				return e.what();
+			}
+		}();
+		if (!sError.empty()) {
+			AVK_SKIP("No Vulkan device: " + sError);
+		}
+	}
+
+	struct resources
+	{
+		resources()
+		{
+			mCache = avk::context().create_descriptor_cache("descriptor_cache_tests");
+			for (int i = 0; i < 2; ++i) {
+				mUniformBuffers.push_back(avk::context().create_buffer(avk::memory_usage::device, {}, avk::uniform_buffer_meta::create_from_size(sizeof(glm::mat4))));
+			}
+			for (int i = 0; i < 3; ++i) {
+				mStorageBuffers.push_back(avk::context().create_buffer(avk::memory_usage::device, {}, avk::storage_buffer_meta::create_from_size(1024)));
+			}
+			auto sampler = avk::context().create_sampler(avk::filter_mode::bilinear, avk::border_handling_mode::repeat);
+			sampler.enable_shared_ownership();
+			for (uint32_t i = 0; i < cNumImageSamplers; ++i) {
+				auto image = avk::context().create_image(1, 1, vk::Format::eR8G8B8A8Unorm, 1, avk::memory_usage::device, avk::image_usage::general_texture);
+				mImageSamplers.push_back(avk::context().create_image_sampler(avk::context().create_image_view(std::move(image)), sampler));
+			}
+			mCombinedImageSamplers = avk::as_combined_image_samplers(mImageSamplers, avk::layout::shader_read_only_optimal);
+		}
+
+		avk::descriptor_cache mCache;
+		std::vector<avk::buffer> mUniformBuffers;
+		std::vector<avk::buffer> mStorageBuffers;
+		std::vector<avk::image_sampler> mImageSamplers;
+		std::vector<avk::combined_image_sampler_descriptor_info> mCombinedImageSamplers;
+	};
+
+	std::vector<std::tuple<uint32_t, vk::DescriptorSet>> handles_of(const std::vector<avk::descriptor_set>& aSets)
+	{
+		std::vector<std::tuple<uint32_t, vk::DescriptorSet>> result;
+		for (const auto& set : aSets) {
+			result.emplace_back(set.set_id(), set.handle());
+		}
+		return result;
+	}
+
+	/** Requests the sets via both paths; aRequest gets a function which takes the bindings and returns the sets' ids and handles */
+	template <typename R>
+	void check_both_paths(resources& aResources, R aRequest)
+	{
+		const auto lookup = [&aResources](std::initializer_list<avk::binding_data> aBindings) {
+			return handles_of(aResources.mCache->get_or_create_descriptor_sets(aBindings));
+		};
+		const auto prepared = [&aResources](std::initializer_list<avk::binding_data> aBindings) {
+			return handles_of(aResources.mCache->find_or_alloc_descriptor_sets(aBindings));
+		};
+
+		// Allocates the sets, and puts them into the lookup table:
+		const auto expected = aRequest(lookup);
+		AVK_CHECK(!expected.empty());
+		AVK_CHECK(aRequest(prepared) == expected);
+		int numOtherSets = 0;
+		for (int i = 0; i < cNumRepetitions; ++i) {
+			numOtherSets += aRequest(lookup) == expected ? 0 : 1;
+		}
+		AVK_CHECK(0 == numOtherSets);
+	}
+}
+
+// Replaces the global allocation functions of the whole test executable, and counts their calls within count_allocations:
+void* operator new(std::size_t aSize)
+{
+	if (tCountAllocations) {
+		++tNumAllocations;
+	}
+	if (void* memory = std::malloc(aSize > 0 ? aSize : 1)) {
+		return memory;
+	}
+	throw std::bad_alloc{};
+}
+
+void* operator new[](std::size_t aSize)
+{
+	return ::operator new(aSize);
+}
+
+void operator delete(void* aMemory) noexcept
+{
+	std::free(aMemory);
+}
+
+void operator delete[](void* aMemory) noexcept
+{
+	std::free(aMemory);
+}
+
+void operator delete(void* aMemory, std::size_t) noexcept
+{
+	std::free(aMemory);
+}
+
+void operator delete[](void* aMemory, std::size_t) noexcept
+{
+	std::free(aMemory);
+}
+
+AVK_TEST(descriptor_cache_rasterization_sets)
+{
+	require_device();
+	resources r;
+	check_both_paths(r, [&r](auto aGetSets) {
+		return aGetSets({
+			avk::descriptor_binding(0, 0, r.mCombinedImageSamplers),
+			avk::descriptor_binding(0, 1, r.mUniformBuffers[0]),
+			avk::descriptor_binding(0, 2, r.mUniformBuffers[1]),
+			avk::descriptor_binding(1, 0, r.mStorageBuffers[0]),
+			avk::descriptor_binding(1, 1, r.mStorageBuffers[1]),
+			avk::descriptor_binding(1, 2, r.mStorageBuffers[2])
+		});
+	});
+}
+
+AVK_TEST(descriptor_cache_post_processing_sets)
+{
+	require_device();
+	resources r;
+	check_both_paths(r, [&r](auto aGetSets) {
+		return aGetSets({
+			avk::descriptor_binding(0, 0, r.mImageSamplers[0]->as_combined_image_sampler(avk::layout::shader_read_only_optimal)),
+			avk::descriptor_binding(0, 1, r.mImageSamplers[1]->as_combined_image_sampler(avk::layout::shader_read_only_optimal)),
+			avk::descriptor_binding(0, 2, r.mUniformBuffers[0])
+		});
+	});
+}
+
+AVK_TEST(descriptor_cache_warm_lookup_does_not_allocate)
+{
+	require_device();
+	resources r;
+	// Built before counting, since copying the array of image samplers into a binding allocates:
+	const std::initializer_list<avk::binding_data> rasterization = {
+		avk::descriptor_binding(0, 0, r.mCombinedImageSamplers),
+		avk::descriptor_binding(0, 1, r.mUniformBuffers[0]),
+		avk::descriptor_binding(0, 2, r.mUniformBuffers[1]),
+		avk::descriptor_binding(1, 0, r.mStorageBuffers[0]),
+		avk::descriptor_binding(1, 1, r.mStorageBuffers[1]),
+		avk::descriptor_binding(1, 2, r.mStorageBuffers[2])
+	};
+	const std::initializer_list<avk::binding_data> postProcessing = {
+		avk::descriptor_binding(0, 0, r.mImageSamplers[0]->as_combined_image_sampler(avk::layout::shader_read_only_optimal)),
+		avk::descriptor_binding(0, 1, r.mImageSamplers[1]->as_combined_image_sampler(avk::layout::shader_read_only_optimal)),
+		avk::descriptor_binding(0, 2, r.mUniformBuffers[0])
+	};
+
+	// Allocates the sets, and puts them into the lookup table:
+	const auto expectedRasterization = handles_of(r.mCache->get_or_create_descriptor_sets(rasterization));
+	const auto expectedPostProcessing = handles_of(r.mCache->get_or_create_descriptor_sets(postProcessing));
+
+	size_t numSets = 0;
+	const auto numAllocations = count_allocations([&]() {
+		for (int i = 0; i < cNumRepetitions; ++i) {
+			numSets += r.mCache->get_or_create_descriptor_sets(rasterization).size();
+			numSets += r.mCache->get_or_create_descriptor_sets(postProcessing).size();
+		}
+	});
+	AVK_CHECK(0 == numAllocations);
+	AVK_CHECK(numSets == static_cast<size_t>(cNumRepetitions) * (expectedRasterization.size() + expectedPostProcessing.size()));
+	// The warm lookups have neither allocated nor replaced the sets:
+	AVK_CHECK(handles_of(r.mCache->get_or_create_descriptor_sets(rasterization)) == expectedRasterization);
+	AVK_CHECK(handles_of(r.mCache->get_or_create_descriptor_sets(postProcessing)) == expectedPostProcessing);
+}
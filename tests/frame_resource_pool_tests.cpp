@@ -0,0 +1,77 @@
+#include <string>
+#include <vector>
+
+#include "auto_vk_toolkit.hpp"
+#include "configure_and_compose.hpp"
+#include "frame_resource_pool.hpp"
+#include "test_framework.hpp"
+
+// Runs frames like the demo's render() does, without a window: every in-flight index waits on its fence, begins its frame
+// in a frame_resource_pool, and submits one of the pool's command buffers. After every in-flight index has been used once,
+// the pool must not create any Vulkan objects anymore. Needs a Vulkan device, but no window.
+
+namespace
+{
+	constexpr uint32_t cFramesInFlight = 3;
+	constexpr uint32_t cNumCommandBuffersPerFrame = 2;
+	constexpr uint32_t cNumSemaphoresPerFrame = 1;
+	constexpr int cNumFrames = 1000;
+
+	/** Initializes the context with one queue once per process; skips the running test if there is no Vulkan device */
+	avk::queue& require_device()
+	{
+		static avk::queue* sQueue = nullptr;
+		static const std::string sError = []() -> std::string {
+			try {
+				sQueue = &avk::context().create_queue();
+				avk::configure_and_compose(avk::application_name("avk_toolkit_tests"));
+				return {};
+			}
+			catch (const std::exception& e) {
+				return e.what();
+			}
+		}();
+		if (!sError.empty()) {
+			AVK_SKIP("No Vulkan device: " + sError);
+		}
+		return *sQueue;
+	}
+}
+
+AVK_TEST(frame_resource_pool_creates_nothing_in_steady_state)
+{
+	auto& queue = require_device();
+	frame_resource_pool pool{ queue, cNumCommandBuffersPerFrame, cNumSemaphoresPerFrame };
+	std::vector<avk::fence> fences;
+	for (uint32_t i = 0; i < cFramesInFlight; ++i) {
+		fences.push_back(avk::context().create_fence(true));
+	}
+
+	const uint64_t numObjectsPerFrame = 1 + cNumCommandBuffersPerFrame + cNumSemaphoresPerFrame;
+	int numFramesWhichCreated = 0;
+	for (int frame = 0; frame < cNumFrames; ++frame) {
+		const auto ifi = static_cast<avk::window::frame_id_t>(frame % cFramesInFlight);
+		// What the window does before render():
+		fences[ifi]->wait_until_signalled();
+		fences[ifi]->reset();
+
+		pool.begin_frame(ifi);
+		if (frame < static_cast<int>(cFramesInFlight)) {
+			AVK_CHECK(pool.num_objects_created_in_current_frame() == numObjectsPerFrame);
+		}
+		else {
+			numFramesWhichCreated += 0 == pool.num_objects_created_in_current_frame() ? 0 : 1;
+		}
+		avk::context().record({ avk::command::custom_commands([](avk::command_buffer_t&) {}) })
+			.into_command_buffer(pool.command_buffer(frame % cNumCommandBuffersPerFrame))
+			.then_submit_to(queue)
+			.signaling_upon_completion(fences[ifi].as_reference())
+			.submit();
+	}
+	for (auto& fence : fences) {
+		fence->wait_until_signalled();
+	}
+
+	AVK_CHECK(0 == numFramesWhichCreated);
+	AVK_CHECK(pool.num_objects_created() == cFramesInFlight * numObjectsPerFrame);
+}
@@ -0,0 +1,125 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "auto_vk_toolkit.hpp"
+#include "gbuffer_layout.hpp"
+#include "test_framework.hpp"
+
+// Checks the precision of the gbuffer_format::compact layout (see gbuffer_layout.hpp): view-space positions which are
+// reconstructed from a D32 depth value, with the projection of the demo's cameras, and normals which are encoded into
+// RG16 SNORM, both in view space and transformed into world space like the illumination pass does.
+
+namespace
+{
+	// The same planes as the demo's cameras use:
+	constexpr float cNear = 0.3f;
+	constexpr float cFar = 1000.0f;
+	constexpr size_t cNumSamples = 200000;
+	constexpr double cMaxNormalErrorDegrees = 0.005;
+
+	glm::vec3 random_unit_vector(std::mt19937& aRng)
+	{
+		std::normal_distribution<float> dist;
+		glm::vec3 v;
+		do {
+			v = glm::vec3{ dist(aRng), dist(aRng), dist(aRng) };
+		} while (glm::dot(v, v) < 1e-6f);
+		return glm::normalize(v);
+	}
+
+	double angle_degrees(const glm::dvec3& a, const glm::dvec3& b)
+	{
+		// Not via acos, which would be off by up to 0.02 degrees near 1:
+		return glm::degrees(std::atan2(glm::length(glm::cross(a, b)), glm::dot(a, b)));
+	}
+
+	/** Largest error of reconstructed positions relative to their distance, for random points at distances in [aFrom, aTo] */
+	double max_position_error(std::mt19937& aRng, const glm::mat4& aProjection, float aFrom, float aTo)
+	{
+		const auto inverseProjection = glm::inverse(aProjection);
+		std::uniform_real_distribution<float> ndc{ -1.0f, 1.0f };
+		std::uniform_real_distribution<float> distance{ aFrom, aTo };
+
+		double maxError = 0.0;
+		for (size_t i = 0; i < cNumSamples; ++i) {
+			// A point at the given distance which is visible at the given normalized device coordinates:
+			const auto direction = glm::normalize(glm::vec3{ inverseProjection * glm::vec4{ ndc(aRng), ndc(aRng), 1.0f, 1.0f } });
+			const auto p = direction * distance(aRng);
+
+			// What the rasterization pass stores, and what the screen-space pass interpolates:
+			const auto clip = aProjection * glm::vec4{ p, 1.0f };
+			const float depth = clip.z / clip.w;
+			const glm::vec2 texCoord = glm::vec2{ clip } / clip.w * 0.5f + 0.5f;
+
+			const auto reconstructed = gbuffer_layout::reconstruct_view_position(texCoord, depth, inverseProjection);
+			maxError = std::max(maxError, glm::length(glm::dvec3{ reconstructed } - glm::dvec3{ p }) / glm::length(glm::dvec3{ p }));
+		}
+		return maxError;
+	}
+
+	std::vector<glm::vec3> normals_to_check(std::mt19937& aRng)
+	{
+		std::vector<glm::vec3> normals;
+		// The axes and the seams of the folded octahedron are the edge cases:
+		for (const auto& n : { glm::vec3{ 1, 0, 0 }, glm::vec3{ -1, 0, 0 }, glm::vec3{ 0, 1, 0 }, glm::vec3{ 0, -1, 0 }, glm::vec3{ 0, 0, 1 }, glm::vec3{ 0, 0, -1 },
+		                       glm::vec3{ 1, 1, 0 }, glm::vec3{ -1, 1, 0 }, glm::vec3{ 1, -1, 0 }, glm::vec3{ -1, -1, 0 }, glm::vec3{ 1, 1, -1 }, glm::vec3{ -1, -1, -1 } }) {
+			normals.push_back(glm::normalize(n));
+		}
+		while (normals.size() < cNumSamples) {
+			normals.push_back(random_unit_vector(aRng));
+		}
+		return normals;
+	}
+}
+
+AVK_TEST(gbuffer_reconstructed_positions)
+{
+	std::mt19937 rng{ 42u };
+	avk::camera camera;
+	camera.set_perspective_projection(glm::radians(30.0f), 16.0f / 9.0f, cNear, cFar);
+	for (float from = cNear; from < cFar; from *= 10.0f) {
+		const auto to = std::min(from * 10.0f, cFar);
+		// The depth value's derivative w.r.t. the distance z is about near / z^2, i.e., a float rounding error of the depth value,
+		// or a cancellation in the projection or in its inverse, changes the distance relative to z by about epsilon * z / near:
+		const double epsilon = std::numeric_limits<float>::epsilon();
+		AVK_CHECK(max_position_error(rng, camera.projection_matrix(), from, to) <= 2.0 * epsilon * to / cNear + 16.0 * epsilon);
+	}
+}
+
+AVK_TEST(gbuffer_view_space_normals)
+{
+	std::mt19937 rng{ 42u };
+	double maxError = 0.0;
+	for (const auto& n : normals_to_check(rng)) {
+		const auto decoded = gbuffer_layout::decode_normal(gbuffer_layout::encode_normal(n));
+		maxError = std::max(maxError, angle_degrees(glm::dvec3{ decoded }, glm::dvec3{ n }));
+	}
+	AVK_CHECK(maxError <= cMaxNormalErrorDegrees);
+}
+
+AVK_TEST(gbuffer_world_space_normals)
+{
+	std::mt19937 rng{ 42u };
+	std::uniform_real_distribution<float> angle{ 0.0f, glm::two_pi<float>() };
+	double maxError = 0.0;
+	for (const auto& n : normals_to_check(rng)) {
+		const auto decoded = gbuffer_layout::decode_normal(gbuffer_layout::encode_normal(n));
+		// The illumination pass transforms the decoded normal with the inverse view matrix of a rigid camera:
+		const auto inverseView = glm::rotate(glm::mat4{ 1.0f }, angle(rng), random_unit_vector(rng));
+		const auto decodedWS = glm::mat3{ inverseView } * decoded;
+		const auto expectedWS = glm::dmat3{ glm::dmat4{ inverseView } } * glm::dvec3{ n };
+		maxError = std::max(maxError, angle_degrees(glm::dvec3{ decodedWS }, expectedWS));
+	}
+	AVK_CHECK(maxError <= cMaxNormalErrorDegrees);
+}
+
+AVK_TEST(gbuffer_compact_layout_size)
+{
+	AVK_CHECK(gbuffer_layout::color_formats(gbuffer_format::compact).size() == 2);
+	AVK_CHECK(gbuffer_layout::color_formats(gbuffer_format::full_precision).size() == 5);
+	AVK_CHECK(gbuffer_layout::bytes_per_pixel(gbuffer_format::compact) == 12);
+	AVK_CHECK(gbuffer_layout::bytes_per_pixel(gbuffer_format::full_precision) == 72);
+}
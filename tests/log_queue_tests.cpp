@@ -0,0 +1,127 @@
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "auto_vk_toolkit.hpp"
+#include "log_queue.hpp"
+#include "test_framework.hpp"
+
+// Logs from several producer threads at once into avk::log_queue without a console sink, and checks what arrives at the
+// other sinks.
+
+namespace
+{
+	constexpr uint32_t cNumProducers = 4;
+
+	avk::log_pack message_of(uint32_t aProducer, size_t aIndex, avk::log_type aLogType = avk::log_type::verbose)
+	{
+		return avk::log_pack{ std::format("{} {}\n", aProducer, aIndex), aLogType, avk::log_importance::normal };
+	}
+
+	/** Runs aProduce(producer) on cNumProducers threads at once */
+	template <typename F>
+	void produce(F aProduce)
+	{
+		std::vector<std::thread> producers;
+		for (uint32_t p = 0; p < cNumProducers; ++p) {
+			producers.emplace_back([p, &aProduce]() { aProduce(p); });
+		}
+		for (auto& t : producers) {
+			t.join();
+		}
+	}
+}
+
+AVK_TEST(log_queue_accounts_for_every_message)
+{
+	constexpr size_t numMessages = 100000;
+	avk::log_queue queue{ avk::log_queue_config{ .mCapacity = 64, .mConsoleSink = false } };
+	produce([&](uint32_t aProducer) {
+		for (size_t i = 0; i < numMessages; ++i) {
+			queue.push(message_of(aProducer, i));
+		}
+	});
+	queue.flush();
+	AVK_CHECK(queue.num_written() + queue.num_dropped() == cNumProducers * numMessages);
+}
+
+AVK_TEST(log_queue_never_drops_errors)
+{
+	constexpr size_t numMessages = 20000;
+	avk::log_queue queue{ avk::log_queue_config{ .mCapacity = 4, .mMaxBatchSize = 1, .mConsoleSink = false } };
+	produce([&](uint32_t aProducer) {
+		for (size_t i = 0; i < numMessages; ++i) {
+			queue.push(message_of(aProducer, i, avk::log_type::error));
+		}
+	});
+	queue.flush();
+	AVK_CHECK(queue.num_dropped() == 0);
+	AVK_CHECK(queue.num_written() == cNumProducers * numMessages);
+}
+
+AVK_TEST(log_queue_keeps_the_order_of_every_producer)
+{
+	constexpr size_t numMessages = 5000;
+	avk::log_queue queue{ avk::log_queue_config{ .mCapacity = 64, .mConsoleSink = false, .mRingBufferSinkSize = cNumProducers * numMessages } };
+	produce([&](uint32_t aProducer) {
+		for (size_t i = 0; i < numMessages; ++i) {
+			// Wait for a free slot, s.t. nothing is dropped:
+			while (!queue.try_push(message_of(aProducer, i))) {
+				std::this_thread::yield();
+			}
+		}
+	});
+	queue.flush();
+
+	const auto messages = queue.recent_messages();
+	AVK_CHECK(messages.size() == cNumProducers * numMessages);
+	std::vector<size_t> next(cNumProducers, 0);
+	bool inOrder = true;
+	for (const auto& message : messages) {
+		uint32_t producer = 0;
+		size_t index = 0;
+		std::istringstream{ message } >> producer >> index;
+		inOrder = producer < cNumProducers && next[producer]++ == index && inOrder;
+	}
+	AVK_CHECK(inOrder);
+}
+
+AVK_TEST(log_queue_ring_buffer_keeps_the_most_recent_messages)
+{
+	avk::log_queue queue{ avk::log_queue_config{ .mConsoleSink = false, .mRingBufferSinkSize = 8 } };
+	for (size_t i = 0; i < 20; ++i) {
+		queue.push(message_of(0, i));
+	}
+	queue.flush();
+	const auto messages = queue.recent_messages();
+	AVK_CHECK(messages.size() == 8);
+	for (size_t i = 0; i < messages.size(); ++i) {
+		AVK_CHECK(messages[i] == message_of(0, 12 + i).mMessage);
+	}
+}
+
+AVK_TEST(log_queue_file_sink)
+{
+	const auto path = (std::filesystem::temp_directory_path() / "avk_toolkit_tests_log_queue.txt").string();
+	{
+		avk::log_queue queue{ avk::log_queue_config{ .mConsoleSink = false, .mFileSinkPath = path } };
+		for (size_t i = 0; i < 1000; ++i) {
+			queue.push(message_of(0, i, avk::log_type::error));
+		}
+	}
+
+	// The destructor has written all remaining messages:
+	std::ifstream file(path);
+	std::string line;
+	size_t numLines = 0;
+	while (std::getline(file, line)) {
+		AVK_CHECK(line.find(std::format("0 {}", numLines)) != std::string::npos);
+		++numLines;
+	}
+	AVK_CHECK(numLines == 1000);
+	file.close();
+	std::filesystem::remove(path);
+}
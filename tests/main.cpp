@@ -0,0 +1,50 @@
+#include "test_framework.hpp"
+
+/** Runs the tests whose names are passed as arguments, or all tests if there are none.
+ *  @return	0 if all checks have passed, cSkipReturnCode if all tests have been skipped, 1 otherwise
+ */
+int main(int argc, char** argv)
+{
+	std::map<std::string, std::function<void()>> tests;
+	for (int i = 1; i < argc; ++i) {
+		const auto it = avk_tests::registry().find(argv[i]);
+		if (avk_tests::registry().end() == it) {
+			std::cerr << "Unknown test '" << argv[i] << "'" << std::endl;
+			return 1;
+		}
+		tests.insert(*it);
+	}
+	if (tests.empty()) {
+		tests = avk_tests::registry();
+	}
+
+	int numFailed = 0;
+	int numSkipped = 0;
+	for (const auto& [name, test] : tests) {
+		avk_tests::failed_checks() = 0;
+		try {
+			test();
+		}
+		catch (const avk_tests::skipped& e) {
+			std::cout << "SKIPPED " << name << ": " << e.mReason << std::endl;
+			++numSkipped;
+			continue;
+		}
+		catch (const std::exception& e) {
+			std::cerr << name << " threw: " << e.what() << std::endl;
+			++avk_tests::failed_checks();
+		}
+		if (avk_tests::failed_checks() > 0) {
+			std::cout << "FAILED  " << name << std::endl;
+			++numFailed;
+		}
+		else {
+			std::cout << "PASSED  " << name << std::endl;
+		}
+	}
+
+	if (numFailed > 0) {
+		return 1;
+	}
+	return numSkipped == static_cast<int>(tests.size()) ? avk_tests::cSkipReturnCode : 0;
+}
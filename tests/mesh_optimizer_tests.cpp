@@ -0,0 +1,195 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "auto_vk_toolkit.hpp"
+#include "mesh_optimizer.hpp"
+#include "test_framework.hpp"
+
+// Checks the mesh optimization passes (see mesh_optimizer.hpp) with a simulated vertex cache of 16 entries on a set of
+// synthetic meshes: a tessellated sphere in its natural order, the same triangles shuffled, with degenerate triangles,
+// and a triangle soup without shared vertices.
+
+namespace
+{
+	constexpr uint32_t cCacheSize = 16;
+
+	struct mesh
+	{
+		std::string mName;
+		std::vector<glm::vec3> mPositions;
+		std::vector<uint32_t> mIndices;
+	};
+
+	mesh create_sphere()
+	{
+		constexpr uint32_t rings = 256;
+		constexpr uint32_t segments = 256;
+		mesh result{ "sphere" };
+		for (uint32_t i = 0; i <= rings; ++i) {
+			for (uint32_t j = 0; j <= segments; ++j) {
+				const auto theta = glm::pi<float>() * static_cast<float>(i) / rings;
+				const auto phi = glm::two_pi<float>() * static_cast<float>(j) / segments;
+				result.mPositions.emplace_back(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi));
+			}
+		}
+		for (uint32_t i = 0; i < rings; ++i) {
+			for (uint32_t j = 0; j < segments; ++j) {
+				const auto a = i * (segments + 1) + j;
+				const auto c = a + segments + 1;
+				result.mIndices.insert(result.mIndices.end(), { a, c, a + 1, a + 1, c, c + 1 });
+			}
+		}
+		return result;
+	}
+
+	mesh shuffle_triangles(const mesh& aMesh, uint32_t aSeed)
+	{
+		std::mt19937 rng{ aSeed };
+		std::vector<size_t> order(aMesh.mIndices.size() / 3);
+		std::iota(order.begin(), order.end(), size_t{ 0 });
+		std::shuffle(order.begin(), order.end(), rng);
+		mesh result{ "shuffled " + aMesh.mName, aMesh.mPositions };
+		result.mIndices.reserve(aMesh.mIndices.size());
+		for (const auto t : order) {
+			result.mIndices.insert(result.mIndices.end(), aMesh.mIndices.begin() + t * 3, aMesh.mIndices.begin() + t * 3 + 3);
+		}
+		return result;
+	}
+
+	/** The sphere, the shuffled sphere, the shuffled sphere with degenerate triangles, and a triangle soup */
+	std::vector<mesh> create_meshes()
+	{
+		std::vector<mesh> meshes;
+		meshes.push_back(create_sphere());
+		meshes.push_back(shuffle_triangles(meshes[0], 42u));
+
+		// Degenerate triangles, as they might come out of Assimp:
+		meshes.push_back(meshes[1]);
+		meshes.back().mName += " with degenerates";
+		meshes.back().mIndices.insert(meshes.back().mIndices.end(), { 0u, 0u, 1u, 7u, 7u, 7u });
+
+		// Every triangle has its own vertices => nothing to gain, but nothing must break:
+		mesh soup{ "triangle soup" };
+		const auto& sphere = meshes[0];
+		for (size_t t = 0; t < sphere.mIndices.size() / 3; t += 7) {
+			for (size_t k = 0; k < 3; ++k) {
+				soup.mIndices.push_back(static_cast<uint32_t>(soup.mPositions.size()));
+				soup.mPositions.push_back(sphere.mPositions[sphere.mIndices[t * 3 + k]]);
+			}
+		}
+		meshes.push_back(std::move(soup));
+		return meshes;
+	}
+
+	/** The triangles as a sorted list, where every triangle is rotated s.t. its smallest vertex index comes first (retains the winding) */
+	std::vector<std::array<uint32_t, 3>> canonical_triangles(const std::vector<uint32_t>& aIndices, const std::vector<uint32_t>* aNewToOld = nullptr)
+	{
+		std::vector<std::array<uint32_t, 3>> result;
+		for (size_t t = 0; t < aIndices.size() / 3; ++t) {
+			std::array<uint32_t, 3> tri;
+			for (size_t k = 0; k < 3; ++k) {
+				tri[k] = nullptr == aNewToOld ? aIndices[t * 3 + k] : (*aNewToOld)[aIndices[t * 3 + k]];
+			}
+			std::rotate(tri.begin(), std::min_element(tri.begin(), tri.end()), tri.end());
+			result.push_back(tri);
+		}
+		std::sort(result.begin(), result.end());
+		return result;
+	}
+
+	void log_statistics(const std::string& aMesh, const char* aPass, const avk::vertex_cache_statistics& aStatistics)
+	{
+		std::cout << aMesh << ", " << aPass << ": ACMR " << aStatistics.mAcmr << ", ATVR " << aStatistics.mAtvr << std::endl;
+	}
+}
+
+AVK_TEST(mesh_optimizer_keeps_triangles)
+{
+	for (const auto& m : create_meshes()) {
+		const auto reference = canonical_triangles(m.mIndices);
+		const auto vertexCacheOptimized = avk::optimize_vertex_cache(m.mIndices, m.mPositions.size());
+		const auto overdrawOptimized = avk::optimize_overdraw(vertexCacheOptimized, m.mPositions);
+		auto fetchOptimized = overdrawOptimized;
+		const auto newToOld = avk::optimize_vertex_fetch(fetchOptimized, m.mPositions.size());
+
+		AVK_CHECK(canonical_triangles(vertexCacheOptimized) == reference);
+		AVK_CHECK(canonical_triangles(overdrawOptimized) == reference);
+		AVK_CHECK(canonical_triangles(fetchOptimized, &newToOld) == reference);
+	}
+}
+
+AVK_TEST(mesh_optimizer_vertex_cache)
+{
+	for (const auto& m : create_meshes()) {
+		const auto input = avk::analyze_vertex_cache(m.mIndices, m.mPositions.size(), cCacheSize);
+		const auto optimized = avk::analyze_vertex_cache(avk::optimize_vertex_cache(m.mIndices, m.mPositions.size()), m.mPositions.size(), cCacheSize);
+		log_statistics(m.mName, "input", input);
+		log_statistics(m.mName, "vertex cache", optimized);
+
+		AVK_CHECK(optimized.mVerticesTransformed <= input.mVerticesTransformed);
+		AVK_CHECK(optimized.mAtvr >= 1.0f);
+	}
+
+	// A shuffled regular mesh misses nearly every vertex; optimized, it must come close to its natural order:
+	const auto meshes = create_meshes();
+	const auto& sphere = meshes[0];
+	const auto& shuffled = meshes[1];
+	const auto natural = avk::analyze_vertex_cache(sphere.mIndices, sphere.mPositions.size(), cCacheSize);
+	const auto optimized = avk::analyze_vertex_cache(avk::optimize_vertex_cache(shuffled.mIndices, shuffled.mPositions.size()), shuffled.mPositions.size(), cCacheSize);
+	AVK_CHECK(optimized.mAcmr <= natural.mAcmr);
+	AVK_CHECK(optimized.mAtvr < 1.5f);
+}
+
+AVK_TEST(mesh_optimizer_overdraw_bounds_acmr)
+{
+	constexpr float threshold = 1.05f;
+	for (const auto& m : create_meshes()) {
+		const auto vertexCacheOptimized = avk::optimize_vertex_cache(m.mIndices, m.mPositions.size());
+		const auto before = avk::analyze_vertex_cache(vertexCacheOptimized, m.mPositions.size(), cCacheSize);
+		const auto after = avk::analyze_vertex_cache(avk::optimize_overdraw(vertexCacheOptimized, m.mPositions, threshold), m.mPositions.size(), cCacheSize);
+		log_statistics(m.mName, "overdraw", after);
+
+		AVK_CHECK(after.mAcmr <= before.mAcmr * threshold);
+	}
+}
+
+AVK_TEST(mesh_optimizer_vertex_fetch)
+{
+	for (const auto& m : create_meshes()) {
+		const auto overdrawOptimized = avk::optimize_overdraw(avk::optimize_vertex_cache(m.mIndices, m.mPositions.size()), m.mPositions);
+		auto fetchOptimized = overdrawOptimized;
+		const auto newToOld = avk::optimize_vertex_fetch(fetchOptimized, m.mPositions.size());
+
+		// Renumbering the vertices must not change which of them hit the cache:
+		const auto before = avk::analyze_vertex_cache(overdrawOptimized, m.mPositions.size(), cCacheSize);
+		const auto after = avk::analyze_vertex_cache(fetchOptimized, newToOld.size(), cCacheSize);
+		AVK_CHECK(after.mVerticesTransformed == before.mVerticesTransformed);
+
+		// Only referenced vertices are kept, and they are numbered in the order of their first reference:
+		std::vector<bool> referenced(m.mPositions.size(), false);
+		for (const auto index : m.mIndices) {
+			referenced[index] = true;
+		}
+		AVK_CHECK(newToOld.size() == static_cast<size_t>(std::count(referenced.begin(), referenced.end(), true)));
+		uint32_t next = 0;
+		bool firstReferencesInOrder = true;
+		for (const auto index : fetchOptimized) {
+			if (index == next) {
+				++next;
+			}
+			else if (index > next) {
+				firstReferencesInOrder = false;
+			}
+		}
+		AVK_CHECK(firstReferencesInOrder);
+
+		const auto remapped = avk::remap_vertices(m.mPositions, newToOld);
+		AVK_CHECK(remapped.size() == newToOld.size());
+		AVK_CHECK(std::equal(remapped.begin(), remapped.end(), newToOld.begin(), [&](const glm::vec3& aPosition, uint32_t aOld) { return aPosition == m.mPositions[aOld]; }));
+	}
+}
@@ -0,0 +1,257 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <optional>
+#include <random>
+#include <tuple>
+#include <vector>
+
+#include "auto_vk_toolkit.hpp"
+#include "meshlet_helpers.hpp"
+#include "test_framework.hpp"
+
+// Divides a tessellated sphere, whose triangles have been shuffled, into meshlets with the same limits as
+// avk::meshlet_gpu_data's defaults, and checks the meshlets, their bounds, and their GPU representations.
+
+namespace
+{
+	constexpr uint32_t cMaxVertices = 64;
+	constexpr uint32_t cMaxIndices = 378;
+
+	struct mesh
+	{
+		std::vector<glm::vec3> mPositions;
+		std::vector<uint32_t> mIndices;
+	};
+
+	mesh create_shuffled_sphere()
+	{
+		constexpr uint32_t rings = 64;
+		constexpr uint32_t segments = 64;
+		mesh sphere;
+		for (uint32_t i = 0; i <= rings; ++i) {
+			for (uint32_t j = 0; j <= segments; ++j) {
+				const auto theta = glm::pi<float>() * static_cast<float>(i) / rings;
+				const auto phi = glm::two_pi<float>() * static_cast<float>(j) / segments;
+				sphere.mPositions.emplace_back(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi));
+			}
+		}
+		std::vector<std::array<uint32_t, 3>> triangles;
+		for (uint32_t i = 0; i < rings; ++i) {
+			for (uint32_t j = 0; j < segments; ++j) {
+				const auto a = i * (segments + 1) + j;
+				const auto c = a + segments + 1;
+				triangles.push_back({ a, c, a + 1 });
+				triangles.push_back({ a + 1, c, c + 1 });
+			}
+		}
+		std::mt19937 rng{ 42u };
+		std::shuffle(triangles.begin(), triangles.end(), rng);
+		for (const auto& t : triangles) {
+			sphere.mIndices.insert(sphere.mIndices.end(), t.begin(), t.end());
+		}
+		return sphere;
+	}
+
+	/** The meshlets' triangles in terms of the mesh's vertex indices, sorted */
+	std::vector<std::array<uint32_t, 3>> triangles_of(const std::vector<avk::meshlet>& aMeshlets)
+	{
+		std::vector<std::array<uint32_t, 3>> result;
+		for (const auto& ml : aMeshlets) {
+			for (uint32_t i = 0; i + 2 < ml.mIndexCount; i += 3) {
+				result.push_back({ ml.mVertices[ml.mIndices[i]], ml.mVertices[ml.mIndices[i + 1]], ml.mVertices[ml.mIndices[i + 2]] });
+			}
+		}
+		std::sort(result.begin(), result.end());
+		return result;
+	}
+
+	std::vector<std::array<uint32_t, 3>> triangles_of(const std::vector<uint32_t>& aIndices)
+	{
+		std::vector<std::array<uint32_t, 3>> result;
+		for (size_t i = 0; i + 2 < aIndices.size(); i += 3) {
+			result.push_back({ aIndices[i], aIndices[i + 1], aIndices[i + 2] });
+		}
+		std::sort(result.begin(), result.end());
+		return result;
+	}
+
+	/** Number of indices per meshlet vertex; 1.0 means that every vertex is duplicated for every triangle which uses it */
+	double vertex_reuse_ratio(const std::vector<avk::meshlet>& aMeshlets)
+	{
+		size_t numVertices = 0;
+		size_t numIndices = 0;
+		for (const auto& ml : aMeshlets) {
+			numVertices += ml.mVertexCount;
+			numIndices += ml.mIndexCount;
+		}
+		return numVertices > 0 ? static_cast<double>(numIndices) / numVertices : 0.0;
+	}
+
+	bool same_bounds(const avk::meshlet_bounds& a, const avk::meshlet_bounds& b)
+	{
+		return a.mBoundingSphere == b.mBoundingSphere && a.mNormalCone == b.mNormalCone;
+	}
+
+	std::vector<avk::meshlet> build_meshlets(const mesh& aMesh)
+	{
+		avk::model_t model;
+		return avk::cluster_meshlets_builder(aMesh.mPositions, aMesh.mIndices, model, {}, cMaxVertices, cMaxIndices);
+	}
+}
+
+AVK_TEST(meshlet_builder_keeps_triangles_within_limits)
+{
+	const auto sphere = create_shuffled_sphere();
+	avk::model_t model;
+	const auto clustered = build_meshlets(sphere);
+	const auto basic = avk::basic_meshlets_divider(sphere.mIndices, model, {}, cMaxVertices, cMaxIndices);
+
+	for (const auto* meshlets : { &clustered, &basic }) {
+		AVK_CHECK(triangles_of(*meshlets) == triangles_of(sphere.mIndices));
+		for (const auto& ml : *meshlets) {
+			AVK_CHECK(ml.mVertexCount > 0 && ml.mVertexCount <= cMaxVertices);
+			AVK_CHECK(ml.mIndexCount <= cMaxIndices && 0 == ml.mIndexCount % 3);
+			AVK_CHECK(std::all_of(ml.mIndices.begin(), ml.mIndices.begin() + ml.mIndexCount, [&](uint8_t i) { return i < ml.mVertexCount; }));
+		}
+	}
+
+	// Triangles which share their vertices end up in the same meshlet, even though they are shuffled:
+	std::cout << "Vertex reuse: " << vertex_reuse_ratio(basic) << " (basic), " << vertex_reuse_ratio(clustered) << " (clustered)" << std::endl;
+	AVK_CHECK(vertex_reuse_ratio(clustered) > 2.0 * vertex_reuse_ratio(basic));
+}
+
+AVK_TEST(meshlet_bounds_are_conservative)
+{
+	const auto sphere = create_shuffled_sphere();
+	const auto meshlets = build_meshlets(sphere);
+	std::mt19937 rng{ 7u };
+	std::uniform_real_distribution<float> dist{ -4.0f, 4.0f };
+	size_t numCulled = 0;
+	for (const auto& ml : meshlets) {
+		AVK_CHECK(ml.mBounds.has_value());
+		if (!ml.mBounds.has_value()) {
+			continue;
+		}
+		const glm::vec3 center{ ml.mBounds->mBoundingSphere };
+		const auto radius = ml.mBounds->mBoundingSphere.w;
+		const glm::vec3 axis{ ml.mBounds->mNormalCone };
+		const auto cutoff = ml.mBounds->mNormalCone.w;
+
+		// The sphere contains all vertices:
+		for (uint32_t i = 0; i < ml.mVertexCount; ++i) {
+			AVK_CHECK(glm::length(sphere.mPositions[ml.mVertices[i]] - center) <= radius * 1.0001f);
+		}
+
+		// Whenever the cone allows to cull the meshlet, all of its triangles face away from the camera:
+		for (int i = 0; i < 64; ++i) {
+			const glm::vec3 camera{ dist(rng), dist(rng), dist(rng) };
+			const auto toCenter = center - camera;
+			if (glm::dot(toCenter, axis) < cutoff * glm::length(toCenter) + radius) {
+				continue;
+			}
+			++numCulled;
+			for (uint32_t t = 0; t + 2 < ml.mIndexCount; t += 3) {
+				const auto& a = sphere.mPositions[ml.mVertices[ml.mIndices[t]]];
+				const auto& b = sphere.mPositions[ml.mVertices[ml.mIndices[t + 1]]];
+				const auto& c = sphere.mPositions[ml.mVertices[ml.mIndices[t + 2]]];
+				AVK_CHECK(glm::dot(a - camera, glm::cross(b - a, c - a)) >= -1e-6f);
+			}
+		}
+	}
+	// The closed sphere must be partly culled from outside:
+	AVK_CHECK(numCulled > 0);
+}
+
+AVK_TEST(meshlet_gpu_data_keeps_its_layout)
+{
+	// Shaders declare these structs themselves, hence the bounds must not have changed them:
+	using gpu_meshlet = avk::meshlet_gpu_data<cMaxVertices, cMaxIndices>;
+	AVK_CHECK(0 == offsetof(gpu_meshlet, mVertices));
+	AVK_CHECK(0 == offsetof(avk::meshlet_redirected_gpu_data, mDataOffset));
+	AVK_CHECK(32 == sizeof(avk::meshlet_bounds));
+}
+
+AVK_TEST(meshlet_bounds_are_gathered_for_gpu_usage)
+{
+	const auto meshlets = build_meshlets(create_shuffled_sphere());
+	auto [gpuMeshlets, noData] = avk::convert_for_gpu_usage<avk::meshlet_gpu_data<cMaxVertices, cMaxIndices>>(meshlets);
+	auto [redirectedMeshlets, data] = avk::convert_for_gpu_usage<avk::meshlet_redirected_gpu_data, cMaxVertices, cMaxIndices>(meshlets);
+	const auto gpuBounds = avk::convert_bounds_for_gpu_usage(meshlets);
+	AVK_CHECK(!noData.has_value());
+	AVK_CHECK(data.has_value());
+	AVK_CHECK(gpuMeshlets.size() == meshlets.size());
+	AVK_CHECK(redirectedMeshlets.size() == meshlets.size());
+	AVK_CHECK(gpuBounds.size() == meshlets.size());
+
+	for (size_t i = 0; i < std::min({ meshlets.size(), gpuMeshlets.size(), redirectedMeshlets.size(), gpuBounds.size() }); ++i) {
+		AVK_CHECK(same_bounds(gpuBounds[i], *meshlets[i].mBounds));
+		AVK_CHECK(gpuMeshlets[i].mVertexCount == meshlets[i].mVertexCount);
+		AVK_CHECK(gpuMeshlets[i].mPrimitiveCount * 3u == meshlets[i].mIndexCount);
+		AVK_CHECK(std::equal(meshlets[i].mVertices.begin(), meshlets[i].mVertices.begin() + meshlets[i].mVertexCount, data->begin() + redirectedMeshlets[i].mDataOffset));
+	}
+
+	// Meshlets without bounds must never be culled:
+	avk::meshlet unbounded{};
+	unbounded.mVertexCount = 0;
+	unbounded.mIndexCount = 0;
+	const auto unboundedGpuBounds = avk::convert_bounds_for_gpu_usage({ unbounded });
+	AVK_CHECK(std::isinf(unboundedGpuBounds.front().mBoundingSphere.w));
+	AVK_CHECK(1.0f == unboundedGpuBounds.front().mNormalCone.w);
+}
+
+AVK_TEST(meshlet_gpu_data_cache_round_trip)
+{
+	using gpu_meshlet = avk::meshlet_gpu_data<cMaxVertices, cMaxIndices>;
+	const auto meshlets = build_meshlets(create_shuffled_sphere());
+	const auto path = (std::filesystem::temp_directory_path() / "avk_toolkit_tests_meshlets.cache").string();
+
+	std::vector<gpu_meshlet> written;
+	std::vector<avk::meshlet_redirected_gpu_data> writtenRedirected;
+	std::optional<std::vector<uint32_t>> writtenData;
+	std::vector<avk::meshlet_bounds> writtenBounds;
+	{
+		avk::serializer serializer(path, avk::serializer::mode::serialize);
+		std::tie(written, std::ignore) = avk::convert_for_gpu_usage_cached<gpu_meshlet>(serializer, meshlets);
+		std::tie(writtenRedirected, writtenData) = avk::convert_for_gpu_usage_cached<avk::meshlet_redirected_gpu_data, cMaxVertices, cMaxIndices>(serializer, meshlets);
+		writtenBounds = avk::convert_bounds_for_gpu_usage_cached(serializer, meshlets);
+	}
+	std::vector<gpu_meshlet> read;
+	std::vector<avk::meshlet_redirected_gpu_data> readRedirected;
+	std::optional<std::vector<uint32_t>> readData;
+	std::vector<avk::meshlet_bounds> readBounds;
+	{
+		avk::serializer serializer(path, avk::serializer::mode::deserialize);
+		std::tie(read, std::ignore) = avk::convert_for_gpu_usage_cached<gpu_meshlet>(serializer, {});
+		std::tie(readRedirected, readData) = avk::convert_for_gpu_usage_cached<avk::meshlet_redirected_gpu_data, cMaxVertices, cMaxIndices>(serializer, {});
+		readBounds = avk::convert_bounds_for_gpu_usage_cached(serializer, {});
+	}
+	std::filesystem::remove(path);
+
+	// The bounds, the vertices and the indices must all be part of the cache:
+	AVK_CHECK(read.size() == written.size());
+	AVK_CHECK(readRedirected.size() == writtenRedirected.size());
+	AVK_CHECK(readData == writtenData);
+	AVK_CHECK(readBounds.size() == writtenBounds.size());
+	bool same = true;
+	for (size_t i = 0; i < std::min(readBounds.size(), writtenBounds.size()); ++i) {
+		same = same_bounds(readBounds[i], writtenBounds[i]) && same;
+	}
+	for (size_t i = 0; i < std::min(read.size(), written.size()); ++i) {
+		same = 0 == std::memcmp(read[i].mVertices, written[i].mVertices, sizeof(gpu_meshlet::mVertices))
+			&& 0 == std::memcmp(read[i].mIndices, written[i].mIndices, sizeof(gpu_meshlet::mIndices))
+			&& read[i].mVertexCount == written[i].mVertexCount
+			&& read[i].mPrimitiveCount == written[i].mPrimitiveCount
+			&& same;
+	}
+	for (size_t i = 0; i < std::min(readRedirected.size(), writtenRedirected.size()); ++i) {
+		same = readRedirected[i].mDataOffset == writtenRedirected[i].mDataOffset
+			&& readRedirected[i].mVertexCount == writtenRedirected[i].mVertexCount
+			&& readRedirected[i].mPrimitiveCount == writtenRedirected[i].mPrimitiveCount
+			&& same;
+	}
+	AVK_CHECK(same);
+}
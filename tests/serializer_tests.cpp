@@ -0,0 +1,90 @@
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+#include "auto_vk_toolkit.hpp"
+#include "serializer.hpp"
+#include "test_framework.hpp"
+
+// Writes cache files via avk::create_serializer_for_source_file into a temporary directory, and checks that a cache file
+// is either complete or not there at all: truncated cache files and cache files which were being written when an
+// exception occurred must be rebuilt on the next start instead of being read.
+
+namespace
+{
+	constexpr std::uint32_t cFormatVersion = 7;
+	constexpr std::uint64_t cPayload = 0x0123456789abcdefull;
+
+	/** A directory of its own for every test, s.t. tests can run in parallel; it is removed again when the test ends */
+	struct temp_directory
+	{
+		explicit temp_directory(const std::string& aName)
+			: mPath{ std::filesystem::temp_directory_path() / aName }
+		{
+			std::filesystem::remove_all(mPath);
+			std::filesystem::create_directories(mPath);
+			std::ofstream(source_file()) << "the source asset";
+		}
+
+		~temp_directory()
+		{
+			std::error_code ec;
+			std::filesystem::remove_all(mPath, ec);
+		}
+
+		std::string source_file() const { return (mPath / "scene.obj").string(); }
+		std::string cache_file() const { return (mPath / "scene.obj.cache").string(); }
+
+		std::filesystem::path mPath;
+	};
+
+	/** Writes the cache file if it is not up to date, or reads it; returns true if it has been written */
+	bool write_or_read(const temp_directory& aDirectory)
+	{
+		auto serializer = avk::create_serializer_for_source_file(aDirectory.cache_file(), aDirectory.source_file(), cFormatVersion);
+		std::uint64_t payload = cPayload;
+		serializer.archive(payload);
+		if (payload != cPayload) {
+			throw std::runtime_error("Wrong payload read from the cache file");
+		}
+		return serializer.mode() == avk::serializer::mode::serialize;
+	}
+}
+
+AVK_TEST(serializer_cache_file_is_reused)
+{
+	temp_directory directory{ "avk_serializer_reused" };
+	AVK_CHECK(write_or_read(directory));
+	AVK_CHECK(avk::has_complete_cache_file(directory.cache_file()));
+	AVK_CHECK(!std::filesystem::exists(directory.cache_file() + ".tmp"));
+	AVK_CHECK(!write_or_read(directory));
+}
+
+AVK_TEST(serializer_truncated_cache_file_is_rebuilt)
+{
+	temp_directory directory{ "avk_serializer_truncated" };
+	write_or_read(directory);
+	// What a cache file looked like if the process was killed while writing it in place: a valid header, but a short body:
+	std::filesystem::resize_file(directory.cache_file(), std::filesystem::file_size(directory.cache_file()) - 20);
+	AVK_CHECK(!avk::has_complete_cache_file(directory.cache_file()));
+	AVK_CHECK(write_or_read(directory));
+	AVK_CHECK(!write_or_read(directory));
+}
+
+AVK_TEST(serializer_exception_while_writing_leaves_no_cache_file)
+{
+	temp_directory directory{ "avk_serializer_exception" };
+	try {
+		auto serializer = avk::create_serializer_for_source_file(directory.cache_file(), directory.source_file(), cFormatVersion);
+		std::uint64_t payload = cPayload;
+		serializer.archive(payload);
+		throw std::runtime_error("Loading the scene has failed");
+	}
+	catch (const std::runtime_error&) {
+	}
+	AVK_CHECK(!std::filesystem::exists(directory.cache_file()));
+	AVK_CHECK(!std::filesystem::exists(directory.cache_file() + ".tmp"));
+	AVK_CHECK(write_or_read(directory));
+}
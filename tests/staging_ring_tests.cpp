@@ -0,0 +1,154 @@
+#include <algorithm>
+#include <deque>
+#include <random>
+#include <tuple>
+#include <vector>
+
+#include "auto_vk_toolkit.hpp"
+#include "test_framework.hpp"
+
+// Drives the bookkeeping of avk::staging_ring (avk::ring_suballocator), which needs no device: regions are handed out in
+// order, recycled in order once released, never overlap a region which has not been released yet, and a workload which
+// releases its regions a few frames later like buffer_t::fill's command buffers do runs in a bounded part of the ring forever.
+
+namespace
+{
+	constexpr vk::DeviceSize cCapacity = 4096;
+	constexpr vk::DeviceSize cAlignment = 16;
+
+	struct region
+	{
+		uint64_t mId;
+		vk::DeviceSize mOffset;
+		vk::DeviceSize mSize;
+	};
+
+	region allocate(avk::ring_suballocator& aRing, vk::DeviceSize aSize)
+	{
+		const auto result = aRing.allocate(aSize, cAlignment);
+		if (!result.has_value()) {
+			return region{ 0, cCapacity, 0 };
+		}
+		return region{ std::get<0>(result.value()), std::get<1>(result.value()), aSize };
+	}
+
+	bool overlap(const region& a, const region& b)
+	{
+		return a.mOffset < b.mOffset + b.mSize && b.mOffset < a.mOffset + a.mSize;
+	}
+}
+
+AVK_TEST(staging_ring_recycles_regions_in_order)
+{
+	avk::ring_suballocator ring{ cCapacity };
+	const auto a = allocate(ring, 1000);
+	const auto b = allocate(ring, 1000);
+	const auto c = allocate(ring, 1000);
+	AVK_CHECK(a.mOffset == 0 && b.mOffset == 1008 && c.mOffset == 2016);
+	AVK_CHECK(b.mId == a.mId + 1 && c.mId == b.mId + 1);
+
+	// b's space is not recycled before a's:
+	ring.release(b.mId);
+	AVK_CHECK(ring.num_in_flight() == 3);
+	ring.release(a.mId);
+	AVK_CHECK(ring.num_in_flight() == 1);
+	// Releasing twice, or an id which the ring has never handed out, changes nothing:
+	ring.release(a.mId);
+	ring.release(c.mId + 100);
+	AVK_CHECK(ring.num_in_flight() == 1);
+	ring.release(c.mId);
+	AVK_CHECK(ring.num_in_flight() == 0);
+
+	// An empty ring starts over at its beginning:
+	AVK_CHECK(allocate(ring, 1000).mOffset == 0);
+	AVK_CHECK(ring.num_wraps() == 0);
+}
+
+AVK_TEST(staging_ring_wraps_around_behind_the_oldest_region)
+{
+	avk::ring_suballocator ring{ cCapacity };
+	const auto a = allocate(ring, 1500);
+	const auto b = allocate(ring, 1500);
+	// Neither at the end, nor in front of a:
+	AVK_CHECK(!ring.allocate(1500, cAlignment).has_value());
+
+	ring.release(a.mId);
+	const auto c = allocate(ring, 1500);
+	AVK_CHECK(c.mOffset == 0);
+	AVK_CHECK(ring.num_wraps() == 1);
+	// The head is in front of b now, and must not run into it:
+	AVK_CHECK(!ring.allocate(100, cAlignment).has_value());
+	AVK_CHECK(!overlap(b, c));
+
+	ring.release(b.mId);
+	const auto d = allocate(ring, 1500);
+	AVK_CHECK(d.mOffset == 1504);
+	AVK_CHECK(!overlap(c, d));
+	AVK_CHECK(!ring.allocate(0, cAlignment).has_value());
+	AVK_CHECK(!ring.allocate(cCapacity + 1, cAlignment).has_value());
+}
+
+AVK_TEST(staging_ring_never_hands_out_regions_in_use)
+{
+	std::mt19937 rng{ 42u };
+	std::uniform_int_distribution<vk::DeviceSize> size{ 1, cCapacity / 4 };
+	avk::ring_suballocator ring{ cCapacity };
+	std::vector<region> inUse;
+	int numOverlaps = 0;
+	int numMisaligned = 0;
+	int numServed = 0;
+	int numFailed = 0;
+	for (int i = 0; i < 100000; ++i) {
+		// Release a random region in use, i.e., not necessarily the oldest one, or allocate a new one:
+		if (!inUse.empty() && (rng() % 2 == 0 || inUse.size() > 16)) {
+			const auto index = rng() % inUse.size();
+			ring.release(inUse[index].mId);
+			inUse.erase(inUse.begin() + index);
+			continue;
+		}
+		const auto r = allocate(ring, size(rng));
+		if (0 == r.mSize) {
+			++numFailed;
+			continue;
+		}
+		numMisaligned += 0 == r.mOffset % cAlignment && r.mOffset + r.mSize <= cCapacity ? 0 : 1;
+		numOverlaps += static_cast<int>(std::count_if(inUse.begin(), inUse.end(), [&r](const region& other) { return overlap(r, other); }));
+		inUse.push_back(r);
+		++numServed;
+	}
+	AVK_CHECK(0 == numOverlaps);
+	AVK_CHECK(0 == numMisaligned);
+	// Some requests fail while the ring is full, but most of them are served:
+	AVK_CHECK(numFailed > 0 && numFailed < numServed);
+	AVK_CHECK(ring.num_wraps() > 0);
+}
+
+AVK_TEST(staging_ring_steady_state_stays_bounded)
+{
+	// Every frame uploads a few regions which are released when the frame's command buffer is reset, three frames later:
+	constexpr size_t cFramesInFlight = 3;
+	avk::ring_suballocator ring{ cCapacity };
+	std::deque<std::vector<uint64_t>> frames;
+	size_t maxInFlight = 0;
+	int numFailed = 0;
+	for (int frame = 0; frame < 10000; ++frame) {
+		if (frames.size() == cFramesInFlight) {
+			for (const auto id : frames.front()) {
+				ring.release(id);
+			}
+			frames.pop_front();
+		}
+		auto& ids = frames.emplace_back();
+		for (vk::DeviceSize size : { 100, 250, 64 }) {
+			const auto r = ring.allocate(size, cAlignment);
+			numFailed += r.has_value() ? 0 : 1;
+			if (r.has_value()) {
+				ids.push_back(std::get<0>(r.value()));
+			}
+		}
+		maxInFlight = std::max(maxInFlight, ring.num_in_flight());
+	}
+	AVK_CHECK(0 == numFailed);
+	AVK_CHECK(maxInFlight == cFramesInFlight * 3);
+	AVK_CHECK(ring.num_wraps() > 0);
+}
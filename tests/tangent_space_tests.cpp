@@ -0,0 +1,195 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "auto_vk_toolkit.hpp"
+#include "model.hpp"
+#include "work_stealing_pool.hpp"
+#include "test_framework.hpp"
+#include <assimp/qnan.h>
+
+// Calculates the tangent space of a synthetic OBJ scene, loaded from memory, with avk::model_t's structure-of-arrays
+// implementation, and compares it against the face-by-face implementation which calculate_tangent_space_for_mesh used
+// to have. The scene consists of a wavy grid of quads, the same grid with mirrored texture coordinates, and the same
+// grid with degenerate texture coordinates.
+
+namespace
+{
+	constexpr uint32_t cGridSize = 96;
+	constexpr float cTolerance = 1e-4f;
+
+	using tangent_space = std::vector<std::tuple<std::vector<glm::vec3>, std::vector<glm::vec3>>>;
+
+	/** Appends a grid object whose vertices are shared by up to four quads. aTexCoord maps the grid coordinates to UVs. */
+	template <typename F>
+	void append_grid(std::string& aObj, const std::string& aName, uint32_t& aNumVertices, F aTexCoord)
+	{
+		aObj += "o " + aName + "\n";
+		for (uint32_t i = 0; i <= cGridSize; ++i) {
+			for (uint32_t j = 0; j <= cGridSize; ++j) {
+				const auto x = static_cast<float>(j) / cGridSize;
+				const auto z = static_cast<float>(i) / cGridSize;
+				const auto y = 0.1f * std::sin(8.0f * x) * std::cos(6.0f * z);
+				const auto n = glm::normalize(glm::vec3{ -0.8f * std::cos(8.0f * x) * std::cos(6.0f * z), 1.0f, 0.6f * std::sin(8.0f * x) * std::sin(6.0f * z) });
+				const auto uv = aTexCoord(x, z);
+				aObj += std::format("v {} {} {}\nvt {} {}\nvn {} {} {}\n", x, y, z, uv.x, uv.y, n.x, n.y, n.z);
+			}
+		}
+		for (uint32_t i = 0; i < cGridSize; ++i) {
+			for (uint32_t j = 0; j < cGridSize; ++j) {
+				const auto a = aNumVertices + i * (cGridSize + 1) + j + 1; // OBJ indices are 1-based
+				const auto c = a + cGridSize + 1;
+				aObj += std::format("f {0}/{0}/{0} {1}/{1}/{1} {2}/{2}/{2} {3}/{3}/{3}\n", a, c, c + 1, a + 1);
+			}
+		}
+		aNumVertices += (cGridSize + 1) * (cGridSize + 1);
+	}
+
+	avk::model load_scene()
+	{
+		std::string obj;
+		uint32_t numVertices = 0;
+		append_grid(obj, "wave", numVertices, [](float x, float z) { return glm::vec2{ 2.0f * x, 3.0f * z }; });
+		append_grid(obj, "mirrored", numVertices, [](float x, float z) { return glm::vec2{ 1.0f - x, z }; });
+		append_grid(obj, "degenerate_uvs", numVertices, [](float, float) { return glm::vec2{ 0.5f, 0.5f }; });
+		return avk::model_t::load_from_memory(obj, aiProcess_Triangulate | aiProcess_JoinIdenticalVertices);
+	}
+
+	/** The face-by-face implementation which model_t::calculate_tangent_space_for_mesh used to have: every face writes its frame into all of its vertices */
+	tangent_space calculate_reference(const avk::model_t& aModel)
+	{
+		const aiScene* scene = aModel.handle();
+		tangent_space result(scene->mNumMeshes);
+		for (unsigned int m = 0; m < scene->mNumMeshes; ++m) {
+			const aiMesh* pMesh = scene->mMeshes[m];
+			auto& [meshTang, meshBitang] = result[m];
+			meshTang.resize(pMesh->mNumVertices);
+			meshBitang.resize(pMesh->mNumVertices);
+			if (!(pMesh->mPrimitiveTypes & (aiPrimitiveType_TRIANGLE | aiPrimitiveType_POLYGON)) || nullptr == pMesh->mNormals || nullptr == pMesh->mTextureCoords[0]) {
+				continue;
+			}
+
+			const float qnan = std::numeric_limits<ai_real>::quiet_NaN();
+			const aiVector3D* meshPos = pMesh->mVertices;
+			const aiVector3D* meshNorm = pMesh->mNormals;
+			const aiVector3D* meshTex = pMesh->mTextureCoords[0];
+			for (unsigned int a = 0; a < pMesh->mNumFaces; a++) {
+				const aiFace& face = pMesh->mFaces[a];
+				if (face.mNumIndices < 3) {
+					for (unsigned int i = 0; i < face.mNumIndices; ++i) {
+						meshTang[face.mIndices[i]] = glm::vec3(qnan);
+						meshBitang[face.mIndices[i]] = glm::vec3(qnan);
+					}
+					continue;
+				}
+
+				const unsigned int p0 = face.mIndices[0], p1 = face.mIndices[1], p2 = face.mIndices[2];
+				aiVector3D v = meshPos[p1] - meshPos[p0], w = meshPos[p2] - meshPos[p0];
+				float sx = meshTex[p1].x - meshTex[p0].x, sy = meshTex[p1].y - meshTex[p0].y;
+				float tx = meshTex[p2].x - meshTex[p0].x, ty = meshTex[p2].y - meshTex[p0].y;
+				float dirCorrection = (tx * sy - ty * sx) < 0.0f ? -1.0f : 1.0f;
+				if (sx * ty == sy * tx) {
+					sx = 0.0; sy = 1.0; tx = 1.0; ty = 0.0;
+				}
+				aiVector3D tangent, bitangent;
+				tangent.x = (w.x * sy - v.x * ty) * dirCorrection;
+				tangent.y = (w.y * sy - v.y * ty) * dirCorrection;
+				tangent.z = (w.z * sy - v.z * ty) * dirCorrection;
+				bitangent.x = (w.x * sx - v.x * tx) * dirCorrection;
+				bitangent.y = (w.y * sx - v.y * tx) * dirCorrection;
+				bitangent.z = (w.z * sx - v.z * tx) * dirCorrection;
+
+				for (unsigned int b = 0; b < face.mNumIndices; ++b) {
+					unsigned int p = face.mIndices[b];
+					aiVector3D localTangent = tangent - meshNorm[p] * (tangent * meshNorm[p]);
+					aiVector3D localBitangent = bitangent - meshNorm[p] * (bitangent * meshNorm[p]);
+					localTangent.NormalizeSafe();
+					localBitangent.NormalizeSafe();
+					bool invalidTangent = is_special_float(localTangent.x) || is_special_float(localTangent.y) || is_special_float(localTangent.z);
+					bool invalidBitangent = is_special_float(localBitangent.x) || is_special_float(localBitangent.y) || is_special_float(localBitangent.z);
+					if (invalidTangent != invalidBitangent) {
+						if (invalidTangent) {
+							localTangent = meshNorm[p] ^ localBitangent;
+							localTangent.NormalizeSafe();
+						}
+						else {
+							localBitangent = localTangent ^ meshNorm[p];
+							localBitangent.NormalizeSafe();
+						}
+					}
+					meshTang[p] = glm::vec3(localTangent.x, localTangent.y, localTangent.z);
+					meshBitang[p] = glm::vec3(localBitangent.x, localBitangent.y, localBitangent.z);
+				}
+			}
+		}
+		return result;
+	}
+
+	/** Largest component-wise deviation between two sets of vectors; infinity if one of them is NaN where the other one is not */
+	float max_deviation(const std::vector<glm::vec3>& aExpected, const std::vector<glm::vec3>& aActual)
+	{
+		if (aExpected.size() != aActual.size()) {
+			return std::numeric_limits<float>::infinity();
+		}
+		float result = 0.0f;
+		for (size_t i = 0; i < aExpected.size(); ++i) {
+			for (glm::length_t c = 0; c < 3; ++c) {
+				if (std::isnan(aExpected[i][c]) != std::isnan(aActual[i][c])) {
+					return std::numeric_limits<float>::infinity();
+				}
+				if (!std::isnan(aExpected[i][c])) {
+					result = std::max(result, std::abs(aExpected[i][c] - aActual[i][c]));
+				}
+			}
+		}
+		return result;
+	}
+
+	tangent_space tangent_space_of(const avk::model_t& aModel)
+	{
+		tangent_space result;
+		for (avk::mesh_index_t i = 0; i < aModel.num_meshes(); ++i) {
+			result.emplace_back(aModel.tangents_for_mesh(i), aModel.bitangents_for_mesh(i));
+		}
+		return result;
+	}
+
+	bool same_bits(const std::vector<glm::vec3>& aExpected, const std::vector<glm::vec3>& aActual)
+	{
+		return aExpected.size() == aActual.size() && 0 == std::memcmp(aExpected.data(), aActual.data(), aExpected.size() * sizeof(glm::vec3));
+	}
+}
+
+AVK_TEST(tangent_space_matches_face_by_face_reference)
+{
+	auto scene = load_scene();
+	AVK_CHECK(scene->num_meshes() >= 1);
+	const auto reference = calculate_reference(*scene);
+	scene->calculate_tangent_space_for_all_meshes();
+	for (avk::mesh_index_t i = 0; i < scene->num_meshes(); ++i) {
+		AVK_CHECK(scene->number_of_vertices_for_mesh(i) > 0);
+		AVK_CHECK(max_deviation(std::get<0>(reference[i]), scene->tangents_for_mesh(i)) <= cTolerance);
+		AVK_CHECK(max_deviation(std::get<1>(reference[i]), scene->bitangents_for_mesh(i)) <= cTolerance);
+	}
+}
+
+AVK_TEST(tangent_space_parallel_matches_single_thread)
+{
+	auto scene = load_scene();
+	scene->calculate_tangent_space_for_all_meshes();
+	const auto expected = tangent_space_of(*scene);
+	for (uint32_t numThreads : { 1u, 2u, 4u }) {
+		avk::work_stealing_pool pool{ numThreads };
+		scene->calculate_tangent_space_for_all_meshes(pool);
+		const auto actual = tangent_space_of(*scene);
+		AVK_CHECK(actual.size() == expected.size());
+		for (size_t i = 0; i < std::min(actual.size(), expected.size()); ++i) {
+			AVK_CHECK(same_bits(std::get<0>(expected[i]), std::get<0>(actual[i])));
+			AVK_CHECK(same_bits(std::get<1>(expected[i]), std::get<1>(actual[i])));
+		}
+	}
+}
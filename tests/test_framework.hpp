@@ -0,0 +1,72 @@
+#pragma once
+
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <string>
+
+/** A minimal test registry for avk_toolkit_tests. Every test is a function which is registered under its name via AVK_TEST,
+ *  and which reports failed conditions via AVK_CHECK. CTest runs every test in its own process, by passing the test's name
+ *  to avk_toolkit_tests (see tests/CMakeLists.txt).
+ *
+ *  Usage example:
+ *
+ *	AVK_TEST(my_feature_works)
+ *	{
+ *		AVK_CHECK(1 + 1 == 2);
+ *	}
+ */
+namespace avk_tests
+{
+	/** The exit code of a test which cannot run in this environment, e.g., because there is no Vulkan device. CTest reports it as skipped. */
+	constexpr int cSkipReturnCode = 77;
+
+	/** Thrown by AVK_SKIP */
+	struct skipped
+	{
+		std::string mReason;
+	};
+
+	/** All registered tests by name */
+	inline std::map<std::string, std::function<void()>>& registry()
+	{
+		static std::map<std::string, std::function<void()>> sTests;
+		return sTests;
+	}
+
+	/** The number of failed checks of the running test */
+	inline int& failed_checks()
+	{
+		static int sFailedChecks = 0;
+		return sFailedChecks;
+	}
+
+	struct registrar
+	{
+		registrar(const char* aName, std::function<void()> aTest)
+		{
+			registry().emplace(aName, std::move(aTest));
+		}
+	};
+
+	inline void check(bool aPassed, const char* aExpression, const char* aFile, int aLine)
+	{
+		if (!aPassed) {
+			++failed_checks();
+			std::cerr << aFile << "(" << aLine << "): check failed: " << aExpression << std::endl;
+		}
+	}
+}
+
+/** Defines and registers a test; the function body follows the macro */
+#define AVK_TEST(name) \
+	static void name(); \
+	static const avk_tests::registrar name##_registrar{ #name, name }; \
+	static void name()
+
+/** Fails the running test if expression is false, but continues it */
+#define AVK_CHECK(expression) avk_tests::check(static_cast<bool>(expression), #expression, __FILE__, __LINE__)
+
+/** Ends the running test as skipped */
+#define AVK_SKIP(reason) throw avk_tests::skipped{ reason }
@@ -0,0 +1,285 @@
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <gli/core/bc.hpp>
+#include <stb_image_write.h>
+
+#include "auto_vk_toolkit.hpp"
+#include "texture_baker.hpp"
+#include "test_framework.hpp"
+
+// Bakes synthetic textures of every avk::texture_content (an opaque color texture, a color texture with alpha, a normal map,
+// and a height map) from PNG files in a temporary directory into a cache there, loads the baked KTX files via gli like the
+// demo loads them, and compares their decoded first levels against the source images. The RMS errors of colors, alpha, and
+// heights are given in 8-bit steps; normals are compared after reconstructing their Z like the shaders do.
+
+namespace
+{
+	constexpr int cSize = 1024;
+	// RMS errors in 8-bit steps, which BC1/BC3/BC4 reach for smooth content like the synthetic textures:
+	constexpr double cMaxRmsColorError = 3.0;
+	constexpr double cMaxRmsAlphaError = 0.5;
+	constexpr double cMaxRmsHeightError = 0.5;
+	constexpr double cMaxRmsNormalErrorDegrees = 0.5;
+
+	uint8_t to_unorm8(float aValue)
+	{
+		return static_cast<uint8_t>(std::lround(std::clamp(aValue, 0.0f, 1.0f) * 255.0f));
+	}
+
+	/** Smooth gradients and waves; with alpha, the alpha varies smoothly across the whole range */
+	std::vector<uint8_t> make_color(bool aWithAlpha)
+	{
+		std::vector<uint8_t> pixels(static_cast<size_t>(cSize) * cSize * 4);
+		for (int y = 0; y < cSize; ++y) {
+			for (int x = 0; x < cSize; ++x) {
+				const float u = static_cast<float>(x) / cSize;
+				const float v = static_cast<float>(y) / cSize;
+				auto* p = &pixels[(static_cast<size_t>(y) * cSize + x) * 4];
+				p[0] = to_unorm8(u);
+				p[1] = to_unorm8(0.5f + 0.5f * std::sin(glm::two_pi<float>() * 4.0f * v));
+				p[2] = to_unorm8(0.5f + 0.5f * std::cos(glm::two_pi<float>() * 3.0f * (u + v)));
+				p[3] = aWithAlpha ? to_unorm8(0.5f + 0.5f * std::sin(glm::two_pi<float>() * 2.0f * u)) : 255;
+			}
+		}
+		return pixels;
+	}
+
+	float height(float u, float v)
+	{
+		return 0.5f + 0.25f * std::sin(glm::two_pi<float>() * 3.0f * u) * std::cos(glm::two_pi<float>() * 2.0f * v);
+	}
+
+	std::vector<uint8_t> make_height()
+	{
+		std::vector<uint8_t> pixels(static_cast<size_t>(cSize) * cSize * 4);
+		for (int y = 0; y < cSize; ++y) {
+			for (int x = 0; x < cSize; ++x) {
+				auto* p = &pixels[(static_cast<size_t>(y) * cSize + x) * 4];
+				p[0] = p[1] = p[2] = to_unorm8(height(static_cast<float>(x) / cSize, static_cast<float>(y) / cSize));
+				p[3] = 255;
+			}
+		}
+		return pixels;
+	}
+
+	/** The tangent-space normals of a bumpy height field */
+	std::vector<uint8_t> make_normals()
+	{
+		std::vector<uint8_t> pixels(static_cast<size_t>(cSize) * cSize * 4);
+		const float h = 1.0f / cSize;
+		for (int y = 0; y < cSize; ++y) {
+			for (int x = 0; x < cSize; ++x) {
+				const float u = static_cast<float>(x) / cSize;
+				const float v = static_cast<float>(y) / cSize;
+				const float dx = (height(u + h, v) - height(u - h, v)) / (2.0f * h);
+				const float dy = (height(u, v + h) - height(u, v - h)) / (2.0f * h);
+				const auto n = glm::normalize(glm::vec3{ -dx * 0.2f, -dy * 0.2f, 1.0f });
+				auto* p = &pixels[(static_cast<size_t>(y) * cSize + x) * 4];
+				for (int c = 0; c < 3; ++c) {
+					p[c] = to_unorm8(n[c] * 0.5f + 0.5f);
+				}
+				p[3] = 255;
+			}
+		}
+		return pixels;
+	}
+
+	/** A directory of its own for every test, s.t. tests can run in parallel; it is removed again when the test ends */
+	struct temp_directory
+	{
+		explicit temp_directory(const std::string& aName)
+			: mPath{ std::filesystem::temp_directory_path() / aName }
+		{
+			std::filesystem::remove_all(mPath);
+			std::filesystem::create_directories(mPath);
+		}
+
+		~temp_directory()
+		{
+			std::error_code ec;
+			std::filesystem::remove_all(mPath, ec);
+		}
+
+		std::filesystem::path mPath;
+	};
+
+	std::string write_png(const temp_directory& aDirectory, const std::string& aName, const std::vector<uint8_t>& aPixels)
+	{
+		const auto path = (aDirectory.mPath / (aName + ".png")).string();
+		if (0 == stbi_write_png(path.c_str(), cSize, cSize, 4, aPixels.data(), cSize * 4)) {
+			throw avk::runtime_error("Could not write " + path);
+		}
+		return path;
+	}
+
+	/** Decodes the first level of a block-compressed texture into RGBA values in [0, 1] */
+	std::vector<glm::vec4> decode_first_level(const gli::texture2d& aTexture)
+	{
+		const auto extent = aTexture.extent(0);
+		const auto blocksX = (extent.x + 3) / 4;
+		const auto blocksY = (extent.y + 3) / 4;
+		const auto blockSize = gli::block_size(aTexture.format());
+		const auto* blocks = aTexture.data<uint8_t>(0, 0, 0);
+
+		std::vector<glm::vec4> texels(static_cast<size_t>(extent.x) * extent.y);
+		for (int by = 0; by < blocksY; ++by) {
+			for (int bx = 0; bx < blocksX; ++bx) {
+				const auto* block = blocks + (static_cast<size_t>(by) * blocksX + bx) * blockSize;
+				gli::detail::texel_block4x4 decoded;
+				switch (aTexture.format()) {
+				case gli::FORMAT_RGB_DXT1_UNORM_BLOCK8:
+				case gli::FORMAT_RGB_DXT1_SRGB_BLOCK8:
+					decoded = gli::detail::decompress_dxt1_block(*reinterpret_cast<const gli::detail::dxt1_block*>(block));
+					break;
+				case gli::FORMAT_RGBA_DXT5_UNORM_BLOCK16:
+				case gli::FORMAT_RGBA_DXT5_SRGB_BLOCK16:
+					decoded = gli::detail::decompress_dxt5_block(*reinterpret_cast<const gli::detail::dxt5_block*>(block));
+					break;
+				case gli::FORMAT_R_ATI1N_UNORM_BLOCK8:
+					decoded = gli::detail::decompress_bc4unorm_block(*reinterpret_cast<const gli::detail::bc4_block*>(block));
+					break;
+				case gli::FORMAT_RG_ATI2N_UNORM_BLOCK16:
+					decoded = gli::detail::decompress_bc5unorm_block(*reinterpret_cast<const gli::detail::bc5_block*>(block));
+					break;
+				default:
+					throw avk::runtime_error("Unexpected format of a baked texture");
+				}
+				for (int y = 0; y < 4 && by * 4 + y < extent.y; ++y) {
+					for (int x = 0; x < 4 && bx * 4 + x < extent.x; ++x) {
+						texels[static_cast<size_t>(by * 4 + y) * extent.x + bx * 4 + x] = decoded.Texel[y][x];
+					}
+				}
+			}
+		}
+		return texels;
+	}
+
+	/** Bakes the source image without flipping, s.t. the decoded pixels can be compared against the source pixels directly */
+	gli::texture2d bake(const std::string& aName, avk::texture_content aContent, const std::vector<uint8_t>& aPixels)
+	{
+		temp_directory directory{ "avk_texture_baker_" + aName };
+		avk::texture_baker baker((directory.mPath / "cache").string());
+		const auto path = write_png(directory, aName, aPixels);
+		return gli::texture2d(gli::load(baker.bake(path, aContent, avk::texture_content::color == aContent, false)));
+	}
+
+	bool has_complete_mip_chain(const gli::texture2d& aTexture)
+	{
+		return aTexture.levels() == static_cast<size_t>(std::floor(std::log2(cSize))) + 1;
+	}
+
+	glm::dvec4 source_texel(const std::vector<uint8_t>& aPixels, size_t aIndex)
+	{
+		return glm::dvec4{ aPixels[aIndex * 4], aPixels[aIndex * 4 + 1], aPixels[aIndex * 4 + 2], aPixels[aIndex * 4 + 3] } / 255.0;
+	}
+
+	/** RMS errors of the colors and of the alpha values, in 8-bit steps */
+	std::tuple<double, double> rms_color_and_alpha_errors(const std::vector<uint8_t>& aPixels, const gli::texture2d& aTexture)
+	{
+		const auto texels = decode_first_level(aTexture);
+		double colorError = 0.0, alphaError = 0.0;
+		for (size_t i = 0; i < texels.size(); ++i) {
+			const auto source = source_texel(aPixels, i);
+			const glm::dvec4 decoded{ texels[i] };
+			const auto d = (glm::dvec3{ decoded } - glm::dvec3{ source }) * 255.0;
+			colorError += glm::dot(d, d) / 3.0;
+			alphaError += std::pow((decoded.a - source.a) * 255.0, 2.0);
+		}
+		const auto n = static_cast<double>(texels.size());
+		return { std::sqrt(colorError / n), std::sqrt(alphaError / n) };
+	}
+}
+
+AVK_TEST(texture_baker_color_bc1)
+{
+	const auto pixels = make_color(false);
+	const auto texture = bake("color", avk::texture_content::color, pixels);
+	AVK_CHECK(texture.format() == gli::FORMAT_RGB_DXT1_SRGB_BLOCK8);
+	AVK_CHECK(has_complete_mip_chain(texture));
+	if (texture.format() == gli::FORMAT_RGB_DXT1_SRGB_BLOCK8) {
+		AVK_CHECK(std::get<0>(rms_color_and_alpha_errors(pixels, texture)) <= cMaxRmsColorError);
+	}
+}
+
+AVK_TEST(texture_baker_color_alpha_bc3)
+{
+	const auto pixels = make_color(true);
+	const auto texture = bake("color_alpha", avk::texture_content::color, pixels);
+	AVK_CHECK(texture.format() == gli::FORMAT_RGBA_DXT5_SRGB_BLOCK16);
+	AVK_CHECK(has_complete_mip_chain(texture));
+	if (texture.format() == gli::FORMAT_RGBA_DXT5_SRGB_BLOCK16) {
+		const auto [colorError, alphaError] = rms_color_and_alpha_errors(pixels, texture);
+		AVK_CHECK(colorError <= cMaxRmsColorError);
+		AVK_CHECK(alphaError <= cMaxRmsAlphaError);
+	}
+}
+
+AVK_TEST(texture_baker_height_map_bc4)
+{
+	const auto pixels = make_height();
+	const auto texture = bake("height", avk::texture_content::single_channel, pixels);
+	AVK_CHECK(texture.format() == gli::FORMAT_R_ATI1N_UNORM_BLOCK8);
+	AVK_CHECK(has_complete_mip_chain(texture));
+	if (texture.format() == gli::FORMAT_R_ATI1N_UNORM_BLOCK8) {
+		const auto texels = decode_first_level(texture);
+		double error = 0.0;
+		for (size_t i = 0; i < texels.size(); ++i) {
+			error += std::pow((texels[i].r - source_texel(pixels, i).r) * 255.0, 2.0);
+		}
+		AVK_CHECK(std::sqrt(error / static_cast<double>(texels.size())) <= cMaxRmsHeightError);
+	}
+}
+
+AVK_TEST(texture_baker_normal_map_bc5)
+{
+	const auto pixels = make_normals();
+	const auto texture = bake("normals", avk::texture_content::normal_map, pixels);
+	AVK_CHECK(texture.format() == gli::FORMAT_RG_ATI2N_UNORM_BLOCK16);
+	AVK_CHECK(has_complete_mip_chain(texture));
+	if (texture.format() == gli::FORMAT_RG_ATI2N_UNORM_BLOCK16) {
+		const auto texels = decode_first_level(texture);
+		double error = 0.0;
+		for (size_t i = 0; i < texels.size(); ++i) {
+			// Like shaders reconstruct it:
+			const glm::dvec2 xy = glm::dvec2{ texels[i] } * 2.0 - 1.0;
+			const glm::dvec3 n{ xy, std::sqrt(std::max(0.0, 1.0 - glm::dot(xy, xy))) };
+			const auto expected = glm::normalize(glm::dvec3{ source_texel(pixels, i) } * 2.0 - 1.0);
+			const auto angle = std::atan2(glm::length(glm::cross(n, expected)), glm::dot(n, expected));
+			error += angle * angle;
+		}
+		AVK_CHECK(glm::degrees(std::sqrt(error / static_cast<double>(texels.size()))) <= cMaxRmsNormalErrorDegrees);
+	}
+}
+
+AVK_TEST(texture_baker_cache_hits)
+{
+	temp_directory directory{ "avk_texture_baker_cache" };
+	const auto cacheDirectory = (directory.mPath / "cache").string();
+	const std::vector<std::tuple<std::string, avk::texture_content>> sources = {
+		{ write_png(directory, "color", make_color(false)), avk::texture_content::color },
+		{ write_png(directory, "normals", make_normals()), avk::texture_content::normal_map },
+		{ write_png(directory, "height", make_height()), avk::texture_content::single_channel }
+	};
+
+	std::vector<std::string> bakedPaths;
+	avk::texture_baker baker(cacheDirectory);
+	for (const auto& [path, content] : sources) {
+		bakedPaths.push_back(baker.bake(path, content, avk::texture_content::color == content, false));
+	}
+	AVK_CHECK(baker.stats().mNumBaked == sources.size());
+	AVK_CHECK(baker.stats().mBakedBytes < baker.stats().mUncompressedBytes);
+
+	// A second baker must take all of them from the cache:
+	avk::texture_baker warmBaker(cacheDirectory);
+	for (size_t i = 0; i < sources.size(); ++i) {
+		const auto& [path, content] = sources[i];
+		AVK_CHECK(bakedPaths[i] == warmBaker.bake(path, content, avk::texture_content::color == content, false));
+	}
+	AVK_CHECK(warmBaker.stats().mNumBaked == 0);
+	AVK_CHECK(warmBaker.stats().mNumFromCache == sources.size());
+}
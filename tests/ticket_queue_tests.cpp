@@ -0,0 +1,115 @@
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "auto_vk_toolkit.hpp"
+#include "ticket_queue.hpp"
+#include "test_framework.hpp"
+
+// Drives ticket_queue, which texture_streamer keeps its uploads in until their images can be swapped in, without a device:
+// elements retire in the order in which they have been pushed, exactly when their tickets have completed, elements which
+// have been submitted together retire together, and a streaming workload whose uploads complete at random frames never
+// swaps in an image before its upload has completed, nor leaves a completed one behind.
+
+namespace
+{
+	constexpr int cNumFrames = 2000;
+	constexpr int cMaxUploadsPerFrame = 4;
+
+	struct upload
+	{
+		int mId;
+		uint64_t mTicket;
+	};
+}
+
+AVK_TEST(ticket_queue_retires_in_order)
+{
+	ticket_queue<int> queue;
+	queue.push(1, 10);
+	queue.push(2, 20);
+	queue.push(2, 21);
+	queue.push(4, 40);
+	AVK_CHECK(queue.size() == 4);
+	AVK_CHECK(queue.oldest_ticket() == 1 && queue.newest_ticket() == 4);
+
+	std::vector<int> retired;
+	const auto record = [&retired](int& aElement) { retired.push_back(aElement); };
+	AVK_CHECK(queue.retire(0, record) == 0);
+	AVK_CHECK(queue.retire(1, record) == 1);
+	AVK_CHECK((retired == std::vector<int>{ 10 }));
+
+	// Elements which share a ticket retire together:
+	AVK_CHECK(queue.retire(3, record) == 2);
+	AVK_CHECK((retired == std::vector<int>{ 10, 20, 21 }));
+	AVK_CHECK(queue.oldest_ticket() == 4);
+
+	AVK_CHECK(queue.retire(100, record) == 1);
+	AVK_CHECK((retired == std::vector<int>{ 10, 20, 21, 40 }));
+	AVK_CHECK(queue.empty());
+	AVK_CHECK(!queue.oldest_ticket().has_value() && !queue.newest_ticket().has_value());
+}
+
+AVK_TEST(ticket_queue_rejects_decreasing_tickets)
+{
+	ticket_queue<int> queue;
+	queue.push(5, 0);
+	queue.push(5, 1);
+	bool thrown = false;
+	try {
+		queue.push(4, 2);
+	}
+	catch (const std::logic_error&) {
+		thrown = true;
+	}
+	AVK_CHECK(thrown);
+	AVK_CHECK(queue.size() == 2);
+	AVK_CHECK(queue.newest_ticket() == 5);
+}
+
+AVK_TEST(ticket_queue_streaming_never_retires_incomplete_uploads)
+{
+	std::mt19937 rng{ 42 };
+	std::uniform_int_distribution<int> numUploads{ 0, cMaxUploadsPerFrame };
+	std::uniform_int_distribution<int> progress{ 0, 3 };
+
+	ticket_queue<upload> queue;
+	uint64_t submitted = 0; // Like upload_batcher's timeline value
+	uint64_t completed = 0; // Like the current value of its timeline semaphore
+	int nextId = 0;
+	int nextRetiredId = 0;
+	for (int frame = 0; frame < cNumFrames; ++frame) {
+		// A frame's uploads share one submission, like texture_streamer::stage_loaded_levels:
+		const auto n = numUploads(rng);
+		if (n > 0) {
+			++submitted;
+			for (int i = 0; i < n; ++i) {
+				queue.push(submitted, upload{ nextId++, submitted });
+			}
+		}
+
+		// The device completes zero or more submissions per frame, in order:
+		completed = std::min(submitted, completed + static_cast<uint64_t>(progress(rng)));
+
+		queue.retire(completed, [&](upload& aUpload) {
+			AVK_CHECK(aUpload.mTicket <= completed);
+			AVK_CHECK(aUpload.mId == nextRetiredId);
+			++nextRetiredId;
+		});
+		// Whatever remains has not completed yet:
+		AVK_CHECK(!queue.oldest_ticket().has_value() || *queue.oldest_ticket() > completed);
+	}
+
+	// Like ~texture_streamer, which waits for the newest ticket:
+	if (!queue.empty()) {
+		completed = *queue.newest_ticket();
+	}
+	queue.retire(completed, [&](upload& aUpload) {
+		AVK_CHECK(aUpload.mId == nextRetiredId);
+		++nextRetiredId;
+	});
+	AVK_CHECK(queue.empty());
+	AVK_CHECK(nextRetiredId == nextId);
+}
@@ -0,0 +1,185 @@
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "auto_vk_toolkit.hpp"
+#include "upload_ring.hpp"
+#include "test_framework.hpp"
+
+// Drives upload_ring, the bookkeeping of upload_batcher's staging ring, without a device: memory is recycled in submission
+// order once the submissions' tickets have completed, it wraps around behind the oldest submission, the ring starts over
+// whenever it is empty, and a workload which stages, submits, and waits like upload_batcher::allocate never hands out
+// memory which a submission that has not completed yet still reads from.
+
+namespace
+{
+	constexpr size_t cCapacity = 4096;
+	constexpr int cNumUploads = 5000;
+
+	struct region
+	{
+		uint64_t mTicket;
+		size_t mOffset;
+		size_t mSize;
+	};
+
+	bool overlap(const region& a, const region& b)
+	{
+		return a.mOffset < b.mOffset + b.mSize && b.mOffset < a.mOffset + a.mSize;
+	}
+
+	size_t reserve(upload_ring& aRing, size_t aSize)
+	{
+		const auto offset = aRing.find_space(aSize);
+		if (!offset.has_value()) {
+			return cCapacity;
+		}
+		aRing.reserve(offset.value(), aSize);
+		return offset.value();
+	}
+}
+
+AVK_TEST(upload_ring_recycles_memory_when_tickets_complete)
+{
+	upload_ring ring{ cCapacity };
+	AVK_CHECK(reserve(ring, 1000) == 0);
+	ring.submitted(1);
+	AVK_CHECK(reserve(ring, 1000) == 1008);
+	ring.submitted(2);
+	AVK_CHECK(reserve(ring, 1000) == 2016);
+	ring.submitted(3);
+	AVK_CHECK(ring.num_in_flight() == 3);
+	AVK_CHECK(ring.oldest_ticket() == 1);
+
+	// Nothing before ticket 1 has completed, and 1100 bytes fit neither at the end nor at the beginning:
+	ring.retire(0);
+	AVK_CHECK(ring.num_in_flight() == 3);
+	AVK_CHECK(!ring.find_space(1100).has_value());
+
+	ring.retire(2);
+	AVK_CHECK(ring.num_in_flight() == 1);
+	AVK_CHECK(ring.oldest_ticket() == 3);
+	AVK_CHECK(ring.find_space(1100) == 0);
+
+	// Without any reservations, the ring starts over as soon as everything has completed:
+	ring.retire(3);
+	AVK_CHECK(ring.num_in_flight() == 0);
+	AVK_CHECK(!ring.oldest_ticket().has_value());
+	AVK_CHECK(ring.find_space(cCapacity) == 0);
+	AVK_CHECK(ring.largest_free_chunk() == cCapacity);
+}
+
+AVK_TEST(upload_ring_keeps_reservations_which_have_not_been_submitted)
+{
+	upload_ring ring{ cCapacity };
+	AVK_CHECK(reserve(ring, 1000) == 0);
+	ring.submitted(1);
+	AVK_CHECK(reserve(ring, 1000) == 1008);
+
+	// The second reservation belongs to the next submission, hence, the ring must not start over:
+	ring.retire(1);
+	AVK_CHECK(ring.num_in_flight() == 0);
+	AVK_CHECK(reserve(ring, 1000) == 2016);
+	ring.submitted(2);
+	ring.retire(2);
+	AVK_CHECK(ring.find_space(cCapacity) == 0);
+}
+
+AVK_TEST(upload_ring_wraps_around_behind_the_oldest_submission)
+{
+	upload_ring ring{ cCapacity };
+	AVK_CHECK(reserve(ring, 2000) == 0);
+	ring.submitted(1);
+	AVK_CHECK(reserve(ring, 1500) == 2000);
+	ring.submitted(2);
+	ring.retire(1);
+
+	// 1000 bytes do not fit at the end anymore, but in front of the second submission:
+	AVK_CHECK(ring.largest_free_chunk() == 1999);
+	AVK_CHECK(reserve(ring, 1000) == 0);
+	ring.submitted(3);
+	// The head must never reach the tail, which would mean "empty":
+	AVK_CHECK(ring.largest_free_chunk() == 2000 - 1008 - 1);
+	AVK_CHECK(!ring.find_space(2000 - 1008).has_value());
+	AVK_CHECK(ring.find_space(2000 - 1008 - 1) == 1008);
+}
+
+AVK_TEST(upload_ring_never_hands_out_memory_in_use)
+{
+	std::mt19937 rng{ 42 };
+	std::uniform_int_distribution<size_t> sizes{ 1, cCapacity / 3 };
+	std::uniform_int_distribution<int> uploadsPerSubmission{ 1, 4 };
+	std::uniform_int_distribution<int> progress{ 0, 2 };
+
+	upload_ring ring{ cCapacity };
+	std::vector<region> inUse;
+	std::vector<region> pending;
+	uint64_t submitted = 0; // Like upload_batcher's timeline value
+	uint64_t completed = 0; // Like the current value of its timeline semaphore
+	size_t maxInFlight = 0;
+	const auto retire = [&]() {
+		ring.retire(completed);
+		std::erase_if(inUse, [completed](const region& r) { return r.mTicket <= completed; });
+	};
+	const auto submit = [&]() {
+		++submitted;
+		for (auto& r : pending) {
+			r.mTicket = submitted;
+			inUse.push_back(r);
+		}
+		pending.clear();
+		ring.submitted(submitted);
+	};
+
+	auto remaining = uploadsPerSubmission(rng);
+	for (int i = 0; i < cNumUploads; ++i) {
+		const auto size = sizes(rng);
+		retire();
+		AVK_CHECK(ring.largest_free_chunk() == 0 || ring.find_space(ring.largest_free_chunk()).has_value());
+
+		// Like upload_batcher::allocate: submit what is pending, and wait for the oldest submission until there is space:
+		auto offset = ring.find_space(size);
+		while (!offset.has_value()) {
+			if (!pending.empty()) {
+				submit();
+			}
+			AVK_CHECK(ring.oldest_ticket().has_value());
+			if (!ring.oldest_ticket().has_value()) {
+				return;
+			}
+			completed = std::max(completed, ring.oldest_ticket().value());
+			retire();
+			offset = ring.find_space(size);
+		}
+		ring.reserve(offset.value(), size);
+
+		const region r{ 0, offset.value(), size };
+		AVK_CHECK(r.mOffset + r.mSize <= cCapacity);
+		for (const auto& other : inUse) {
+			AVK_CHECK(!overlap(r, other));
+		}
+		for (const auto& other : pending) {
+			AVK_CHECK(!overlap(r, other));
+		}
+		pending.push_back(r);
+
+		if (--remaining == 0) {
+			submit();
+			remaining = uploadsPerSubmission(rng);
+		}
+		// The device completes zero or more submissions in the meantime, in order:
+		completed = std::min(submitted, completed + static_cast<uint64_t>(progress(rng)));
+		maxInFlight = std::max(maxInFlight, ring.num_in_flight());
+	}
+
+	// Like ~upload_batcher, which submits and waits for everything:
+	if (!pending.empty()) {
+		submit();
+	}
+	completed = submitted;
+	retire();
+	AVK_CHECK(ring.num_in_flight() == 0);
+	AVK_CHECK(ring.find_space(cCapacity) == 0);
+	AVK_CHECK(maxInFlight > 1);
+}
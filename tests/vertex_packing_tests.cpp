@@ -0,0 +1,117 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "auto_vk_toolkit.hpp"
+#include "vertex_packing.hpp"
+#include "test_framework.hpp"
+
+// Packs random vertices into the vertex_format::interleaved_quantized layout (see vertex_packing.hpp), unpacks them again,
+// and compares the largest errors against the bounds which the encodings guarantee.
+
+namespace
+{
+	constexpr size_t cNumVertices = 200000;
+
+	glm::vec3 random_unit_vector(std::mt19937& aRng)
+	{
+		std::normal_distribution<float> dist;
+		glm::vec3 v;
+		do {
+			v = glm::vec3{ dist(aRng), dist(aRng), dist(aRng) };
+		} while (glm::dot(v, v) < 1e-6f);
+		return glm::normalize(v);
+	}
+
+	/** The largest error of the unpacked positions per axis, relative to the AABB's extent */
+	double max_position_error(std::mt19937& aRng, const glm::vec3& aMin, const glm::vec3& aExtent)
+	{
+		std::uniform_real_distribution<float> dist{ 0.0f, 1.0f };
+		std::vector<glm::vec3> positions{ aMin, aMin + aExtent };
+		while (positions.size() < cNumVertices) {
+			positions.push_back(aMin + glm::vec3{ dist(aRng), dist(aRng), dist(aRng) } * aExtent);
+		}
+		const auto quantization = position_quantization::from_positions(positions);
+
+		// Minus the float rounding of offset + t * scale:
+		double maxError = 0.0;
+		const auto rounding = 4.0 * std::numeric_limits<float>::epsilon() * static_cast<double>(glm::length(glm::abs(aMin) + aExtent));
+		for (const auto& p : positions) {
+			const auto decoded = vertex_packing::unpack_position(vertex_packing::pack(p, glm::vec2{ 0.0f }, glm::vec3{ 0.0f, 0.0f, 1.0f }, quantization), quantization);
+			for (glm::length_t c = 0; c < 3; ++c) {
+				const auto error = std::abs(static_cast<double>(decoded[c]) - p[c]) - rounding;
+				maxError = std::max(maxError, aExtent[c] > 0.0f ? error / aExtent[c] : error);
+			}
+		}
+		return maxError;
+	}
+}
+
+AVK_TEST(vertex_packing_positions)
+{
+	// Half a quantization step, for AABBs from millimeters to kilometers:
+	constexpr double bound = 0.5 / 65535.0;
+	std::mt19937 rng{ 42u };
+	AVK_CHECK(max_position_error(rng, glm::vec3{ 0.0f }, glm::vec3{ 0.001f }) <= bound);
+	AVK_CHECK(max_position_error(rng, glm::vec3{ -20.0f, 0.0f, -5.0f }, glm::vec3{ 40.0f, 12.0f, 10.0f }) <= bound);
+	AVK_CHECK(max_position_error(rng, glm::vec3{ 1000.0f }, glm::vec3{ 2000.0f, 0.0f, 500.0f }) <= bound);
+}
+
+AVK_TEST(vertex_packing_octahedral_normals)
+{
+	constexpr double boundDegrees = 0.005;
+	std::vector<glm::vec3> normals;
+	// The axes and the seams of the folded octahedron are the edge cases:
+	for (const auto& n : { glm::vec3{ 1, 0, 0 }, glm::vec3{ -1, 0, 0 }, glm::vec3{ 0, 1, 0 }, glm::vec3{ 0, -1, 0 }, glm::vec3{ 0, 0, 1 }, glm::vec3{ 0, 0, -1 },
+	                       glm::vec3{ 1, 1, 0 }, glm::vec3{ -1, 1, 0 }, glm::vec3{ 1, -1, 0 }, glm::vec3{ -1, -1, 0 }, glm::vec3{ 1, 1, -1 }, glm::vec3{ -1, -1, -1 } }) {
+		normals.push_back(glm::normalize(n));
+	}
+	std::mt19937 rng{ 42u };
+	while (normals.size() < cNumVertices) {
+		normals.push_back(random_unit_vector(rng));
+	}
+
+	double maxError = 0.0;
+	for (const auto& n : normals) {
+		const auto decoded = vertex_packing::unpack_normal(vertex_packing::pack(glm::vec3{ 0.0f }, glm::vec2{ 0.0f }, n, position_quantization{ glm::vec3{ 0.0f }, glm::vec3{ 1.0f } }));
+		// In double precision, since acos of a float dot product alone would be off by up to 0.02 degrees near 1:
+		const glm::dvec3 a{ decoded };
+		const glm::dvec3 b{ n };
+		maxError = std::max(maxError, glm::degrees(std::atan2(glm::length(glm::cross(a, b)), glm::dot(a, b))));
+	}
+	std::cout << "Max. normal error: " << maxError << " degrees" << std::endl;
+	AVK_CHECK(maxError <= boundDegrees);
+}
+
+AVK_TEST(vertex_packing_half_tex_coords)
+{
+	// Half precision, for repeating texture coordinates in [-64, 64]:
+	constexpr double bound = 1.0 / 2048.0;
+	std::mt19937 rng{ 42u };
+	std::uniform_real_distribution<float> dist{ -64.0f, 64.0f };
+	double maxError = 0.0;
+	for (size_t i = 0; i < cNumVertices; ++i) {
+		const glm::vec2 uv{ dist(rng), dist(rng) };
+		const auto decoded = vertex_packing::unpack_tex_coord(vertex_packing::pack(glm::vec3{ 0.0f }, uv, glm::vec3{ 0.0f, 0.0f, 1.0f }, position_quantization{ glm::vec3{ 0.0f }, glm::vec3{ 1.0f } }));
+		for (glm::length_t c = 0; c < 2; ++c) {
+			// Values below half's smallest normal number have an absolute error instead:
+			const auto magnitude = std::max(std::abs(static_cast<double>(uv[c])), 6.103515625e-05);
+			maxError = std::max(maxError, std::abs(static_cast<double>(decoded[c]) - uv[c]) / magnitude);
+		}
+	}
+	AVK_CHECK(maxError <= bound);
+}
+
+AVK_TEST(vertex_packing_vertex_size)
+{
+	AVK_CHECK(vertex_packing::bytes_per_vertex(vertex_format::separate_full_precision) == 32);
+	AVK_CHECK(vertex_packing::bytes_per_vertex(vertex_format::interleaved_quantized) == 16);
+
+	std::mt19937 rng{ 42u };
+	std::vector<glm::vec3> positions{ glm::vec3{ -1.0f }, glm::vec3{ 1.0f } };
+	std::vector<glm::vec2> texCoords{ glm::vec2{ 0.0f }, glm::vec2{ 1.0f } };
+	std::vector<glm::vec3> normals{ random_unit_vector(rng), random_unit_vector(rng) };
+	AVK_CHECK(vertex_packing::pack(positions, texCoords, normals, position_quantization::from_positions(positions)).size() == positions.size());
+}